@@ -0,0 +1,137 @@
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <dynemit/core.h>
+#include <dynemit/vector_add.h>
+
+/*
+ * Call overhead of the three ways to reach the same kernel: through the
+ * ifunc symbol (a GOT/PLT indirection bound at load time), through the
+ * rebindable dispatch table (a relaxed load and an indirect call), and
+ * through a kernel pointer held in a local, the floor both compete with.
+ * Small sizes isolate the call itself; the larger ones show where it stops
+ * mattering.
+ */
+
+typedef enum { VARIANT_POINTER, VARIANT_IFUNC, VARIANT_TABLE } variant_t;
+
+static const char *const variant_names[] = { "pointer", "ifunc", "table" };
+
+typedef void (*add_fn)(const float *, const float *, float *, size_t);
+
+static float a[4096], b[4096], out[4096];
+
+/* ---------- timing helper ---------- */
+static double
+now_sec(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static int
+compare_double(const void *x, const void *y)
+{
+    double dx = *(const double *)x;
+    double dy = *(const double *)y;
+    if (dx < dy) return -1;
+    if (dx > dy) return 1;
+    return 0;
+}
+
+/*
+ * Median seconds per call over several trials. The kernel pointer and the
+ * slot are passed in so the compiler cannot hoist the table load out of
+ * the loop; the barrier keeps it from dropping calls.
+ */
+static __attribute__((noinline)) double
+time_variant(variant_t v, add_fn kernel, const dynemit_dispatch_t *slot, size_t n)
+{
+    enum { num_trials = 9 };
+    // Roughly 50M elements per trial, at least 1M calls
+    const long iters = 50000000 / (long)(n + 1) + 1000000;
+    double t[num_trials];
+
+    for (int trial = 0; trial < num_trials; trial++) {
+        double t0 = now_sec();
+        for (long i = 0; i < iters; i++) {
+            switch (v) {
+            case VARIANT_POINTER: kernel(a, b, out, n); break;
+            case VARIANT_IFUNC:   vector_add_f32(a, b, out, n); break;
+            case VARIANT_TABLE:   DYNEMIT_DISPATCH_CALL(slot, vector_add_f32, a, b, out, n); break;
+            }
+            __asm__ volatile("" : "+r"(kernel), "+r"(slot) : : "memory");
+        }
+        t[trial] = (now_sec() - t0) / (double)iters;
+    }
+
+    qsort(t, num_trials, sizeof(double), compare_double);
+    return t[num_trials / 2];
+}
+
+int
+main(int argc, char **argv)
+{
+    int csv_mode = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--csv") == 0) {
+            csv_mode = 1;
+        } else if (strcmp(argv[i], "--help") == 0 || strcmp(argv[i], "-h") == 0) {
+            printf("Usage: %s [OPTIONS]\n", argv[0]);
+            printf("\nOptions:\n");
+            printf("  --csv          Output results in CSV format to stdout\n");
+            printf("                 Format: variant,size,median_ns,overhead_ns,simd_level\n");
+            printf("  --help, -h     Show this help message\n");
+            return 0;
+        } else {
+            fprintf(stderr, "Unknown option: %s\n", argv[i]);
+            fprintf(stderr, "Use --help for usage information\n");
+            return 1;
+        }
+    }
+
+    const size_t sizes[] = { 0, 1, 8, 64, 512, 4096 };
+    const int num_sizes = sizeof(sizes) / sizeof(sizes[0]);
+
+    simd_level_t lvl = detect_simd_level();
+    add_fn kernel = (add_fn)dynemit_get_kernel("vector_add_f32", lvl);
+    const dynemit_dispatch_t *slot = dynemit_dispatch_lookup("vector_add_f32");
+    if (!kernel || !slot) {
+        fprintf(stderr, "vector_add_f32 is not registered\n");
+        return 1;
+    }
+    // Bind both the ifunc symbol and the slot before timing
+    vector_add_f32(a, b, out, 1);
+    DYNEMIT_DISPATCH_CALL(slot, vector_add_f32, a, b, out, 1);
+
+    if (csv_mode) {
+        printf("variant,size,median_ns,overhead_ns,simd_level\n");
+    } else {
+        printf("===========================================\n");
+        printf("Dispatch Call Overhead Benchmark\n");
+        printf("===========================================\n");
+        printf("Detected SIMD level: %s\n", simd_level_name(lvl));
+        printf("vector_add_f32; overhead is relative to calling the kernel pointer\n");
+        printf("\n%-8s %8s %12s %12s\n", "variant", "size", "median ns", "overhead ns");
+    }
+
+    for (int s = 0; s < num_sizes; s++) {
+        size_t n = sizes[s];
+        double base = time_variant(VARIANT_POINTER, kernel, slot, n);
+        for (variant_t v = VARIANT_POINTER; v <= VARIANT_TABLE; v++) {
+            double sec = v == VARIANT_POINTER ? base : time_variant(v, kernel, slot, n);
+            if (csv_mode) {
+                printf("%s,%zu,%.3f,%.3f,%s\n", variant_names[v], n, sec * 1e9, (sec - base) * 1e9,
+                       simd_level_name(lvl));
+            } else {
+                printf("%-8s %8zu %12.3f %12.3f\n", variant_names[v], n, sec * 1e9, (sec - base) * 1e9);
+            }
+        }
+    }
+
+    return 0;
+}
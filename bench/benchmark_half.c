@@ -0,0 +1,184 @@
+#define _POSIX_C_SOURCE 200809L
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <dynemit/core.h>
+#include <dynemit/half.h>
+#include <dynemit/reduce.h>
+#include <dynemit/vector_mul.h>
+
+/*
+ * float vs fp16 vs bf16 storage for element-wise multiply and dot product.
+ * Large inputs are bandwidth-bound, so next to GFLOP/s the benchmark reports
+ * the effective bandwidth: bytes read plus bytes written per call, divided
+ * by the time per call.
+ */
+
+typedef enum { KIND_MUL, KIND_DOT } kernel_kind_t;
+
+typedef struct {
+    const char *name;
+    kernel_kind_t kind;
+    size_t in_size;   // bytes per input element
+    size_t out_size;  // bytes per output element (mul only)
+} kernel_info_t;
+
+static const kernel_info_t kernels[] = {
+    { "vector_mul_f32",      KIND_MUL, 4, 4 },
+    { "vector_mul_f16",      KIND_MUL, 2, 2 },
+    { "vector_mul_f16_f32",  KIND_MUL, 2, 4 },
+    { "vector_mul_bf16",     KIND_MUL, 2, 2 },
+    { "vector_mul_bf16_f32", KIND_MUL, 2, 4 },
+    { "dot_f32",             KIND_DOT, 4, 0 },
+    { "dot_f16",             KIND_DOT, 2, 0 },
+    { "dot_bf16",            KIND_DOT, 2, 0 },
+};
+
+static void *a, *b, *out;
+static volatile float sink;
+
+static void
+run_kernel(int k, size_t n)
+{
+    switch (k) {
+    case 0: vector_mul_f32(a, b, out, n); break;
+    case 1: vector_mul_f16(a, b, out, n); break;
+    case 2: vector_mul_f16_f32(a, b, out, n); break;
+    case 3: vector_mul_bf16(a, b, out, n); break;
+    case 4: vector_mul_bf16_f32(a, b, out, n); break;
+    case 5: sink = dot_f32(a, b, n); break;
+    case 6: sink = dot_f16(a, b, n); break;
+    case 7: sink = dot_bf16(a, b, n); break;
+    }
+}
+
+/* ---------- timing helper ---------- */
+static double
+now_sec(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static int
+compare_double(const void *x, const void *y)
+{
+    double dx = *(const double *)x;
+    double dy = *(const double *)y;
+    if (dx < dy) return -1;
+    if (dx > dy) return 1;
+    return 0;
+}
+
+/* Median seconds per call over several trials */
+static double
+time_kernel(int k, size_t n)
+{
+    enum { num_trials = 7 };
+    // Roughly 50M elements per trial, at least 3 calls
+    const int iters = (int)(50000000 / (n + 1)) + 3;
+    double t[num_trials];
+
+    run_kernel(k, n);
+    for (int trial = 0; trial < num_trials; trial++) {
+        double t0 = now_sec();
+        for (int i = 0; i < iters; i++) {
+            run_kernel(k, n);
+            __asm__ volatile("" : : "r"(out) : "memory");
+        }
+        t[trial] = (now_sec() - t0) / (double)iters;
+    }
+
+    qsort(t, num_trials, sizeof(double), compare_double);
+    return t[num_trials / 2];
+}
+
+int
+main(int argc, char **argv)
+{
+    int csv_mode = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--csv") == 0) {
+            csv_mode = 1;
+        } else if (strcmp(argv[i], "--help") == 0 || strcmp(argv[i], "-h") == 0) {
+            printf("Usage: %s [OPTIONS]\n", argv[0]);
+            printf("\nOptions:\n");
+            printf("  --csv          Output results in CSV format to stdout\n");
+            printf("                 Format: kernel,array_size,median_ns,gflops,gbps,simd_level\n");
+            printf("  --help, -h     Show this help message\n");
+            return 0;
+        } else {
+            fprintf(stderr, "Unknown option: %s\n", argv[i]);
+            fprintf(stderr, "Use --help for usage information\n");
+            return 1;
+        }
+    }
+
+    // From L1-resident up to well past most last-level caches
+    const size_t sizes[] = { 4096, 65536, 1048576, 16777216 };
+    const int num_sizes = sizeof(sizes) / sizeof(sizes[0]);
+    const int num_kernels = sizeof(kernels) / sizeof(kernels[0]);
+    const size_t max_n = sizes[num_sizes - 1];
+
+    a   = aligned_alloc(64, max_n * sizeof(float));
+    b   = aligned_alloc(64, max_n * sizeof(float));
+    out = aligned_alloc(64, max_n * sizeof(float));
+    if (!a || !b || !out) {
+        fprintf(stderr, "alloc failed\n");
+        return 1;
+    }
+    // One bit pattern that reads as ordinary normal numbers in every format:
+    // as float it is ~1.0, as 16-bit halves it is fp16 1.0 / 1.875 and bf16
+    // 0.0078 / 1.0, so no kernel hits subnormals or overflow
+    for (size_t i = 0; i < max_n; i++) {
+        ((uint32_t *)a)[i] = 0x3f803c00u;
+        ((uint32_t *)b)[i] = 0x3f803c00u;
+    }
+
+    simd_level_t lvl = detect_simd_level();
+    if (csv_mode) {
+        printf("kernel,array_size,median_ns,gflops,gbps,simd_level\n");
+    } else {
+        printf("===========================================\n");
+        printf("Half-Precision Storage Benchmark\n");
+        printf("===========================================\n");
+        printf("Detected SIMD level: %s\n", simd_level_name(lvl));
+        printf("F16C: %s, AVX512-FP16: %s, AVX-512 BF16: %s\n",
+               dynemit_cpu_has(DYNEMIT_CPU_F16C) ? "yes" : "no",
+               dynemit_cpu_has(DYNEMIT_CPU_AVX512FP16) ? "yes" : "no",
+               dynemit_cpu_has(DYNEMIT_CPU_AVX512BF16) ? "yes" : "no");
+        printf("GB/s counts bytes read + written per call\n");
+    }
+
+    for (int s = 0; s < num_sizes; s++) {
+        size_t n = sizes[s];
+        if (!csv_mode) {
+            printf("\n--- %zu elements ---\n", n);
+            printf("%-22s %14s %10s %10s\n", "kernel", "median ns", "GFLOP/s", "GB/s");
+        }
+        for (int k = 0; k < num_kernels; k++) {
+            const kernel_info_t *ki = &kernels[k];
+            double sec = time_kernel(k, n);
+            double flops = ki->kind == KIND_MUL ? (double)n : 2.0 * (double)n;
+            double bytes = (double)n * (double)(2 * ki->in_size + ki->out_size);
+            double gflops = flops / sec / 1e9;
+            double gbps = bytes / sec / 1e9;
+
+            if (csv_mode) {
+                printf("%s,%zu,%.1f,%.4f,%.4f,%s\n", ki->name, n, sec * 1e9, gflops, gbps,
+                       simd_level_name(lvl));
+            } else {
+                printf("%-22s %14.1f %10.3f %10.3f\n", ki->name, sec * 1e9, gflops, gbps);
+            }
+        }
+    }
+
+    free(a);
+    free(b);
+    free(out);
+    return 0;
+}
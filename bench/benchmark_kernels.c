@@ -0,0 +1,1007 @@
+#define _GNU_SOURCE
+#include <ctype.h>
+#include <math.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <dynemit/core.h>
+#include "perf_counters.h"
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+/*
+ * Benchmark for every registered function and SIMD variant.
+ *
+ * Functions come from dynemit_list_kernels() and are matched by prototype
+ * against the call shapes below; functions with another prototype (the
+ * batched forms) are listed with --list but not timed. For each function,
+ * every distinct kernel dynemit_get_kernel() returns up to
+ * detect_simd_level() is swept over sizes, alignment offsets, in-place and
+ * out-of-place operands, thread counts and warm or cold caches.
+ *
+ * Each thread is pinned to its own CPU and owns its operands, allocated and
+ * first touched on that CPU. A trial times iters back-to-back calls on every
+ * thread between two barriers; warm trials last at least --min-time, cold
+ * trials flush the operands from the cache hierarchy and time one call.
+ *
+ * Rows share one schema in CSV and JSON: the columns of
+ * benchmark_vector_mul --csv, which scripts/plot_benchmark.py reads, plus
+ * the point's configuration. scripts/compare_benchmark.py compares two runs.
+ * With --perf, each thread also counts hardware events over its timed calls
+ * (see perf_counters.h); rows then carry the counts per call and the
+ * effective core frequency. With --prefetch, every point is run once per
+ * software prefetch distance (dynemit_set_prefetch_distance()) and rows
+ * carry the distance, to compare it per CPU model.
+ */
+
+#define MAX_KERNELS 512
+#define MAX_LIST    64
+#define MAX_THREADS 256
+#define MAX_TRIALS  1000
+
+/* ---------- call shapes ---------- */
+
+typedef enum { T_F32, T_F64, T_I32, T_I16, T_F16, T_BF16 } elem_t;
+
+static const size_t elem_size[] = { 4, 8, 4, 2, 2, 2 };
+
+typedef struct {
+    void  *in[3];
+    void  *out;
+    void  *out2;            // second output (addsub)
+    size_t n;
+} operands_t;
+
+typedef void (*call_fn)(dynemit_kernel_t k, const operands_t *op);
+
+typedef struct {
+    const char *prototype;  // parameter names dropped
+    call_fn     call;
+    int         nin;        // input arrays
+    elem_t      in_type;
+    int         nout;       // output arrays
+    int         inout;      // the output is read as well (axpy)
+    elem_t      out_type;
+    double      ops;        // arithmetic operations per element
+} shape_t;
+
+static __thread volatile float sink;
+
+#define BINARY_CALL(fn, TI, TO)                                                 \
+    static void fn(dynemit_kernel_t k, const operands_t *op)                    \
+    {                                                                           \
+        ((void (*)(const TI *, const TI *, TO *, size_t))k)(op->in[0], op->in[1], op->out, op->n); \
+    }
+
+BINARY_CALL(call_binary_f32, float, float)
+BINARY_CALL(call_binary_f64, double, double)
+BINARY_CALL(call_binary_i32, int32_t, int32_t)
+BINARY_CALL(call_binary_i16, int16_t, int16_t)
+BINARY_CALL(call_binary_h16, uint16_t, uint16_t)
+BINARY_CALL(call_binary_h16_f32, uint16_t, float)
+
+// Broadcast scalar (out = a op s) and in place (a op= b, a op= s), on out
+#define BROADCAST_CALLS(suffix, T)                                              \
+    static void call_broadcast_##suffix(dynemit_kernel_t k, const operands_t *op) \
+    {                                                                           \
+        ((void (*)(const T *, T, T *, size_t))k)(op->in[0], (T)1, op->out, op->n); \
+    }                                                                           \
+    static void call_ip_##suffix(dynemit_kernel_t k, const operands_t *op)      \
+    {                                                                           \
+        ((void (*)(T *, const T *, size_t))k)(op->out, op->in[0], op->n);       \
+    }                                                                           \
+    static void call_broadcast_ip_##suffix(dynemit_kernel_t k, const operands_t *op) \
+    {                                                                           \
+        ((void (*)(T *, T, size_t))k)(op->out, (T)1, op->n);                     \
+    }
+
+BROADCAST_CALLS(f32, float)
+BROADCAST_CALLS(f64, double)
+
+static void
+call_unary_f32(dynemit_kernel_t k, const operands_t *op)
+{
+    ((void (*)(const float *, float *, size_t))k)(op->in[0], op->out, op->n);
+}
+
+static void
+call_ternary_f32(dynemit_kernel_t k, const operands_t *op)
+{
+    ((void (*)(const float *, const float *, const float *, float *, size_t))k)(
+        op->in[0], op->in[1], op->in[2], op->out, op->n);
+}
+
+static void
+call_axpy_f32(dynemit_kernel_t k, const operands_t *op)
+{
+    ((void (*)(float, const float *, float *, size_t))k)(1e-3f, op->in[0], op->out, op->n);
+}
+
+static void
+call_addsub_f32(dynemit_kernel_t k, const operands_t *op)
+{
+    ((void (*)(const float *, const float *, float *, float *, size_t))k)(
+        op->in[0], op->in[1], op->out, op->out2, op->n);
+}
+
+static void
+call_mul_reduce_f32(dynemit_kernel_t k, const operands_t *op)
+{
+    sink = ((float (*)(const float *, const float *, float *, size_t))k)(op->in[0], op->in[1], op->out, op->n);
+}
+
+static void
+call_reduce1_f32(dynemit_kernel_t k, const operands_t *op)
+{
+    sink = ((float (*)(const float *, size_t))k)(op->in[0], op->n);
+}
+
+static void
+call_reduce2_f32(dynemit_kernel_t k, const operands_t *op)
+{
+    sink = ((float (*)(const float *, const float *, size_t))k)(op->in[0], op->in[1], op->n);
+}
+
+static void
+call_reduce2_h16(dynemit_kernel_t k, const operands_t *op)
+{
+    sink = ((float (*)(const uint16_t *, const uint16_t *, size_t))k)(op->in[0], op->in[1], op->n);
+}
+
+static void
+call_minmax_f32(dynemit_kernel_t k, const operands_t *op)
+{
+    float lo, hi;
+    ((void (*)(const float *, size_t, float *, float *))k)(op->in[0], op->n, &lo, &hi);
+    sink = lo + hi;
+}
+
+static const shape_t shapes[] = {
+    { "void (const float *, const float *, float *, size_t)",    call_binary_f32, 2, T_F32, 1, 0, T_F32, 1 },
+    { "void (const double *, const double *, double *, size_t)", call_binary_f64, 2, T_F64, 1, 0, T_F64, 1 },
+    { "void (const int32_t *, const int32_t *, int32_t *, size_t)", call_binary_i32, 2, T_I32, 1, 0, T_I32, 1 },
+    { "void (const int16_t *, const int16_t *, int16_t *, size_t)", call_binary_i16, 2, T_I16, 1, 0, T_I16, 1 },
+    { "void (const dynemit_f16_t *, const dynemit_f16_t *, dynemit_f16_t *, size_t)",
+      call_binary_h16, 2, T_F16, 1, 0, T_F16, 1 },
+    { "void (const dynemit_bf16_t *, const dynemit_bf16_t *, dynemit_bf16_t *, size_t)",
+      call_binary_h16, 2, T_BF16, 1, 0, T_BF16, 1 },
+    { "void (const dynemit_f16_t *, const dynemit_f16_t *, float *, size_t)",
+      call_binary_h16_f32, 2, T_F16, 1, 0, T_F32, 1 },
+    { "void (const dynemit_bf16_t *, const dynemit_bf16_t *, float *, size_t)",
+      call_binary_h16_f32, 2, T_BF16, 1, 0, T_F32, 1 },
+    { "void (const float *, float *, size_t)",                   call_unary_f32, 1, T_F32, 1, 0, T_F32, 1 },
+    { "void (const float *, float, float *, size_t)",            call_broadcast_f32, 1, T_F32, 1, 0, T_F32, 1 },
+    { "void (const double *, double, double *, size_t)",         call_broadcast_f64, 1, T_F64, 1, 0, T_F64, 1 },
+    { "void (float *, const float *, size_t)",                   call_ip_f32, 1, T_F32, 1, 1, T_F32, 1 },
+    { "void (double *, const double *, size_t)",                 call_ip_f64, 1, T_F64, 1, 1, T_F64, 1 },
+    { "void (float *, float, size_t)",                           call_broadcast_ip_f32, 0, T_F32, 1, 1, T_F32, 1 },
+    { "void (double *, double, size_t)",                         call_broadcast_ip_f64, 0, T_F64, 1, 1, T_F64, 1 },
+    { "void (const float *, const float *, const float *, float *, size_t)",
+      call_ternary_f32, 3, T_F32, 1, 0, T_F32, 2 },
+    { "void (float, const float *, float *, size_t)",            call_axpy_f32, 1, T_F32, 1, 1, T_F32, 2 },
+    { "void (const float *, const float *, float *, float *, size_t)",
+      call_addsub_f32, 2, T_F32, 2, 0, T_F32, 2 },
+    { "float (const float *, const float *, float *, size_t)",   call_mul_reduce_f32, 2, T_F32, 1, 0, T_F32, 2 },
+    { "float (const float *, size_t)",                           call_reduce1_f32, 1, T_F32, 0, 0, T_F32, 1 },
+    { "float (const float *, const float *, size_t)",            call_reduce2_f32, 2, T_F32, 0, 0, T_F32, 2 },
+    { "float (const dynemit_f16_t *, const dynemit_f16_t *, size_t)",
+      call_reduce2_h16, 2, T_F16, 0, 0, T_F32, 2 },
+    { "float (const dynemit_bf16_t *, const dynemit_bf16_t *, size_t)",
+      call_reduce2_h16, 2, T_BF16, 0, 0, T_F32, 2 },
+    { "void (const float *, size_t, float *, float *)",          call_minmax_f32, 1, T_F32, 0, 0, T_F32, 2 },
+};
+
+// "void (const float *a, size_t n)" -> "void (const float *, size_t)"
+static void
+strip_parameter_names(const char *proto, char *buf, size_t size)
+{
+    size_t len = 0, param = 0;
+    int depth = 0;
+
+    for (const char *p = proto; *p && len + 1 < size; p++) {
+        if ((*p == ',' || *p == ')') && depth == 1) {
+            size_t s = len;
+            while (s > param && (isalnum((unsigned char)buf[s - 1]) || buf[s - 1] == '_'))
+                s--;
+            size_t t = s;
+            while (t > param && buf[t - 1] == ' ')
+                t--;
+            // Keep a lone type name ("void", "size_t" without a name)
+            if (s < len && t > param && (buf[s - 1] == ' ' || buf[s - 1] == '*'))
+                len = buf[s - 1] == '*' ? s : t;
+        }
+        if (*p == '(')
+            depth++;
+        else if (*p == ')')
+            depth--;
+        buf[len++] = *p;
+        if (*p == '(' && depth == 1)
+            param = len;
+        if (*p == ',' && depth == 1) {
+            buf[len++] = ' ';
+            while (p[1] == ' ')
+                p++;
+            param = len;
+        }
+    }
+    buf[len] = '\0';
+}
+
+static const shape_t *
+shape_for(const char *prototype)
+{
+    if (!prototype)
+        return nullptr;
+    char stripped[256];
+    strip_parameter_names(prototype, stripped, sizeof(stripped));
+    for (size_t i = 0; i < sizeof(shapes) / sizeof(shapes[0]); i++) {
+        if (strcmp(shapes[i].prototype, stripped) == 0)
+            return &shapes[i];
+    }
+    return nullptr;
+}
+
+// norm2 has sum's prototype but squares each element as well
+static double
+ops_per_element(const char *name, const shape_t *shape)
+{
+    return strncmp(name, "norm2_", 6) == 0 ? 2 : shape->ops;
+}
+
+/* ---------- options ---------- */
+
+typedef struct {
+    const char *filter[MAX_LIST];
+    int         num_filters;
+    size_t      sizes[MAX_LIST];
+    int         num_sizes;
+    size_t      offsets[MAX_LIST];
+    int         num_offsets;
+    int         threads[MAX_LIST];
+    int         num_threads;
+    int         inplace[2];   // out-of-place, in-place
+    int         cache[2];     // warm, cold
+    int         best_only;
+    simd_level_t levels[MAX_LIST];
+    int         num_levels;   // 0: every distinct kernel
+    int         trials;
+    double      min_time;     // seconds per warm trial
+    int         cpu;          // first CPU, -1 to leave threads unpinned
+    enum { FMT_TEXT, FMT_CSV, FMT_JSON } format;
+    const char *output;
+    int         list;
+    int         perf;
+    size_t      prefetch[MAX_LIST];
+    int         num_prefetch;  // 0: the library's distance, not reported
+} options_t;
+
+// "1K" = 1024, "4M" = 4 * 1024 * 1024
+static int
+parse_size(const char *s, size_t *value)
+{
+    char *end;
+    unsigned long long v = strtoull(s, &end, 10);
+    if (end == s)
+        return -1;
+    if (*end == 'k' || *end == 'K')
+        v <<= 10, end++;
+    else if (*end == 'm' || *end == 'M')
+        v <<= 20, end++;
+    if (*end)
+        return -1;
+    *value = (size_t)v;
+    return 0;
+}
+
+// Comma-separated list into argv-style pointers; modifies s
+static int
+split_list(char *s, const char **items, int max)
+{
+    int count = 0;
+    for (char *tok = strtok(s, ","); tok && count < max; tok = strtok(nullptr, ","))
+        items[count++] = tok;
+    return count;
+}
+
+static int
+parse_size_list(char *s, size_t *values, int *count, size_t min)
+{
+    const char *items[MAX_LIST];
+    *count = split_list(s, items, MAX_LIST);
+    for (int i = 0; i < *count; i++) {
+        if (parse_size(items[i], &values[i]) != 0 || values[i] < min)
+            return -1;
+    }
+    return *count ? 0 : -1;
+}
+
+static int
+parse_both(const char *s, const char *no, const char *yes, int flags[2])
+{
+    flags[0] = strcmp(s, no) == 0 || strcmp(s, "both") == 0;
+    flags[1] = strcmp(s, yes) == 0 || strcmp(s, "both") == 0;
+    return flags[0] || flags[1] ? 0 : -1;
+}
+
+static void
+usage(const char *prog)
+{
+    printf("Usage: %s [OPTIONS]\n", prog);
+    printf("\nOptions:\n");
+    printf("  --list               List registered functions and their call shapes\n");
+    printf("  --filter A,B         Only functions whose name contains A or B\n");
+    printf("  --sizes LIST         Element counts, K/M suffixes allowed\n");
+    printf("                       (default 256,1K,4K,16K,64K,256K,1M,4M)\n");
+    printf("  --offsets LIST       Element offsets from 64-byte alignment (default 0)\n");
+    printf("  --inplace MODE       no, yes or both: out aliases the first input (default no)\n");
+    printf("  --threads LIST       Thread counts, one pinned CPU each (default 1)\n");
+    printf("  --cpu N              CPU of the first thread, -1 for no pinning\n");
+    printf("                       (default: first CPU of the affinity mask)\n");
+    printf("  --cache MODE         warm, cold or both (default warm)\n");
+    printf("  --levels LIST        all, best or levels such as sse2,avx2 (default all)\n");
+    printf("  --trials N           Trials per point (default 10)\n");
+    printf("  --min-time MS        Minimum duration of a warm trial (default 2)\n");
+    printf("  --format FMT         text, csv or json (default text)\n");
+    printf("  --output FILE        Write results to FILE instead of stdout\n");
+    printf("  --perf               Count hardware events per call: " PERF_CSV_COLUMNS "\n");
+    printf("  --prefetch LIST      Sweep software prefetch distances in bytes, K suffix allowed\n");
+    printf("  --help, -h           Show this help message\n");
+    printf("\nExamples:\n");
+    printf("  %s --filter vector_add_f32 --offsets 0,1,3 --inplace both\n", prog);
+    printf("  %s --cache both --threads 1,4 --format csv --output run.csv\n", prog);
+    printf("  %s --filter vector_mul_f32 --sizes 4M,16M --prefetch 0,512,1K,2K,4K\n", prog);
+}
+
+static int
+parse_options(int argc, char **argv, options_t *opt)
+{
+    *opt = (options_t){
+        .sizes = { 256, 1 << 10, 4 << 10, 16 << 10, 64 << 10, 256 << 10, 1 << 20, 4 << 20 },
+        .num_sizes = 8,
+        .num_offsets = 1,
+        .threads = { 1 },
+        .num_threads = 1,
+        .inplace = { 1, 0 },
+        .cache = { 1, 0 },
+        .trials = 10,
+        .min_time = 2e-3,
+        .cpu = -2,  // default: first CPU of the mask
+    };
+
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        char *val = i + 1 < argc ? argv[i + 1] : nullptr;
+
+        if (strcmp(arg, "--help") == 0 || strcmp(arg, "-h") == 0) {
+            usage(argv[0]);
+            exit(0);
+        } else if (strcmp(arg, "--list") == 0) {
+            opt->list = 1;
+            continue;
+        } else if (strcmp(arg, "--perf") == 0) {
+            opt->perf = 1;
+            continue;
+        }
+
+        if (!val) {
+            fprintf(stderr, "Missing value for %s\n", arg);
+            return -1;
+        }
+        i++;
+
+        int bad = 0;
+        if (strcmp(arg, "--filter") == 0) {
+            opt->num_filters = split_list(val, opt->filter, MAX_LIST);
+        } else if (strcmp(arg, "--sizes") == 0) {
+            bad = parse_size_list(val, opt->sizes, &opt->num_sizes, 1);
+        } else if (strcmp(arg, "--offsets") == 0) {
+            bad = parse_size_list(val, opt->offsets, &opt->num_offsets, 0);
+        } else if (strcmp(arg, "--prefetch") == 0) {
+            bad = parse_size_list(val, opt->prefetch, &opt->num_prefetch, 0);
+        } else if (strcmp(arg, "--threads") == 0) {
+            const char *items[MAX_LIST];
+            opt->num_threads = split_list(val, items, MAX_LIST);
+            for (int t = 0; t < opt->num_threads; t++) {
+                opt->threads[t] = atoi(items[t]);
+                bad |= opt->threads[t] < 1 || opt->threads[t] > MAX_THREADS;
+            }
+            bad |= opt->num_threads == 0;
+        } else if (strcmp(arg, "--inplace") == 0) {
+            bad = parse_both(val, "no", "yes", opt->inplace);
+        } else if (strcmp(arg, "--cache") == 0) {
+            bad = parse_both(val, "warm", "cold", opt->cache);
+        } else if (strcmp(arg, "--levels") == 0) {
+            opt->best_only = strcmp(val, "best") == 0;
+            opt->num_levels = 0;
+            if (!opt->best_only && strcmp(val, "all") != 0) {
+                const char *items[MAX_LIST];
+                int count = split_list(val, items, MAX_LIST);
+                for (int l = 0; l < count; l++)
+                    bad |= simd_level_from_name(items[l], &opt->levels[opt->num_levels++]);
+                bad |= count == 0;
+            }
+        } else if (strcmp(arg, "--trials") == 0) {
+            opt->trials = atoi(val);
+            bad = opt->trials < 1 || opt->trials > MAX_TRIALS;
+        } else if (strcmp(arg, "--min-time") == 0) {
+            opt->min_time = atof(val) * 1e-3;
+            bad = opt->min_time <= 0;
+        } else if (strcmp(arg, "--cpu") == 0) {
+            opt->cpu = atoi(val);
+            bad = opt->cpu < -1;
+        } else if (strcmp(arg, "--format") == 0) {
+            opt->format = strcmp(val, "csv") == 0 ? FMT_CSV : strcmp(val, "json") == 0 ? FMT_JSON : FMT_TEXT;
+            bad = opt->format == FMT_TEXT && strcmp(val, "text") != 0;
+        } else if (strcmp(arg, "--output") == 0) {
+            opt->output = val;
+        } else {
+            fprintf(stderr, "Unknown option: %s\n", arg);
+            fprintf(stderr, "Use --help for usage information\n");
+            return -1;
+        }
+        if (bad) {
+            fprintf(stderr, "Invalid value for %s: %s\n", arg, val);
+            return -1;
+        }
+    }
+    return 0;
+}
+
+/* ---------- CPUs ---------- */
+
+static int cpus[CPU_SETSIZE];
+static int num_cpus;
+
+// Thread t runs on the t-th CPU of the affinity mask, counting from --cpu
+static int
+cpu_for_thread(const options_t *opt, int t)
+{
+    if (opt->cpu == -1 || num_cpus == 0)
+        return -1;
+    int first = 0;
+    while (first < num_cpus && cpus[first] != opt->cpu)
+        first++;
+    if (first == num_cpus)
+        first = 0;
+    return cpus[(first + t) % num_cpus];
+}
+
+static void
+pin_to_cpu(int cpu)
+{
+    if (cpu < 0)
+        return;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    sched_setaffinity(0, sizeof(set), &set);
+}
+
+static void
+get_cpu_model(char *buf, size_t size)
+{
+    snprintf(buf, size, "unknown");
+    FILE *fp = fopen("/proc/cpuinfo", "r");
+    if (!fp)
+        return;
+    char line[256];
+    while (fgets(line, sizeof(line), fp)) {
+        char *colon = strchr(line, ':');
+        if (strncmp(line, "model name", 10) != 0 || !colon)
+            continue;
+        colon++;
+        while (*colon == ' ' || *colon == '\t')
+            colon++;
+        colon[strcspn(colon, "\n\"\\")] = '\0';
+        snprintf(buf, size, "%s", colon);
+        break;
+    }
+    fclose(fp);
+}
+
+/* ---------- operands ---------- */
+
+typedef struct {
+    const char      *name;
+    const shape_t   *shape;
+    dynemit_kernel_t kernel;
+    simd_level_t     level;
+    size_t           n;
+    size_t           offset;   // elements past 64-byte alignment
+    int              inplace;
+    int              threads;
+    int              cold;
+    size_t           prefetch;  // bytes, with --prefetch
+} point_t;
+
+typedef struct {
+    operands_t op;
+    void      *mem[4];
+    size_t     bytes[4];  // bytes used from each array's start, for flushing
+    int        count;
+} buffers_t;
+
+static void
+fill(void *p, elem_t type, size_t n)
+{
+    // Second input factors are at least 1, so repeated in-place calls never
+    // produce denormals
+    for (size_t i = 0; i < n; i++) {
+        switch (type) {
+        case T_F32:  ((float *)p)[i] = 1.0f + (float)(i % 16) * 0.125f; break;
+        case T_F64:  ((double *)p)[i] = 1.0 + (double)(i % 16) * 0.125; break;
+        case T_I32:  ((int32_t *)p)[i] = (int32_t)(i % 100) + 1; break;
+        case T_I16:  ((int16_t *)p)[i] = (int16_t)(i % 100) + 1; break;
+        case T_F16:  ((uint16_t *)p)[i] = (uint16_t)(0x3c00 + i % 16); break;
+        case T_BF16: ((uint16_t *)p)[i] = (uint16_t)(0x3f80 + i % 16); break;
+        }
+    }
+}
+
+static void *
+alloc_array(buffers_t *buf, elem_t type, const point_t *pt)
+{
+    size_t bytes = (pt->n + pt->offset) * elem_size[type];
+    size_t alloc = (bytes + 63) / 64 * 64;
+    void *mem = aligned_alloc(64, alloc ? alloc : 64);
+    if (!mem) {
+        fprintf(stderr, "alloc failed for %s, n=%zu\n", pt->name, pt->n);
+        exit(1);
+    }
+    // First touch by the calling thread, on its pinned CPU
+    fill(mem, type, pt->n + pt->offset);
+    buf->mem[buf->count] = mem;
+    buf->bytes[buf->count] = bytes;
+    buf->count++;
+    return (char *)mem + pt->offset * elem_size[type];
+}
+
+static void
+alloc_operands(buffers_t *buf, const point_t *pt)
+{
+    const shape_t *s = pt->shape;
+    *buf = (buffers_t){ .op.n = pt->n };
+    for (int k = 0; k < s->nin; k++)
+        buf->op.in[k] = alloc_array(buf, s->in_type, pt);
+    if (s->nout >= 1)
+        buf->op.out = pt->inplace ? buf->op.in[0] : alloc_array(buf, s->out_type, pt);
+    if (s->nout >= 2)
+        buf->op.out2 = pt->inplace ? buf->op.in[1] : alloc_array(buf, s->out_type, pt);
+}
+
+static void
+free_operands(buffers_t *buf)
+{
+    for (int k = 0; k < buf->count; k++)
+        free(buf->mem[k]);
+}
+
+// Evict the operands from every cache level before a cold call
+static void
+flush_operands(const buffers_t *buf)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    for (int k = 0; k < buf->count; k++) {
+        for (size_t off = 0; off < buf->bytes[k]; off += 64)
+            _mm_clflush((const char *)buf->mem[k] + off);
+    }
+    _mm_mfence();
+#else
+    (void)buf;
+#endif
+}
+
+/* ---------- timing ---------- */
+
+static double
+now_sec(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+typedef struct {
+    const point_t    *pt;
+    int               index;
+    int               cpu;
+    int               iters;
+    int               trials;
+    buffers_t        *main_buf;  // thread 0's operands, set up by main
+    pthread_barrier_t *barrier;
+    double           *times;     // seconds per call, written by thread 0
+    int               use_perf;
+    perf_sample_t     sample;    // this thread's counts over all trials
+} worker_t;
+
+static void *
+worker_main(void *arg)
+{
+    worker_t *w = arg;
+    const point_t *pt = w->pt;
+    buffers_t own, *buf = w->main_buf;
+    perf_counters_t pc;
+
+    if (w->index) {
+        pin_to_cpu(w->cpu);
+        alloc_operands(&own, pt);
+        buf = &own;
+        if (!pt->cold)
+            pt->shape->call(pt->kernel, &buf->op);
+    }
+    // Counters belong to the thread that opens them
+    if (w->use_perf)
+        perf_counters_open(&pc);
+    pthread_barrier_wait(w->barrier);
+
+    for (int trial = 0; trial < w->trials; trial++) {
+        if (pt->cold)
+            flush_operands(buf);
+        pthread_barrier_wait(w->barrier);
+        double t0 = now_sec();
+        if (w->use_perf)
+            perf_counters_start(&pc);
+        for (int i = 0; i < w->iters; i++)
+            pt->shape->call(pt->kernel, &buf->op);
+        if (w->use_perf)
+            perf_counters_stop(&pc, &w->sample);
+        pthread_barrier_wait(w->barrier);
+        if (w->index == 0)
+            w->times[trial] = (now_sec() - t0) / (double)w->iters;
+    }
+
+    if (w->use_perf)
+        perf_counters_close(&pc);
+    if (w->index)
+        free_operands(&own);
+    return nullptr;
+}
+
+typedef struct {
+    double median_ms, mean_ms, stddev_ms, min_ms, max_ms, p99_ms;
+    perf_sample_t counts;  // summed over all threads, with --perf
+    double calls;          // calls the counts cover
+} summary_t;
+
+static int
+compare_double(const void *a, const void *b)
+{
+    double da = *(const double *)a, db = *(const double *)b;
+    return (da > db) - (da < db);
+}
+
+static summary_t
+summarize(double *times, int n)
+{
+    summary_t s = { 0 };
+    qsort(times, (size_t)n, sizeof(double), compare_double);
+
+    double sum = 0.0;
+    for (int i = 0; i < n; i++)
+        sum += times[i];
+    double mean = sum / n, sq = 0.0;
+    for (int i = 0; i < n; i++)
+        sq += (times[i] - mean) * (times[i] - mean);
+
+    double index = 0.99 * (n - 1);
+    int lo = (int)floor(index), hi = (int)ceil(index);
+    double p99 = times[lo] + (times[hi] - times[lo]) * (index - lo);
+
+    s.median_ms = (n % 2 ? times[n / 2] : (times[n / 2 - 1] + times[n / 2]) / 2.0) * 1e3;
+    s.mean_ms   = mean * 1e3;
+    s.stddev_ms = sqrt(sq / n) * 1e3;
+    s.min_ms    = times[0] * 1e3;
+    s.max_ms    = times[n - 1] * 1e3;
+    s.p99_ms    = p99 * 1e3;
+    return s;
+}
+
+static summary_t
+run_point(const point_t *pt, const options_t *opt)
+{
+    buffers_t buf;
+    pin_to_cpu(cpu_for_thread(opt, 0));
+    alloc_operands(&buf, pt);
+
+    // Warm trials run at least min_time; cold trials time one call each
+    int iters = 1;
+    if (!pt->cold) {
+        for (;;) {
+            double t0 = now_sec();
+            for (int i = 0; i < iters; i++)
+                pt->shape->call(pt->kernel, &buf.op);
+            if (now_sec() - t0 >= opt->min_time || iters >= (1 << 24))
+                break;
+            iters *= 2;
+        }
+    }
+
+    double times[MAX_TRIALS];
+    pthread_barrier_t barrier;
+    pthread_barrier_init(&barrier, nullptr, (unsigned)pt->threads);
+
+    worker_t workers[MAX_THREADS];
+    pthread_t tids[MAX_THREADS];
+    for (int t = 0; t < pt->threads; t++) {
+        workers[t] = (worker_t){
+            pt, t, cpu_for_thread(opt, t), iters, opt->trials, &buf, &barrier, times, opt->perf, { { 0 }, { 0 } },
+        };
+        if (t && pthread_create(&tids[t], nullptr, worker_main, &workers[t]) != 0) {
+            fprintf(stderr, "pthread_create failed\n");
+            exit(1);
+        }
+    }
+    worker_main(&workers[0]);
+    for (int t = 1; t < pt->threads; t++)
+        pthread_join(tids[t], nullptr);
+
+    pthread_barrier_destroy(&barrier);
+    free_operands(&buf);
+
+    summary_t s = summarize(times, opt->trials);
+    for (int t = 0; t < pt->threads; t++)
+        perf_sample_add(&s.counts, &workers[t].sample);
+    s.calls = (double)opt->trials * iters * pt->threads;
+    return s;
+}
+
+/* ---------- output ---------- */
+
+static FILE *out;
+static int rows;
+
+static void
+print_header(const options_t *opt)
+{
+    char model[128];
+    get_cpu_model(model, sizeof(model));
+
+    if (opt->format == FMT_CSV) {
+        fprintf(out, "array_size,median_ms,mean_ms,stddev_ms,min_ms,max_ms,p99_ms,gflops,gbps,"
+                     "simd_level,function,offset,inplace,threads,cache,ns_per_elem%s%s\n",
+                opt->num_prefetch ? ",prefetch" : "", opt->perf ? "," PERF_CSV_COLUMNS : "");
+    } else if (opt->format == FMT_JSON) {
+        fprintf(out, "{\"cpu\": \"%s\", \"simd_level\": \"%s\", \"trials\": %d, \"results\": [",
+                model, simd_level_name(detect_simd_level()), opt->trials);
+    } else {
+        fprintf(out, "CPU: %s\nDetected SIMD level: %s\n\n", model, simd_level_name(detect_simd_level()));
+        fprintf(out, "%-22s %-8s %9s %4s %-8s %3s %-5s %12s %10s %10s %9s", "function", "level", "n",
+                "off", "operands", "thr", "cache", "median_ms", "ns/elem", "GB/s", "GOP/s");
+        if (opt->num_prefetch)
+            fprintf(out, " %6s", "pf");
+        if (opt->perf)
+            fprintf(out, " %9s %6s %6s", "cyc/elem", "IPC", "GHz");
+        fputc('\n', out);
+    }
+}
+
+// Cycles per element, IPC and GHz for the text table, "-" where unavailable
+static void
+print_perf_text(const perf_sample_t *c, double elements)
+{
+    if (c->valid[PERF_CYCLES])
+        fprintf(out, " %9.3f", c->count[PERF_CYCLES] / elements);
+    else
+        fprintf(out, " %9s", "-");
+    if (c->valid[PERF_CYCLES] && c->valid[PERF_INSTRUCTIONS] && c->count[PERF_CYCLES] > 0)
+        fprintf(out, " %6.2f", c->count[PERF_INSTRUCTIONS] / c->count[PERF_CYCLES]);
+    else
+        fprintf(out, " %6s", "-");
+    double ghz = perf_ghz(c);
+    if (ghz > 0)
+        fprintf(out, " %6.2f", ghz);
+    else
+        fprintf(out, " %6s", "-");
+}
+
+static void
+print_row(const options_t *opt, const point_t *pt, const summary_t *s)
+{
+    const shape_t *sh = pt->shape;
+    double elements = (double)pt->n * pt->threads;
+    double bytes = elements * (sh->nin * elem_size[sh->in_type] +
+                               sh->nout * (1 + sh->inout) * elem_size[sh->out_type]);
+    double sec = s->median_ms * 1e-3;
+    double gops = elements * ops_per_element(pt->name, sh) / sec / 1e9;
+    double gbps = bytes / sec / 1e9;
+    double ns = sec * 1e9 / elements;
+    const char *level = simd_level_name(pt->level);
+    const char *cache = pt->cold ? "cold" : "warm";
+
+    if (opt->format == FMT_CSV) {
+        fprintf(out, "%zu,%.9f,%.9f,%.9f,%.9f,%.9f,%.9f,%.4f,%.4f,%s,%s,%zu,%d,%d,%s,%.4f", pt->n,
+                s->median_ms, s->mean_ms, s->stddev_ms, s->min_ms, s->max_ms, s->p99_ms, gops, gbps,
+                level, pt->name, pt->offset, pt->inplace, pt->threads, cache, ns);
+        if (opt->num_prefetch)
+            fprintf(out, ",%zu", pt->prefetch);
+        if (opt->perf)
+            perf_print_csv(out, &s->counts, s->calls);
+        fputc('\n', out);
+    } else if (opt->format == FMT_JSON) {
+        fprintf(out, "%s\n  {\"array_size\": %zu, \"median_ms\": %.9f, \"mean_ms\": %.9f, "
+                     "\"stddev_ms\": %.9f, \"min_ms\": %.9f, \"max_ms\": %.9f, \"p99_ms\": %.9f, "
+                     "\"gflops\": %.4f, \"gbps\": %.4f, \"simd_level\": \"%s\", \"function\": \"%s\", "
+                     "\"offset\": %zu, \"inplace\": %d, \"threads\": %d, \"cache\": \"%s\", "
+                     "\"ns_per_elem\": %.4f",
+                rows ? "," : "", pt->n, s->median_ms, s->mean_ms, s->stddev_ms, s->min_ms, s->max_ms,
+                s->p99_ms, gops, gbps, level, pt->name, pt->offset, pt->inplace, pt->threads, cache, ns);
+        if (opt->num_prefetch)
+            fprintf(out, ", \"prefetch\": %zu", pt->prefetch);
+        if (opt->perf)
+            perf_print_json(out, &s->counts, s->calls);
+        fputc('}', out);
+    } else {
+        fprintf(out, "%-22s %-8s %9zu %4zu %-8s %3d %-5s %12.6f %10.4f %10.2f %9.2f", pt->name, level,
+                pt->n, pt->offset, pt->inplace ? "in-place" : "separate", pt->threads, cache,
+                s->median_ms, ns, gbps, gops);
+        if (opt->num_prefetch)
+            fprintf(out, " %6zu", pt->prefetch);
+        if (opt->perf)
+            print_perf_text(&s->counts, s->calls * (double)pt->n);
+        fputc('\n', out);
+    }
+    fflush(out);
+    rows++;
+}
+
+static void
+print_footer(const options_t *opt)
+{
+    if (opt->format == FMT_JSON)
+        fprintf(out, "\n]}\n");
+}
+
+/* ---------- sweep ---------- */
+
+static int
+selected(const options_t *opt, const char *name)
+{
+    if (!opt->num_filters)
+        return 1;
+    for (int i = 0; i < opt->num_filters; i++) {
+        if (strstr(name, opt->filter[i]))
+            return 1;
+    }
+    return 0;
+}
+
+// Levels to run for a function: each distinct kernel up to the detected
+// level, under the lowest level that selects it
+static int
+variants(const options_t *opt, const char *name, simd_level_t *levels)
+{
+    simd_level_t top = detect_simd_level();
+    int count = 0;
+
+    if (opt->best_only) {
+        levels[count++] = top;
+    } else if (opt->num_levels) {
+        for (int i = 0; i < opt->num_levels; i++) {
+            if (opt->levels[i] <= top)
+                levels[count++] = opt->levels[i];
+        }
+    } else {
+        dynemit_kernel_t prev = nullptr;
+        for (int l = SIMD_SCALAR; l <= (int)top; l++) {
+            dynemit_kernel_t k = dynemit_get_kernel(name, (simd_level_t)l);
+            if (k && k != prev)
+                levels[count++] = (simd_level_t)l;
+            prev = k;
+        }
+    }
+    return count;
+}
+
+static int
+compare_name(const void *a, const void *b)
+{
+    return strcmp(((const dynemit_kernel_info_t *)a)->name, ((const dynemit_kernel_info_t *)b)->name);
+}
+
+static void
+list_kernels(const dynemit_kernel_info_t *kernels, size_t count, const options_t *opt)
+{
+    for (size_t i = 0; i < count; i++) {
+        if (!selected(opt, kernels[i].name))
+            continue;
+        simd_level_t levels[MAX_LIST];
+        int nlevels = variants(opt, kernels[i].name, levels);
+        printf("%-26s %-8s", kernels[i].name, shape_for(kernels[i].prototype) ? "timed" : "skipped");
+        for (int l = 0; l < nlevels; l++)
+            printf(" %s", simd_level_name(levels[l]));
+        printf("\n    %s\n", kernels[i].prototype ? kernels[i].prototype : "(no prototype)");
+    }
+}
+
+int
+main(int argc, char **argv)
+{
+    options_t opt;
+    if (parse_options(argc, argv, &opt) != 0)
+        return 1;
+
+    cpu_set_t mask;
+    if (sched_getaffinity(0, sizeof(mask), &mask) == 0) {
+        for (int c = 0; c < CPU_SETSIZE; c++) {
+            if (CPU_ISSET(c, &mask))
+                cpus[num_cpus++] = c;
+        }
+    }
+    if (opt.cpu == -2)
+        opt.cpu = num_cpus ? cpus[0] : -1;
+
+    static dynemit_kernel_info_t kernels[MAX_KERNELS];
+    size_t count = dynemit_list_kernels(kernels, MAX_KERNELS);
+    if (count > MAX_KERNELS)
+        count = MAX_KERNELS;
+    qsort(kernels, count, sizeof(kernels[0]), compare_name);
+
+    if (opt.list) {
+        list_kernels(kernels, count, &opt);
+        return 0;
+    }
+
+    out = stdout;
+    if (opt.output && !(out = fopen(opt.output, "w"))) {
+        fprintf(stderr, "Error: Could not create file '%s'\n", opt.output);
+        return 1;
+    }
+
+    if (opt.perf) {
+        perf_counters_t pc;
+        perf_counters_open(&pc);
+        fprintf(stderr, "Hardware counters: ");
+        perf_counters_describe(&pc, stderr);
+        perf_counters_close(&pc);
+    }
+    size_t prefetch_default = dynemit_prefetch_distance();
+    if (opt.num_prefetch)
+        fprintf(stderr, "Prefetch distance: %zu bytes by default, sweeping %d\n",
+                prefetch_default, opt.num_prefetch);
+
+    print_header(&opt);
+    for (size_t i = 0; i < count; i++) {
+        const shape_t *shape = shape_for(kernels[i].prototype);
+        if (!selected(&opt, kernels[i].name) || !shape)
+            continue;
+
+        simd_level_t levels[MAX_LIST];
+        int nlevels = variants(&opt, kernels[i].name, levels);
+        for (int l = 0; l < nlevels; l++)
+        for (int s = 0; s < opt.num_sizes; s++)
+        for (int o = 0; o < opt.num_offsets; o++)
+        for (int ip = 0; ip < 2; ip++)
+        for (int t = 0; t < opt.num_threads; t++)
+        for (int c = 0; c < 2; c++)
+        for (int p = 0; p < (opt.num_prefetch ? opt.num_prefetch : 1); p++) {
+            // Only an output of the inputs' type can alias one
+            if (!opt.inplace[ip] || !opt.cache[c] ||
+                (ip && (!shape->nout || shape->inout || shape->in_type != shape->out_type)))
+                continue;
+
+            point_t pt = {
+                kernels[i].name, shape, dynemit_get_kernel(kernels[i].name, levels[l]), levels[l],
+                opt.sizes[s], opt.offsets[o], ip, opt.threads[t], c,
+                opt.num_prefetch ? opt.prefetch[p] : prefetch_default,
+            };
+            if (!pt.kernel)
+                continue;
+            dynemit_set_prefetch_distance(pt.prefetch);
+            summary_t summary = run_point(&pt, &opt);
+            print_row(&opt, &pt, &summary);
+        }
+    }
+    dynemit_set_prefetch_distance(prefetch_default);
+    print_footer(&opt);
+
+    if (out != stdout)
+        fclose(out);
+    if (opt.output)
+        fprintf(stderr, "%d results saved to: %s\n", rows, opt.output);
+    return 0;
+}
@@ -10,6 +10,11 @@
 #include <math.h>
 #include <dynemit/core.h>
 #include <dynemit/vector_mul.h>
+#include "perf_counters.h"
+
+// Hardware counters, with --perf
+static int use_perf;
+static perf_counters_t perf;
 
 /* ---------- CPU model detection ---------- */
 static void
@@ -225,8 +230,23 @@ find_max(double *values, int n)
 }
 
 /* ---------- benchmark a single array size ---------- */
-static void
-benchmark_size(size_t n, int csv_mode, simd_level_t lvl)
+typedef struct {
+    size_t n;
+    int iters;
+    int num_trials;
+    double median_ms;
+    double mean_ms;
+    double stddev_ms;
+    double min_ms;
+    double max_ms;
+    double p99_ms;
+    double gflops;
+    double gbps;
+    perf_sample_t counts;
+} bench_stats_t;
+
+static int
+benchmark_size(size_t n, int check, bench_stats_t *st)
 {
     const size_t bytes = n * sizeof(float);
     const int num_trials = 10;
@@ -249,7 +269,10 @@ benchmark_size(size_t n, int csv_mode, simd_level_t lvl)
 
     if (!a || !b || !out) {
         fprintf(stderr, "alloc failed for n=%zu\n", n);
-        return;
+        free(a);
+        free(b);
+        free(out);
+        return -1;
     }
 
     // Initialize arrays
@@ -264,12 +287,17 @@ benchmark_size(size_t n, int csv_mode, simd_level_t lvl)
 
     // Run multiple trials
     double times_ms[num_trials];
+    perf_sample_t counts = { 0 };
     for (int trial = 0; trial < num_trials; trial++) {
+        if (use_perf)
+            perf_counters_start(&perf);
         double t0 = now_sec();
         for (int i = 0; i < iters; i++) {
             vector_mul_f32(a, b, out, n);
         }
         double t1 = now_sec();
+        if (use_perf)
+            perf_counters_stop(&perf, &counts);
         
         double elapsed = t1 - t0;
         double elapsed_ms = elapsed * 1000.0;
@@ -277,19 +305,25 @@ benchmark_size(size_t n, int csv_mode, simd_level_t lvl)
     }
 
     // Calculate statistics
-    double median_ms = calculate_median(times_ms, num_trials);
-    double mean_ms = calculate_mean(times_ms, num_trials);
-    double stddev_ms = calculate_stddev(times_ms, num_trials, mean_ms);
-    double min_ms = find_min(times_ms, num_trials);
-    double max_ms = find_max(times_ms, num_trials);
-    double p99_ms = calculate_percentile(times_ms, num_trials, 0.99);
+    st->n = n;
+    st->iters = iters;
+    st->num_trials = num_trials;
+    st->median_ms = calculate_median(times_ms, num_trials);
+    st->mean_ms = calculate_mean(times_ms, num_trials);
+    st->stddev_ms = calculate_stddev(times_ms, num_trials, st->mean_ms);
+    st->min_ms = find_min(times_ms, num_trials);
+    st->max_ms = find_max(times_ms, num_trials);
+    st->p99_ms = calculate_percentile(times_ms, num_trials, 0.99);
+    st->counts = counts;
     
-    // Calculate GFLOP/s using median (more robust)
-    double ops = (double)iters * (double)n;
-    double gflops = ops / (median_ms / 1000.0) / 1e9;
+    // Calculate GFLOP/s using median (more robust); times are per call
+    double ops = (double)n;
+    st->gflops = ops / (st->median_ms / 1000.0) / 1e9;
+    // Effective bandwidth: two inputs read and one output written per call
+    st->gbps = 3.0 * (double)bytes / (st->median_ms / 1000.0) / 1e9;
 
-    // Correctness check (only for non-CSV mode)
-    if (!csv_mode) {
+    // Correctness check (only for human-readable output)
+    if (check) {
         int bad = 0;
         for (size_t i = 0; i < 16 && i < n; i++) {
             float expect = a[i] * b[i];
@@ -302,22 +336,202 @@ benchmark_size(size_t n, int csv_mode, simd_level_t lvl)
             printf("  correctness: OK\n");
     }
 
-    // Output results
+    free(a);
+    free(b);
+    free(out);
+    return 0;
+}
+
+static void
+print_stats(const bench_stats_t *st, int csv_mode, simd_level_t lvl)
+{
+    const perf_sample_t *counts = &st->counts;
+
     if (csv_mode) {
-        // CSV format: array_size,median_ms,mean_ms,stddev_ms,min_ms,max_ms,p99_ms,gflops,simd_level
-        printf("%zu,%.6f,%.6f,%.6f,%.6f,%.6f,%.6f,%.4f,%s\n", 
-               n, median_ms, mean_ms, stddev_ms, min_ms, max_ms, p99_ms, gflops, simd_level_name(lvl));
+        // CSV format: array_size,median_ms,mean_ms,stddev_ms,min_ms,max_ms,p99_ms,gflops,gbps,simd_level
+        // followed by the counters per call with --perf
+        printf("%zu,%.6f,%.6f,%.6f,%.6f,%.6f,%.6f,%.4f,%.4f,%s", 
+               st->n, st->median_ms, st->mean_ms, st->stddev_ms, st->min_ms, st->max_ms, st->p99_ms,
+               st->gflops, st->gbps, simd_level_name(lvl));
+        if (use_perf)
+            perf_print_csv(stdout, counts, (double)st->num_trials * st->iters);
+        printf("\n");
     } else {
-        printf("  n = %zu, iters = %d, trials = %d\n", n, iters, num_trials);
-        printf("  median = %.6f ms, mean = %.6f ms\n", median_ms, mean_ms);
-        printf("  stddev = %.6f ms, min = %.6f ms, max = %.6f ms\n", stddev_ms, min_ms, max_ms);
-        printf("  p99 = %.6f ms\n", p99_ms);
-        printf("  GFLOP/s = %.4f (based on median)\n", gflops);
+        printf("  n = %zu, iters = %d, trials = %d\n", st->n, st->iters, st->num_trials);
+        printf("  median = %.6f ms, mean = %.6f ms\n", st->median_ms, st->mean_ms);
+        printf("  stddev = %.6f ms, min = %.6f ms, max = %.6f ms\n", st->stddev_ms, st->min_ms, st->max_ms);
+        printf("  p99 = %.6f ms\n", st->p99_ms);
+        printf("  GFLOP/s = %.4f, GB/s = %.4f (based on median)\n", st->gflops, st->gbps);
+        if (use_perf) {
+            double calls = (double)st->num_trials * st->iters;
+            const char *sep = " ";
+            printf("  per call:");
+            if (counts->valid[PERF_CYCLES])
+                printf("%scycles = %.0f", sep, counts->count[PERF_CYCLES] / calls), sep = ", ";
+            if (counts->valid[PERF_INSTRUCTIONS])
+                printf("%sinstructions = %.0f", sep, counts->count[PERF_INSTRUCTIONS] / calls), sep = ", ";
+            if (counts->valid[PERF_L1D_MISSES])
+                printf("%sL1D misses = %.1f", sep, counts->count[PERF_L1D_MISSES] / calls), sep = ", ";
+            if (counts->valid[PERF_LLC_MISSES])
+                printf("%sLLC misses = %.1f", sep, counts->count[PERF_LLC_MISSES] / calls), sep = ", ";
+            if (counts->valid[PERF_DTLB_MISSES])
+                printf("%sDTLB misses = %.1f", sep, counts->count[PERF_DTLB_MISSES] / calls), sep = ", ";
+            if (perf_ghz(counts) > 0)
+                printf("%s%.3f GHz", sep, perf_ghz(counts)), sep = ", ";
+            if (sep[0] == ' ')
+                printf(" no hardware counters");
+            printf("\n");
+        }
     }
+}
 
-    free(a);
-    free(b);
-    free(out);
+/* ---------- comparison against a stored baseline ---------- */
+#define MAX_BASELINE_POINTS 256
+
+typedef struct {
+    size_t n;
+    double median_ms;
+    double stddev_ms;
+    double p99_ms;
+} baseline_point_t;
+
+/*
+ * Read the array_size, median_ms, stddev_ms and p99_ms columns of a CSV
+ * written by --csv or --auto-detect; the columns are found by name, so
+ * files from before gbps was added load too. Copies the simd_level of the
+ * first row into level. Returns the number of points, or -1 on error.
+ */
+static int
+load_baseline(const char *path, baseline_point_t *points, int max_points, char *level, size_t level_size)
+{
+    FILE *fp = fopen(path, "r");
+    if (!fp) {
+        fprintf(stderr, "Error: Could not open baseline '%s'\n", path);
+        return -1;
+    }
+
+    enum { COL_SIZE, COL_MEDIAN, COL_STDDEV, COL_P99, COL_LEVEL, NUM_COLS };
+    static const char *const names[NUM_COLS] = { "array_size", "median_ms", "stddev_ms", "p99_ms", "simd_level" };
+    int col[NUM_COLS] = { -1, -1, -1, -1, -1 };
+    char line[1024];
+
+    if (fgets(line, sizeof(line), fp)) {
+        int c = 0;
+        for (char *save, *tok = strtok_r(line, ",\r\n", &save); tok; tok = strtok_r(NULL, ",\r\n", &save), c++) {
+            for (int k = 0; k < NUM_COLS; k++) {
+                if (strcmp(tok, names[k]) == 0)
+                    col[k] = c;
+            }
+        }
+    }
+    for (int k = 0; k < COL_LEVEL; k++) {
+        if (col[k] < 0) {
+            fprintf(stderr, "Error: Baseline '%s' has no %s column\n", path, names[k]);
+            fclose(fp);
+            return -1;
+        }
+    }
+
+    int count = 0;
+    level[0] = '\0';
+    while (count < max_points && fgets(line, sizeof(line), fp)) {
+        baseline_point_t p = { 0 };
+        int seen = 0, c = 0;
+        for (char *save, *tok = strtok_r(line, ",\r\n", &save); tok; tok = strtok_r(NULL, ",\r\n", &save), c++) {
+            if (c == col[COL_SIZE]) {
+                p.n = strtoull(tok, NULL, 10);
+                seen++;
+            } else if (c == col[COL_MEDIAN]) {
+                p.median_ms = strtod(tok, NULL);
+                seen++;
+            } else if (c == col[COL_STDDEV]) {
+                p.stddev_ms = strtod(tok, NULL);
+                seen++;
+            } else if (c == col[COL_P99]) {
+                p.p99_ms = strtod(tok, NULL);
+                seen++;
+            } else if (c == col[COL_LEVEL] && count == 0) {
+                snprintf(level, level_size, "%s", tok);
+            }
+        }
+        if (seen != COL_LEVEL || p.n == 0 || !(p.median_ms > 0.0))
+            continue;   // blank or malformed line
+        points[count++] = p;
+    }
+
+    fclose(fp);
+    if (count == 0)
+        fprintf(stderr, "Error: Baseline '%s' has no results\n", path);
+    return count ? count : -1;
+}
+
+/*
+ * A point regresses when its median is slower than the baseline median by
+ * more than threshold_pct percent, by more than twice the combined standard
+ * deviation of both runs, and lies above the baseline p99: the typical run
+ * is then slower than nearly every baseline trial, not just noisier. This
+ * is the rule of scripts/compare_benchmark.py plus the p99 check.
+ */
+static int
+is_regression(const baseline_point_t *base, const bench_stats_t *st, double threshold_pct)
+{
+    double noise = 2.0 * hypot(base->stddev_ms, st->stddev_ms);
+    return st->median_ms > base->median_ms * (1.0 + threshold_pct / 100.0) &&
+           st->median_ms - base->median_ms > noise && st->median_ms > base->p99_ms;
+}
+
+/*
+ * Re-run every size point of the baseline and report the change of the
+ * median. A point that regresses is measured once more and only counts
+ * when it regresses again, so a single disturbed run does not fail a gate.
+ * Returns the number of regressions, or -1 when the baseline is unusable.
+ */
+static int
+compare_baseline(const char *path, double threshold_pct, simd_level_t lvl)
+{
+    static baseline_point_t points[MAX_BASELINE_POINTS];
+    char base_level[32];
+    int num_points = load_baseline(path, points, MAX_BASELINE_POINTS, base_level, sizeof(base_level));
+    if (num_points < 0)
+        return -1;
+
+    printf("Baseline: %s (%d points, %s)\n", path, num_points, base_level[0] ? base_level : "unknown level");
+    printf("Detected SIMD level: %s\n", simd_level_name(lvl));
+    if (base_level[0] && strcmp(base_level, simd_level_name(lvl)) != 0)
+        printf("Warning: the baseline was recorded at %s\n", base_level);
+    printf("\n%10s %12s %12s %12s %8s\n", "size", "base_ms", "new_ms", "base_p99", "change");
+
+    int regressions = 0, improvements = 0;
+    for (int i = 0; i < num_points; i++) {
+        const baseline_point_t *base = &points[i];
+        bench_stats_t st;
+        if (benchmark_size(base->n, 0, &st) != 0)
+            return -1;
+        if (is_regression(base, &st, threshold_pct)) {
+            bench_stats_t retry;
+            if (benchmark_size(base->n, 0, &retry) != 0)
+                return -1;
+            if (retry.median_ms < st.median_ms)
+                st = retry;
+        }
+
+        const char *status = "";
+        if (is_regression(base, &st, threshold_pct)) {
+            status = "REGRESSION";
+            regressions++;
+        } else if (base->median_ms > st.median_ms * (1.0 + threshold_pct / 100.0) &&
+                   base->median_ms - st.median_ms > 2.0 * hypot(base->stddev_ms, st.stddev_ms)) {
+            status = "improved";
+            improvements++;
+        }
+        printf("%10zu %12.6f %12.6f %12.6f %+7.1f%% %s\n", base->n, base->median_ms, st.median_ms, base->p99_ms,
+               (st.median_ms / base->median_ms - 1.0) * 100.0, status);
+        fflush(stdout);
+    }
+
+    printf("\n%d points compared, %d regressed, %d improved (threshold %g%%)\n", num_points, regressions,
+           improvements, threshold_pct);
+    return regressions;
 }
 
 int
@@ -326,6 +540,9 @@ main(int argc, char **argv)
     // Parse command line arguments
     int csv_mode = 0;
     int auto_detect = 0;
+    int compare = 0;
+    const char *baseline_path = NULL;
+    double threshold_pct = 5.0;
     
     for (int i = 1; i < argc; i++) {
         if (strcmp(argv[i], "--csv") == 0) {
@@ -333,18 +550,40 @@ main(int argc, char **argv)
         } else if (strcmp(argv[i], "--auto-detect") == 0) {
             csv_mode = 1;
             auto_detect = 1;
+        } else if (strcmp(argv[i], "--compare") == 0) {
+            compare = 1;
+            if (i + 1 < argc && argv[i + 1][0] != '-')
+                baseline_path = argv[++i];
+        } else if (strcmp(argv[i], "--threshold") == 0 && i + 1 < argc) {
+            char *end;
+            threshold_pct = strtod(argv[++i], &end);
+            if (*end != '\0' || threshold_pct < 0.0) {
+                fprintf(stderr, "Invalid threshold: %s\n", argv[i]);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--perf") == 0) {
+            use_perf = 1;
         } else if (strcmp(argv[i], "--help") == 0 || strcmp(argv[i], "-h") == 0) {
             printf("Usage: %s [OPTIONS]\n", argv[0]);
             printf("\nOptions:\n");
             printf("  --csv          Output results in CSV format to stdout\n");
-            printf("                 Format: array_size,time_ms,gflops,simd_level\n");
+            printf("                 Format: array_size,median_ms,...,gflops,gbps,simd_level\n");
             printf("  --auto-detect  Auto-detect CPU and SIMD level, write CSV to file\n");
             printf("                 Filename format: results_<cpu_model>_<simd_level>.csv\n");
+            printf("  --compare [FILE]\n");
+            printf("                 Re-run the size points of a baseline CSV and flag regressions;\n");
+            printf("                 exits with status 1 if any point regressed. FILE defaults to\n");
+            printf("                 the --auto-detect filename of this CPU and SIMD level\n");
+            printf("  --threshold PCT\n");
+            printf("                 Minimum slowdown in percent to count as a regression (default: 5)\n");
+            printf("  --perf         Add hardware counters per call (perf_event_open):\n");
+            printf("                 " PERF_CSV_COLUMNS "\n");
             printf("  --help, -h     Show this help message\n");
             printf("\nExamples:\n");
             printf("  %s                    # Human-readable output\n", argv[0]);
             printf("  %s --csv > out.csv    # CSV to stdout\n", argv[0]);
             printf("  %s --auto-detect      # Auto-generate filename\n", argv[0]);
+            printf("  %s --compare          # Check against the stored results of this CPU\n", argv[0]);
             return 0;
         } else {
             fprintf(stderr, "Unknown option: %s\n", argv[i]);
@@ -354,6 +593,25 @@ main(int argc, char **argv)
     }
 
     simd_level_t lvl = detect_simd_level();
+
+    if (use_perf) {
+        perf_counters_open(&perf);
+        fprintf(stderr, "Hardware counters: ");
+        perf_counters_describe(&perf, stderr);
+    }
+
+    // Comparison mode: re-run the baseline's points instead of the size list
+    if (compare) {
+        char auto_filename[512];
+        if (!baseline_path) {
+            generate_auto_filename(auto_filename, sizeof(auto_filename), lvl);
+            baseline_path = auto_filename;
+        }
+        int regressions = compare_baseline(baseline_path, threshold_pct, lvl);
+        if (use_perf)
+            perf_counters_close(&perf);
+        return regressions < 0 ? 2 : regressions > 0;
+    }
     
     // Handle auto-detect mode: redirect stdout to file
     FILE *original_stdout = NULL;
@@ -388,7 +646,8 @@ main(int argc, char **argv)
         printf("\n");
     } else {
         // CSV header
-        printf("array_size,median_ms,mean_ms,stddev_ms,min_ms,max_ms,p99_ms,gflops,simd_level\n");
+        printf("array_size,median_ms,mean_ms,stddev_ms,min_ms,max_ms,p99_ms,gflops,gbps,simd_level%s\n",
+               use_perf ? "," PERF_CSV_COLUMNS : "");
     }
 
     // Array sizes to test: comprehensive range from 512 to 16M elements
@@ -440,7 +699,9 @@ main(int argc, char **argv)
         if (!csv_mode) {
             printf("\n--- Benchmarking size: %zu elements ---\n", sizes[i]);
         }
-        benchmark_size(sizes[i], csv_mode, lvl);
+        bench_stats_t st;
+        if (benchmark_size(sizes[i], !csv_mode, &st) == 0)
+            print_stats(&st, csv_mode, lvl);
     }
 
     if (!csv_mode) {
@@ -458,6 +719,9 @@ main(int argc, char **argv)
         fprintf(stderr, "Benchmark complete! Results saved to: %s\n", auto_filename);
     }
 
+    if (use_perf)
+        perf_counters_close(&perf);
+
     return 0;
 }
 
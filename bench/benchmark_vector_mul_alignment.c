@@ -0,0 +1,216 @@
+#define _POSIX_C_SOURCE 200809L
+#include <immintrin.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <dynemit/core.h>
+#include <dynemit/vector_mul.h>
+
+/*
+ * Sweep over short, odd sizes and misaligned output offsets comparing the
+ * dispatched vector_mul_f32 (alignment peel + masked tail) against the
+ * previous kernel shape at the same SIMD level: unaligned loads/stores with
+ * a scalar remainder loop.
+ */
+
+/* ---------- previous kernel shape, kept here as the baseline ---------- */
+__attribute__((target("default")))
+__attribute__((optimize("no-tree-vectorize")))
+static void
+baseline_mul_scalar(const float *a, const float *b, float *out, size_t n)
+{
+    for (size_t i = 0; i < n; i++)
+        out[i] = a[i] * b[i];
+}
+
+__attribute__((target("sse2")))
+__attribute__((optimize("no-tree-vectorize")))
+static void
+baseline_mul_sse2(const float *a, const float *b, float *out, size_t n)
+{
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+        _mm_storeu_ps(out + i, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+    for (; i < n; i++)
+        out[i] = a[i] * b[i];
+}
+
+__attribute__((target("avx")))
+__attribute__((optimize("no-tree-vectorize")))
+static void
+baseline_mul_avx(const float *a, const float *b, float *out, size_t n)
+{
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8)
+        _mm256_storeu_ps(out + i, _mm256_mul_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i)));
+    for (; i < n; i++)
+        out[i] = a[i] * b[i];
+}
+
+// The scalar remainder loops are kept scalar so the compiler does not
+// vectorize them behind our back and blur the comparison
+__attribute__((target("avx512f")))
+__attribute__((optimize("no-tree-vectorize")))
+static void
+baseline_mul_avx512f(const float *a, const float *b, float *out, size_t n)
+{
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16)
+        _mm512_storeu_ps(out + i, _mm512_mul_ps(_mm512_loadu_ps(a + i), _mm512_loadu_ps(b + i)));
+    for (; i < n; i++)
+        out[i] = a[i] * b[i];
+}
+
+typedef void (*mul_func_t)(const float *, const float *, float *, size_t);
+
+static mul_func_t
+baseline_for_level(simd_level_t level)
+{
+    switch (level) {
+    case SIMD_AVX512F: return baseline_mul_avx512f;
+    case SIMD_AVX2:
+    case SIMD_AVX:     return baseline_mul_avx;
+    case SIMD_SSE4_2:
+    case SIMD_SSE2:    return baseline_mul_sse2;
+    case SIMD_SCALAR:
+    default:           return baseline_mul_scalar;
+    }
+}
+
+/* ---------- timing helper ---------- */
+static double
+now_sec(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static int
+compare_double(const void *a, const void *b)
+{
+    double da = *(const double *)a;
+    double db = *(const double *)b;
+    if (da < db) return -1;
+    if (da > db) return 1;
+    return 0;
+}
+
+/* Median nanoseconds per call over several trials */
+static double
+time_kernel(mul_func_t fn, const float *a, const float *b, float *out, size_t n)
+{
+    enum { num_trials = 9 };
+    // Keep each trial around a millisecond regardless of n
+    const int iters = (int)(200000 / (n + 16)) + 1000;
+    double ns[num_trials];
+
+    for (int w = 0; w < 100; w++)
+        fn(a, b, out, n);
+
+    for (int t = 0; t < num_trials; t++) {
+        double t0 = now_sec();
+        for (int i = 0; i < iters; i++) {
+            fn(a, b, out, n);
+            __asm__ volatile("" : : "r"(out) : "memory");
+        }
+        double t1 = now_sec();
+        ns[t] = (t1 - t0) * 1e9 / (double)iters;
+    }
+
+    qsort(ns, num_trials, sizeof(double), compare_double);
+    return ns[num_trials / 2];
+}
+
+int
+main(int argc, char **argv)
+{
+    int csv_mode = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--csv") == 0) {
+            csv_mode = 1;
+        } else if (strcmp(argv[i], "--help") == 0 || strcmp(argv[i], "-h") == 0) {
+            printf("Usage: %s [OPTIONS]\n", argv[0]);
+            printf("\nOptions:\n");
+            printf("  --csv          Output results in CSV format to stdout\n");
+            printf("                 Format: array_size,offset,baseline_ns,dispatched_ns,speedup,simd_level\n");
+            printf("  --help, -h     Show this help message\n");
+            return 0;
+        } else {
+            fprintf(stderr, "Unknown option: %s\n", argv[i]);
+            fprintf(stderr, "Use --help for usage information\n");
+            return 1;
+        }
+    }
+
+    simd_level_t lvl = detect_simd_level();
+    mul_func_t baseline = baseline_for_level(lvl);
+
+    // Odd sizes around the vector widths, concentrated on the 17-200 range
+    const size_t sizes[] = { 17, 23, 31, 33, 47, 63, 65, 95, 100, 127, 129, 150, 199, 200, 255, 257, 1000, 1023, 4097 };
+    // Output offsets in floats from a 64-byte boundary
+    const size_t offsets[] = { 0, 1, 3, 4, 7, 8, 13, 15 };
+    const int num_sizes = sizeof(sizes) / sizeof(sizes[0]);
+    const int num_offsets = sizeof(offsets) / sizeof(offsets[0]);
+
+    const size_t max_n = 4097 + 16;
+    float *a   = aligned_alloc(64, max_n * sizeof(float) + 64);
+    float *b   = aligned_alloc(64, max_n * sizeof(float) + 64);
+    float *out = aligned_alloc(64, max_n * sizeof(float) + 64);
+    if (!a || !b || !out) {
+        fprintf(stderr, "alloc failed\n");
+        return 1;
+    }
+    for (size_t i = 0; i < max_n; i++) {
+        a[i] = (float)i * 0.5f;
+        b[i] = (float)i * 0.25f + 1.0f;
+    }
+
+    if (csv_mode) {
+        printf("array_size,offset,baseline_ns,dispatched_ns,speedup,simd_level\n");
+    } else {
+        printf("===========================================\n");
+        printf("Vector Multiply Alignment/Tail Sweep\n");
+        printf("===========================================\n");
+        printf("Detected SIMD level: %s\n", simd_level_name(lvl));
+        printf("baseline   = unaligned loads/stores + scalar remainder loop\n");
+        printf("dispatched = vector_mul_f32 (alignment peel + masked tail)\n\n");
+        printf("%8s %7s %12s %14s %9s\n", "n", "offset", "baseline ns", "dispatched ns", "speedup");
+    }
+
+    double total_base = 0.0, total_disp = 0.0;
+    for (int s = 0; s < num_sizes; s++) {
+        for (int o = 0; o < num_offsets; o++) {
+            size_t n = sizes[s];
+            size_t off = offsets[o];
+            // Misalign all three streams by the same amount, as a sliced
+            // or offset view into a larger array would be
+            const float *pa = a + off, *pb = b + off;
+            float *po = out + off;
+
+            double base_ns = time_kernel(baseline, pa, pb, po, n);
+            double disp_ns = time_kernel(vector_mul_f32, pa, pb, po, n);
+            total_base += base_ns;
+            total_disp += disp_ns;
+
+            if (csv_mode) {
+                printf("%zu,%zu,%.3f,%.3f,%.4f,%s\n", n, off, base_ns, disp_ns,
+                       base_ns / disp_ns, simd_level_name(lvl));
+            } else {
+                printf("%8zu %7zu %12.2f %14.2f %8.2fx\n", n, off, base_ns, disp_ns, base_ns / disp_ns);
+            }
+        }
+    }
+
+    if (!csv_mode) {
+        printf("\nTotal over sweep: baseline %.1f ns, dispatched %.1f ns (%.2fx)\n",
+               total_base, total_disp, total_base / total_disp);
+    }
+
+    free(a);
+    free(b);
+    free(out);
+    return 0;
+}
@@ -5,186 +5,15 @@
 #include <stdint.h>
 #include <time.h>
 #include <string.h>
-#include <strings.h>
-#include <ctype.h>
 #include <math.h>
-#include <immintrin.h>
 #include <dynemit/core.h>
+#include <dynemit/vector_mul.h>
 
-/* ---------- SIMD Implementation Functions ---------- */
-
-// Scalar version - disable auto-vectorization to get true scalar code
-__attribute__((target("default")))
-__attribute__((optimize("no-tree-vectorize")))
-static void
-vector_mul_f32_scalar(const float *a, const float *b, float *out, size_t n)
-{
-    for (size_t i = 0; i < n; i++)
-        out[i] = a[i] * b[i];
-}
-
-__attribute__((target("sse2")))
-static void
-vector_mul_f32_sse2(const float *a, const float *b, float *out, size_t n)
-{
-    size_t i = 0;
-    const size_t step = 4;
-    for (; i + step <= n; i += step) {
-        __m128 va = _mm_loadu_ps(a + i);
-        __m128 vb = _mm_loadu_ps(b + i);
-        __m128 vc = _mm_mul_ps(va, vb);
-        _mm_storeu_ps(out + i, vc);
-    }
-    for (; i < n; i++)
-        out[i] = a[i] * b[i];
-}
-
-__attribute__((target("sse4.2")))
-static void
-vector_mul_f32_sse42(const float *a, const float *b, float *out, size_t n)
-{
-    size_t i = 0;
-    const size_t step = 4;
-    for (; i + step <= n; i += step) {
-        __m128 va = _mm_loadu_ps(a + i);
-        __m128 vb = _mm_loadu_ps(b + i);
-        __m128 vc = _mm_mul_ps(va, vb);
-        _mm_storeu_ps(out + i, vc);
-    }
-    for (; i < n; i++)
-        out[i] = a[i] * b[i];
-}
-
-__attribute__((target("avx")))
-static void
-vector_mul_f32_avx(const float *a, const float *b, float *out, size_t n)
-{
-    size_t i = 0;
-    const size_t step = 8;
-    for (; i + step <= n; i += step) {
-        __m256 va = _mm256_loadu_ps(a + i);
-        __m256 vb = _mm256_loadu_ps(b + i);
-        __m256 vc = _mm256_mul_ps(va, vb);
-        _mm256_storeu_ps(out + i, vc);
-    }
-    for (; i < n; i++)
-        out[i] = a[i] * b[i];
-}
-
-__attribute__((target("avx2")))
-static void
-vector_mul_f32_avx2(const float *a, const float *b, float *out, size_t n)
-{
-    size_t i = 0;
-    const size_t step = 8;
-    for (; i + step <= n; i += step) {
-        __m256 va = _mm256_loadu_ps(a + i);
-        __m256 vb = _mm256_loadu_ps(b + i);
-        __m256 vc = _mm256_mul_ps(va, vb);
-        _mm256_storeu_ps(out + i, vc);
-    }
-    for (; i < n; i++)
-        out[i] = a[i] * b[i];
-}
-
-__attribute__((target("avx512f")))
-static void
-vector_mul_f32_avx512f(const float *a, const float *b, float *out, size_t n)
-{
-    size_t i = 0;
-    const size_t step = 16;
-    for (; i + step <= n; i += step) {
-        __m512 va = _mm512_loadu_ps(a + i);
-        __m512 vb = _mm512_loadu_ps(b + i);
-        __m512 vc = _mm512_mul_ps(va, vb);
-        _mm512_storeu_ps(out + i, vc);
-    }
-    for (; i < n; i++)
-        out[i] = a[i] * b[i];
-}
-
-/* ---------- CPU model detection ---------- */
-static void
-get_cpu_model_name(char *buffer, size_t bufsize)
-{
-    FILE *fp = fopen("/proc/cpuinfo", "r");
-    if (!fp) {
-        snprintf(buffer, bufsize, "unknown_cpu");
-        return;
-    }
-
-    char line[256];
-    int found = 0;
-    
-    while (fgets(line, sizeof(line), fp)) {
-        if (strncmp(line, "model name", 10) == 0) {
-            // Found "model name : ..."
-            char *colon = strchr(line, ':');
-            if (colon) {
-                colon++; // skip the colon
-                while (*colon == ' ' || *colon == '\t') colon++; // skip whitespace
-                
-                // Copy the CPU model name
-                size_t len = strlen(colon);
-                if (len > 0 && colon[len-1] == '\n') {
-                    colon[len-1] = '\0'; // remove newline
-                }
-                
-                // Remove core count information (e.g., "16-Core", "14-Core Processor")
-                // Common patterns: "N-Core", "N Core", "Processor"
-                char temp[256];
-                strncpy(temp, colon, sizeof(temp) - 1);
-                temp[sizeof(temp) - 1] = '\0';
-                
-                // Find and remove patterns like "16-Core", "14 Core", "Processor"
-                char *patterns[] = {"-core", " core", "processor", NULL};
-                for (int p = 0; patterns[p]; p++) {
-                    char *pos = strcasestr(temp, patterns[p]);
-                    if (pos) {
-                        // Look backwards for the number
-                        char *num_start = pos;
-                        while (num_start > temp && (isdigit(*(num_start-1)) || *(num_start-1) == ' ' || *(num_start-1) == '-')) {
-                            num_start--;
-                        }
-                        // Remove from num_start to after the pattern
-                        char *pattern_end = pos + strlen(patterns[p]);
-                        // Skip any trailing spaces
-                        while (*pattern_end == ' ') pattern_end++;
-                        
-                        // Shift the rest of the string
-                        memmove(num_start, pattern_end, strlen(pattern_end) + 1);
-                    }
-                }
-                
-                // Sanitize: convert to lowercase and replace spaces/special chars with underscores
-                size_t j = 0;
-                for (size_t i = 0; temp[i] && j < bufsize - 1; i++) {
-                    char c = temp[i];
-                    if (isalnum(c)) {
-                        buffer[j++] = tolower(c);
-                    } else if (c == ' ' || c == '-' || c == '(' || c == ')' || c == '@') {
-                        if (j > 0 && buffer[j-1] != '_') {
-                            buffer[j++] = '_';
-                        }
-                    }
-                }
-                // Remove trailing underscore
-                while (j > 0 && buffer[j-1] == '_') {
-                    j--;
-                }
-                buffer[j] = '\0';
-                found = 1;
-                break;
-            }
-        }
-    }
-    
-    fclose(fp);
-    
-    if (!found) {
-        snprintf(buffer, bufsize, "unknown_cpu");
-    }
-}
+/*
+ * Every SIMD level's vector_mul_f32 kernel, fetched from the library with
+ * dynemit_get_kernel(), so the levels measured here are exactly the code
+ * the dispatcher would run.
+ */
 
 /* ---------- timing helper ---------- */
 static double
@@ -284,23 +113,9 @@ find_max(double *values, int n)
     return max;
 }
 
-/* ---------- Function pointer type and selector ---------- */
+/* ---------- Function pointer type ---------- */
 typedef void (*vector_mul_func_t)(const float *, const float *, float *, size_t);
 
-static vector_mul_func_t
-get_function_for_level(simd_level_t level)
-{
-    switch (level) {
-    case SIMD_AVX512F: return vector_mul_f32_avx512f;
-    case SIMD_AVX2:    return vector_mul_f32_avx2;
-    case SIMD_AVX:     return vector_mul_f32_avx;
-    case SIMD_SSE4_2:  return vector_mul_f32_sse42;
-    case SIMD_SSE2:    return vector_mul_f32_sse2;
-    case SIMD_SCALAR:
-    default:           return vector_mul_f32_scalar;
-    }
-}
-
 /* ---------- benchmark a single array size ---------- */
 static void
 benchmark_size(size_t n, int csv_mode, simd_level_t lvl, vector_mul_func_t func)
@@ -365,13 +180,15 @@ benchmark_size(size_t n, int csv_mode, simd_level_t lvl, vector_mul_func_t func)
     double ops = (double)iters * (double)n;
     double gflops = ops / (median_ms / 1000.0) / 1e9;
 
-    // Correctness check (only for non-CSV mode)
+    // Correctness check against the dispatched function (only for non-CSV mode)
     if (!csv_mode) {
+        float expect[16];
+        size_t m = n < 16 ? n : 16;
+        vector_mul_f32(a, b, expect, m);
         int bad = 0;
-        for (size_t i = 0; i < 16 && i < n; i++) {
-            float expect = a[i] * b[i];
-            if (out[i] != expect) {
-                printf("mismatch at %zu: got %f, expect %f\n", i, out[i], expect);
+        for (size_t i = 0; i < m; i++) {
+            if (out[i] != expect[i]) {
+                printf("mismatch at %zu: got %f, expect %f\n", i, out[i], expect[i]);
                 bad = 1;
             }
         }
@@ -402,34 +219,23 @@ main(int argc, char **argv)
 {
     // Parse command line arguments
     int csv_mode = 0;
+    int all_levels = 0;
     simd_level_t forced_level = SIMD_SCALAR;
     int use_forced_level = 0;
     
     for (int i = 1; i < argc; i++) {
         if (strcmp(argv[i], "--csv") == 0) {
             csv_mode = 1;
+        } else if (strcmp(argv[i], "--all-levels") == 0) {
+            all_levels = 1;
         } else if (strcmp(argv[i], "--force-level") == 0) {
             if (i + 1 >= argc) {
                 fprintf(stderr, "Error: --force-level requires an argument\n");
                 return 1;
             }
             i++;
-            const char *level_str = argv[i];
-            
-            if (strcmp(level_str, "scalar") == 0) {
-                forced_level = SIMD_SCALAR;
-            } else if (strcmp(level_str, "sse2") == 0) {
-                forced_level = SIMD_SSE2;
-            } else if (strcmp(level_str, "sse4.2") == 0) {
-                forced_level = SIMD_SSE4_2;
-            } else if (strcmp(level_str, "avx") == 0) {
-                forced_level = SIMD_AVX;
-            } else if (strcmp(level_str, "avx2") == 0) {
-                forced_level = SIMD_AVX2;
-            } else if (strcmp(level_str, "avx512f") == 0) {
-                forced_level = SIMD_AVX512F;
-            } else {
-                fprintf(stderr, "Error: Unknown SIMD level '%s'\n", level_str);
+            if (simd_level_from_name(argv[i], &forced_level) != 0) {
+                fprintf(stderr, "Error: Unknown SIMD level '%s'\n", argv[i]);
                 fprintf(stderr, "Valid levels: scalar, sse2, sse4.2, avx, avx2, avx512f\n");
                 return 1;
             }
@@ -441,11 +247,13 @@ main(int argc, char **argv)
             printf("                     Format: array_size,median_ms,mean_ms,stddev_ms,min_ms,max_ms,p99_ms,gflops,simd_level\n");
             printf("  --force-level LVL  Force specific SIMD level instead of auto-detection\n");
             printf("                     Valid levels: scalar, sse2, sse4.2, avx, avx2, avx512f\n");
+            printf("  --all-levels       Benchmark every level the CPU supports, in one run\n");
             printf("  --help, -h         Show this help message\n");
+            printf("\nThe default level honours DYNEMIT_MAX_LEVEL.\n");
             printf("\nExamples:\n");
             printf("  %s                              # Human-readable output with auto-detect\n", argv[0]);
             printf("  %s --csv --force-level avx2     # CSV output using AVX2\n", argv[0]);
-            printf("  %s --force-level scalar         # Test scalar implementation\n", argv[0]);
+            printf("  %s --csv --all-levels           # Scalar through the best level\n", argv[0]);
             return 0;
         } else {
             fprintf(stderr, "Unknown option: %s\n", argv[i]);
@@ -454,20 +262,26 @@ main(int argc, char **argv)
         }
     }
 
-    simd_level_t lvl;
-    if (use_forced_level) {
-        lvl = forced_level;
-    } else {
-        lvl = detect_simd_level();
+    simd_level_t lvl = use_forced_level ? forced_level : detect_simd_level();
+    simd_level_t first = all_levels ? SIMD_SCALAR : lvl;
+    simd_level_t last = lvl;
+    if (all_levels) {
+        // Highest level with a kernel, ignoring DYNEMIT_MAX_LEVEL
+        last = SIMD_AVX512F;
+        while (last > SIMD_SCALAR && !dynemit_get_kernel("vector_mul_f32", last))
+            last--;
+    } else if (!dynemit_get_kernel("vector_mul_f32", lvl)) {
+        fprintf(stderr, "Error: SIMD level %s is not supported by this CPU\n", simd_level_name(lvl));
+        return 1;
     }
     
-    vector_mul_func_t func = get_function_for_level(lvl);
-    
     if (!csv_mode) {
         printf("===========================================\n");
         printf("Vector Multiply Benchmark (Feature Compare)\n");
         printf("===========================================\n");
-        if (use_forced_level) {
+        if (all_levels) {
+            printf("SIMD levels: %s to %s\n", simd_level_name(first), simd_level_name(last));
+        } else if (use_forced_level) {
             printf("Forced SIMD level: %s\n", simd_level_name(lvl));
         } else {
             printf("Detected SIMD level: %s\n", simd_level_name(lvl));
@@ -522,12 +336,18 @@ main(int argc, char **argv)
     };
     const int num_sizes = sizeof(sizes) / sizeof(sizes[0]);
 
-    // Benchmark each size
-    for (int i = 0; i < num_sizes; i++) {
-        if (!csv_mode) {
-            printf("\n--- Benchmarking size: %zu elements ---\n", sizes[i]);
+    // Benchmark each level and size
+    for (int l = first; l <= (int)last; l++) {
+        vector_mul_func_t func = (vector_mul_func_t)dynemit_get_kernel("vector_mul_f32", (simd_level_t)l);
+        if (!csv_mode && all_levels) {
+            printf("\n=== SIMD level: %s ===\n", simd_level_name((simd_level_t)l));
+        }
+        for (int i = 0; i < num_sizes; i++) {
+            if (!csv_mode) {
+                printf("\n--- Benchmarking size: %zu elements ---\n", sizes[i]);
+            }
+            benchmark_size(sizes[i], csv_mode, (simd_level_t)l, func);
         }
-        benchmark_size(sizes[i], csv_mode, lvl, func);
     }
 
     if (!csv_mode) {
@@ -0,0 +1,151 @@
+#define _GNU_SOURCE
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include "perf_counters.h"
+
+#define CACHE_READ_MISS(cache)                                                  \
+    ((cache) | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16))
+
+static const struct {
+    uint32_t    type;
+    uint64_t    config;
+    const char *json;
+} events[PERF_NUM_EVENTS] = {
+    [PERF_CYCLES]       = { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES, "cycles" },
+    [PERF_INSTRUCTIONS] = { PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS, "instructions" },
+    [PERF_L1D_MISSES]   = { PERF_TYPE_HW_CACHE, CACHE_READ_MISS(PERF_COUNT_HW_CACHE_L1D), "l1d_misses" },
+    [PERF_LLC_MISSES]   = { PERF_TYPE_HW_CACHE, CACHE_READ_MISS(PERF_COUNT_HW_CACHE_LL), "llc_misses" },
+    [PERF_DTLB_MISSES]  = { PERF_TYPE_HW_CACHE, CACHE_READ_MISS(PERF_COUNT_HW_CACHE_DTLB), "dtlb_misses" },
+    [PERF_TASK_CLOCK]   = { PERF_TYPE_SOFTWARE, PERF_COUNT_SW_TASK_CLOCK, "task_clock" },
+};
+
+int
+perf_counters_open(perf_counters_t *pc)
+{
+    int opened = 0;
+
+    // Separate events rather than one group: a group that does not fit the
+    // PMU never runs at all; the kernel multiplexes lone events and the
+    // running time lets us scale them
+    for (int e = 0; e < PERF_NUM_EVENTS; e++) {
+        struct perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = events[e].type;
+        attr.config = events[e].config;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+        pc->fd[e] = (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+        if (pc->fd[e] >= 0)
+            opened++;
+    }
+    return opened;
+}
+
+void
+perf_counters_close(perf_counters_t *pc)
+{
+    for (int e = 0; e < PERF_NUM_EVENTS; e++) {
+        if (pc->fd[e] >= 0)
+            close(pc->fd[e]);
+        pc->fd[e] = -1;
+    }
+}
+
+void
+perf_counters_describe(const perf_counters_t *pc, FILE *out)
+{
+    int any = 0;
+    for (int e = 0; e < PERF_NUM_EVENTS; e++) {
+        if (pc->fd[e] >= 0) {
+            fprintf(out, "%s%s", any ? " " : "", events[e].json);
+            any = 1;
+        }
+    }
+    fprintf(out, "%s\n", any ? "" : "none");
+}
+
+void
+perf_counters_start(perf_counters_t *pc)
+{
+    for (int e = 0; e < PERF_NUM_EVENTS; e++) {
+        if (pc->fd[e] >= 0) {
+            ioctl(pc->fd[e], PERF_EVENT_IOC_RESET, 0);
+            ioctl(pc->fd[e], PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+}
+
+void
+perf_counters_stop(perf_counters_t *pc, perf_sample_t *sample)
+{
+    for (int e = 0; e < PERF_NUM_EVENTS; e++) {
+        if (pc->fd[e] >= 0)
+            ioctl(pc->fd[e], PERF_EVENT_IOC_DISABLE, 0);
+    }
+    for (int e = 0; e < PERF_NUM_EVENTS; e++) {
+        uint64_t v[3];  // value, time enabled, time running
+        if (pc->fd[e] < 0 || read(pc->fd[e], v, sizeof(v)) != sizeof(v) || !v[2])
+            continue;
+        sample->count[e] += (double)v[0] * ((double)v[1] / (double)v[2]);
+        sample->valid[e] = 1;
+    }
+}
+
+void
+perf_sample_add(perf_sample_t *sum, const perf_sample_t *sample)
+{
+    for (int e = 0; e < PERF_NUM_EVENTS; e++) {
+        if (sample->valid[e]) {
+            sum->count[e] += sample->count[e];
+            sum->valid[e] = 1;
+        }
+    }
+}
+
+double
+perf_ghz(const perf_sample_t *sample)
+{
+    if (!sample->valid[PERF_CYCLES] || !sample->valid[PERF_TASK_CLOCK] || !sample->count[PERF_TASK_CLOCK])
+        return 0.0;
+    return sample->count[PERF_CYCLES] / sample->count[PERF_TASK_CLOCK];
+}
+
+void
+perf_print_csv(FILE *out, const perf_sample_t *sample, double calls)
+{
+    for (int e = 0; e < PERF_TASK_CLOCK; e++) {
+        if (sample->valid[e])
+            fprintf(out, ",%.1f", sample->count[e] / calls);
+        else
+            fputc(',', out);
+    }
+    double ghz = perf_ghz(sample);
+    if (ghz > 0)
+        fprintf(out, ",%.3f", ghz);
+    else
+        fputc(',', out);
+}
+
+void
+perf_print_json(FILE *out, const perf_sample_t *sample, double calls)
+{
+    for (int e = 0; e < PERF_TASK_CLOCK; e++) {
+        if (sample->valid[e])
+            fprintf(out, ", \"%s\": %.1f", events[e].json, sample->count[e] / calls);
+        else
+            fprintf(out, ", \"%s\": null", events[e].json);
+    }
+    double ghz = perf_ghz(sample);
+    if (ghz > 0)
+        fprintf(out, ", \"ghz\": %.3f", ghz);
+    else
+        fprintf(out, ", \"ghz\": null");
+}
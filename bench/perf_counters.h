@@ -0,0 +1,67 @@
+#ifndef DYNEMIT_BENCH_PERF_COUNTERS_H
+#define DYNEMIT_BENCH_PERF_COUNTERS_H
+
+#include <stdio.h>
+
+/*
+ * Hardware performance counters for the benchmarks, via perf_event_open().
+ *
+ * Counters are per thread and count user space only, so they work with the
+ * default perf_event_paranoid setting of 2. Events the CPU, hypervisor or
+ * kernel do not provide are left out and reported as unavailable; on a VM
+ * without a virtual PMU only the task clock opens and the frequency column
+ * stays empty.
+ */
+
+typedef enum {
+    PERF_CYCLES,
+    PERF_INSTRUCTIONS,
+    PERF_L1D_MISSES,    // L1D read misses
+    PERF_LLC_MISSES,    // last-level cache read misses
+    PERF_DTLB_MISSES,   // DTLB read misses
+    PERF_TASK_CLOCK,    // ns on CPU, for the frequency
+    PERF_NUM_EVENTS
+} perf_event_id_t;
+
+typedef struct {
+    int fd[PERF_NUM_EVENTS];
+} perf_counters_t;
+
+// Counts accumulated over several start/stop intervals
+typedef struct {
+    double count[PERF_NUM_EVENTS];
+    int    valid[PERF_NUM_EVENTS];
+} perf_sample_t;
+
+/** Open the counters for the calling thread. Returns how many opened. */
+int perf_counters_open(perf_counters_t *pc);
+
+void perf_counters_close(perf_counters_t *pc);
+
+/** Print the names of the opened counters, or "none", to out. */
+void perf_counters_describe(const perf_counters_t *pc, FILE *out);
+
+/** Reset and enable. */
+void perf_counters_start(perf_counters_t *pc);
+
+/** Disable and add the counts since perf_counters_start() to sample. */
+void perf_counters_stop(perf_counters_t *pc, perf_sample_t *sample);
+
+/** Add the counts of another thread's sample. */
+void perf_sample_add(perf_sample_t *sum, const perf_sample_t *sample);
+
+/** Column names, comma-separated, for a CSV header. */
+#define PERF_CSV_COLUMNS "cycles,instructions,l1d_misses,llc_misses,dtlb_misses,ghz"
+
+/**
+ * Print the counts per call (calls = calls counted across all threads) as
+ * CSV fields, each preceded by a comma, or as JSON members, each preceded by
+ * ", ". Unavailable counters are empty fields or null.
+ */
+void perf_print_csv(FILE *out, const perf_sample_t *sample, double calls);
+void perf_print_json(FILE *out, const perf_sample_t *sample, double calls);
+
+/** Effective core frequency in GHz (cycles over task clock), or 0. */
+double perf_ghz(const perf_sample_t *sample);
+
+#endif
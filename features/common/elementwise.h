@@ -0,0 +1,670 @@
+/* SPDX-License-Identifier: BSL-1.0 */
+#ifndef DYNEMIT_FEATURES_ELEMENTWISE_H
+#define DYNEMIT_FEATURES_ELEMENTWISE_H
+
+// Internal macros generating element-wise binary kernels
+// (out[i] = op(a[i], b[i])) for one element type: one static function per
+// SIMD level, the ifunc resolver and the public symbol. Not part of the
+// installed API.
+//
+// The per-type ladders below make a new operation one line per type
+// in the feature's .c file:
+//
+//   DYNEMIT_BINARY_I32(vector_add_i32, dynemit_add_i32,
+//                      _mm_add_epi32, _mm_add_epi32, _mm256_add_epi32,
+//                      _mm512_add_epi32)
+//
+// and the building blocks (scalar kernel, SIMD kernel with scalar or masked
+// tail, resolver + ifunc symbol) can be combined directly for other shapes.
+// Operations that are a plain lane-wise expression, like the float and
+// double add/sub/mul, are generated by <dynemit/kernel.h> instead, which
+// also holds the size dispatch shared with the broadcast kernels here.
+//
+// LOAD/STORE/OP may be intrinsics or function-like macros; SCALAR_OP is a
+// function-like macro or inline function used for the scalar kernel and
+// scalar tails.
+//
+// Everything between here and the shared scalar operations is the x86
+// ladder. Other architectures get the macros of portable.h instead; the
+// scalar kernel macros and DYNEMIT_BINARY_AUTOTUNE_DISPATCH() exist on both.
+
+#if defined(__x86_64__) || defined(__i386__)
+#define DYNEMIT_ARCH_X86 1
+#include <immintrin.h>
+#else
+#define DYNEMIT_ARCH_X86 0
+#endif
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <dynemit/core.h>
+#include <dynemit/kernel.h>   // dynemit_sized_large_bytes()
+
+// Attributes of the hand-written scalar kernels: no auto-vectorization, so
+// they really are the baseline, and on x86 the default target
+#if DYNEMIT_ARCH_X86
+#define DYNEMIT_SCALAR_KERNEL_ATTRS                                             \
+    __attribute__((target("default"))) __attribute__((optimize("no-tree-vectorize")))
+#else
+#define DYNEMIT_SCALAR_KERNEL_ATTRS __attribute__((optimize("no-tree-vectorize")))
+#endif
+
+#if DYNEMIT_ARCH_X86
+
+#include "simd_mask.h"
+
+// Integer vector loads/stores take __m128i/__m256i/void pointers
+#define DYNEMIT_LOADU_SI128(p)     _mm_loadu_si128((const __m128i *)(p))
+#define DYNEMIT_STOREU_SI128(p, v) _mm_storeu_si128((__m128i *)(p), (v))
+#define DYNEMIT_LOADU_SI256(p)     _mm256_loadu_si256((const __m256i *)(p))
+#define DYNEMIT_STOREU_SI256(p, v) _mm256_storeu_si256((__m256i *)(p), (v))
+#define DYNEMIT_LOADU_SI512(p)     _mm512_loadu_si512((const void *)(p))
+#define DYNEMIT_STOREU_SI512(p, v) _mm512_storeu_si512((void *)(p), (v))
+
+// Low-k-lanes masks for tails (k is always below the vector width)
+#define DYNEMIT_TAIL_MASK(mask_t, k) ((mask_t)((UINT64_C(1) << (k)) - 1))
+
+/**
+ * Scalar kernel with auto-vectorization disabled, so it really is the
+ * baseline. The _CVT forms take a different output type than input type
+ * (e.g. fp16 in, float out).
+ */
+#define DYNEMIT_BINARY_KERNEL_SCALAR_CVT(name, TI, TO, SCALAR_OP)               \
+    __attribute__((target("default")))                                          \
+    __attribute__((optimize("no-tree-vectorize")))                              \
+    static void                                                                 \
+    name##_scalar(const TI *a, const TI *b, TO *out, size_t n)                  \
+    {                                                                           \
+        for (size_t i = 0; i < n; i++)                                          \
+            out[i] = SCALAR_OP(a[i], b[i]);                                     \
+    }
+
+#define DYNEMIT_BINARY_KERNEL_SCALAR(name, T, SCALAR_OP)                         \
+    DYNEMIT_BINARY_KERNEL_SCALAR_CVT(name, T, T, SCALAR_OP)
+
+/**
+ * Full-width SIMD body followed by a scalar tail, for levels without masked
+ * loads/stores of this element size (SSE, and 16-bit lanes on AVX2).
+ */
+#define DYNEMIT_BINARY_KERNEL_CVT(name, suffix, tgt, TI, TO, VT, width,         \
+                                  LOAD, STORE, OP, SCALAR_OP)                   \
+    __attribute__((target(tgt)))                                                \
+    static void                                                                 \
+    name##_##suffix(const TI *a, const TI *b, TO *out, size_t n)                \
+    {                                                                           \
+        size_t i = 0;                                                           \
+        for (; i + (width) <= n; i += (width)) {                                \
+            VT va = LOAD(a + i);                                                \
+            VT vb = LOAD(b + i);                                                \
+            STORE(out + i, OP(va, vb));                                         \
+        }                                                                       \
+        for (; i < n; i++)                                                      \
+            out[i] = SCALAR_OP(a[i], b[i]);                                     \
+    }
+
+#define DYNEMIT_BINARY_KERNEL(name, suffix, tgt, T, VT, width,                  \
+                              LOAD, STORE, OP, SCALAR_OP)                       \
+    DYNEMIT_BINARY_KERNEL_CVT(name, suffix, tgt, T, T, VT, width,               \
+                              LOAD, STORE, OP, SCALAR_OP)
+
+/**
+ * Full-width SIMD body followed by one masked operation for the remainder.
+ * MAKE_MASK(k) builds a MASK_T enabling k lanes; MLOAD(p, m) must return
+ * zero (or any harmless value) in masked-off lanes and MSTORE(p, m, v) must
+ * leave them untouched.
+ */
+#define DYNEMIT_BINARY_KERNEL_MASKED(name, suffix, tgt, T, VT, width,           \
+                                     LOAD, STORE, OP,                           \
+                                     MASK_T, MAKE_MASK, MLOAD, MSTORE)          \
+    __attribute__((target(tgt)))                                                \
+    static void                                                                 \
+    name##_##suffix(const T *a, const T *b, T *out, size_t n)                   \
+    {                                                                           \
+        size_t i = 0;                                                           \
+        for (; i + (width) <= n; i += (width)) {                                \
+            VT va = LOAD(a + i);                                                \
+            VT vb = LOAD(b + i);                                                \
+            STORE(out + i, OP(va, vb));                                         \
+        }                                                                       \
+        if (i < n) {                                                            \
+            MASK_T m = MAKE_MASK(n - i);                                        \
+            VT va = MLOAD(a + i, m);                                            \
+            VT vb = MLOAD(b + i, m);                                            \
+            MSTORE(out + i, m, OP(va, vb));                                     \
+        }                                                                       \
+    }
+
+// Prefetch the line dist bytes past p into all cache levels. The large
+// paths read dist once per call from dynemit_prefetch_distance() and skip
+// the prefetches when it is 0
+#define DYNEMIT_PREFETCH_AHEAD(p, dist)                                         \
+    _mm_prefetch((const char *)(p) + (dist), _MM_HINT_T0)
+
+/**
+ * name##_select(level) over one kernel per simd_level_t, returning
+ * name##_func_t. The AVX-512 kernel needs every feature in avx512_req,
+ * otherwise the AVX2 one is returned.
+ */
+#define DYNEMIT_LEVEL_SELECT(name, f_avx512, avx512_req,                        \
+                             f_avx2, f_avx, f_sse42, f_sse2, f_scalar)          \
+    static name##_func_t                                                        \
+    name##_select(simd_level_t level)                                           \
+    {                                                                           \
+        switch (level) {                                                        \
+        case SIMD_AVX512F:                                                      \
+            if (dynemit_cpu_has(avx512_req))                                    \
+                return f_avx512;                                                \
+            return f_avx2;                                                      \
+        case SIMD_AVX2:    return f_avx2;                                       \
+        case SIMD_AVX:     return f_avx;                                        \
+        case SIMD_SSE4_2:  return f_sse42;                                      \
+        case SIMD_SSE2:    return f_sse2;                                       \
+        case SIMD_SCALAR:                                                       \
+        default:           return f_scalar;                                     \
+        }                                                                       \
+    }
+
+/**
+ * Selector (registered for dynemit_get_kernel()), resolver and
+ * ifunc-dispatched public symbol. One kernel per simd_level_t
+ * (levels that add nothing for a type may repeat the one below). The
+ * AVX-512 kernel is only chosen when the CPU also has every feature in
+ * avx512_req, e.g. DYNEMIT_CPU_AVX512BW for 8/16-bit lanes; otherwise the
+ * AVX2 kernel is used.
+ */
+#define DYNEMIT_BINARY_DISPATCH(name, T, f_avx512, avx512_req,                  \
+                                f_avx2, f_avx, f_sse42, f_sse2)                 \
+    typedef void (*name##_func_t)(const T *, const T *, T *, size_t);           \
+    DYNEMIT_LEVEL_SELECT(name, f_avx512, avx512_req,                            \
+                         f_avx2, f_avx, f_sse42, f_sse2, name##_scalar)         \
+    DYNEMIT_DISPATCH(name, void, (const T *a, const T *b, T *out, size_t n),    \
+                     (a, b, out, n), n)
+
+#else // !DYNEMIT_ARCH_X86
+
+#include "portable.h"
+
+#endif
+
+/**
+ * Dispatched float binary operation with opt-in autotuning, on top of
+ * name##_select(). Without DYNEMIT_AUTOTUNE it is the plain
+ * DYNEMIT_DISPATCH(). With it, the symbol binds to name##_tuned, which
+ * runs dynemit_autotune_binary_f32() on its first call and then routes
+ * each call by the size class of its working set; call statistics report
+ * it as DYNEMIT_STATS_LEVEL_TUNED. Calls that race with the
+ * first one use the untuned kernel until the table is ready.
+ */
+#define DYNEMIT_BINARY_AUTOTUNE_DISPATCH(name)                                  \
+    static name##_func_t name##_tuned_table[DYNEMIT_SIZE_CLASSES];              \
+    static _Atomic int name##_tuned_state;  /* 0 new, 1 tuning, 2 ready */      \
+                                                                                \
+    static void                                                                 \
+    name##_tuned(const float *a, const float *b, float *out, size_t n)          \
+    {                                                                           \
+        int state = atomic_load_explicit(&name##_tuned_state,                   \
+                                         memory_order_acquire);                 \
+        if (state != 2) {                                                       \
+            int expected = 0;                                                   \
+            if (state == 1 ||                                                   \
+                !atomic_compare_exchange_strong(&name##_tuned_state,            \
+                                                &expected, 1)) {                \
+                name##_select(detect_simd_level_ts())(a, b, out, n);            \
+                return;                                                         \
+            }                                                                   \
+            simd_level_t levels[DYNEMIT_SIZE_CLASSES];                          \
+            for (int c = 0; c < DYNEMIT_SIZE_CLASSES; c++)                      \
+                levels[c] = detect_simd_level_ts();                             \
+            dynemit_autotune_binary_f32(#name, levels);                         \
+            for (int c = 0; c < DYNEMIT_SIZE_CLASSES; c++)                      \
+                name##_tuned_table[c] = name##_select(levels[c]);               \
+            atomic_store_explicit(&name##_tuned_state, 2, memory_order_release); \
+        }                                                                       \
+        name##_tuned_table[dynemit_size_class(3 * n * sizeof(float))](a, b, out, n); \
+    }                                                                           \
+                                                                                \
+    DYNEMIT_DISPATCH_BIND(name,                                                 \
+                          dynemit_autotune_mode() ? name##_tuned                \
+                                                  : name##_select(detect_simd_level_ts()), \
+                          dynemit_autotune_mode() ? DYNEMIT_STATS_LEVEL_TUNED   \
+                                                  : detect_simd_level_ts(),     \
+                          void, (const float *a, const float *b, float *out, size_t n), \
+                          (a, b, out, n), n)
+
+#if DYNEMIT_ARCH_X86
+
+/**
+ * Batched and strided forms of one level kernel, calling it directly so
+ * it can be inlined into the loop:
+ *
+ *   - name##_batch_##suffix: count independent items,
+ *     out[k][i] = op(a[k][i], b[k][i]) for i < n[k];
+ *   - name##_batch_strided_##suffix: count vectors of n elements each, the
+ *     k-th starting at a + k * stride (likewise b and out).
+ */
+#define DYNEMIT_BINARY_BATCH_KERNEL(name, suffix, tgt, T)                       \
+    __attribute__((target(tgt)))                                                \
+    static void                                                                 \
+    name##_batch_##suffix(const T *const *a, const T *const *b,                 \
+                          T *const *out, const size_t *n, size_t count)         \
+    {                                                                           \
+        for (size_t k = 0; k < count; k++)                                      \
+            name##_##suffix(a[k], b[k], out[k], n[k]);                          \
+    }                                                                           \
+                                                                                \
+    __attribute__((target(tgt)))                                                \
+    static void                                                                 \
+    name##_batch_strided_##suffix(const T *a, const T *b, T *out, size_t n,     \
+                                  size_t count, size_t stride)                  \
+    {                                                                           \
+        for (size_t k = 0; k < count; k++)                                      \
+            name##_##suffix(a + k * stride, b + k * stride, out + k * stride, n); \
+    }
+
+/**
+ * name##_batch() and name##_batch_strided() for an operation with one kernel
+ * per level (name##_scalar, _sse2, _sse42, _avx, _avx2, _avx512f), as the
+ * float add/sub/mul have: the batch kernels, selectors (registered for
+ * dynemit_get_kernel()), resolvers and ifunc-dispatched public symbols. A
+ * whole batch costs one indirect call.
+ */
+#define DYNEMIT_BINARY_BATCH(name, T)                                           \
+    DYNEMIT_BINARY_BATCH_KERNEL(name, scalar, "default", T)                     \
+    DYNEMIT_BINARY_BATCH_KERNEL(name, sse2, "sse2", T)                          \
+    DYNEMIT_BINARY_BATCH_KERNEL(name, sse42, "sse4.2", T)                       \
+    DYNEMIT_BINARY_BATCH_KERNEL(name, avx, "avx", T)                            \
+    DYNEMIT_BINARY_BATCH_KERNEL(name, avx2, "avx2", T)                          \
+    DYNEMIT_BINARY_BATCH_KERNEL(name, avx512f, "avx512f", T)                    \
+                                                                                \
+    typedef void (*name##_batch_func_t)(const T *const *, const T *const *,     \
+                                        T *const *, const size_t *, size_t);    \
+    typedef void (*name##_batch_strided_func_t)(const T *, const T *, T *,      \
+                                                size_t, size_t, size_t);        \
+                                                                                \
+    static name##_batch_func_t                                                  \
+    name##_batch_select(simd_level_t level)                                     \
+    {                                                                           \
+        switch (level) {                                                        \
+        case SIMD_AVX512F: return name##_batch_avx512f;                         \
+        case SIMD_AVX2:    return name##_batch_avx2;                            \
+        case SIMD_AVX:     return name##_batch_avx;                             \
+        case SIMD_SSE4_2:  return name##_batch_sse42;                           \
+        case SIMD_SSE2:    return name##_batch_sse2;                            \
+        case SIMD_SCALAR:                                                       \
+        default:           return name##_batch_scalar;                          \
+        }                                                                       \
+    }                                                                           \
+                                                                                \
+    static name##_batch_strided_func_t                                          \
+    name##_batch_strided_select(simd_level_t level)                             \
+    {                                                                           \
+        switch (level) {                                                        \
+        case SIMD_AVX512F: return name##_batch_strided_avx512f;                 \
+        case SIMD_AVX2:    return name##_batch_strided_avx2;                    \
+        case SIMD_AVX:     return name##_batch_strided_avx;                     \
+        case SIMD_SSE4_2:  return name##_batch_strided_sse42;                   \
+        case SIMD_SSE2:    return name##_batch_strided_sse2;                    \
+        case SIMD_SCALAR:                                                       \
+        default:           return name##_batch_strided_scalar;                  \
+        }                                                                       \
+    }                                                                           \
+                                                                                \
+    DYNEMIT_DISPATCH(name##_batch, void,                                        \
+                     (const T *const *a, const T *const *b, T *const *out,      \
+                      const size_t *n, size_t count),                           \
+                     (a, b, out, n, count), count)                              \
+                                                                                \
+    DYNEMIT_DISPATCH(name##_batch_strided, void,                                \
+                     (const T *a, const T *b, T *out, size_t n,                 \
+                      size_t count, size_t stride),                             \
+                     (a, b, out, n, count, stride), count)
+
+// ===================================================
+// In-place and broadcast-scalar forms
+// ===================================================
+
+/**
+ * In-place form of a binary operation, a[i] = op(a[i], b[i]):
+ * name##_ip_##suffix calls the level kernel with out = a, which is why every
+ * kernel loads both inputs before it stores an element. The size-dispatched
+ * kernels of <dynemit/kernel.h> keep regular stores in place.
+ */
+#define DYNEMIT_BINARY_IP_KERNEL(name, suffix, tgt, T)                          \
+    __attribute__((target(tgt)))                                                \
+    static void                                                                 \
+    name##_ip_##suffix(T *a, const T *b, size_t n)                              \
+    {                                                                           \
+        name##_##suffix(a, b, a, n);                                            \
+    }
+
+/** Selector, resolver and public symbol name##_ip(a, b, n). */
+#define DYNEMIT_BINARY_IP_DISPATCH(name, T, f_avx512, avx512_req,               \
+                                   f_avx2, f_avx, f_sse42, f_sse2)              \
+    typedef void (*name##_ip_func_t)(T *, const T *, size_t);                   \
+    DYNEMIT_LEVEL_SELECT(name##_ip, f_avx512, avx512_req,                       \
+                         f_avx2, f_avx, f_sse42, f_sse2, name##_ip_scalar)      \
+    DYNEMIT_DISPATCH(name##_ip, void, (T *a, const T *b, size_t n),             \
+                     (a, b, n), n)
+
+/**
+ * name##_ip() for an operation with one kernel per level (name##_scalar,
+ * _sse2, _sse42, _avx, _avx2, _avx512f), as the float and double add/sub/mul
+ * generated by <dynemit/kernel.h> have.
+ */
+#define DYNEMIT_BINARY_IP(name, T)                                              \
+    DYNEMIT_BINARY_IP_KERNEL(name, scalar, "default", T)                        \
+    DYNEMIT_BINARY_IP_KERNEL(name, sse2, "sse2", T)                             \
+    DYNEMIT_BINARY_IP_KERNEL(name, sse42, "sse4.2", T)                          \
+    DYNEMIT_BINARY_IP_KERNEL(name, avx, "avx", T)                               \
+    DYNEMIT_BINARY_IP_KERNEL(name, avx2, "avx2", T)                             \
+    DYNEMIT_BINARY_IP_KERNEL(name, avx512f, "avx512f", T)                       \
+    DYNEMIT_BINARY_IP_DISPATCH(name, T, name##_ip_avx512f, DYNEMIT_CPU_AVX512F, \
+                               name##_ip_avx2, name##_ip_avx, name##_ip_sse42,  \
+                               name##_ip_sse2)
+
+/**
+ * Broadcast-scalar kernels, out[i] = op(a[i], s): one input stream, the
+ * scalar held in a register. Same structure as the binary kernels of
+ * <dynemit/kernel.h>; the SIZED form has no tiny path, as its masked head and tail already cover
+ * short inputs without a loop.
+ */
+#define DYNEMIT_BROADCAST_KERNEL_SCALAR(name, T, SCALAR_OP)                     \
+    __attribute__((target("default")))                                          \
+    __attribute__((optimize("no-tree-vectorize")))                              \
+    static void                                                                 \
+    name##_scalar(const T *a, T s, T *out, size_t n)                            \
+    {                                                                           \
+        for (size_t i = 0; i < n; i++)                                          \
+            out[i] = SCALAR_OP(a[i], s);                                        \
+    }
+
+#define DYNEMIT_BROADCAST_KERNEL(name, suffix, tgt, T, VT, width,               \
+                                 SET1, LOAD, STORE, OP, SCALAR_OP)              \
+    __attribute__((target(tgt)))                                                \
+    static void                                                                 \
+    name##_##suffix(const T *a, T s, T *out, size_t n)                          \
+    {                                                                           \
+        VT vs = SET1(s);                                                        \
+        size_t i = 0;                                                           \
+        for (; i + 2 * (width) <= n; i += 2 * (width)) {                        \
+            VT r0 = OP(LOAD(a + i), vs);                                        \
+            VT r1 = OP(LOAD(a + i + (width)), vs);                              \
+            STORE(out + i, r0);                                                 \
+            STORE(out + i + (width), r1);                                       \
+        }                                                                       \
+        for (; i + (width) <= n; i += (width))                                  \
+            STORE(out + i, OP(LOAD(a + i), vs));                                \
+        for (; i < n; i++)                                                      \
+            out[i] = SCALAR_OP(a[i], s);                                        \
+    }
+
+#define DYNEMIT_BROADCAST_KERNEL_SIZED(name, suffix, tgt, T, VT, width, align,  \
+                                       SET1, LOAD, STORE, STREAM, OP,           \
+                                       MASK_T, MAKE_MASK, MLOAD, MSTORE)        \
+    __attribute__((target(tgt), always_inline))                                 \
+    static inline void                                                          \
+    name##_##suffix##_body(const T *a, VT vs, T *out, size_t n,                 \
+                           const int large)                                     \
+    {                                                                           \
+        const size_t step = 4 * (width);                                        \
+        const size_t pf = large ? dynemit_prefetch_distance() : 0;              \
+        size_t i = 0;                                                           \
+                                                                                \
+        size_t head = (((align) - ((uintptr_t)out & ((align) - 1))) &           \
+                       ((align) - 1)) / sizeof(T);                              \
+        if (head > n)                                                           \
+            head = n;                                                           \
+        if (head) {                                                             \
+            MASK_T m = MAKE_MASK(head);                                         \
+            MSTORE(out, m, OP(MLOAD(a, m), vs));                                \
+            i = head;                                                           \
+        }                                                                       \
+        if (large && out != a && n * sizeof(T) >= dynemit_stream_threshold() && \
+            ((uintptr_t)(out + i) & ((align) - 1)) == 0) {                      \
+            for (; i + step <= n; i += step) {                                  \
+                for (size_t p = 0; pf && p < step * sizeof(T); p += 64)         \
+                    DYNEMIT_PREFETCH_AHEAD((const char *)(a + i) + p, pf);      \
+                VT r0 = OP(LOAD(a + i), vs);                                    \
+                VT r1 = OP(LOAD(a + i + (width)), vs);                          \
+                VT r2 = OP(LOAD(a + i + 2 * (width)), vs);                      \
+                VT r3 = OP(LOAD(a + i + 3 * (width)), vs);                      \
+                STREAM(out + i, r0);                                            \
+                STREAM(out + i + (width), r1);                                  \
+                STREAM(out + i + 2 * (width), r2);                              \
+                STREAM(out + i + 3 * (width), r3);                              \
+            }                                                                   \
+            for (; i + (width) <= n; i += (width))                              \
+                STREAM(out + i, OP(LOAD(a + i), vs));                           \
+            _mm_sfence();                                                       \
+        }                                                                       \
+        for (; i + step <= n; i += step) {                                      \
+            for (size_t p = 0; pf && p < step * sizeof(T); p += 64)             \
+                DYNEMIT_PREFETCH_AHEAD((const char *)(a + i) + p, pf);          \
+            VT r0 = OP(LOAD(a + i), vs);                                        \
+            VT r1 = OP(LOAD(a + i + (width)), vs);                              \
+            VT r2 = OP(LOAD(a + i + 2 * (width)), vs);                          \
+            VT r3 = OP(LOAD(a + i + 3 * (width)), vs);                          \
+            STORE(out + i, r0);                                                 \
+            STORE(out + i + (width), r1);                                       \
+            STORE(out + i + 2 * (width), r2);                                   \
+            STORE(out + i + 3 * (width), r3);                                   \
+        }                                                                       \
+        for (; i + (width) <= n; i += (width))                                  \
+            STORE(out + i, OP(LOAD(a + i), vs));                                \
+        if (i < n) {                                                            \
+            MASK_T m = MAKE_MASK(n - i);                                        \
+            MSTORE(out + i, m, OP(MLOAD(a + i, m), vs));                        \
+        }                                                                       \
+    }                                                                           \
+                                                                                \
+    __attribute__((target(tgt), noinline))                                      \
+    static void                                                                 \
+    name##_##suffix##_cached(const T *a, T s, T *out, size_t n)                 \
+    {                                                                           \
+        name##_##suffix##_body(a, SET1(s), out, n, 0);                          \
+    }                                                                           \
+                                                                                \
+    __attribute__((target(tgt), noinline))                                      \
+    static void                                                                 \
+    name##_##suffix##_large(const T *a, T s, T *out, size_t n)                  \
+    {                                                                           \
+        name##_##suffix##_body(a, SET1(s), out, n, 1);                          \
+    }                                                                           \
+                                                                                \
+    __attribute__((target(tgt)))                                                \
+    static void                                                                 \
+    name##_##suffix(const T *a, T s, T *out, size_t n)                          \
+    {                                                                           \
+        if (n * sizeof(T) < dynemit_sized_large_bytes())                        \
+            name##_##suffix##_cached(a, s, out, n);                             \
+        else                                                                    \
+            name##_##suffix##_large(a, s, out, n);                              \
+    }
+
+/** In-place broadcast form, a[i] = op(a[i], s). */
+#define DYNEMIT_BROADCAST_IP_KERNEL(name, suffix, tgt, T)                       \
+    __attribute__((target(tgt)))                                                \
+    static void                                                                 \
+    name##_ip_##suffix(T *a, T s, size_t n)                                     \
+    {                                                                           \
+        name##_##suffix(a, s, a, n);                                            \
+    }
+
+/**
+ * Selectors, resolvers and public symbols of name(a, s, out, n) and
+ * name##_ip(a, s, n). Kernels are given by level suffix (avx512f, avx, ...)
+ * and must exist in both forms.
+ */
+#define DYNEMIT_BROADCAST_DISPATCH(name, T, s_avx512, avx512_req,               \
+                                   s_avx2, s_avx, s_sse42, s_sse2)              \
+    typedef void (*name##_func_t)(const T *, T, T *, size_t);                   \
+    DYNEMIT_LEVEL_SELECT(name, name##_##s_avx512, avx512_req, name##_##s_avx2,  \
+                         name##_##s_avx, name##_##s_sse42, name##_##s_sse2,     \
+                         name##_scalar)                                         \
+    DYNEMIT_DISPATCH(name, void, (const T *a, T s, T *out, size_t n),           \
+                     (a, s, out, n), n)                                         \
+                                                                                \
+    typedef void (*name##_ip_func_t)(T *, T, size_t);                           \
+    DYNEMIT_LEVEL_SELECT(name##_ip, name##_ip_##s_avx512, avx512_req,           \
+                         name##_ip_##s_avx2, name##_ip_##s_avx,                 \
+                         name##_ip_##s_sse42, name##_ip_##s_sse2,               \
+                         name##_ip_scalar)                                      \
+    DYNEMIT_DISPATCH(name##_ip, void, (T *a, T s, size_t n), (a, s, n), n)
+
+// ===================================================
+// Masked load/store adapters, (p, m) argument order
+// ===================================================
+
+#define DYNEMIT_MASKLOAD_PS256(p, m)        _mm256_maskload_ps((p), (m))
+#define DYNEMIT_MASKSTORE_PS256(p, m, v)    _mm256_maskstore_ps((p), (m), (v))
+#define DYNEMIT_MASKLOAD_PS512(p, m)        _mm512_maskz_loadu_ps((m), (p))
+#define DYNEMIT_MASKSTORE_PS512(p, m, v)    _mm512_mask_storeu_ps((p), (m), (v))
+
+#define DYNEMIT_MASK_PD256(k)               dynemit_mask8(2 * (k))  // two dwords per double
+#define DYNEMIT_MASKLOAD_PD256(p, m)        _mm256_maskload_pd((p), (m))
+#define DYNEMIT_MASKSTORE_PD256(p, m, v)    _mm256_maskstore_pd((p), (m), (v))
+#define DYNEMIT_MASK_PD512(k)               DYNEMIT_TAIL_MASK(__mmask8, k)
+#define DYNEMIT_MASKLOAD_PD512(p, m)        _mm512_maskz_loadu_pd((m), (p))
+#define DYNEMIT_MASKSTORE_PD512(p, m, v)    _mm512_mask_storeu_pd((p), (m), (v))
+
+#define DYNEMIT_MASKLOAD_EPI32_256(p, m)     _mm256_maskload_epi32((const int *)(p), (m))
+#define DYNEMIT_MASKSTORE_EPI32_256(p, m, v) _mm256_maskstore_epi32((int *)(p), (m), (v))
+#define DYNEMIT_MASK_EPI32_512(k)            DYNEMIT_TAIL_MASK(__mmask16, k)
+#define DYNEMIT_MASKLOAD_EPI32_512(p, m)     _mm512_maskz_loadu_epi32((m), (p))
+#define DYNEMIT_MASKSTORE_EPI32_512(p, m, v) _mm512_mask_storeu_epi32((p), (m), (v))
+
+#define DYNEMIT_MASK_EPI16_512(k)            DYNEMIT_TAIL_MASK(__mmask32, k)
+#define DYNEMIT_MASKLOAD_EPI16_512(p, m)     _mm512_maskz_loadu_epi16((m), (p))
+#define DYNEMIT_MASKSTORE_EPI16_512(p, m, v) _mm512_mask_storeu_epi16((p), (m), (v))
+
+// ===================================================
+// Full ladders per element type
+// ===================================================
+
+/**
+ * int32_t: SSE2, SSE4.2 (SSE4.1 adds pmulld), AVX2 (masked tail) and AVX-512F
+ * (masked tail). AVX has no 256-bit integer arithmetic and uses the SSE4.2
+ * kernel.
+ */
+#define DYNEMIT_BINARY_I32(name, SCALAR_OP, OP_SSE2, OP_SSE41, OP256, OP512)    \
+    DYNEMIT_BINARY_KERNEL_SCALAR(name, int32_t, SCALAR_OP)                      \
+    DYNEMIT_BINARY_KERNEL(name, sse2, "sse2", int32_t, __m128i, 4,              \
+                          DYNEMIT_LOADU_SI128, DYNEMIT_STOREU_SI128,            \
+                          OP_SSE2, SCALAR_OP)                                   \
+    DYNEMIT_BINARY_KERNEL(name, sse42, "sse4.2", int32_t, __m128i, 4,           \
+                          DYNEMIT_LOADU_SI128, DYNEMIT_STOREU_SI128,            \
+                          OP_SSE41, SCALAR_OP)                                  \
+    DYNEMIT_BINARY_KERNEL_MASKED(name, avx2, "avx2", int32_t, __m256i, 8,       \
+                                 DYNEMIT_LOADU_SI256, DYNEMIT_STOREU_SI256,     \
+                                 OP256, __m256i, dynemit_mask8,                 \
+                                 DYNEMIT_MASKLOAD_EPI32_256,                    \
+                                 DYNEMIT_MASKSTORE_EPI32_256)                   \
+    DYNEMIT_BINARY_KERNEL_MASKED(name, avx512f, "avx512f", int32_t, __m512i, 16,\
+                                 DYNEMIT_LOADU_SI512, DYNEMIT_STOREU_SI512,     \
+                                 OP512, __mmask16, DYNEMIT_MASK_EPI32_512,      \
+                                 DYNEMIT_MASKLOAD_EPI32_512,                    \
+                                 DYNEMIT_MASKSTORE_EPI32_512)                   \
+    DYNEMIT_BINARY_DISPATCH(name, int32_t,                                      \
+                            name##_avx512f, DYNEMIT_CPU_AVX512F,                \
+                            name##_avx2, name##_sse42, name##_sse42, name##_sse2)
+
+/**
+ * int16_t: SSE2 (also used for SSE4.2 and AVX), AVX2 and AVX-512BW (masked
+ * tail). AVX2 has no 16-bit masked load/store, so its tail stays scalar.
+ * CPUs with AVX-512F but not BW fall back to the AVX2 kernel.
+ */
+#define DYNEMIT_BINARY_I16(name, SCALAR_OP, OP128, OP256, OP512)                \
+    DYNEMIT_BINARY_KERNEL_SCALAR(name, int16_t, SCALAR_OP)                      \
+    DYNEMIT_BINARY_KERNEL(name, sse2, "sse2", int16_t, __m128i, 8,              \
+                          DYNEMIT_LOADU_SI128, DYNEMIT_STOREU_SI128,            \
+                          OP128, SCALAR_OP)                                     \
+    DYNEMIT_BINARY_KERNEL(name, avx2, "avx2", int16_t, __m256i, 16,             \
+                          DYNEMIT_LOADU_SI256, DYNEMIT_STOREU_SI256,            \
+                          OP256, SCALAR_OP)                                     \
+    DYNEMIT_BINARY_KERNEL_MASKED(name, avx512bw, "avx512f,avx512bw", int16_t,   \
+                                 __m512i, 32,                                   \
+                                 DYNEMIT_LOADU_SI512, DYNEMIT_STOREU_SI512,     \
+                                 OP512, __mmask32, DYNEMIT_MASK_EPI16_512,      \
+                                 DYNEMIT_MASKLOAD_EPI16_512,                    \
+                                 DYNEMIT_MASKSTORE_EPI16_512)                   \
+    DYNEMIT_BINARY_DISPATCH(name, int16_t,                                      \
+                            name##_avx512bw,                                    \
+                            DYNEMIT_CPU_AVX512F | DYNEMIT_CPU_AVX512BW,         \
+                            name##_avx2, name##_sse2, name##_sse2, name##_sse2)
+
+/**
+ * Broadcast-scalar float and double operations, name(a, s, out, n) and
+ * name##_ip(a, s, n): SSE2 (also used for SSE4.2) and size-dispatched AVX
+ * (also used for AVX2) and AVX-512F kernels.
+ */
+#define DYNEMIT_BROADCAST_F32(name, SCALAR_OP, OP128, OP256, OP512)             \
+    DYNEMIT_BROADCAST_KERNEL_SCALAR(name, float, SCALAR_OP)                     \
+    DYNEMIT_BROADCAST_KERNEL(name, sse2, "sse2", float, __m128, 4,              \
+                             _mm_set1_ps, _mm_loadu_ps, _mm_storeu_ps,          \
+                             OP128, SCALAR_OP)                                  \
+    DYNEMIT_BROADCAST_KERNEL_SIZED(name, avx, "avx", float, __m256, 8, 32,      \
+                                   _mm256_set1_ps, _mm256_loadu_ps,             \
+                                   _mm256_storeu_ps, _mm256_stream_ps, OP256,   \
+                                   __m256i, dynemit_mask8,                      \
+                                   DYNEMIT_MASKLOAD_PS256, DYNEMIT_MASKSTORE_PS256) \
+    DYNEMIT_BROADCAST_KERNEL_SIZED(name, avx512f, "avx512f", float, __m512, 16, 64, \
+                                   _mm512_set1_ps, _mm512_loadu_ps,             \
+                                   _mm512_storeu_ps, _mm512_stream_ps, OP512,   \
+                                   __mmask16, dynemit_mask16,                   \
+                                   DYNEMIT_MASKLOAD_PS512, DYNEMIT_MASKSTORE_PS512) \
+    DYNEMIT_BROADCAST_IP_KERNEL(name, scalar, "default", float)                 \
+    DYNEMIT_BROADCAST_IP_KERNEL(name, sse2, "sse2", float)                      \
+    DYNEMIT_BROADCAST_IP_KERNEL(name, avx, "avx", float)                        \
+    DYNEMIT_BROADCAST_IP_KERNEL(name, avx512f, "avx512f", float)                \
+    DYNEMIT_BROADCAST_DISPATCH(name, float, avx512f, DYNEMIT_CPU_AVX512F,       \
+                               avx, avx, sse2, sse2)
+
+#define DYNEMIT_BROADCAST_F64(name, SCALAR_OP, OP128, OP256, OP512)             \
+    DYNEMIT_BROADCAST_KERNEL_SCALAR(name, double, SCALAR_OP)                    \
+    DYNEMIT_BROADCAST_KERNEL(name, sse2, "sse2", double, __m128d, 2,            \
+                             _mm_set1_pd, _mm_loadu_pd, _mm_storeu_pd,          \
+                             OP128, SCALAR_OP)                                  \
+    DYNEMIT_BROADCAST_KERNEL_SIZED(name, avx, "avx", double, __m256d, 4, 32,    \
+                                   _mm256_set1_pd, _mm256_loadu_pd,             \
+                                   _mm256_storeu_pd, _mm256_stream_pd, OP256,   \
+                                   __m256i, DYNEMIT_MASK_PD256,                 \
+                                   DYNEMIT_MASKLOAD_PD256, DYNEMIT_MASKSTORE_PD256) \
+    DYNEMIT_BROADCAST_KERNEL_SIZED(name, avx512f, "avx512f", double, __m512d, 8, 64, \
+                                   _mm512_set1_pd, _mm512_loadu_pd,             \
+                                   _mm512_storeu_pd, _mm512_stream_pd, OP512,   \
+                                   __mmask8, DYNEMIT_MASK_PD512,                \
+                                   DYNEMIT_MASKLOAD_PD512, DYNEMIT_MASKSTORE_PD512) \
+    DYNEMIT_BROADCAST_IP_KERNEL(name, scalar, "default", double)                \
+    DYNEMIT_BROADCAST_IP_KERNEL(name, sse2, "sse2", double)                     \
+    DYNEMIT_BROADCAST_IP_KERNEL(name, avx, "avx", double)                       \
+    DYNEMIT_BROADCAST_IP_KERNEL(name, avx512f, "avx512f", double)               \
+    DYNEMIT_BROADCAST_DISPATCH(name, double, avx512f, DYNEMIT_CPU_AVX512F,      \
+                               avx, avx, sse2, sse2)
+
+#endif // DYNEMIT_ARCH_X86
+
+// ===================================================
+// Scalar element operations shared by the features
+// ===================================================
+
+#define DYNEMIT_SCALAR_ADD(x, y) ((x) + (y))
+#define DYNEMIT_SCALAR_SUB(x, y) ((x) - (y))
+#define DYNEMIT_SCALAR_MUL(x, y) ((x) * (y))
+
+// int32 arithmetic wraps (two's complement), like the SIMD instructions;
+// going through uint32_t keeps the scalar path free of signed overflow
+static inline int32_t dynemit_add_i32(int32_t a, int32_t b) { return (int32_t)((uint32_t)a + (uint32_t)b); }
+static inline int32_t dynemit_sub_i32(int32_t a, int32_t b) { return (int32_t)((uint32_t)a - (uint32_t)b); }
+static inline int32_t dynemit_mul_i32(int32_t a, int32_t b) { return (int32_t)((uint32_t)a * (uint32_t)b); }
+
+// int16 arithmetic saturates to [INT16_MIN, INT16_MAX]
+static inline int16_t
+dynemit_sat_i16(int32_t v)
+{
+    return (int16_t)(v > INT16_MAX ? INT16_MAX : v < INT16_MIN ? INT16_MIN : v);
+}
+static inline int16_t dynemit_adds_i16(int16_t a, int16_t b) { return dynemit_sat_i16((int32_t)a + b); }
+static inline int16_t dynemit_subs_i16(int16_t a, int16_t b) { return dynemit_sat_i16((int32_t)a - b); }
+static inline int16_t dynemit_muls_i16(int16_t a, int16_t b) { return dynemit_sat_i16((int32_t)a * b); }
+
+#endif // DYNEMIT_FEATURES_ELEMENTWISE_H
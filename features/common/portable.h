@@ -0,0 +1,383 @@
+/* SPDX-License-Identifier: BSL-1.0 */
+#ifndef DYNEMIT_FEATURES_PORTABLE_H
+#define DYNEMIT_FEATURES_PORTABLE_H
+
+// Internal macros generating the non-x86 ladders, included by elementwise.h
+// in place of the x86 ones. Not part of the installed API.
+//
+//   aarch64  scalar and NEON kernels in the feature's .c file (ASIMD is part
+//            of the base ISA, so it needs no target attribute); SVE and SVE2
+//            kernels in <feature>_sve.c / <feature>_sve2.c, built with
+//            -march=armv8-a+sve / +sve2 when the compiler supports it
+//            (DYNEMIT_HAVE_SVE / DYNEMIT_HAVE_SVE2)
+//   RISC-V   scalar kernels, and RVV kernels in <feature>_rvv.c built with
+//            -march=rv64gcv (DYNEMIT_HAVE_RVV)
+//   other    scalar kernels only
+//
+// The SVE and RVV kernels are vector-length agnostic: each iteration is
+// predicated by svwhilelt or strip-mined by vsetvl, so the last, partial
+// vector needs no scalar tail. They are hidden external functions named
+// name##_sve, name##_sve2 and name##_rvv; where a file was not built the
+// selectors fall back to the next kernel down. SVE2 adds nothing for most
+// operations and reuses the SVE kernel.
+//
+// One line per operation and type in the feature's .c file:
+//
+//   DYNEMIT_PORTABLE_BINARY(vector_add_f64, double, DYNEMIT_SCALAR_ADD,
+//                           float64x2_t, 2, vld1q_f64, vst1q_f64, vaddq_f64)
+//
+// The NEON arguments are only expanded on aarch64, so they may name
+// intrinsics that do not exist elsewhere.
+
+#if defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+/**
+ * Scalar kernels, auto-vectorization disabled as on x86. Same names and
+ * arguments as the x86 building blocks.
+ */
+#define DYNEMIT_BINARY_KERNEL_SCALAR_CVT(name, TI, TO, SCALAR_OP)               \
+    DYNEMIT_SCALAR_KERNEL_ATTRS                                                 \
+    static void                                                                 \
+    name##_scalar(const TI *a, const TI *b, TO *out, size_t n)                  \
+    {                                                                           \
+        for (size_t i = 0; i < n; i++)                                          \
+            out[i] = SCALAR_OP(a[i], b[i]);                                     \
+    }
+
+#define DYNEMIT_BINARY_KERNEL_SCALAR(name, T, SCALAR_OP)                         \
+    DYNEMIT_BINARY_KERNEL_SCALAR_CVT(name, T, T, SCALAR_OP)
+
+#define DYNEMIT_BROADCAST_KERNEL_SCALAR(name, T, SCALAR_OP)                     \
+    DYNEMIT_SCALAR_KERNEL_ATTRS                                                 \
+    static void                                                                 \
+    name##_scalar(const T *a, T s, T *out, size_t n)                            \
+    {                                                                           \
+        for (size_t i = 0; i < n; i++)                                          \
+            out[i] = SCALAR_OP(a[i], s);                                        \
+    }
+
+// ===================================================
+// Kernels available per architecture
+// ===================================================
+
+// The kernel of `name` a level resolves to on this build
+#if defined(__aarch64__)
+#define DYNEMIT_NEON_KERNEL(name) name##_neon
+#else
+#define DYNEMIT_NEON_KERNEL(name) name##_scalar
+#endif
+
+#if defined(__aarch64__) && defined(DYNEMIT_HAVE_SVE)
+#define DYNEMIT_SVE_KERNEL(name) name##_sve
+#else
+#define DYNEMIT_SVE_KERNEL(name) DYNEMIT_NEON_KERNEL(name)
+#endif
+
+#if defined(__aarch64__) && defined(DYNEMIT_HAVE_SVE2)
+#define DYNEMIT_SVE2_KERNEL(name) name##_sve2
+#else
+#define DYNEMIT_SVE2_KERNEL(name) DYNEMIT_SVE_KERNEL(name)
+#endif
+
+#if defined(__riscv) && defined(DYNEMIT_HAVE_RVV)
+#define DYNEMIT_RVV_KERNEL(name) name##_rvv
+#else
+#define DYNEMIT_RVV_KERNEL(name) name##_scalar
+#endif
+
+/**
+ * Prototype of the external kernel name##_sve or name##_rvv, when this build
+ * has one: DYNEMIT_EXTERN_KERNEL(dot_f32, float, (const float *a, ...)).
+ * The _SVE2 form is for the few operations with an SVE2 kernel.
+ */
+#if defined(__aarch64__) && defined(DYNEMIT_HAVE_SVE)
+#define DYNEMIT_EXTERN_KERNEL(name, ret, params) ret name##_sve params;
+#elif defined(__riscv) && defined(DYNEMIT_HAVE_RVV)
+#define DYNEMIT_EXTERN_KERNEL(name, ret, params) ret name##_rvv params;
+#else
+#define DYNEMIT_EXTERN_KERNEL(name, ret, params)
+#endif
+
+#if defined(__aarch64__) && defined(DYNEMIT_HAVE_SVE2)
+#define DYNEMIT_EXTERN_KERNEL_SVE2(name, ret, params) ret name##_sve2 params;
+#else
+#define DYNEMIT_EXTERN_KERNEL_SVE2(name, ret, params)
+#endif
+
+/**
+ * M(name, suffix, T) once per kernel suffix this build has, for the forms
+ * derived from a level kernel (in place, batched).
+ */
+#if defined(__aarch64__) && defined(DYNEMIT_HAVE_SVE)
+#define DYNEMIT_PORTABLE_EACH(M, name, T) M(name, scalar, T) M(name, neon, T) M(name, sve, T)
+#elif defined(__aarch64__)
+#define DYNEMIT_PORTABLE_EACH(M, name, T) M(name, scalar, T) M(name, neon, T)
+#elif defined(__riscv) && defined(DYNEMIT_HAVE_RVV)
+#define DYNEMIT_PORTABLE_EACH(M, name, T) M(name, scalar, T) M(name, rvv, T)
+#else
+#define DYNEMIT_PORTABLE_EACH(M, name, T) M(name, scalar, T)
+#endif
+
+/**
+ * name##_select(level) returning name##_func_t, over the kernels of the
+ * running architecture. Levels of another ladder get the scalar kernel.
+ */
+#define DYNEMIT_PORTABLE_SELECT(name)                                           \
+    static name##_func_t                                                        \
+    name##_select(simd_level_t level)                                           \
+    {                                                                           \
+        switch (level) {                                                        \
+        case SIMD_SVE2:                                                         \
+        case SIMD_SVE:     return DYNEMIT_SVE_KERNEL(name);                     \
+        case SIMD_NEON:    return DYNEMIT_NEON_KERNEL(name);                    \
+        case SIMD_RVV:     return DYNEMIT_RVV_KERNEL(name);                     \
+        case SIMD_SCALAR:                                                       \
+        default:           return name##_scalar;                                \
+        }                                                                       \
+    }
+
+// ===================================================
+// NEON kernels
+// ===================================================
+
+#if defined(__aarch64__)
+
+/**
+ * Two vectors per iteration, then one, then a scalar tail. Both inputs
+ * are loaded before anything is stored, so out may be a or b.
+ */
+#define DYNEMIT_NEON_BINARY_KERNEL_CVT(name, TI, TO, VT, width,                 \
+                                       LOAD, STORE, OP, SCALAR_OP)              \
+    static void                                                                 \
+    name##_neon(const TI *a, const TI *b, TO *out, size_t n)                    \
+    {                                                                           \
+        size_t i = 0;                                                           \
+        for (; i + 2 * (width) <= n; i += 2 * (width)) {                        \
+            VT r0 = OP(LOAD(a + i), LOAD(b + i));                               \
+            VT r1 = OP(LOAD(a + i + (width)), LOAD(b + i + (width)));           \
+            STORE(out + i, r0);                                                 \
+            STORE(out + i + (width), r1);                                       \
+        }                                                                       \
+        for (; i + (width) <= n; i += (width))                                  \
+            STORE(out + i, OP(LOAD(a + i), LOAD(b + i)));                       \
+        for (; i < n; i++)                                                      \
+            out[i] = SCALAR_OP(a[i], b[i]);                                     \
+    }
+
+#define DYNEMIT_NEON_BROADCAST_KERNEL(name, T, VT, width,                       \
+                                      DUP, LOAD, STORE, OP, SCALAR_OP)          \
+    static void                                                                 \
+    name##_neon(const T *a, T s, T *out, size_t n)                              \
+    {                                                                           \
+        VT vs = DUP(s);                                                         \
+        size_t i = 0;                                                           \
+        for (; i + 2 * (width) <= n; i += 2 * (width)) {                        \
+            VT r0 = OP(LOAD(a + i), vs);                                        \
+            VT r1 = OP(LOAD(a + i + (width)), vs);                              \
+            STORE(out + i, r0);                                                 \
+            STORE(out + i + (width), r1);                                       \
+        }                                                                       \
+        for (; i + (width) <= n; i += (width))                                  \
+            STORE(out + i, OP(LOAD(a + i), vs));                                \
+        for (; i < n; i++)                                                      \
+            out[i] = SCALAR_OP(a[i], s);                                        \
+    }
+
+#else
+
+#define DYNEMIT_NEON_BINARY_KERNEL_CVT(name, TI, TO, VT, width, LOAD, STORE, OP, SCALAR_OP)
+#define DYNEMIT_NEON_BROADCAST_KERNEL(name, T, VT, width, DUP, LOAD, STORE, OP, SCALAR_OP)
+
+#endif
+
+#define DYNEMIT_NEON_BINARY_KERNEL(name, T, VT, width, LOAD, STORE, OP, SCALAR_OP) \
+    DYNEMIT_NEON_BINARY_KERNEL_CVT(name, T, T, VT, width, LOAD, STORE, OP, SCALAR_OP)
+
+// ===================================================
+// Ladders
+// ===================================================
+
+/**
+ * Level kernels, external kernel prototype, name##_func_t and selector of a
+ * binary operation; the caller adds DYNEMIT_DISPATCH() or
+ * DYNEMIT_BINARY_AUTOTUNE_DISPATCH().
+ */
+#define DYNEMIT_PORTABLE_BINARY_KERNELS(name, T, SCALAR_OP, VT, width,          \
+                                        LOAD, STORE, OP)                        \
+    DYNEMIT_BINARY_KERNEL_SCALAR(name, T, SCALAR_OP)                            \
+    DYNEMIT_NEON_BINARY_KERNEL(name, T, VT, width, LOAD, STORE, OP, SCALAR_OP)  \
+    DYNEMIT_EXTERN_KERNEL(name, void, (const T *a, const T *b, T *out, size_t n)) \
+    typedef void (*name##_func_t)(const T *, const T *, T *, size_t);           \
+    DYNEMIT_PORTABLE_SELECT(name)
+
+/** Binary operation: kernels, selector, resolver and public symbol. */
+#define DYNEMIT_PORTABLE_BINARY(name, T, SCALAR_OP, VT, width, LOAD, STORE, OP)  \
+    DYNEMIT_PORTABLE_BINARY_KERNELS(name, T, SCALAR_OP, VT, width,              \
+                                    LOAD, STORE, OP)                            \
+    DYNEMIT_DISPATCH(name, void, (const T *a, const T *b, T *out, size_t n),    \
+                     (a, b, out, n), n)
+
+/** In-place form name##_ip(a, b, n) over every level kernel of name. */
+#define DYNEMIT_PORTABLE_IP_KERNEL(name, suffix, T)                             \
+    static void                                                                 \
+    name##_ip_##suffix(T *a, const T *b, size_t n)                              \
+    {                                                                           \
+        name##_##suffix(a, b, a, n);                                            \
+    }
+
+#define DYNEMIT_PORTABLE_IP(name, T)                                            \
+    DYNEMIT_PORTABLE_EACH(DYNEMIT_PORTABLE_IP_KERNEL, name, T)                  \
+    typedef void (*name##_ip_func_t)(T *, const T *, size_t);                   \
+    DYNEMIT_PORTABLE_SELECT(name##_ip)                                          \
+    DYNEMIT_DISPATCH(name##_ip, void, (T *a, const T *b, size_t n),             \
+                     (a, b, n), n)
+
+/** name##_batch() and name##_batch_strided() over every level kernel. */
+#define DYNEMIT_PORTABLE_BATCH_KERNEL(name, suffix, T)                          \
+    static void                                                                 \
+    name##_batch_##suffix(const T *const *a, const T *const *b,                 \
+                          T *const *out, const size_t *n, size_t count)         \
+    {                                                                           \
+        for (size_t k = 0; k < count; k++)                                      \
+            name##_##suffix(a[k], b[k], out[k], n[k]);                          \
+    }                                                                           \
+                                                                                \
+    static void                                                                 \
+    name##_batch_strided_##suffix(const T *a, const T *b, T *out, size_t n,     \
+                                  size_t count, size_t stride)                  \
+    {                                                                           \
+        for (size_t k = 0; k < count; k++)                                      \
+            name##_##suffix(a + k * stride, b + k * stride, out + k * stride, n); \
+    }
+
+#define DYNEMIT_PORTABLE_BATCH(name, T)                                         \
+    DYNEMIT_PORTABLE_EACH(DYNEMIT_PORTABLE_BATCH_KERNEL, name, T)               \
+                                                                                \
+    typedef void (*name##_batch_func_t)(const T *const *, const T *const *,     \
+                                        T *const *, const size_t *, size_t);    \
+    typedef void (*name##_batch_strided_func_t)(const T *, const T *, T *,      \
+                                                size_t, size_t, size_t);        \
+    DYNEMIT_PORTABLE_SELECT(name##_batch)                                       \
+    DYNEMIT_PORTABLE_SELECT(name##_batch_strided)                               \
+                                                                                \
+    DYNEMIT_DISPATCH(name##_batch, void,                                        \
+                     (const T *const *a, const T *const *b, T *const *out,      \
+                      const size_t *n, size_t count),                           \
+                     (a, b, out, n, count), count)                              \
+                                                                                \
+    DYNEMIT_DISPATCH(name##_batch_strided, void,                                \
+                     (const T *a, const T *b, T *out, size_t n,                 \
+                      size_t count, size_t stride),                             \
+                     (a, b, out, n, count, stride), count)
+
+/**
+ * Broadcast-scalar operation name(a, s, out, n) and its in-place form
+ * name##_ip(a, s, n).
+ */
+#define DYNEMIT_PORTABLE_BROADCAST_IP_KERNEL(name, suffix, T)                   \
+    static void                                                                 \
+    name##_ip_##suffix(T *a, T s, size_t n)                                     \
+    {                                                                           \
+        name##_##suffix(a, s, a, n);                                            \
+    }
+
+#define DYNEMIT_PORTABLE_BROADCAST(name, T, SCALAR_OP, VT, width,               \
+                                   DUP, LOAD, STORE, OP)                        \
+    DYNEMIT_BROADCAST_KERNEL_SCALAR(name, T, SCALAR_OP)                         \
+    DYNEMIT_NEON_BROADCAST_KERNEL(name, T, VT, width, DUP, LOAD, STORE, OP,     \
+                                  SCALAR_OP)                                    \
+    DYNEMIT_EXTERN_KERNEL(name, void, (const T *a, T s, T *out, size_t n))      \
+    DYNEMIT_PORTABLE_EACH(DYNEMIT_PORTABLE_BROADCAST_IP_KERNEL, name, T)        \
+                                                                                \
+    typedef void (*name##_func_t)(const T *, T, T *, size_t);                   \
+    DYNEMIT_PORTABLE_SELECT(name)                                               \
+    DYNEMIT_DISPATCH(name, void, (const T *a, T s, T *out, size_t n),           \
+                     (a, s, out, n), n)                                         \
+                                                                                \
+    typedef void (*name##_ip_func_t)(T *, T, size_t);                           \
+    DYNEMIT_PORTABLE_SELECT(name##_ip)                                          \
+    DYNEMIT_DISPATCH(name##_ip, void, (T *a, T s, size_t n), (a, s, n), n)
+
+// ===================================================
+// SVE kernels (only in files built with SVE enabled)
+// ===================================================
+
+#if defined(__ARM_FEATURE_SVE)
+#include <arm_sve.h>
+
+// Lanes per vector for an element size in bits
+#define DYNEMIT_SVE_LANES_16 svcnth
+#define DYNEMIT_SVE_LANES_32 svcntw
+#define DYNEMIT_SVE_LANES_64 svcntd
+
+/**
+ * name##_sve: one predicated vector per iteration, the last one partial
+ * (DYNEMIT_SVE_BINARY_KERNEL() names other suffixes, e.g. sve2).
+ * OP(pg, x, y) is an overloaded _x intrinsic such as svadd_x, or a macro
+ * of the same shape. The broadcast form passes the scalar as y, which the
+ * overloaded intrinsics turn into their _n form.
+ */
+#define DYNEMIT_SVE_BINARY_KERNEL(name, suffix, T, bits, OP)                   \
+    void                                                                        \
+    name##_##suffix(const T *a, const T *b, T *out, size_t n)                   \
+    {                                                                           \
+        for (size_t i = 0; i < n; i += DYNEMIT_SVE_LANES_##bits()) {            \
+            svbool_t pg = svwhilelt_b##bits((uint64_t)i, (uint64_t)n);          \
+            svst1(pg, out + i, OP(pg, svld1(pg, a + i), svld1(pg, b + i)));     \
+        }                                                                       \
+    }
+
+#define DYNEMIT_SVE_BINARY(name, T, bits, OP)                                   \
+    DYNEMIT_SVE_BINARY_KERNEL(name, sve, T, bits, OP)
+
+#define DYNEMIT_SVE_BROADCAST(name, T, bits, OP)                                \
+    void                                                                        \
+    name##_sve(const T *a, T s, T *out, size_t n)                               \
+    {                                                                           \
+        for (size_t i = 0; i < n; i += DYNEMIT_SVE_LANES_##bits()) {            \
+            svbool_t pg = svwhilelt_b##bits((uint64_t)i, (uint64_t)n);          \
+            svst1(pg, out + i, OP(pg, svld1(pg, a + i), s));                    \
+        }                                                                       \
+    }
+
+#endif // __ARM_FEATURE_SVE
+
+// ===================================================
+// RVV kernels (only in files built with V enabled)
+// ===================================================
+
+#if defined(__riscv_vector)
+#include <riscv_vector.h>
+
+/**
+ * name##_rvv: strip-mined, vsetvl picks how many elements each pass
+ * handles, so the last pass is simply shorter. LOAD/STORE/OP are the typed
+ * intrinsics for one SEW/LMUL, e.g. __riscv_vsetvl_e32m8,
+ * __riscv_vle32_v_f32m8, __riscv_vse32_v_f32m8 and __riscv_vfadd_vv_f32m8;
+ * the broadcast form takes the .vf/.vx variant of OP.
+ */
+#define DYNEMIT_RVV_BINARY(name, T, SETVL, LOAD, STORE, OP)                     \
+    void                                                                        \
+    name##_rvv(const T *a, const T *b, T *out, size_t n)                        \
+    {                                                                           \
+        for (size_t i = 0, vl; i < n; i += vl) {                                \
+            vl = SETVL(n - i);                                                  \
+            STORE(out + i, OP(LOAD(a + i, vl), LOAD(b + i, vl), vl), vl);       \
+        }                                                                       \
+    }
+
+#define DYNEMIT_RVV_BROADCAST(name, T, SETVL, LOAD, STORE, OP)                  \
+    void                                                                        \
+    name##_rvv(const T *a, T s, T *out, size_t n)                               \
+    {                                                                           \
+        for (size_t i = 0, vl; i < n; i += vl) {                                \
+            vl = SETVL(n - i);                                                  \
+            STORE(out + i, OP(LOAD(a + i, vl), s, vl), vl);                     \
+        }                                                                       \
+    }
+
+#endif // __riscv_vector
+
+#endif // DYNEMIT_FEATURES_PORTABLE_H
@@ -0,0 +1,43 @@
+/* SPDX-License-Identifier: BSL-1.0 */
+#ifndef DYNEMIT_FEATURES_SIMD_MASK_H
+#define DYNEMIT_FEATURES_SIMD_MASK_H
+
+// Internal helpers for alignment peeling and masked tails, shared by the
+// feature kernels. Not part of the installed API.
+
+#include <immintrin.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Kernels only peel when the body spans at least this many full vectors;
+// below that the extra masked head costs more than the aligned stores save
+#define DYNEMIT_PEEL_MIN_VECTORS 4
+
+// Number of elements before p reaches an `align`-byte boundary, capped at n.
+// `align` must be a power of two.
+static inline size_t
+dynemit_head_count(const float *p, size_t align, size_t n)
+{
+    size_t head = ((align - ((uintptr_t)p & (align - 1))) & (align - 1)) / sizeof(float);
+    return head < n ? head : n;
+}
+
+// AVX-512 lane mask enabling the low k of 16 lanes (k <= 16)
+__attribute__((target("avx512f")))
+static inline __mmask16
+dynemit_mask16(size_t k)
+{
+    return (__mmask16)((1u << k) - 1u);
+}
+
+// vmaskmovps mask enabling the low k of 8 lanes (k <= 8). Masked-off lanes
+// are neither read nor written, so loads past the end of an array never fault.
+__attribute__((target("avx")))
+static inline __m256i
+dynemit_mask8(size_t k)
+{
+    static const int32_t lanes[16] = { -1, -1, -1, -1, -1, -1, -1, -1, 0, 0, 0, 0, 0, 0, 0, 0 };
+    return _mm256_loadu_si256((const __m256i *)(lanes + 8 - k));
+}
+
+#endif // DYNEMIT_FEATURES_SIMD_MASK_H
@@ -0,0 +1,207 @@
+/* SPDX-License-Identifier: BSL-1.0 */
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <dynemit/expr.h>
+#include <dynemit/vector_add.h>
+#include <dynemit/vector_fma.h>
+#include <dynemit/vector_mul.h>
+#include <dynemit/vector_sub.h>
+
+typedef enum { OP_INPUT, OP_CONST, OP_ADD, OP_SUB, OP_MUL, OP_FMA } expr_op_t;
+
+typedef struct {
+    expr_op_t op;
+    int       arg[3];  // operand node ids (operations)
+    unsigned  index;   // input index (OP_INPUT)
+    float     value;   // OP_CONST
+} expr_node_t;
+
+struct dynemit_expr {
+    int         count;
+    expr_node_t nodes[DYNEMIT_EXPR_MAX_NODES];
+};
+
+// Where a node's values for the current chunk live
+typedef enum { SRC_INPUT, SRC_SCRATCH, SRC_OUT } src_kind_t;
+
+// Scratch chunks kept on the stack (8 KiB); expressions with more live
+// intermediates take one heap block for the call instead
+#define EXPR_STACK_SLOTS 4
+
+dynemit_expr *
+dynemit_expr_create(void)
+{
+    return calloc(1, sizeof(dynemit_expr));
+}
+
+void
+dynemit_expr_destroy(dynemit_expr *e)
+{
+    free(e);
+}
+
+static int
+valid_node(const dynemit_expr *e, int id)
+{
+    return id >= 0 && id < e->count;
+}
+
+static int
+add_node(dynemit_expr *e, expr_node_t node)
+{
+    if (!e || e->count >= DYNEMIT_EXPR_MAX_NODES)
+        return -1;
+    e->nodes[e->count] = node;
+    return e->count++;
+}
+
+int
+dynemit_expr_input(dynemit_expr *e, unsigned index)
+{
+    if (index >= DYNEMIT_EXPR_MAX_INPUTS)
+        return -1;
+    return add_node(e, (expr_node_t){ .op = OP_INPUT, .index = index });
+}
+
+int
+dynemit_expr_const(dynemit_expr *e, float value)
+{
+    return add_node(e, (expr_node_t){ .op = OP_CONST, .value = value });
+}
+
+static int
+add_op(dynemit_expr *e, expr_op_t op, int x, int y, int z)
+{
+    if (!e || !valid_node(e, x) || !valid_node(e, y) || (op == OP_FMA && !valid_node(e, z)))
+        return -1;
+    return add_node(e, (expr_node_t){ .op = op, .arg = { x, y, z } });
+}
+
+int dynemit_expr_add(dynemit_expr *e, int x, int y)        { return add_op(e, OP_ADD, x, y, -1); }
+int dynemit_expr_sub(dynemit_expr *e, int x, int y)        { return add_op(e, OP_SUB, x, y, -1); }
+int dynemit_expr_mul(dynemit_expr *e, int x, int y)        { return add_op(e, OP_MUL, x, y, -1); }
+int dynemit_expr_fma(dynemit_expr *e, int x, int y, int z) { return add_op(e, OP_FMA, x, y, z); }
+
+static int
+num_args(expr_op_t op)
+{
+    return op == OP_FMA ? 3 : op >= OP_ADD ? 2 : 0;
+}
+
+int
+dynemit_expr_eval(const dynemit_expr *e, int root, const float *const *inputs,
+                  float *out, size_t n)
+{
+    if (!e || !valid_node(e, root))
+        return -1;
+
+    // Operands always have lower ids, so one backward sweep marks every
+    // node root depends on and the last operation that reads each of them
+    int used[DYNEMIT_EXPR_MAX_NODES] = { 0 };
+    int last_use[DYNEMIT_EXPR_MAX_NODES];
+    used[root] = 1;
+    for (int id = root; id >= 0; id--) {
+        last_use[id] = -1;
+        if (!used[id])
+            continue;
+        for (int k = 0; k < num_args(e->nodes[id].op); k++)
+            used[e->nodes[id].arg[k]] = 1;
+    }
+    for (int id = 0; id <= root; id++) {
+        if (!used[id])
+            continue;
+        for (int k = 0; k < num_args(e->nodes[id].op); k++)
+            last_use[e->nodes[id].arg[k]] = id;
+    }
+
+    // One scratch chunk per live value. Constants keep theirs; an operation
+    // may reuse the chunk of an operand it is the last reader of, since the
+    // kernels are element-wise
+    src_kind_t kind[DYNEMIT_EXPR_MAX_NODES];
+    int slot[DYNEMIT_EXPR_MAX_NODES];
+    int free_slots[DYNEMIT_EXPR_MAX_NODES], num_free = 0, num_slots = 0;
+
+    for (int id = 0; id <= root; id++) {
+        const expr_node_t *node = &e->nodes[id];
+        if (!used[id])
+            continue;
+        if (node->op == OP_INPUT && id != root) {
+            kind[id] = SRC_INPUT;
+            continue;
+        }
+        if (node->op != OP_CONST) {
+            for (int k = 0; k < num_args(node->op); k++) {
+                int arg = node->arg[k];
+                if (last_use[arg] == id && kind[arg] == SRC_SCRATCH &&
+                    e->nodes[arg].op != OP_CONST) {
+                    free_slots[num_free++] = slot[arg];
+                    last_use[arg] = -1;  // operand may repeat, free once
+                }
+            }
+        }
+        if (id == root) {
+            kind[id] = SRC_OUT;
+            continue;
+        }
+        kind[id] = SRC_SCRATCH;
+        slot[id] = num_free ? free_slots[--num_free] : num_slots++;
+    }
+
+    // Sized by the slots actually needed, so a small expression does not
+    // reserve DYNEMIT_EXPR_MAX_NODES chunks of stack
+    float stack_scratch[EXPR_STACK_SLOTS * DYNEMIT_EXPR_CHUNK] __attribute__((aligned(64)));
+    float *scratch = stack_scratch;
+    if (num_slots > EXPR_STACK_SLOTS) {
+        scratch = aligned_alloc(64, (size_t)num_slots * DYNEMIT_EXPR_CHUNK * sizeof(float));
+        if (!scratch)
+            return -1;
+    }
+
+    // Constants are filled once
+    for (int id = 0; id < root; id++) {
+        if (used[id] && e->nodes[id].op == OP_CONST) {
+            float *dst = scratch + (size_t)slot[id] * DYNEMIT_EXPR_CHUNK;
+            for (size_t i = 0; i < DYNEMIT_EXPR_CHUNK; i++)
+                dst[i] = e->nodes[id].value;
+        }
+    }
+
+    for (size_t base = 0; base < n; base += DYNEMIT_EXPR_CHUNK) {
+        size_t m = n - base < DYNEMIT_EXPR_CHUNK ? n - base : DYNEMIT_EXPR_CHUNK;
+
+        for (int id = 0; id <= root; id++) {
+            const expr_node_t *node = &e->nodes[id];
+            if (!used[id] || ((node->op == OP_INPUT || node->op == OP_CONST) && id != root))
+                continue;
+
+            const float *src[3];
+            for (int k = 0; k < num_args(node->op); k++) {
+                int arg = node->arg[k];
+                src[k] = kind[arg] == SRC_INPUT ? inputs[e->nodes[arg].index] + base
+                                                : scratch + (size_t)slot[arg] * DYNEMIT_EXPR_CHUNK;
+            }
+            float *dst = kind[id] == SRC_OUT ? out + base
+                                             : scratch + (size_t)slot[id] * DYNEMIT_EXPR_CHUNK;
+
+            switch (node->op) {
+            case OP_INPUT:
+                // Only reached for a bare input as root
+                memmove(dst, inputs[node->index] + base, m * sizeof(float));
+                break;
+            case OP_CONST:
+                for (size_t i = 0; i < m; i++)
+                    dst[i] = node->value;
+                break;
+            case OP_ADD: vector_add_f32(src[0], src[1], dst, m); break;
+            case OP_SUB: vector_sub_f32(src[0], src[1], dst, m); break;
+            case OP_MUL: vector_mul_f32(src[0], src[1], dst, m); break;
+            case OP_FMA: vector_fma_f32(src[0], src[1], src[2], dst, m); break;
+            }
+        }
+    }
+
+    if (scratch != stack_scratch)
+        free(scratch);
+    return 0;
+}
@@ -0,0 +1,724 @@
+/* SPDX-License-Identifier: BSL-1.0 */
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <dynemit/core.h>
+#include <dynemit/half.h>
+#include "../common/elementwise.h"
+
+// fp16/bf16 are storage formats here: every kernel widens to float in
+// registers, computes in float and narrows the result again. At large n these
+// kernels move half the bytes of their float counterparts, which is the whole
+// point; the conversions themselves are one or two instructions per vector.
+//
+// Conversion support per level:
+//   fp16  F16C (VEX, so AVX and up), AVX-512F vcvtph2ps/vcvtps2ph,
+//         AVX512-FP16 native add/mul (same correctly rounded result)
+//   bf16  integer shifts and rounding on SSE2/AVX2/AVX-512F,
+//         AVX-512 BF16 vcvtneps2bf16 and vdpbf16ps
+// SSE levels have no fp16 conversions and use the scalar kernels.
+// aarch64 has fcvtl/fcvtn for fp16 in the base ISA and uses NEON for
+// every level; RISC-V uses the scalar kernels.
+
+// ===================================================
+// Scalar conversions
+// ===================================================
+
+static inline uint32_t
+f32_bits(float f)
+{
+    uint32_t u;
+    memcpy(&u, &f, sizeof(u));
+    return u;
+}
+
+static inline float
+bits_f32(uint32_t u)
+{
+    float f;
+    memcpy(&f, &u, sizeof(f));
+    return f;
+}
+
+static inline float
+f16_to_f32(dynemit_f16_t h)
+{
+    uint32_t sign = (uint32_t)(h & 0x8000u) << 16;
+    uint32_t exp = (h >> 10) & 0x1fu;
+    uint32_t mant = h & 0x3ffu;
+
+    if (exp == 0x1f)   // infinity / NaN (made quiet, as vcvtph2ps does)
+        return bits_f32(sign | 0x7f800000u | (mant << 13) | (mant ? 0x00400000u : 0));
+    if (exp != 0)      // normal: rebias the exponent
+        return bits_f32(sign | ((exp + 112) << 23) | (mant << 13));
+    // zero / subnormal: mant * 2^-24 is exact in float
+    return bits_f32(sign | f32_bits((float)mant * 0x1p-24f));
+}
+
+static inline dynemit_f16_t
+f32_to_f16(float f)
+{
+    uint32_t x = f32_bits(f);
+    uint32_t sign = (x >> 16) & 0x8000u;
+    x &= 0x7fffffffu;
+
+    if (x >= 0x47800000u) {
+        // >= 65536: infinity, or a quiet NaN keeping the top payload bits
+        // like vcvtps2ph does
+        if (x > 0x7f800000u)
+            return (dynemit_f16_t)(sign | 0x7e00u | ((x >> 13) & 0x3ffu));
+        return (dynemit_f16_t)(sign | 0x7c00u);
+    }
+    if (x < 0x38800000u) {
+        // Below the smallest normal fp16: adding 0.5f lines the fp16
+        // subnormal bits up with the bottom of the float mantissa and lets
+        // the FPU round them to nearest-even
+        float t = bits_f32(x) + 0.5f;
+        return (dynemit_f16_t)(sign | (f32_bits(t) - 0x3f000000u));
+    }
+    // Normal: rebias and round to nearest-even on the 13 dropped bits;
+    // a carry out of the mantissa correctly bumps the exponent (up to inf)
+    uint32_t odd = (x >> 13) & 1u;
+    x += ((uint32_t)(15 - 127) << 23) + 0xfffu + odd;
+    return (dynemit_f16_t)(sign | (x >> 13));
+}
+
+static inline float
+bf16_to_f32(dynemit_bf16_t h)
+{
+    return bits_f32((uint32_t)h << 16);
+}
+
+static inline dynemit_bf16_t
+f32_to_bf16(float f)
+{
+    uint32_t x = f32_bits(f);
+    if ((x & 0x7fffffffu) > 0x7f800000u)   // NaN: truncate and force quiet
+        return (dynemit_bf16_t)((x >> 16) | 0x0040u);
+    x += 0x7fffu + ((x >> 16) & 1u);
+    return (dynemit_bf16_t)(x >> 16);
+}
+
+float dynemit_f16_to_f32(dynemit_f16_t h) { return f16_to_f32(h); }
+dynemit_f16_t dynemit_f32_to_f16(float f) { return f32_to_f16(f); }
+float dynemit_bf16_to_f32(dynemit_bf16_t h) { return bf16_to_f32(h); }
+dynemit_bf16_t dynemit_f32_to_bf16(float f) { return f32_to_bf16(f); }
+
+#define F16_ADD(x, y)     f32_to_f16(f16_to_f32(x) + f16_to_f32(y))
+#define F16_MUL(x, y)     f32_to_f16(f16_to_f32(x) * f16_to_f32(y))
+#define F16_ADD_F32(x, y) (f16_to_f32(x) + f16_to_f32(y))
+#define F16_MUL_F32(x, y) (f16_to_f32(x) * f16_to_f32(y))
+#define BF16_ADD(x, y)     f32_to_bf16(bf16_to_f32(x) + bf16_to_f32(y))
+#define BF16_MUL(x, y)     f32_to_bf16(bf16_to_f32(x) * bf16_to_f32(y))
+#define BF16_ADD_F32(x, y) (bf16_to_f32(x) + bf16_to_f32(y))
+#define BF16_MUL_F32(x, y) (bf16_to_f32(x) * bf16_to_f32(y))
+
+#if DYNEMIT_ARCH_X86
+
+// ===================================================
+// Vector loads/stores with conversion
+// ===================================================
+
+#define ROUND_NEAREST (_MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC)
+
+__attribute__((target("avx,f16c")))
+static inline __m256
+load_f16_f16c(const dynemit_f16_t *p)
+{
+    return _mm256_cvtph_ps(_mm_loadu_si128((const __m128i *)p));
+}
+
+__attribute__((target("avx,f16c")))
+static inline void
+store_f16_f16c(dynemit_f16_t *p, __m256 v)
+{
+    _mm_storeu_si128((__m128i *)p, _mm256_cvtps_ph(v, ROUND_NEAREST));
+}
+
+__attribute__((target("avx512f")))
+static inline __m512
+load_f16_avx512f(const dynemit_f16_t *p)
+{
+    return _mm512_cvtph_ps(_mm256_loadu_si256((const __m256i *)p));
+}
+
+__attribute__((target("avx512f")))
+static inline void
+store_f16_avx512f(dynemit_f16_t *p, __m512 v)
+{
+    _mm256_storeu_si256((__m256i *)p, _mm512_cvtps_ph(v, ROUND_NEAREST));
+}
+
+// AVX512-FP16 works on the 16-bit values directly, 32 lanes per vector
+#define LOAD_PH(p)          _mm512_loadu_ph((const void *)(p))
+#define STORE_PH(p, v)      _mm512_storeu_ph((void *)(p), (v))
+#define MASKLOAD_PH(p, m)   _mm512_castsi512_ph(_mm512_maskz_loadu_epi16((m), (p)))
+#define MASKSTORE_PH(p, m, v) _mm512_mask_storeu_epi16((p), (m), _mm512_castph_si512(v))
+
+// bf16 -> float is a 16-bit shift into the upper half of each lane
+__attribute__((target("sse2")))
+static inline __m128
+load_bf16_sse2(const dynemit_bf16_t *p)
+{
+    __m128i h = _mm_loadl_epi64((const __m128i *)p);
+    return _mm_castsi128_ps(_mm_unpacklo_epi16(_mm_setzero_si128(), h));
+}
+
+// float -> bf16 rounding to nearest-even on the low 16 bits, NaNs truncated
+// and made quiet; the bf16 ends up in the upper half of each 32-bit lane
+__attribute__((target("sse2")))
+static inline __m128i
+round_bf16_sse2(__m128 v)
+{
+    __m128i x = _mm_castps_si128(v);
+    __m128i odd = _mm_and_si128(_mm_srli_epi32(x, 16), _mm_set1_epi32(1));
+    __m128i r = _mm_add_epi32(x, _mm_add_epi32(_mm_set1_epi32(0x7fff), odd));
+    __m128i qnan = _mm_or_si128(x, _mm_set1_epi32(0x00400000));
+    __m128i is_nan = _mm_castps_si128(_mm_cmpunord_ps(v, v));
+    return _mm_or_si128(_mm_and_si128(is_nan, qnan), _mm_andnot_si128(is_nan, r));
+}
+
+__attribute__((target("sse2")))
+static inline void
+store_bf16_sse2(dynemit_bf16_t *p, __m128 v)
+{
+    // Arithmetic shift keeps every value in int16 range, so the signed
+    // saturating pack is exact
+    __m128i hi = _mm_srai_epi32(round_bf16_sse2(v), 16);
+    _mm_storel_epi64((__m128i *)p, _mm_packs_epi32(hi, hi));
+}
+
+__attribute__((target("avx2")))
+static inline __m256
+load_bf16_avx2(const dynemit_bf16_t *p)
+{
+    __m256i w = _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i *)p));
+    return _mm256_castsi256_ps(_mm256_slli_epi32(w, 16));
+}
+
+__attribute__((target("avx2")))
+static inline void
+store_bf16_avx2(dynemit_bf16_t *p, __m256 v)
+{
+    __m256i x = _mm256_castps_si256(v);
+    __m256i odd = _mm256_and_si256(_mm256_srli_epi32(x, 16), _mm256_set1_epi32(1));
+    __m256i r = _mm256_add_epi32(x, _mm256_add_epi32(_mm256_set1_epi32(0x7fff), odd));
+    __m256i qnan = _mm256_or_si256(x, _mm256_set1_epi32(0x00400000));
+    __m256i is_nan = _mm256_castps_si256(_mm256_cmp_ps(v, v, _CMP_UNORD_Q));
+    r = _mm256_srli_epi32(_mm256_blendv_epi8(r, qnan, is_nan), 16);
+    // The pack works per 128-bit lane; gather the two low quadwords
+    __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi32(r, r), _MM_SHUFFLE(3, 1, 2, 0));
+    _mm_storeu_si128((__m128i *)p, _mm256_castsi256_si128(packed));
+}
+
+__attribute__((target("avx512f")))
+static inline __m512
+load_bf16_avx512f(const dynemit_bf16_t *p)
+{
+    __m512i w = _mm512_cvtepu16_epi32(_mm256_loadu_si256((const __m256i *)p));
+    return _mm512_castsi512_ps(_mm512_slli_epi32(w, 16));
+}
+
+__attribute__((target("avx512f")))
+static inline void
+store_bf16_avx512f(dynemit_bf16_t *p, __m512 v)
+{
+    __m512i x = _mm512_castps_si512(v);
+    __m512i odd = _mm512_and_si512(_mm512_srli_epi32(x, 16), _mm512_set1_epi32(1));
+    __m512i r = _mm512_add_epi32(x, _mm512_add_epi32(_mm512_set1_epi32(0x7fff), odd));
+    __mmask16 is_nan = _mm512_cmp_ps_mask(v, v, _CMP_UNORD_Q);
+    r = _mm512_mask_mov_epi32(r, is_nan, _mm512_or_si512(x, _mm512_set1_epi32(0x00400000)));
+    _mm256_storeu_si256((__m256i *)p, _mm512_cvtepi32_epi16(_mm512_srli_epi32(r, 16)));
+}
+
+__attribute__((target("avx512f,avx512bf16")))
+static inline void
+store_bf16_avx512bf16(dynemit_bf16_t *p, __m512 v)
+{
+    _mm256_storeu_si256((__m256i *)p, (__m256i)_mm512_cvtneps_pbh(v));
+}
+
+// ===================================================
+// Element-wise kernels
+// ===================================================
+
+// fp16 in and out, or fp16 in and float out
+#define F16_BINARY_KERNELS(op, OP256, OP512, OP_PH, SCALAR_OP, SCALAR_OP_F32)                     \
+    DYNEMIT_BINARY_KERNEL_SCALAR(vector_##op##_f16, dynemit_f16_t, SCALAR_OP)                       \
+    DYNEMIT_BINARY_KERNEL(vector_##op##_f16, f16c, "avx,f16c", dynemit_f16_t, __m256, 8,            \
+                          load_f16_f16c, store_f16_f16c, OP256, SCALAR_OP)                          \
+    DYNEMIT_BINARY_KERNEL(vector_##op##_f16, avx512f, "avx512f", dynemit_f16_t, __m512, 16,         \
+                          load_f16_avx512f, store_f16_avx512f, OP512, SCALAR_OP)                    \
+    DYNEMIT_BINARY_KERNEL_MASKED(vector_##op##_f16, avx512fp16, "avx512f,avx512bw,avx512fp16",      \
+                                 dynemit_f16_t, __m512h, 32, LOAD_PH, STORE_PH, OP_PH,              \
+                                 __mmask32, DYNEMIT_MASK_EPI16_512, MASKLOAD_PH, MASKSTORE_PH)      \
+    DYNEMIT_BINARY_KERNEL_SCALAR_CVT(vector_##op##_f16_f32, dynemit_f16_t, float, SCALAR_OP_F32)    \
+    DYNEMIT_BINARY_KERNEL_CVT(vector_##op##_f16_f32, f16c, "avx,f16c", dynemit_f16_t, float,        \
+                              __m256, 8, load_f16_f16c, _mm256_storeu_ps, OP256, SCALAR_OP_F32)     \
+    DYNEMIT_BINARY_KERNEL_CVT(vector_##op##_f16_f32, avx512f, "avx512f", dynemit_f16_t, float,      \
+                              __m512, 16, load_f16_avx512f, _mm512_storeu_ps, OP512, SCALAR_OP_F32)
+
+F16_BINARY_KERNELS(add, _mm256_add_ps, _mm512_add_ps, _mm512_add_ph, F16_ADD, F16_ADD_F32)
+F16_BINARY_KERNELS(mul, _mm256_mul_ps, _mm512_mul_ps, _mm512_mul_ph, F16_MUL, F16_MUL_F32)
+
+// bf16 in and out, or bf16 in and float out
+#define BF16_BINARY_KERNELS(op, OP128, OP256, OP512, SCALAR_OP, SCALAR_OP_F32)                     \
+    DYNEMIT_BINARY_KERNEL_SCALAR(vector_##op##_bf16, dynemit_bf16_t, SCALAR_OP)                     \
+    DYNEMIT_BINARY_KERNEL(vector_##op##_bf16, sse2, "sse2", dynemit_bf16_t, __m128, 4,              \
+                          load_bf16_sse2, store_bf16_sse2, OP128, SCALAR_OP)                        \
+    DYNEMIT_BINARY_KERNEL(vector_##op##_bf16, avx2, "avx2", dynemit_bf16_t, __m256, 8,              \
+                          load_bf16_avx2, store_bf16_avx2, OP256, SCALAR_OP)                        \
+    DYNEMIT_BINARY_KERNEL(vector_##op##_bf16, avx512f, "avx512f", dynemit_bf16_t, __m512, 16,       \
+                          load_bf16_avx512f, store_bf16_avx512f, OP512, SCALAR_OP)                  \
+    DYNEMIT_BINARY_KERNEL(vector_##op##_bf16, avx512bf16, "avx512f,avx512bf16", dynemit_bf16_t,     \
+                          __m512, 16, load_bf16_avx512f, store_bf16_avx512bf16, OP512, SCALAR_OP)   \
+    DYNEMIT_BINARY_KERNEL_SCALAR_CVT(vector_##op##_bf16_f32, dynemit_bf16_t, float, SCALAR_OP_F32)  \
+    DYNEMIT_BINARY_KERNEL_CVT(vector_##op##_bf16_f32, sse2, "sse2", dynemit_bf16_t, float,          \
+                              __m128, 4, load_bf16_sse2, _mm_storeu_ps, OP128, SCALAR_OP_F32)       \
+    DYNEMIT_BINARY_KERNEL_CVT(vector_##op##_bf16_f32, avx2, "avx2", dynemit_bf16_t, float,          \
+                              __m256, 8, load_bf16_avx2, _mm256_storeu_ps, OP256, SCALAR_OP_F32)    \
+    DYNEMIT_BINARY_KERNEL_CVT(vector_##op##_bf16_f32, avx512f, "avx512f", dynemit_bf16_t, float,    \
+                              __m512, 16, load_bf16_avx512f, _mm512_storeu_ps, OP512, SCALAR_OP_F32)
+
+BF16_BINARY_KERNELS(add, _mm_add_ps, _mm256_add_ps, _mm512_add_ps, BF16_ADD, BF16_ADD_F32)
+BF16_BINARY_KERNELS(mul, _mm_mul_ps, _mm256_mul_ps, _mm512_mul_ps, BF16_MUL, BF16_MUL_F32)
+
+#else // aarch64 (NEON) or scalar only; see portable.h
+
+#if defined(__aarch64__)
+
+static inline float32x4_t
+load_f16_neon(const dynemit_f16_t *p)
+{
+    return vcvt_f32_f16(vreinterpret_f16_u16(vld1_u16(p)));
+}
+
+static inline void
+store_f16_neon(dynemit_f16_t *p, float32x4_t v)
+{
+    vst1_u16(p, vreinterpret_u16_f16(vcvt_f16_f32(v)));
+}
+
+static inline float32x4_t
+load_bf16_neon(const dynemit_bf16_t *p)
+{
+    return vreinterpretq_f32_u32(vshll_n_u16(vld1_u16(p), 16));
+}
+
+// Round to nearest-even on the dropped half; NaNs are truncated and made
+// quiet like f32_to_bf16()
+static inline void
+store_bf16_neon(dynemit_bf16_t *p, float32x4_t v)
+{
+    uint32x4_t x = vreinterpretq_u32_f32(v);
+    uint32x4_t odd = vandq_u32(vshrq_n_u32(x, 16), vdupq_n_u32(1));
+    uint32x4_t r = vaddq_u32(x, vaddq_u32(vdupq_n_u32(0x7fff), odd));
+    uint32x4_t is_num = vceqq_f32(v, v);
+    r = vbslq_u32(is_num, r, vorrq_u32(x, vdupq_n_u32(0x00400000)));
+    vst1_u16(p, vshrn_n_u32(r, 16));
+}
+
+#endif
+
+#define HALF_BINARY_KERNELS(op, T, LOAD, STORE, OP, SCALAR_OP, SCALAR_OP_F32)                    \
+    DYNEMIT_BINARY_KERNEL_SCALAR(vector_##op, T, SCALAR_OP)                                        \
+    DYNEMIT_NEON_BINARY_KERNEL(vector_##op, T, float32x4_t, 4, LOAD, STORE, OP, SCALAR_OP)         \
+    DYNEMIT_BINARY_KERNEL_SCALAR_CVT(vector_##op##_f32, T, float, SCALAR_OP_F32)                   \
+    DYNEMIT_NEON_BINARY_KERNEL_CVT(vector_##op##_f32, T, float, float32x4_t, 4,                    \
+                                   LOAD, vst1q_f32, OP, SCALAR_OP_F32)
+
+HALF_BINARY_KERNELS(add_f16, dynemit_f16_t, load_f16_neon, store_f16_neon, vaddq_f32,
+                    F16_ADD, F16_ADD_F32)
+HALF_BINARY_KERNELS(mul_f16, dynemit_f16_t, load_f16_neon, store_f16_neon, vmulq_f32,
+                    F16_MUL, F16_MUL_F32)
+HALF_BINARY_KERNELS(add_bf16, dynemit_bf16_t, load_bf16_neon, store_bf16_neon, vaddq_f32,
+                    BF16_ADD, BF16_ADD_F32)
+HALF_BINARY_KERNELS(mul_bf16, dynemit_bf16_t, load_bf16_neon, store_bf16_neon, vmulq_f32,
+                    BF16_MUL, BF16_MUL_F32)
+
+#endif // DYNEMIT_ARCH_X86
+
+// ===================================================
+// Dot products (float accumulation)
+// ===================================================
+
+// Scalar version - disable auto-vectorization to get true scalar code
+DYNEMIT_SCALAR_KERNEL_ATTRS
+static float
+dot_f16_scalar(const dynemit_f16_t *a, const dynemit_f16_t *b, size_t n)
+{
+    float s0 = 0.0f, s1 = 0.0f;
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        s0 += f16_to_f32(a[i]) * f16_to_f32(b[i]);
+        s1 += f16_to_f32(a[i + 1]) * f16_to_f32(b[i + 1]);
+    }
+    for (; i < n; i++)
+        s0 += f16_to_f32(a[i]) * f16_to_f32(b[i]);
+    return s0 + s1;
+}
+
+DYNEMIT_SCALAR_KERNEL_ATTRS
+static float
+dot_bf16_scalar(const dynemit_bf16_t *a, const dynemit_bf16_t *b, size_t n)
+{
+    float s0 = 0.0f, s1 = 0.0f;
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        s0 += bf16_to_f32(a[i]) * bf16_to_f32(b[i]);
+        s1 += bf16_to_f32(a[i + 1]) * bf16_to_f32(b[i + 1]);
+    }
+    for (; i < n; i++)
+        s0 += bf16_to_f32(a[i]) * bf16_to_f32(b[i]);
+    return s0 + s1;
+}
+
+#if DYNEMIT_ARCH_X86
+
+__attribute__((target("avx")))
+static inline float
+hsum_ps_avx(__m256 v)
+{
+    __m128 s = _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+    s = _mm_add_ps(s, _mm_movehl_ps(s, s));
+    s = _mm_add_ss(s, _mm_shuffle_ps(s, s, 1));
+    return _mm_cvtss_f32(s);
+}
+
+__attribute__((target("sse2")))
+static inline float
+hsum_ps_sse2(__m128 v)
+{
+    v = _mm_add_ps(v, _mm_movehl_ps(v, v));
+    v = _mm_add_ss(v, _mm_shuffle_ps(v, v, 1));
+    return _mm_cvtss_f32(v);
+}
+
+__attribute__((target("avx,f16c")))
+static float
+dot_f16_f16c(const dynemit_f16_t *a, const dynemit_f16_t *b, size_t n)
+{
+    __m256 acc0 = _mm256_setzero_ps(), acc1 = _mm256_setzero_ps();
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        acc0 = _mm256_add_ps(acc0, _mm256_mul_ps(load_f16_f16c(a + i), load_f16_f16c(b + i)));
+        acc1 = _mm256_add_ps(acc1, _mm256_mul_ps(load_f16_f16c(a + i + 8), load_f16_f16c(b + i + 8)));
+    }
+    if (i + 8 <= n) {
+        acc0 = _mm256_add_ps(acc0, _mm256_mul_ps(load_f16_f16c(a + i), load_f16_f16c(b + i)));
+        i += 8;
+    }
+    float s = hsum_ps_avx(_mm256_add_ps(acc0, acc1));
+    for (; i < n; i++)
+        s += f16_to_f32(a[i]) * f16_to_f32(b[i]);
+    return s;
+}
+
+__attribute__((target("avx,fma,f16c")))
+static float
+dot_f16_fma3(const dynemit_f16_t *a, const dynemit_f16_t *b, size_t n)
+{
+    __m256 acc0 = _mm256_setzero_ps(), acc1 = _mm256_setzero_ps();
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        acc0 = _mm256_fmadd_ps(load_f16_f16c(a + i), load_f16_f16c(b + i), acc0);
+        acc1 = _mm256_fmadd_ps(load_f16_f16c(a + i + 8), load_f16_f16c(b + i + 8), acc1);
+    }
+    if (i + 8 <= n) {
+        acc0 = _mm256_fmadd_ps(load_f16_f16c(a + i), load_f16_f16c(b + i), acc0);
+        i += 8;
+    }
+    float s = hsum_ps_avx(_mm256_add_ps(acc0, acc1));
+    for (; i < n; i++)
+        s += f16_to_f32(a[i]) * f16_to_f32(b[i]);
+    return s;
+}
+
+__attribute__((target("avx512f")))
+static float
+dot_f16_avx512f(const dynemit_f16_t *a, const dynemit_f16_t *b, size_t n)
+{
+    __m512 acc0 = _mm512_setzero_ps(), acc1 = _mm512_setzero_ps();
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        acc0 = _mm512_fmadd_ps(load_f16_avx512f(a + i), load_f16_avx512f(b + i), acc0);
+        acc1 = _mm512_fmadd_ps(load_f16_avx512f(a + i + 16), load_f16_avx512f(b + i + 16), acc1);
+    }
+    if (i + 16 <= n) {
+        acc0 = _mm512_fmadd_ps(load_f16_avx512f(a + i), load_f16_avx512f(b + i), acc0);
+        i += 16;
+    }
+    float s = _mm512_reduce_add_ps(_mm512_add_ps(acc0, acc1));
+    for (; i < n; i++)
+        s += f16_to_f32(a[i]) * f16_to_f32(b[i]);
+    return s;
+}
+
+__attribute__((target("sse2")))
+static float
+dot_bf16_sse2(const dynemit_bf16_t *a, const dynemit_bf16_t *b, size_t n)
+{
+    __m128 acc0 = _mm_setzero_ps(), acc1 = _mm_setzero_ps();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        acc0 = _mm_add_ps(acc0, _mm_mul_ps(load_bf16_sse2(a + i), load_bf16_sse2(b + i)));
+        acc1 = _mm_add_ps(acc1, _mm_mul_ps(load_bf16_sse2(a + i + 4), load_bf16_sse2(b + i + 4)));
+    }
+    float s = hsum_ps_sse2(_mm_add_ps(acc0, acc1));
+    for (; i < n; i++)
+        s += bf16_to_f32(a[i]) * bf16_to_f32(b[i]);
+    return s;
+}
+
+__attribute__((target("avx2,fma")))
+static float
+dot_bf16_avx2(const dynemit_bf16_t *a, const dynemit_bf16_t *b, size_t n)
+{
+    __m256 acc0 = _mm256_setzero_ps(), acc1 = _mm256_setzero_ps();
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        acc0 = _mm256_fmadd_ps(load_bf16_avx2(a + i), load_bf16_avx2(b + i), acc0);
+        acc1 = _mm256_fmadd_ps(load_bf16_avx2(a + i + 8), load_bf16_avx2(b + i + 8), acc1);
+    }
+    if (i + 8 <= n) {
+        acc0 = _mm256_fmadd_ps(load_bf16_avx2(a + i), load_bf16_avx2(b + i), acc0);
+        i += 8;
+    }
+    float s = hsum_ps_avx(_mm256_add_ps(acc0, acc1));
+    for (; i < n; i++)
+        s += bf16_to_f32(a[i]) * bf16_to_f32(b[i]);
+    return s;
+}
+
+__attribute__((target("avx512f")))
+static float
+dot_bf16_avx512f(const dynemit_bf16_t *a, const dynemit_bf16_t *b, size_t n)
+{
+    __m512 acc0 = _mm512_setzero_ps(), acc1 = _mm512_setzero_ps();
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        acc0 = _mm512_fmadd_ps(load_bf16_avx512f(a + i), load_bf16_avx512f(b + i), acc0);
+        acc1 = _mm512_fmadd_ps(load_bf16_avx512f(a + i + 16), load_bf16_avx512f(b + i + 16), acc1);
+    }
+    if (i + 16 <= n) {
+        acc0 = _mm512_fmadd_ps(load_bf16_avx512f(a + i), load_bf16_avx512f(b + i), acc0);
+        i += 16;
+    }
+    float s = _mm512_reduce_add_ps(_mm512_add_ps(acc0, acc1));
+    for (; i < n; i++)
+        s += bf16_to_f32(a[i]) * bf16_to_f32(b[i]);
+    return s;
+}
+
+// vdpbf16ps multiplies 32 bf16 pairs and adds adjacent products into 16
+// float lanes, without widening the inputs first
+__attribute__((target("avx512f,avx512bf16")))
+static float
+dot_bf16_avx512bf16(const dynemit_bf16_t *a, const dynemit_bf16_t *b, size_t n)
+{
+    __m512 acc0 = _mm512_setzero_ps(), acc1 = _mm512_setzero_ps();
+    size_t i = 0;
+    for (; i + 64 <= n; i += 64) {
+        acc0 = _mm512_dpbf16_ps(acc0, (__m512bh)_mm512_loadu_si512(a + i),
+                                (__m512bh)_mm512_loadu_si512(b + i));
+        acc1 = _mm512_dpbf16_ps(acc1, (__m512bh)_mm512_loadu_si512(a + i + 32),
+                                (__m512bh)_mm512_loadu_si512(b + i + 32));
+    }
+    if (i + 32 <= n) {
+        acc0 = _mm512_dpbf16_ps(acc0, (__m512bh)_mm512_loadu_si512(a + i),
+                                (__m512bh)_mm512_loadu_si512(b + i));
+        i += 32;
+    }
+    float s = _mm512_reduce_add_ps(_mm512_add_ps(acc0, acc1));
+    for (; i < n; i++)
+        s += bf16_to_f32(a[i]) * bf16_to_f32(b[i]);
+    return s;
+}
+
+#elif defined(__aarch64__)
+
+static float
+dot_f16_neon(const dynemit_f16_t *a, const dynemit_f16_t *b, size_t n)
+{
+    float32x4_t acc0 = vdupq_n_f32(0.0f), acc1 = acc0;
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        acc0 = vfmaq_f32(acc0, load_f16_neon(a + i), load_f16_neon(b + i));
+        acc1 = vfmaq_f32(acc1, load_f16_neon(a + i + 4), load_f16_neon(b + i + 4));
+    }
+    float s = vaddvq_f32(vaddq_f32(acc0, acc1));
+    for (; i < n; i++)
+        s += f16_to_f32(a[i]) * f16_to_f32(b[i]);
+    return s;
+}
+
+static float
+dot_bf16_neon(const dynemit_bf16_t *a, const dynemit_bf16_t *b, size_t n)
+{
+    float32x4_t acc0 = vdupq_n_f32(0.0f), acc1 = acc0;
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        acc0 = vfmaq_f32(acc0, load_bf16_neon(a + i), load_bf16_neon(b + i));
+        acc1 = vfmaq_f32(acc1, load_bf16_neon(a + i + 4), load_bf16_neon(b + i + 4));
+    }
+    float s = vaddvq_f32(vaddq_f32(acc0, acc1));
+    for (; i < n; i++)
+        s += bf16_to_f32(a[i]) * bf16_to_f32(b[i]);
+    return s;
+}
+
+#endif // DYNEMIT_ARCH_X86
+
+// ===================================================
+// Resolver functions for ifunc
+// ===================================================
+
+#if DYNEMIT_ARCH_X86
+
+// fp16: F16C needs VEX encoding, so below AVX everything is scalar.
+// f_avx512 is an expression, to pick the AVX512-FP16 kernel where it exists.
+#define F16_DISPATCH(name, TO, f_avx512)                                        \
+    typedef void (*name##_func_t)(const dynemit_f16_t *, const dynemit_f16_t *, \
+                                  TO *, size_t);                                \
+                                                                                \
+    static name##_func_t                                                        \
+    name##_select(simd_level_t level)                                           \
+    {                                                                           \
+        switch (level) {                                                        \
+        case SIMD_AVX512F: return f_avx512;                                     \
+        case SIMD_AVX2:                                                         \
+        case SIMD_AVX:                                                          \
+            if (dynemit_cpu_has(DYNEMIT_CPU_F16C))                              \
+                return name##_f16c;                                             \
+            return name##_scalar;                                               \
+        case SIMD_SSE4_2:                                                       \
+        case SIMD_SSE2:                                                         \
+        case SIMD_SCALAR:                                                       \
+        default:           return name##_scalar;                                \
+        }                                                                       \
+    }                                                                           \
+                                                                                \
+    DYNEMIT_DISPATCH(name, void,                                                \
+                     (const dynemit_f16_t *a, const dynemit_f16_t *b, TO *out, size_t n), \
+                     (a, b, out, n), n)
+
+#define HAS_FP16 dynemit_cpu_has(DYNEMIT_CPU_AVX512FP16 | DYNEMIT_CPU_AVX512BW)
+#define HAS_BF16 dynemit_cpu_has(DYNEMIT_CPU_AVX512BF16)
+
+F16_DISPATCH(vector_add_f16, dynemit_f16_t,
+             HAS_FP16 ? vector_add_f16_avx512fp16 : vector_add_f16_avx512f)
+F16_DISPATCH(vector_mul_f16, dynemit_f16_t,
+             HAS_FP16 ? vector_mul_f16_avx512fp16 : vector_mul_f16_avx512f)
+F16_DISPATCH(vector_add_f16_f32, float, vector_add_f16_f32_avx512f)
+F16_DISPATCH(vector_mul_f16_f32, float, vector_mul_f16_f32_avx512f)
+
+// bf16: AVX has no 256-bit integer shifts, so it shares the SSE2 kernel
+#define BF16_DISPATCH(name, TO, f_avx512)                                       \
+    typedef void (*name##_func_t)(const dynemit_bf16_t *, const dynemit_bf16_t *, \
+                                  TO *, size_t);                                \
+                                                                                \
+    static name##_func_t                                                        \
+    name##_select(simd_level_t level)                                           \
+    {                                                                           \
+        switch (level) {                                                        \
+        case SIMD_AVX512F: return f_avx512;                                     \
+        case SIMD_AVX2:    return name##_avx2;                                  \
+        case SIMD_AVX:                                                          \
+        case SIMD_SSE4_2:                                                       \
+        case SIMD_SSE2:    return name##_sse2;                                  \
+        case SIMD_SCALAR:                                                       \
+        default:           return name##_scalar;                                \
+        }                                                                       \
+    }                                                                           \
+                                                                                \
+    DYNEMIT_DISPATCH(name, void,                                                \
+                     (const dynemit_bf16_t *a, const dynemit_bf16_t *b, TO *out, size_t n), \
+                     (a, b, out, n), n)
+
+BF16_DISPATCH(vector_add_bf16, dynemit_bf16_t,
+              HAS_BF16 ? vector_add_bf16_avx512bf16 : vector_add_bf16_avx512f)
+BF16_DISPATCH(vector_mul_bf16, dynemit_bf16_t,
+              HAS_BF16 ? vector_mul_bf16_avx512bf16 : vector_mul_bf16_avx512f)
+BF16_DISPATCH(vector_add_bf16_f32, float, vector_add_bf16_f32_avx512f)
+BF16_DISPATCH(vector_mul_bf16_f32, float, vector_mul_bf16_f32_avx512f)
+
+typedef float (*dot_f16_func_t)(const dynemit_f16_t *, const dynemit_f16_t *, size_t);
+typedef float (*dot_bf16_func_t)(const dynemit_bf16_t *, const dynemit_bf16_t *, size_t);
+
+static dot_f16_func_t
+dot_f16_select(simd_level_t level)
+{
+    switch (level) {
+    case SIMD_AVX512F: return dot_f16_avx512f;
+    case SIMD_AVX2:
+    case SIMD_AVX:
+        if (!dynemit_cpu_has(DYNEMIT_CPU_F16C))
+            return dot_f16_scalar;
+        return dynemit_cpu_has(DYNEMIT_CPU_FMA) ? dot_f16_fma3 : dot_f16_f16c;
+    case SIMD_SSE4_2:
+    case SIMD_SSE2:
+    case SIMD_SCALAR:
+    default:           return dot_f16_scalar;
+    }
+}
+
+DYNEMIT_DISPATCH(dot_f16, float, (const dynemit_f16_t *a, const dynemit_f16_t *b, size_t n),
+                 (a, b, n), n)
+
+static dot_bf16_func_t
+dot_bf16_select(simd_level_t level)
+{
+    switch (level) {
+    case SIMD_AVX512F: return HAS_BF16 ? dot_bf16_avx512bf16 : dot_bf16_avx512f;
+    case SIMD_AVX2:    return dynemit_cpu_has(DYNEMIT_CPU_FMA) ? dot_bf16_avx2 : dot_bf16_sse2;
+    case SIMD_AVX:
+    case SIMD_SSE4_2:
+    case SIMD_SSE2:    return dot_bf16_sse2;
+    case SIMD_SCALAR:
+    default:           return dot_bf16_scalar;
+    }
+}
+
+DYNEMIT_DISPATCH(dot_bf16, float, (const dynemit_bf16_t *a, const dynemit_bf16_t *b, size_t n),
+                 (a, b, n), n)
+
+#else // aarch64 (NEON) or scalar only
+
+// The NEON kernels serve the SVE levels too; the widening loads and
+// narrowing stores would not get any faster in a scalable register
+#define HALF_DISPATCH(name, ret, params, args)                                  \
+    typedef ret (*name##_func_t) params;                                        \
+                                                                                \
+    static name##_func_t                                                        \
+    name##_select(simd_level_t level)                                           \
+    {                                                                           \
+        switch (level) {                                                        \
+        case SIMD_SVE2:                                                         \
+        case SIMD_SVE:                                                          \
+        case SIMD_NEON:    return DYNEMIT_NEON_KERNEL(name);                    \
+        case SIMD_SCALAR:                                                       \
+        default:           return name##_scalar;                                \
+        }                                                                       \
+    }                                                                           \
+                                                                                \
+    DYNEMIT_DISPATCH(name, ret, params, args, n)
+
+#define HALF_BINARY_DISPATCH(name, TI, TO)                                      \
+    HALF_DISPATCH(name, void, (const TI *a, const TI *b, TO *out, size_t n),   \
+                  (a, b, out, n))
+
+HALF_BINARY_DISPATCH(vector_add_f16, dynemit_f16_t, dynemit_f16_t)
+HALF_BINARY_DISPATCH(vector_mul_f16, dynemit_f16_t, dynemit_f16_t)
+HALF_BINARY_DISPATCH(vector_add_f16_f32, dynemit_f16_t, float)
+HALF_BINARY_DISPATCH(vector_mul_f16_f32, dynemit_f16_t, float)
+HALF_BINARY_DISPATCH(vector_add_bf16, dynemit_bf16_t, dynemit_bf16_t)
+HALF_BINARY_DISPATCH(vector_mul_bf16, dynemit_bf16_t, dynemit_bf16_t)
+HALF_BINARY_DISPATCH(vector_add_bf16_f32, dynemit_bf16_t, float)
+HALF_BINARY_DISPATCH(vector_mul_bf16_f32, dynemit_bf16_t, float)
+
+HALF_DISPATCH(dot_f16, float,
+              (const dynemit_f16_t *a, const dynemit_f16_t *b, size_t n), (a, b, n))
+HALF_DISPATCH(dot_bf16, float,
+              (const dynemit_bf16_t *a, const dynemit_bf16_t *b, size_t n), (a, b, n))
+
+#endif
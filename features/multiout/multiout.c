@@ -0,0 +1,455 @@
+/* SPDX-License-Identifier: BSL-1.0 */
+#include <stddef.h>
+#include <stdint.h>
+#include <dynemit/core.h>
+#include <dynemit/multiout.h>
+#include "../common/elementwise.h"
+
+// Kernels that produce several results from one read of their inputs.
+// Each step loads a vector of a and b once and derives every output from
+// it, so at DRAM sizes a call moves two input streams instead of the four
+// (or, with a separate reduction, three passes) it replaces.
+//
+// vector_mul_reduce_f32 adds the rounded products into the same four
+// accumulators, in the same order, as sum_f32 at that level, and fp-contract
+// is off so the compiler cannot fuse the multiply into the add: the returned
+// sum is bit-identical to sum_f32(out, n) on x86 and at the NEON level. Like
+// sum_f32, SSE4.2 and AVX2 add nothing here and share the SSE2 and AVX
+// kernels. SVE and RVV have no kernels of their own; those levels use NEON
+// and scalar.
+//
+// Outputs of at least dynemit_stream_threshold() bytes in total are written
+// with non-temporal stores when they are vector-aligned and none of them is
+// also an input; the kernels do not peel, which would change the summation
+// order above.
+
+// One vector of each output at offset off from i
+#define ADDSUB_STEP(LOAD, ADD, SUB, STORE, off)                                 \
+    do {                                                                        \
+        __typeof__(LOAD(a)) x_ = LOAD(a + i + (off)), y_ = LOAD(b + i + (off)); \
+        STORE(sum_out + i + (off), ADD(x_, y_));                                \
+        STORE(diff_out + i + (off), SUB(x_, y_));                               \
+    } while (0)
+
+#define MUL_REDUCE_STEP(LOAD, MUL, ADD, STORE, acc, off)                        \
+    do {                                                                        \
+        __typeof__(acc) p_ = MUL(LOAD(a + i + (off)), LOAD(b + i + (off)));     \
+        STORE(out + i + (off), p_);                                             \
+        acc = ADD(acc, p_);                                                     \
+    } while (0)
+
+// Whether outputs of bytes in total, at addresses whose low bits are in
+// addr_bits, take the non-temporal path for vectors of align bytes
+static inline int
+stream_outputs(uintptr_t addr_bits, size_t align, size_t bytes)
+{
+    return (addr_bits & (align - 1)) == 0 && bytes >= dynemit_stream_threshold();
+}
+
+// ===================================================
+// vector_addsub_f32: sum_out = a + b, diff_out = a - b
+// ===================================================
+
+DYNEMIT_SCALAR_KERNEL_ATTRS
+static void
+vector_addsub_f32_scalar(const float *a, const float *b, float *sum_out, float *diff_out, size_t n)
+{
+    for (size_t i = 0; i < n; i++) {
+        float x = a[i], y = b[i];
+        sum_out[i] = x + y;
+        diff_out[i] = x - y;
+    }
+}
+
+#if DYNEMIT_ARCH_X86
+
+#define ADDSUB_APART (sum_out != a && sum_out != b && diff_out != a && diff_out != b)
+
+__attribute__((target("sse2")))
+static void
+vector_addsub_f32_sse2(const float *a, const float *b, float *sum_out, float *diff_out, size_t n)
+{
+    size_t i = 0;
+    int stream = ADDSUB_APART &&
+                 stream_outputs((uintptr_t)sum_out | (uintptr_t)diff_out, 16, 2 * n * sizeof(float));
+    if (stream) {
+        for (; i + 16 <= n; i += 16) {
+            ADDSUB_STEP(_mm_loadu_ps, _mm_add_ps, _mm_sub_ps, _mm_stream_ps, 0);
+            ADDSUB_STEP(_mm_loadu_ps, _mm_add_ps, _mm_sub_ps, _mm_stream_ps, 4);
+            ADDSUB_STEP(_mm_loadu_ps, _mm_add_ps, _mm_sub_ps, _mm_stream_ps, 8);
+            ADDSUB_STEP(_mm_loadu_ps, _mm_add_ps, _mm_sub_ps, _mm_stream_ps, 12);
+        }
+        _mm_sfence();
+    }
+    for (; i + 16 <= n; i += 16) {
+        ADDSUB_STEP(_mm_loadu_ps, _mm_add_ps, _mm_sub_ps, _mm_storeu_ps, 0);
+        ADDSUB_STEP(_mm_loadu_ps, _mm_add_ps, _mm_sub_ps, _mm_storeu_ps, 4);
+        ADDSUB_STEP(_mm_loadu_ps, _mm_add_ps, _mm_sub_ps, _mm_storeu_ps, 8);
+        ADDSUB_STEP(_mm_loadu_ps, _mm_add_ps, _mm_sub_ps, _mm_storeu_ps, 12);
+    }
+    for (; i + 4 <= n; i += 4)
+        ADDSUB_STEP(_mm_loadu_ps, _mm_add_ps, _mm_sub_ps, _mm_storeu_ps, 0);
+    for (; i < n; i++) {
+        float x = a[i], y = b[i];
+        sum_out[i] = x + y;
+        diff_out[i] = x - y;
+    }
+}
+
+__attribute__((target("avx")))
+static void
+vector_addsub_f32_avx(const float *a, const float *b, float *sum_out, float *diff_out, size_t n)
+{
+    size_t i = 0;
+    int stream = ADDSUB_APART &&
+                 stream_outputs((uintptr_t)sum_out | (uintptr_t)diff_out, 32, 2 * n * sizeof(float));
+    if (stream) {
+        for (; i + 32 <= n; i += 32) {
+            ADDSUB_STEP(_mm256_loadu_ps, _mm256_add_ps, _mm256_sub_ps, _mm256_stream_ps, 0);
+            ADDSUB_STEP(_mm256_loadu_ps, _mm256_add_ps, _mm256_sub_ps, _mm256_stream_ps, 8);
+            ADDSUB_STEP(_mm256_loadu_ps, _mm256_add_ps, _mm256_sub_ps, _mm256_stream_ps, 16);
+            ADDSUB_STEP(_mm256_loadu_ps, _mm256_add_ps, _mm256_sub_ps, _mm256_stream_ps, 24);
+        }
+        _mm_sfence();
+    }
+    for (; i + 32 <= n; i += 32) {
+        ADDSUB_STEP(_mm256_loadu_ps, _mm256_add_ps, _mm256_sub_ps, _mm256_storeu_ps, 0);
+        ADDSUB_STEP(_mm256_loadu_ps, _mm256_add_ps, _mm256_sub_ps, _mm256_storeu_ps, 8);
+        ADDSUB_STEP(_mm256_loadu_ps, _mm256_add_ps, _mm256_sub_ps, _mm256_storeu_ps, 16);
+        ADDSUB_STEP(_mm256_loadu_ps, _mm256_add_ps, _mm256_sub_ps, _mm256_storeu_ps, 24);
+    }
+    for (; i + 8 <= n; i += 8)
+        ADDSUB_STEP(_mm256_loadu_ps, _mm256_add_ps, _mm256_sub_ps, _mm256_storeu_ps, 0);
+    if (i < n) {
+        __m256i m = dynemit_mask8(n - i);
+        __m256 x = _mm256_maskload_ps(a + i, m), y = _mm256_maskload_ps(b + i, m);
+        _mm256_maskstore_ps(sum_out + i, m, _mm256_add_ps(x, y));
+        _mm256_maskstore_ps(diff_out + i, m, _mm256_sub_ps(x, y));
+    }
+}
+
+__attribute__((target("avx512f")))
+static void
+vector_addsub_f32_avx512f(const float *a, const float *b, float *sum_out, float *diff_out, size_t n)
+{
+    size_t i = 0;
+    int stream = ADDSUB_APART &&
+                 stream_outputs((uintptr_t)sum_out | (uintptr_t)diff_out, 64, 2 * n * sizeof(float));
+    if (stream) {
+        for (; i + 64 <= n; i += 64) {
+            ADDSUB_STEP(_mm512_loadu_ps, _mm512_add_ps, _mm512_sub_ps, _mm512_stream_ps, 0);
+            ADDSUB_STEP(_mm512_loadu_ps, _mm512_add_ps, _mm512_sub_ps, _mm512_stream_ps, 16);
+            ADDSUB_STEP(_mm512_loadu_ps, _mm512_add_ps, _mm512_sub_ps, _mm512_stream_ps, 32);
+            ADDSUB_STEP(_mm512_loadu_ps, _mm512_add_ps, _mm512_sub_ps, _mm512_stream_ps, 48);
+        }
+        _mm_sfence();
+    }
+    for (; i + 64 <= n; i += 64) {
+        ADDSUB_STEP(_mm512_loadu_ps, _mm512_add_ps, _mm512_sub_ps, _mm512_storeu_ps, 0);
+        ADDSUB_STEP(_mm512_loadu_ps, _mm512_add_ps, _mm512_sub_ps, _mm512_storeu_ps, 16);
+        ADDSUB_STEP(_mm512_loadu_ps, _mm512_add_ps, _mm512_sub_ps, _mm512_storeu_ps, 32);
+        ADDSUB_STEP(_mm512_loadu_ps, _mm512_add_ps, _mm512_sub_ps, _mm512_storeu_ps, 48);
+    }
+    for (; i + 16 <= n; i += 16)
+        ADDSUB_STEP(_mm512_loadu_ps, _mm512_add_ps, _mm512_sub_ps, _mm512_storeu_ps, 0);
+    if (i < n) {
+        __mmask16 m = dynemit_mask16(n - i);
+        __m512 x = _mm512_maskz_loadu_ps(m, a + i), y = _mm512_maskz_loadu_ps(m, b + i);
+        _mm512_mask_storeu_ps(sum_out + i, m, _mm512_add_ps(x, y));
+        _mm512_mask_storeu_ps(diff_out + i, m, _mm512_sub_ps(x, y));
+    }
+}
+
+#endif // DYNEMIT_ARCH_X86
+
+// ===================================================
+// vector_mul_reduce_f32: out = a * b, returns sum(out)
+// ===================================================
+
+// Mirrors sum_f32_scalar over the products
+DYNEMIT_SCALAR_KERNEL_ATTRS
+__attribute__((optimize("fp-contract=off")))
+static float
+vector_mul_reduce_f32_scalar(const float *a, const float *b, float *out, size_t n)
+{
+    float s0 = 0.0f, s1 = 0.0f, s2 = 0.0f, s3 = 0.0f;
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        float p0 = a[i + 0] * b[i + 0], p1 = a[i + 1] * b[i + 1];
+        float p2 = a[i + 2] * b[i + 2], p3 = a[i + 3] * b[i + 3];
+        out[i + 0] = p0;
+        out[i + 1] = p1;
+        out[i + 2] = p2;
+        out[i + 3] = p3;
+        s0 += p0;
+        s1 += p1;
+        s2 += p2;
+        s3 += p3;
+    }
+    for (; i < n; i++) {
+        float p = a[i] * b[i];
+        out[i] = p;
+        s0 += p;
+    }
+    return (s0 + s1) + (s2 + s3);
+}
+
+#if DYNEMIT_ARCH_X86
+
+#define MUL_REDUCE_APART (out != a && out != b)
+
+// The horizontal sums of reduce.c, so the lanes combine in the same order
+__attribute__((target("sse2")))
+static inline float
+hsum_ps_sse2(__m128 v)
+{
+    __m128 shuf = _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1));
+    __m128 sums = _mm_add_ps(v, shuf);
+    shuf = _mm_movehl_ps(shuf, sums);
+    sums = _mm_add_ss(sums, shuf);
+    return _mm_cvtss_f32(sums);
+}
+
+__attribute__((target("avx")))
+static inline float
+hsum_ps_avx(__m256 v)
+{
+    __m128 lo = _mm256_castps256_ps128(v);
+    __m128 hi = _mm256_extractf128_ps(v, 1);
+    return hsum_ps_sse2(_mm_add_ps(lo, hi));
+}
+
+__attribute__((target("sse2")))
+__attribute__((optimize("fp-contract=off")))
+static float
+vector_mul_reduce_f32_sse2(const float *a, const float *b, float *out, size_t n)
+{
+    __m128 acc0 = _mm_setzero_ps(), acc1 = _mm_setzero_ps();
+    __m128 acc2 = _mm_setzero_ps(), acc3 = _mm_setzero_ps();
+    size_t i = 0;
+    int stream = MUL_REDUCE_APART && stream_outputs((uintptr_t)out, 16, n * sizeof(float));
+    if (stream) {
+        for (; i + 16 <= n; i += 16) {
+            MUL_REDUCE_STEP(_mm_loadu_ps, _mm_mul_ps, _mm_add_ps, _mm_stream_ps, acc0, 0);
+            MUL_REDUCE_STEP(_mm_loadu_ps, _mm_mul_ps, _mm_add_ps, _mm_stream_ps, acc1, 4);
+            MUL_REDUCE_STEP(_mm_loadu_ps, _mm_mul_ps, _mm_add_ps, _mm_stream_ps, acc2, 8);
+            MUL_REDUCE_STEP(_mm_loadu_ps, _mm_mul_ps, _mm_add_ps, _mm_stream_ps, acc3, 12);
+        }
+        _mm_sfence();
+    }
+    for (; i + 16 <= n; i += 16) {
+        MUL_REDUCE_STEP(_mm_loadu_ps, _mm_mul_ps, _mm_add_ps, _mm_storeu_ps, acc0, 0);
+        MUL_REDUCE_STEP(_mm_loadu_ps, _mm_mul_ps, _mm_add_ps, _mm_storeu_ps, acc1, 4);
+        MUL_REDUCE_STEP(_mm_loadu_ps, _mm_mul_ps, _mm_add_ps, _mm_storeu_ps, acc2, 8);
+        MUL_REDUCE_STEP(_mm_loadu_ps, _mm_mul_ps, _mm_add_ps, _mm_storeu_ps, acc3, 12);
+    }
+    for (; i + 4 <= n; i += 4)
+        MUL_REDUCE_STEP(_mm_loadu_ps, _mm_mul_ps, _mm_add_ps, _mm_storeu_ps, acc0, 0);
+    float s = hsum_ps_sse2(_mm_add_ps(_mm_add_ps(acc0, acc1), _mm_add_ps(acc2, acc3)));
+    for (; i < n; i++) {
+        float p = a[i] * b[i];
+        out[i] = p;
+        s += p;
+    }
+    return s;
+}
+
+__attribute__((target("avx")))
+__attribute__((optimize("fp-contract=off")))
+static float
+vector_mul_reduce_f32_avx(const float *a, const float *b, float *out, size_t n)
+{
+    __m256 acc0 = _mm256_setzero_ps(), acc1 = _mm256_setzero_ps();
+    __m256 acc2 = _mm256_setzero_ps(), acc3 = _mm256_setzero_ps();
+    size_t i = 0;
+    int stream = MUL_REDUCE_APART && stream_outputs((uintptr_t)out, 32, n * sizeof(float));
+    if (stream) {
+        for (; i + 32 <= n; i += 32) {
+            MUL_REDUCE_STEP(_mm256_loadu_ps, _mm256_mul_ps, _mm256_add_ps, _mm256_stream_ps, acc0, 0);
+            MUL_REDUCE_STEP(_mm256_loadu_ps, _mm256_mul_ps, _mm256_add_ps, _mm256_stream_ps, acc1, 8);
+            MUL_REDUCE_STEP(_mm256_loadu_ps, _mm256_mul_ps, _mm256_add_ps, _mm256_stream_ps, acc2, 16);
+            MUL_REDUCE_STEP(_mm256_loadu_ps, _mm256_mul_ps, _mm256_add_ps, _mm256_stream_ps, acc3, 24);
+        }
+        _mm_sfence();
+    }
+    for (; i + 32 <= n; i += 32) {
+        MUL_REDUCE_STEP(_mm256_loadu_ps, _mm256_mul_ps, _mm256_add_ps, _mm256_storeu_ps, acc0, 0);
+        MUL_REDUCE_STEP(_mm256_loadu_ps, _mm256_mul_ps, _mm256_add_ps, _mm256_storeu_ps, acc1, 8);
+        MUL_REDUCE_STEP(_mm256_loadu_ps, _mm256_mul_ps, _mm256_add_ps, _mm256_storeu_ps, acc2, 16);
+        MUL_REDUCE_STEP(_mm256_loadu_ps, _mm256_mul_ps, _mm256_add_ps, _mm256_storeu_ps, acc3, 24);
+    }
+    for (; i + 8 <= n; i += 8)
+        MUL_REDUCE_STEP(_mm256_loadu_ps, _mm256_mul_ps, _mm256_add_ps, _mm256_storeu_ps, acc0, 0);
+    if (i < n) {
+        // Masked-off lanes load as zero and contribute nothing
+        __m256i m = dynemit_mask8(n - i);
+        __m256 p = _mm256_mul_ps(_mm256_maskload_ps(a + i, m), _mm256_maskload_ps(b + i, m));
+        _mm256_maskstore_ps(out + i, m, p);
+        acc1 = _mm256_add_ps(acc1, p);
+    }
+    return hsum_ps_avx(_mm256_add_ps(_mm256_add_ps(acc0, acc1), _mm256_add_ps(acc2, acc3)));
+}
+
+__attribute__((target("avx512f")))
+__attribute__((optimize("fp-contract=off")))
+static float
+vector_mul_reduce_f32_avx512f(const float *a, const float *b, float *out, size_t n)
+{
+    __m512 acc0 = _mm512_setzero_ps(), acc1 = _mm512_setzero_ps();
+    __m512 acc2 = _mm512_setzero_ps(), acc3 = _mm512_setzero_ps();
+    size_t i = 0;
+    int stream = MUL_REDUCE_APART && stream_outputs((uintptr_t)out, 64, n * sizeof(float));
+    if (stream) {
+        for (; i + 64 <= n; i += 64) {
+            MUL_REDUCE_STEP(_mm512_loadu_ps, _mm512_mul_ps, _mm512_add_ps, _mm512_stream_ps, acc0, 0);
+            MUL_REDUCE_STEP(_mm512_loadu_ps, _mm512_mul_ps, _mm512_add_ps, _mm512_stream_ps, acc1, 16);
+            MUL_REDUCE_STEP(_mm512_loadu_ps, _mm512_mul_ps, _mm512_add_ps, _mm512_stream_ps, acc2, 32);
+            MUL_REDUCE_STEP(_mm512_loadu_ps, _mm512_mul_ps, _mm512_add_ps, _mm512_stream_ps, acc3, 48);
+        }
+        _mm_sfence();
+    }
+    for (; i + 64 <= n; i += 64) {
+        MUL_REDUCE_STEP(_mm512_loadu_ps, _mm512_mul_ps, _mm512_add_ps, _mm512_storeu_ps, acc0, 0);
+        MUL_REDUCE_STEP(_mm512_loadu_ps, _mm512_mul_ps, _mm512_add_ps, _mm512_storeu_ps, acc1, 16);
+        MUL_REDUCE_STEP(_mm512_loadu_ps, _mm512_mul_ps, _mm512_add_ps, _mm512_storeu_ps, acc2, 32);
+        MUL_REDUCE_STEP(_mm512_loadu_ps, _mm512_mul_ps, _mm512_add_ps, _mm512_storeu_ps, acc3, 48);
+    }
+    for (; i + 16 <= n; i += 16)
+        MUL_REDUCE_STEP(_mm512_loadu_ps, _mm512_mul_ps, _mm512_add_ps, _mm512_storeu_ps, acc0, 0);
+    if (i < n) {
+        __mmask16 m = dynemit_mask16(n - i);
+        __m512 p = _mm512_mul_ps(_mm512_maskz_loadu_ps(m, a + i), _mm512_maskz_loadu_ps(m, b + i));
+        _mm512_mask_storeu_ps(out + i, m, p);
+        acc1 = _mm512_add_ps(acc1, p);
+    }
+    return _mm512_reduce_add_ps(_mm512_add_ps(_mm512_add_ps(acc0, acc1), _mm512_add_ps(acc2, acc3)));
+}
+
+#endif // DYNEMIT_ARCH_X86
+
+// ===================================================
+// aarch64: one NEON kernel for every ARM level
+// ===================================================
+
+#if defined(__aarch64__)
+
+static void
+vector_addsub_f32_neon(const float *a, const float *b, float *sum_out, float *diff_out, size_t n)
+{
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        ADDSUB_STEP(vld1q_f32, vaddq_f32, vsubq_f32, vst1q_f32, 0);
+        ADDSUB_STEP(vld1q_f32, vaddq_f32, vsubq_f32, vst1q_f32, 4);
+        ADDSUB_STEP(vld1q_f32, vaddq_f32, vsubq_f32, vst1q_f32, 8);
+        ADDSUB_STEP(vld1q_f32, vaddq_f32, vsubq_f32, vst1q_f32, 12);
+    }
+    for (; i + 4 <= n; i += 4)
+        ADDSUB_STEP(vld1q_f32, vaddq_f32, vsubq_f32, vst1q_f32, 0);
+    for (; i < n; i++) {
+        float x = a[i], y = b[i];
+        sum_out[i] = x + y;
+        diff_out[i] = x - y;
+    }
+}
+
+// Mirrors sum_f32_neon over the products
+__attribute__((optimize("fp-contract=off")))
+static float
+vector_mul_reduce_f32_neon(const float *a, const float *b, float *out, size_t n)
+{
+    float32x4_t acc0 = vdupq_n_f32(0.0f), acc1 = acc0, acc2 = acc0, acc3 = acc0;
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        MUL_REDUCE_STEP(vld1q_f32, vmulq_f32, vaddq_f32, vst1q_f32, acc0, 0);
+        MUL_REDUCE_STEP(vld1q_f32, vmulq_f32, vaddq_f32, vst1q_f32, acc1, 4);
+        MUL_REDUCE_STEP(vld1q_f32, vmulq_f32, vaddq_f32, vst1q_f32, acc2, 8);
+        MUL_REDUCE_STEP(vld1q_f32, vmulq_f32, vaddq_f32, vst1q_f32, acc3, 12);
+    }
+    for (; i + 4 <= n; i += 4)
+        MUL_REDUCE_STEP(vld1q_f32, vmulq_f32, vaddq_f32, vst1q_f32, acc0, 0);
+    float s = vaddvq_f32(vaddq_f32(vaddq_f32(acc0, acc1), vaddq_f32(acc2, acc3)));
+    for (; i < n; i++) {
+        float p = a[i] * b[i];
+        out[i] = p;
+        s += p;
+    }
+    return s;
+}
+
+#endif // __aarch64__
+
+// ===================================================
+// Selectors and dispatch
+// ===================================================
+
+typedef void (*addsub_f32_func_t)(const float *, const float *, float *, float *, size_t);
+typedef float (*mul_reduce_f32_func_t)(const float *, const float *, float *, size_t);
+
+#if DYNEMIT_ARCH_X86
+
+static addsub_f32_func_t
+vector_addsub_f32_select(simd_level_t level)
+{
+    switch (level) {
+    case SIMD_AVX512F: return vector_addsub_f32_avx512f;
+    case SIMD_AVX2:
+    case SIMD_AVX:     return vector_addsub_f32_avx;
+    case SIMD_SSE4_2:
+    case SIMD_SSE2:    return vector_addsub_f32_sse2;
+    case SIMD_SCALAR:
+    default:           return vector_addsub_f32_scalar;
+    }
+}
+
+static mul_reduce_f32_func_t
+vector_mul_reduce_f32_select(simd_level_t level)
+{
+    switch (level) {
+    case SIMD_AVX512F: return vector_mul_reduce_f32_avx512f;
+    case SIMD_AVX2:
+    case SIMD_AVX:     return vector_mul_reduce_f32_avx;
+    case SIMD_SSE4_2:
+    case SIMD_SSE2:    return vector_mul_reduce_f32_sse2;
+    case SIMD_SCALAR:
+    default:           return vector_mul_reduce_f32_scalar;
+    }
+}
+
+#elif defined(__aarch64__)
+
+static addsub_f32_func_t
+vector_addsub_f32_select(simd_level_t level)
+{
+    return level == SIMD_SCALAR ? vector_addsub_f32_scalar : vector_addsub_f32_neon;
+}
+
+static mul_reduce_f32_func_t
+vector_mul_reduce_f32_select(simd_level_t level)
+{
+    return level == SIMD_SCALAR ? vector_mul_reduce_f32_scalar : vector_mul_reduce_f32_neon;
+}
+
+#else // RISC-V and others: scalar at every level
+
+static addsub_f32_func_t
+vector_addsub_f32_select(simd_level_t level)
+{
+    (void)level;
+    return vector_addsub_f32_scalar;
+}
+
+static mul_reduce_f32_func_t
+vector_mul_reduce_f32_select(simd_level_t level)
+{
+    (void)level;
+    return vector_mul_reduce_f32_scalar;
+}
+
+#endif
+
+DYNEMIT_DISPATCH(vector_addsub_f32, void,
+                 (const float *a, const float *b, float *sum_out, float *diff_out, size_t n),
+                 (a, b, sum_out, diff_out, n), n)
+
+DYNEMIT_DISPATCH(vector_mul_reduce_f32, float, (const float *a, const float *b, float *out, size_t n),
+                 (a, b, out, n), n)
@@ -0,0 +1,498 @@
+/* SPDX-License-Identifier: BSL-1.0 */
+#define _GNU_SOURCE
+#include <pthread.h>
+#include <sched.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include <unistd.h>
+#include <dynemit/core.h>
+#include <dynemit/parallel.h>
+#include <dynemit/vector_add.h>
+#include <dynemit/vector_fma.h>
+#include <dynemit/vector_mul.h>
+#include <dynemit/vector_sub.h>
+
+struct dynemit_threadpool {
+    pthread_mutex_t lock;
+    pthread_cond_t  work_cv;      // workers wait here for a new generation
+    pthread_cond_t  done_cv;      // caller waits here for pending == 0
+    pthread_mutex_t submit_lock;  // serializes concurrent callers
+
+    size_t     size;              // participants including the caller
+    pthread_t *workers;           // size - 1 threads
+    size_t     started;           // workers successfully created
+
+    uint64_t   generation;        // bumped once per job
+    int        shutdown;
+    size_t     pending;           // workers still running the current job
+
+    // Current job, valid while pending > 0
+    dynemit_range_fn fn;
+    void      *ctx;
+    size_t     n;
+    size_t     chunk;
+    size_t    *assign;            // chunk run by each participant
+
+    size_t     threshold;
+
+    // NUMA placement, used only on machines with more than one node
+    int        numa;
+    int       *node;              // node of each participant's CPU, -1 unknown
+    int       *chunk_node;        // node holding each chunk's data
+    const void **probe;           // one sample address per chunk
+    unsigned char *taken;
+};
+
+struct worker_arg {
+    dynemit_threadpool *pool;
+    size_t index;                 // 1..size-1, chunk 0 belongs to the caller
+    int    cpu;                   // CPU to pin to, or -1
+};
+
+static void
+run_chunk(dynemit_threadpool *pool, size_t index)
+{
+    size_t begin = pool->assign[index] * pool->chunk;
+    if (begin >= pool->n)
+        return;
+    size_t end = begin + pool->chunk;
+    if (end > pool->n)
+        end = pool->n;
+    pool->fn(pool->ctx, begin, end);
+}
+
+static void *
+worker_main(void *p)
+{
+    struct worker_arg arg = *(struct worker_arg *)p;
+    free(p);
+    dynemit_threadpool *pool = arg.pool;
+
+    if (arg.cpu >= 0) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(arg.cpu, &set);
+        // Best effort: an unpinned worker is still correct
+        (void)pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+    }
+
+    uint64_t seen = 0;
+    pthread_mutex_lock(&pool->lock);
+    for (;;) {
+        while (!pool->shutdown && pool->generation == seen)
+            pthread_cond_wait(&pool->work_cv, &pool->lock);
+        if (pool->shutdown)
+            break;
+        seen = pool->generation;
+        pthread_mutex_unlock(&pool->lock);
+
+        run_chunk(pool, arg.index);
+
+        pthread_mutex_lock(&pool->lock);
+        if (--pool->pending == 0)
+            pthread_cond_signal(&pool->done_cv);
+    }
+    pthread_mutex_unlock(&pool->lock);
+    return nullptr;
+}
+
+// CPUs in the process affinity mask, in ascending order
+static size_t
+allowed_cpus(int *cpus, size_t max)
+{
+    cpu_set_t set;
+    size_t count = 0;
+    if (sched_getaffinity(0, sizeof(set), &set) != 0)
+        return 0;
+    for (int cpu = 0; cpu < CPU_SETSIZE && count < max; cpu++)
+        if (CPU_ISSET(cpu, &set))
+            cpus[count++] = cpu;
+    return count;
+}
+
+/*
+ * Reorder cpus so that it starts with one CPU per physical core, the lowest
+ * of each, followed by the remaining SMT siblings, both in ascending order.
+ * Workers pinned in this order fill every core before any core gets a
+ * second thread, however the siblings are numbered (0/1 on Alder Lake,
+ * 0/N on most servers). CPUs of unknown core count as a core each.
+ * Returns the number of cores, or 0 if no CPU's core is known.
+ */
+static size_t
+order_by_core(int *cpus, size_t ncpus)
+{
+    unsigned char used[CPU_SETSIZE] = { 0 };
+    int siblings[CPU_SETSIZE];
+    size_t cores = 0, nsiblings = 0, known = 0;
+
+    for (size_t i = 0; i < ncpus; i++) {
+        int core = dynemit_core_of_cpu(cpus[i]);
+        if (core >= 0)
+            known++;
+        if (core >= 0 && used[core]) {
+            siblings[nsiblings++] = cpus[i];
+        } else {
+            if (core >= 0)
+                used[core] = 1;
+            cpus[cores++] = cpus[i];
+        }
+    }
+    for (size_t i = 0; i < nsiblings; i++)
+        cpus[cores + i] = siblings[i];
+    return known ? cores : 0;
+}
+
+static size_t
+threshold_from_env(void)
+{
+    const char *env = getenv("DYNEMIT_MT_THRESHOLD");
+    if (env && *env) {
+        char *end;
+        unsigned long long v = strtoull(env, &end, 10);
+        if (*end == '\0')
+            return (size_t)v;
+    }
+    return DYNEMIT_MT_DEFAULT_THRESHOLD;
+}
+
+dynemit_threadpool *
+dynemit_threadpool_create(size_t num_threads)
+{
+    int cpus[CPU_SETSIZE];
+    size_t ncpus = allowed_cpus(cpus, CPU_SETSIZE);
+    size_t cores = order_by_core(cpus, ncpus);
+
+    // Memory-bound kernels gain nothing from SMT siblings: one thread per
+    // physical core of the affinity mask by default
+    if (num_threads == 0) {
+        if (!cores)
+            cores = dynemit_cpu_topology()->physical_cores;
+        num_threads = ncpus ? ncpus : 1;
+        if (cores && cores < num_threads)
+            num_threads = cores;
+    }
+
+    dynemit_threadpool *pool = calloc(1, sizeof(*pool));
+    if (!pool)
+        return nullptr;
+
+    pool->size = num_threads;
+    pool->threshold = threshold_from_env();
+    pool->numa = dynemit_cpu_topology()->numa_nodes > 1;
+    pthread_mutex_init(&pool->lock, nullptr);
+    pthread_mutex_init(&pool->submit_lock, nullptr);
+    pthread_cond_init(&pool->work_cv, nullptr);
+    pthread_cond_init(&pool->done_cv, nullptr);
+
+    pool->assign = calloc(num_threads, sizeof(*pool->assign));
+    pool->node = calloc(num_threads, sizeof(*pool->node));
+    pool->chunk_node = calloc(num_threads, sizeof(*pool->chunk_node));
+    pool->probe = calloc(num_threads, sizeof(*pool->probe));
+    pool->taken = calloc(num_threads, sizeof(*pool->taken));
+    if (num_threads > 1)
+        pool->workers = calloc(num_threads - 1, sizeof(pthread_t));
+    if (!pool->assign || !pool->node || !pool->chunk_node || !pool->probe || !pool->taken ||
+        (num_threads > 1 && !pool->workers)) {
+        dynemit_threadpool_destroy(pool);
+        return nullptr;
+    }
+    pool->node[0] = -1;
+
+    for (size_t i = 1; i < num_threads; i++) {
+        struct worker_arg *arg = malloc(sizeof(*arg));
+        if (!arg) {
+            dynemit_threadpool_destroy(pool);
+            return nullptr;
+        }
+        arg->pool = pool;
+        arg->index = i;
+        // Leave the first CPU to the caller, which runs chunk 0, also when
+        // there are more workers than CPUs and the order wraps around
+        arg->cpu = ncpus > 1 ? cpus[1 + (i - 1) % (ncpus - 1)] : -1;
+        pool->node[i] = dynemit_numa_node_of_cpu(arg->cpu);
+
+        if (pthread_create(&pool->workers[i - 1], nullptr, worker_main, arg) != 0) {
+            free(arg);
+            dynemit_threadpool_destroy(pool);
+            return nullptr;
+        }
+        pool->started++;
+    }
+
+    return pool;
+}
+
+void
+dynemit_threadpool_destroy(dynemit_threadpool *pool)
+{
+    if (!pool)
+        return;
+
+    pthread_mutex_lock(&pool->lock);
+    pool->shutdown = 1;
+    pthread_cond_broadcast(&pool->work_cv);
+    pthread_mutex_unlock(&pool->lock);
+
+    for (size_t i = 0; i < pool->started; i++)
+        pthread_join(pool->workers[i], nullptr);
+
+    pthread_cond_destroy(&pool->done_cv);
+    pthread_cond_destroy(&pool->work_cv);
+    pthread_mutex_destroy(&pool->submit_lock);
+    pthread_mutex_destroy(&pool->lock);
+    free(pool->workers);
+    free(pool->taken);
+    free(pool->probe);
+    free(pool->chunk_node);
+    free(pool->node);
+    free(pool->assign);
+    free(pool);
+}
+
+size_t
+dynemit_threadpool_size(const dynemit_threadpool *pool)
+{
+    return pool ? pool->size : 1;
+}
+
+void
+dynemit_threadpool_set_threshold(dynemit_threadpool *pool, size_t min_elements)
+{
+    if (pool)
+        pool->threshold = min_elements;
+}
+
+size_t
+dynemit_threadpool_threshold(const dynemit_threadpool *pool)
+{
+    return pool ? pool->threshold : DYNEMIT_MT_DEFAULT_THRESHOLD;
+}
+
+/*
+ * Give each participant the chunk whose data already sits on its node.
+ * One page per chunk is sampled, at the chunk's middle; chunks on a node
+ * no participant runs on, or not faulted in yet, fill the remaining
+ * participants in order.
+ */
+static void
+place_chunks(dynemit_threadpool *pool, const char *data, size_t elem)
+{
+    size_t size = pool->size;
+    for (size_t c = 0; c < size; c++) {
+        size_t begin = c * pool->chunk;
+        size_t end = begin + pool->chunk < pool->n ? begin + pool->chunk : pool->n;
+        pool->probe[c] = data + (begin < end ? begin + (end - begin) / 2 : 0) * elem;
+        pool->taken[c] = 0;
+        pool->assign[c] = SIZE_MAX;
+    }
+    if (dynemit_page_nodes(pool->probe, size, pool->chunk_node) != 0) {
+        for (size_t c = 0; c < size; c++)
+            pool->assign[c] = c;
+        return;
+    }
+
+    int cpu = sched_getcpu();
+    pool->node[0] = cpu >= 0 ? dynemit_numa_node_of_cpu(cpu) : -1;
+
+    for (size_t c = 0; c < size; c++) {
+        if (c * pool->chunk >= pool->n || pool->chunk_node[c] < 0)
+            continue;
+        for (size_t t = 0; t < size; t++) {
+            if (pool->assign[t] == SIZE_MAX && pool->node[t] == pool->chunk_node[c]) {
+                pool->assign[t] = c;
+                pool->taken[c] = 1;
+                break;
+            }
+        }
+    }
+    size_t next = 0;
+    for (size_t t = 0; t < size; t++) {
+        if (pool->assign[t] != SIZE_MAX)
+            continue;
+        while (pool->taken[next])
+            next++;
+        pool->assign[t] = next;
+        pool->taken[next] = 1;
+    }
+}
+
+// data, when given, is the array element 0 of the index space refers to;
+// elem is its element size in bytes
+static void
+parallel_run(dynemit_threadpool *pool, size_t n, size_t grain, dynemit_range_fn fn, void *ctx,
+             const void *data, size_t elem)
+{
+    if (n == 0)
+        return;
+    if (!pool || pool->size <= 1) {
+        fn(ctx, 0, n);
+        return;
+    }
+    if (grain == 0)
+        grain = 1;
+
+    // Even split, rounded up to the grain so interior boundaries line up
+    size_t chunk = (n + pool->size - 1) / pool->size;
+    chunk = (chunk + grain - 1) / grain * grain;
+
+    pthread_mutex_lock(&pool->submit_lock);
+
+    pthread_mutex_lock(&pool->lock);
+    pool->fn = fn;
+    pool->ctx = ctx;
+    pool->n = n;
+    pool->chunk = chunk;
+    if (pool->numa && data) {
+        place_chunks(pool, data, elem);
+    } else {
+        for (size_t i = 0; i < pool->size; i++)
+            pool->assign[i] = i;
+    }
+    pool->pending = pool->size - 1;
+    pool->generation++;
+    pthread_cond_broadcast(&pool->work_cv);
+    pthread_mutex_unlock(&pool->lock);
+
+    run_chunk(pool, 0);
+
+    pthread_mutex_lock(&pool->lock);
+    while (pool->pending > 0)
+        pthread_cond_wait(&pool->done_cv, &pool->lock);
+    pthread_mutex_unlock(&pool->lock);
+
+    pthread_mutex_unlock(&pool->submit_lock);
+}
+
+void
+dynemit_threadpool_parallel_for(dynemit_threadpool *pool, size_t n, size_t grain,
+                                dynemit_range_fn fn, void *ctx)
+{
+    parallel_run(pool, n, grain, fn, ctx, nullptr, 0);
+}
+
+// ===================================================
+// First touch
+// ===================================================
+
+struct touch_job {
+    char  *p;
+    size_t page;
+};
+
+// A write fault on the first byte of every page backs the page on the
+// toucher's node; reading and storing back each byte keeps the contents
+static void
+touch_range(void *ctx, size_t begin, size_t end)
+{
+    const struct touch_job *job = ctx;
+    for (size_t off = begin; off < end; off = (off / job->page + 1) * job->page) {
+        volatile char *c = job->p + off;
+        *c = *c;
+    }
+}
+
+void
+dynemit_first_touch(dynemit_threadpool *pool, void *p, size_t bytes)
+{
+    struct touch_job job = { p, (size_t)sysconf(_SC_PAGESIZE) };
+    parallel_run(pool, bytes, DYNEMIT_MT_CHUNK_ALIGN, touch_range, &job, nullptr, 0);
+}
+
+// ===================================================
+// Multithreaded element-wise kernels
+// ===================================================
+
+typedef void (*binary_f32_func_t)(const float *, const float *, float *, size_t);
+
+struct binary_job {
+    binary_f32_func_t kernel;
+    const float *a;
+    const float *b;
+    const float *c;
+    float *out;
+    size_t skew;  // elements between the previous 64-byte boundary and out
+    size_t n;
+};
+
+// Ranges are computed in a shifted index space starting at the cache line
+// that contains out[0], so every interior boundary is 64-byte aligned in the
+// output and no two threads ever write to the same cache line
+static void
+job_range(const struct binary_job *job, size_t begin, size_t end, size_t *first, size_t *count)
+{
+    begin = begin > job->skew ? begin - job->skew : 0;
+    end -= job->skew;
+    *first = begin;
+    *count = end > begin ? end - begin : 0;
+}
+
+static void
+binary_range(void *ctx, size_t begin, size_t end)
+{
+    const struct binary_job *job = ctx;
+    size_t i, len;
+    job_range(job, begin, end, &i, &len);
+    if (len)
+        job->kernel(job->a + i, job->b + i, job->out + i, len);
+}
+
+static void
+fma_range(void *ctx, size_t begin, size_t end)
+{
+    const struct binary_job *job = ctx;
+    size_t i, len;
+    job_range(job, begin, end, &i, &len);
+    if (len)
+        vector_fma_f32(job->a + i, job->b + i, job->c + i, job->out + i, len);
+}
+
+static void
+run_elementwise(dynemit_threadpool *pool, struct binary_job *job, dynemit_range_fn fn)
+{
+    const size_t line = DYNEMIT_MT_CHUNK_ALIGN / sizeof(float);
+    job->skew = ((uintptr_t)job->out / sizeof(float)) % line;
+    parallel_run(pool, job->n + job->skew, line, fn, job, job->out - job->skew, sizeof(float));
+}
+
+static void
+binary_mt(dynemit_threadpool *pool, binary_f32_func_t kernel,
+          const float *a, const float *b, float *out, size_t n)
+{
+    if (!pool || pool->size <= 1 || n < pool->threshold) {
+        kernel(a, b, out, n);
+        return;
+    }
+    struct binary_job job = { kernel, a, b, nullptr, out, 0, n };
+    run_elementwise(pool, &job, binary_range);
+}
+
+void
+vector_add_f32_mt(dynemit_threadpool *pool, const float *a, const float *b, float *out, size_t n)
+{
+    binary_mt(pool, vector_add_f32, a, b, out, n);
+}
+
+void
+vector_sub_f32_mt(dynemit_threadpool *pool, const float *a, const float *b, float *out, size_t n)
+{
+    binary_mt(pool, vector_sub_f32, a, b, out, n);
+}
+
+void
+vector_mul_f32_mt(dynemit_threadpool *pool, const float *a, const float *b, float *out, size_t n)
+{
+    binary_mt(pool, vector_mul_f32, a, b, out, n);
+}
+
+void
+vector_fma_f32_mt(dynemit_threadpool *pool, const float *a, const float *b, const float *c,
+                  float *out, size_t n)
+{
+    if (!pool || pool->size <= 1 || n < pool->threshold) {
+        vector_fma_f32(a, b, c, out, n);
+        return;
+    }
+    struct binary_job job = { nullptr, a, b, c, out, 0, n };
+    run_elementwise(pool, &job, fma_range);
+}
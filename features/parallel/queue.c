@@ -0,0 +1,340 @@
+/* SPDX-License-Identifier: BSL-1.0 */
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include <dynemit/parallel.h>
+#include <dynemit/queue.h>
+
+// Most small operations taken off the ready list per wake-up
+#define QUEUE_BATCH 64
+
+struct future_edge {
+    dynemit_future     *waiter;    // operation this edge holds back
+    struct future_edge *next;      // next dependent of the same future
+};
+
+struct future_callback {
+    void (*fn)(void *user);
+    void *user;
+    struct future_callback *next;
+};
+
+struct dynemit_future {
+    dynemit_queue  *queue;
+    dynemit_op_t    op;
+    dynemit_op_args args;          // after is not kept
+
+    atomic_int      refs;          // the caller's and the queue's
+    atomic_int      done;
+
+    // Guarded by queue->lock
+    size_t          deps_left;
+    struct future_edge     *dependents;
+    struct future_callback *callbacks, *last_callback;
+    dynemit_future *next;          // ready list
+
+    struct future_edge edges[];    // one per entry of after
+};
+
+struct dynemit_queue {
+    pthread_mutex_t lock;
+    pthread_cond_t  work_cv;       // queue thread waits here for ready ops
+    pthread_cond_t  done_cv;       // broadcast after every completed batch
+
+    dynemit_threadpool *pool;
+    pthread_t       thread;
+    int             shutdown;
+
+    dynemit_future *ready, *ready_tail;
+    size_t          outstanding;   // submitted, callbacks not returned yet
+};
+
+static int
+is_elementwise(dynemit_op_t op)
+{
+    return op != DYNEMIT_OP_CALL;
+}
+
+// Large operations split themselves over the pool; small ones run on
+// whichever thread picked them up
+static void
+run_op(dynemit_future *f, dynemit_threadpool *pool)
+{
+    const dynemit_op_args *x = &f->args;
+    switch (f->op) {
+    case DYNEMIT_OP_ADD_F32: vector_add_f32_mt(pool, x->a, x->b, x->out, x->n); break;
+    case DYNEMIT_OP_SUB_F32: vector_sub_f32_mt(pool, x->a, x->b, x->out, x->n); break;
+    case DYNEMIT_OP_MUL_F32: vector_mul_f32_mt(pool, x->a, x->b, x->out, x->n); break;
+    case DYNEMIT_OP_FMA_F32: vector_fma_f32_mt(pool, x->a, x->b, x->c, x->out, x->n); break;
+    case DYNEMIT_OP_CALL:    x->fn(x->ctx); break;
+    }
+}
+
+static void
+batch_range(void *ctx, size_t begin, size_t end)
+{
+    dynemit_future **batch = ctx;
+    for (size_t i = begin; i < end; i++)
+        run_op(batch[i], nullptr);
+}
+
+static void
+future_unref(dynemit_future *f)
+{
+    if (atomic_fetch_sub_explicit(&f->refs, 1, memory_order_acq_rel) != 1)
+        return;
+    struct future_callback *cb = f->callbacks;
+    while (cb) {
+        struct future_callback *next = cb->next;
+        free(cb);
+        cb = next;
+    }
+    free(f);
+}
+
+static void
+push_ready(dynemit_queue *q, dynemit_future *f)
+{
+    f->next = nullptr;
+    if (q->ready_tail)
+        q->ready_tail->next = f;
+    else
+        q->ready = f;
+    q->ready_tail = f;
+}
+
+/*
+ * Take the next batch off the ready list: either one large or
+ * DYNEMIT_OP_CALL operation on its own, or a run of up to QUEUE_BATCH
+ * small element-wise ones. Called with the lock held.
+ */
+static size_t
+take_batch(dynemit_queue *q, dynemit_future **batch, size_t *elements)
+{
+    size_t threshold = dynemit_threadpool_threshold(q->pool);
+    size_t count = 0;
+    *elements = 0;
+
+    while (q->ready && count < QUEUE_BATCH) {
+        dynemit_future *f = q->ready;
+        int small = is_elementwise(f->op) && f->args.n < threshold;
+        if (count > 0 && !small)
+            break;
+        q->ready = f->next;
+        batch[count++] = f;
+        *elements += f->args.n;
+        if (!small)
+            break;
+    }
+    if (!q->ready)
+        q->ready_tail = nullptr;
+    return count;
+}
+
+static void *
+queue_main(void *p)
+{
+    dynemit_queue *q = p;
+    dynemit_future *batch[QUEUE_BATCH];
+
+    pthread_mutex_lock(&q->lock);
+    for (;;) {
+        while (!q->ready && !(q->shutdown && q->outstanding == 0))
+            pthread_cond_wait(&q->work_cv, &q->lock);
+        if (!q->ready)
+            break;
+
+        size_t elements;
+        size_t count = take_batch(q, batch, &elements);
+        pthread_mutex_unlock(&q->lock);
+
+        if (count == 1)
+            run_op(batch[0], q->pool);
+        else if (elements >= dynemit_threadpool_threshold(q->pool))
+            dynemit_threadpool_parallel_for(q->pool, count, 1, batch_range, batch);
+        else
+            batch_range(batch, 0, count);
+
+        // Completion: release dependents and detach the callbacks under the
+        // lock, run the callbacks outside it
+        struct future_callback *callbacks[QUEUE_BATCH];
+        pthread_mutex_lock(&q->lock);
+        for (size_t i = 0; i < count; i++) {
+            dynemit_future *f = batch[i];
+            for (struct future_edge *e = f->dependents; e; e = e->next)
+                if (--e->waiter->deps_left == 0)
+                    push_ready(q, e->waiter);
+            callbacks[i] = f->callbacks;
+            f->dependents = nullptr;
+            atomic_store_explicit(&f->done, 1, memory_order_release);
+        }
+        pthread_cond_broadcast(&q->done_cv);
+        pthread_mutex_unlock(&q->lock);
+
+        for (size_t i = 0; i < count; i++) {
+            for (struct future_callback *cb = callbacks[i]; cb; cb = cb->next)
+                cb->fn(cb->user);
+            future_unref(batch[i]);
+        }
+
+        // Only now are the operations off the queue's books, so wait_all()
+        // and destroy() also wait for the callbacks
+        pthread_mutex_lock(&q->lock);
+        q->outstanding -= count;
+        if (q->outstanding == 0)
+            pthread_cond_broadcast(&q->done_cv);
+    }
+    pthread_mutex_unlock(&q->lock);
+    return nullptr;
+}
+
+dynemit_queue *
+dynemit_queue_create(dynemit_threadpool *pool)
+{
+    dynemit_queue *q = calloc(1, sizeof(*q));
+    if (!q)
+        return nullptr;
+
+    q->pool = pool;
+    pthread_mutex_init(&q->lock, nullptr);
+    pthread_cond_init(&q->work_cv, nullptr);
+    pthread_cond_init(&q->done_cv, nullptr);
+
+    if (pthread_create(&q->thread, nullptr, queue_main, q) != 0) {
+        pthread_cond_destroy(&q->done_cv);
+        pthread_cond_destroy(&q->work_cv);
+        pthread_mutex_destroy(&q->lock);
+        free(q);
+        return nullptr;
+    }
+    return q;
+}
+
+void
+dynemit_queue_destroy(dynemit_queue *q)
+{
+    if (!q)
+        return;
+
+    // Every dependency points at an earlier submission, so the queue always
+    // drains and the thread exits once outstanding reaches zero
+    pthread_mutex_lock(&q->lock);
+    q->shutdown = 1;
+    pthread_cond_signal(&q->work_cv);
+    pthread_mutex_unlock(&q->lock);
+    pthread_join(q->thread, nullptr);
+
+    pthread_cond_destroy(&q->done_cv);
+    pthread_cond_destroy(&q->work_cv);
+    pthread_mutex_destroy(&q->lock);
+    free(q);
+}
+
+dynemit_future *
+dynemit_queue_submit(dynemit_queue *q, dynemit_op_t op, const dynemit_op_args *args)
+{
+    if (!q || !args || (unsigned)op > DYNEMIT_OP_CALL || (op == DYNEMIT_OP_CALL && !args->fn))
+        return nullptr;
+    for (size_t i = 0; i < args->num_after; i++)
+        if (!args->after[i] || args->after[i]->queue != q)
+            return nullptr;
+
+    dynemit_future *f = calloc(1, sizeof(*f) + args->num_after * sizeof(struct future_edge));
+    if (!f)
+        return nullptr;
+    f->queue = q;
+    f->op = op;
+    f->args = *args;
+    f->args.after = nullptr;
+    f->args.num_after = 0;
+    atomic_init(&f->refs, 2);
+    atomic_init(&f->done, 0);
+
+    pthread_mutex_lock(&q->lock);
+    for (size_t i = 0; i < args->num_after; i++) {
+        dynemit_future *dep = args->after[i];
+        if (atomic_load_explicit(&dep->done, memory_order_relaxed))
+            continue;
+        f->edges[i].waiter = f;
+        f->edges[i].next = dep->dependents;
+        dep->dependents = &f->edges[i];
+        f->deps_left++;
+    }
+    q->outstanding++;
+    if (f->deps_left == 0) {
+        push_ready(q, f);
+        pthread_cond_signal(&q->work_cv);
+    }
+    pthread_mutex_unlock(&q->lock);
+    return f;
+}
+
+void
+dynemit_queue_wait_all(dynemit_queue *q)
+{
+    if (!q)
+        return;
+    pthread_mutex_lock(&q->lock);
+    while (q->outstanding > 0)
+        pthread_cond_wait(&q->done_cv, &q->lock);
+    pthread_mutex_unlock(&q->lock);
+}
+
+int
+dynemit_future_done(const dynemit_future *f)
+{
+    return f ? atomic_load_explicit(&f->done, memory_order_acquire) : 1;
+}
+
+void
+dynemit_future_wait(dynemit_future *f)
+{
+    // A completed future may outlive its queue, so it must not touch it
+    if (dynemit_future_done(f))
+        return;
+    dynemit_queue *q = f->queue;
+    pthread_mutex_lock(&q->lock);
+    while (!atomic_load_explicit(&f->done, memory_order_acquire))
+        pthread_cond_wait(&q->done_cv, &q->lock);
+    pthread_mutex_unlock(&q->lock);
+}
+
+int
+dynemit_future_then(dynemit_future *f, void (*fn)(void *user), void *user)
+{
+    if (dynemit_future_done(f))
+        return 1;
+
+    struct future_callback *cb = malloc(sizeof(*cb));
+    if (!cb)
+        return -1;
+    cb->fn = fn;
+    cb->user = user;
+    cb->next = nullptr;
+
+    dynemit_queue *q = f->queue;
+    pthread_mutex_lock(&q->lock);
+    int done = atomic_load_explicit(&f->done, memory_order_acquire);
+    if (!done) {
+        if (f->last_callback)
+            f->last_callback->next = cb;
+        else
+            f->callbacks = cb;
+        f->last_callback = cb;
+    }
+    pthread_mutex_unlock(&q->lock);
+
+    if (done) {
+        free(cb);
+        return 1;
+    }
+    return 0;
+}
+
+void
+dynemit_future_release(dynemit_future *f)
+{
+    if (f)
+        future_unref(f);
+}
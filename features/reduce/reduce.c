@@ -0,0 +1,992 @@
+/* SPDX-License-Identifier: BSL-1.0 */
+#include <math.h>
+#include <stddef.h>
+#include <dynemit/core.h>
+#include <dynemit/reduce.h>
+#include "../common/elementwise.h"
+
+// Reductions are latency-bound, not throughput-bound: a single accumulator
+// serializes every add/FMA on its 4-cycle latency. The fast kernels below keep
+// four independent accumulators per SIMD level so the adds can overlap, and
+// only combine them once at the end.
+//
+// SSE4.2 and AVX2 add nothing for float reductions, so those levels share the
+// SSE2 and AVX/FMA3 kernels respectively.
+
+#if DYNEMIT_ARCH_X86
+
+// ===================================================
+// Horizontal helpers
+// ===================================================
+
+__attribute__((target("sse2")))
+static inline float
+hsum_ps_sse2(__m128 v)
+{
+    __m128 shuf = _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1));
+    __m128 sums = _mm_add_ps(v, shuf);
+    shuf = _mm_movehl_ps(shuf, sums);
+    sums = _mm_add_ss(sums, shuf);
+    return _mm_cvtss_f32(sums);
+}
+
+__attribute__((target("sse2")))
+static inline float
+hmin_ps_sse2(__m128 v)
+{
+    v = _mm_min_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1)));
+    v = _mm_min_ps(v, _mm_movehl_ps(v, v));
+    return _mm_cvtss_f32(v);
+}
+
+__attribute__((target("sse2")))
+static inline float
+hmax_ps_sse2(__m128 v)
+{
+    v = _mm_max_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1)));
+    v = _mm_max_ps(v, _mm_movehl_ps(v, v));
+    return _mm_cvtss_f32(v);
+}
+
+__attribute__((target("avx")))
+static inline float
+hsum_ps_avx(__m256 v)
+{
+    __m128 lo = _mm256_castps256_ps128(v);
+    __m128 hi = _mm256_extractf128_ps(v, 1);
+    return hsum_ps_sse2(_mm_add_ps(lo, hi));
+}
+
+#endif // DYNEMIT_ARCH_X86
+
+// ===================================================
+// dot_f32: sum(a[i] * b[i])
+// ===================================================
+
+// Scalar version - disable auto-vectorization to get true scalar code
+DYNEMIT_SCALAR_KERNEL_ATTRS
+static float
+dot_f32_scalar(const float *a, const float *b, size_t n)
+{
+    float s0 = 0.0f, s1 = 0.0f, s2 = 0.0f, s3 = 0.0f;
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        s0 += a[i + 0] * b[i + 0];
+        s1 += a[i + 1] * b[i + 1];
+        s2 += a[i + 2] * b[i + 2];
+        s3 += a[i + 3] * b[i + 3];
+    }
+    for (; i < n; i++)
+        s0 += a[i] * b[i];
+    return (s0 + s1) + (s2 + s3);
+}
+
+#if DYNEMIT_ARCH_X86
+
+__attribute__((target("sse2")))
+static float
+dot_f32_sse2(const float *a, const float *b, size_t n)
+{
+    __m128 acc0 = _mm_setzero_ps(), acc1 = _mm_setzero_ps();
+    __m128 acc2 = _mm_setzero_ps(), acc3 = _mm_setzero_ps();
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(a + i + 0),  _mm_loadu_ps(b + i + 0)));
+        acc1 = _mm_add_ps(acc1, _mm_mul_ps(_mm_loadu_ps(a + i + 4),  _mm_loadu_ps(b + i + 4)));
+        acc2 = _mm_add_ps(acc2, _mm_mul_ps(_mm_loadu_ps(a + i + 8),  _mm_loadu_ps(b + i + 8)));
+        acc3 = _mm_add_ps(acc3, _mm_mul_ps(_mm_loadu_ps(a + i + 12), _mm_loadu_ps(b + i + 12)));
+    }
+    for (; i + 4 <= n; i += 4)
+        acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+    float s = hsum_ps_sse2(_mm_add_ps(_mm_add_ps(acc0, acc1), _mm_add_ps(acc2, acc3)));
+    for (; i < n; i++)
+        s += a[i] * b[i];
+    return s;
+}
+
+__attribute__((target("avx")))
+static float
+dot_f32_avx(const float *a, const float *b, size_t n)
+{
+    __m256 acc0 = _mm256_setzero_ps(), acc1 = _mm256_setzero_ps();
+    __m256 acc2 = _mm256_setzero_ps(), acc3 = _mm256_setzero_ps();
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        acc0 = _mm256_add_ps(acc0, _mm256_mul_ps(_mm256_loadu_ps(a + i + 0),  _mm256_loadu_ps(b + i + 0)));
+        acc1 = _mm256_add_ps(acc1, _mm256_mul_ps(_mm256_loadu_ps(a + i + 8),  _mm256_loadu_ps(b + i + 8)));
+        acc2 = _mm256_add_ps(acc2, _mm256_mul_ps(_mm256_loadu_ps(a + i + 16), _mm256_loadu_ps(b + i + 16)));
+        acc3 = _mm256_add_ps(acc3, _mm256_mul_ps(_mm256_loadu_ps(a + i + 24), _mm256_loadu_ps(b + i + 24)));
+    }
+    for (; i + 8 <= n; i += 8)
+        acc0 = _mm256_add_ps(acc0, _mm256_mul_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i)));
+    if (i < n) {
+        // Masked-off lanes load as zero and contribute nothing
+        __m256i m = dynemit_mask8(n - i);
+        acc1 = _mm256_add_ps(acc1, _mm256_mul_ps(_mm256_maskload_ps(a + i, m), _mm256_maskload_ps(b + i, m)));
+    }
+    return hsum_ps_avx(_mm256_add_ps(_mm256_add_ps(acc0, acc1), _mm256_add_ps(acc2, acc3)));
+}
+
+__attribute__((target("avx,fma")))
+static float
+dot_f32_fma3(const float *a, const float *b, size_t n)
+{
+    __m256 acc0 = _mm256_setzero_ps(), acc1 = _mm256_setzero_ps();
+    __m256 acc2 = _mm256_setzero_ps(), acc3 = _mm256_setzero_ps();
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        acc0 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i + 0),  _mm256_loadu_ps(b + i + 0),  acc0);
+        acc1 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i + 8),  _mm256_loadu_ps(b + i + 8),  acc1);
+        acc2 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i + 16), _mm256_loadu_ps(b + i + 16), acc2);
+        acc3 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i + 24), _mm256_loadu_ps(b + i + 24), acc3);
+    }
+    for (; i + 8 <= n; i += 8)
+        acc0 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i), acc0);
+    if (i < n) {
+        __m256i m = dynemit_mask8(n - i);
+        acc1 = _mm256_fmadd_ps(_mm256_maskload_ps(a + i, m), _mm256_maskload_ps(b + i, m), acc1);
+    }
+    return hsum_ps_avx(_mm256_add_ps(_mm256_add_ps(acc0, acc1), _mm256_add_ps(acc2, acc3)));
+}
+
+__attribute__((target("avx512f")))
+static float
+dot_f32_avx512f(const float *a, const float *b, size_t n)
+{
+    __m512 acc0 = _mm512_setzero_ps(), acc1 = _mm512_setzero_ps();
+    __m512 acc2 = _mm512_setzero_ps(), acc3 = _mm512_setzero_ps();
+    size_t i = 0;
+    for (; i + 64 <= n; i += 64) {
+        acc0 = _mm512_fmadd_ps(_mm512_loadu_ps(a + i + 0),  _mm512_loadu_ps(b + i + 0),  acc0);
+        acc1 = _mm512_fmadd_ps(_mm512_loadu_ps(a + i + 16), _mm512_loadu_ps(b + i + 16), acc1);
+        acc2 = _mm512_fmadd_ps(_mm512_loadu_ps(a + i + 32), _mm512_loadu_ps(b + i + 32), acc2);
+        acc3 = _mm512_fmadd_ps(_mm512_loadu_ps(a + i + 48), _mm512_loadu_ps(b + i + 48), acc3);
+    }
+    for (; i + 16 <= n; i += 16)
+        acc0 = _mm512_fmadd_ps(_mm512_loadu_ps(a + i), _mm512_loadu_ps(b + i), acc0);
+    if (i < n) {
+        // Masked-off lanes load as zero and contribute nothing
+        __mmask16 m = dynemit_mask16(n - i);
+        acc1 = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(m, a + i), _mm512_maskz_loadu_ps(m, b + i), acc1);
+    }
+    return _mm512_reduce_add_ps(_mm512_add_ps(_mm512_add_ps(acc0, acc1), _mm512_add_ps(acc2, acc3)));
+}
+
+#endif // DYNEMIT_ARCH_X86
+
+// ===================================================
+// sum_f32: sum(a[i])
+// ===================================================
+
+DYNEMIT_SCALAR_KERNEL_ATTRS
+static float
+sum_f32_scalar(const float *a, size_t n)
+{
+    float s0 = 0.0f, s1 = 0.0f, s2 = 0.0f, s3 = 0.0f;
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        s0 += a[i + 0];
+        s1 += a[i + 1];
+        s2 += a[i + 2];
+        s3 += a[i + 3];
+    }
+    for (; i < n; i++)
+        s0 += a[i];
+    return (s0 + s1) + (s2 + s3);
+}
+
+#if DYNEMIT_ARCH_X86
+
+__attribute__((target("sse2")))
+static float
+sum_f32_sse2(const float *a, size_t n)
+{
+    __m128 acc0 = _mm_setzero_ps(), acc1 = _mm_setzero_ps();
+    __m128 acc2 = _mm_setzero_ps(), acc3 = _mm_setzero_ps();
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        acc0 = _mm_add_ps(acc0, _mm_loadu_ps(a + i + 0));
+        acc1 = _mm_add_ps(acc1, _mm_loadu_ps(a + i + 4));
+        acc2 = _mm_add_ps(acc2, _mm_loadu_ps(a + i + 8));
+        acc3 = _mm_add_ps(acc3, _mm_loadu_ps(a + i + 12));
+    }
+    for (; i + 4 <= n; i += 4)
+        acc0 = _mm_add_ps(acc0, _mm_loadu_ps(a + i));
+    float s = hsum_ps_sse2(_mm_add_ps(_mm_add_ps(acc0, acc1), _mm_add_ps(acc2, acc3)));
+    for (; i < n; i++)
+        s += a[i];
+    return s;
+}
+
+__attribute__((target("avx")))
+static float
+sum_f32_avx(const float *a, size_t n)
+{
+    __m256 acc0 = _mm256_setzero_ps(), acc1 = _mm256_setzero_ps();
+    __m256 acc2 = _mm256_setzero_ps(), acc3 = _mm256_setzero_ps();
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        acc0 = _mm256_add_ps(acc0, _mm256_loadu_ps(a + i + 0));
+        acc1 = _mm256_add_ps(acc1, _mm256_loadu_ps(a + i + 8));
+        acc2 = _mm256_add_ps(acc2, _mm256_loadu_ps(a + i + 16));
+        acc3 = _mm256_add_ps(acc3, _mm256_loadu_ps(a + i + 24));
+    }
+    for (; i + 8 <= n; i += 8)
+        acc0 = _mm256_add_ps(acc0, _mm256_loadu_ps(a + i));
+    if (i < n)
+        acc1 = _mm256_add_ps(acc1, _mm256_maskload_ps(a + i, dynemit_mask8(n - i)));
+    return hsum_ps_avx(_mm256_add_ps(_mm256_add_ps(acc0, acc1), _mm256_add_ps(acc2, acc3)));
+}
+
+__attribute__((target("avx512f")))
+static float
+sum_f32_avx512f(const float *a, size_t n)
+{
+    __m512 acc0 = _mm512_setzero_ps(), acc1 = _mm512_setzero_ps();
+    __m512 acc2 = _mm512_setzero_ps(), acc3 = _mm512_setzero_ps();
+    size_t i = 0;
+    for (; i + 64 <= n; i += 64) {
+        acc0 = _mm512_add_ps(acc0, _mm512_loadu_ps(a + i + 0));
+        acc1 = _mm512_add_ps(acc1, _mm512_loadu_ps(a + i + 16));
+        acc2 = _mm512_add_ps(acc2, _mm512_loadu_ps(a + i + 32));
+        acc3 = _mm512_add_ps(acc3, _mm512_loadu_ps(a + i + 48));
+    }
+    for (; i + 16 <= n; i += 16)
+        acc0 = _mm512_add_ps(acc0, _mm512_loadu_ps(a + i));
+    if (i < n) {
+        __mmask16 m = dynemit_mask16(n - i);
+        acc1 = _mm512_add_ps(acc1, _mm512_maskz_loadu_ps(m, a + i));
+    }
+    return _mm512_reduce_add_ps(_mm512_add_ps(_mm512_add_ps(acc0, acc1), _mm512_add_ps(acc2, acc3)));
+}
+
+#endif // DYNEMIT_ARCH_X86
+
+// ===================================================
+// norm2_f32: sqrt(sum(a[i] * a[i]))
+// ===================================================
+
+// The dot kernels are inlined with both operands pointing at `a`, so the
+// compiler merges the duplicate loads and each element is read only once
+
+DYNEMIT_SCALAR_KERNEL_ATTRS
+static float
+norm2_f32_scalar(const float *a, size_t n)
+{
+    return sqrtf(dot_f32_scalar(a, a, n));
+}
+
+#if DYNEMIT_ARCH_X86
+
+__attribute__((target("sse2")))
+static float
+norm2_f32_sse2(const float *a, size_t n)
+{
+    return sqrtf(dot_f32_sse2(a, a, n));
+}
+
+__attribute__((target("avx")))
+static float
+norm2_f32_avx(const float *a, size_t n)
+{
+    return sqrtf(dot_f32_avx(a, a, n));
+}
+
+__attribute__((target("avx,fma")))
+static float
+norm2_f32_fma3(const float *a, size_t n)
+{
+    return sqrtf(dot_f32_fma3(a, a, n));
+}
+
+__attribute__((target("avx512f")))
+static float
+norm2_f32_avx512f(const float *a, size_t n)
+{
+    return sqrtf(dot_f32_avx512f(a, a, n));
+}
+
+#endif // DYNEMIT_ARCH_X86
+
+// ===================================================
+// minmax_f32: min(a[i]) and max(a[i]) in one pass
+// ===================================================
+
+DYNEMIT_SCALAR_KERNEL_ATTRS
+static void
+minmax_f32_scalar(const float *a, size_t n, float *min_out, float *max_out)
+{
+    if (n == 0) {
+        *min_out = INFINITY;
+        *max_out = -INFINITY;
+        return;
+    }
+    float lo = a[0], hi = a[0];
+    for (size_t i = 1; i < n; i++) {
+        lo = a[i] < lo ? a[i] : lo;
+        hi = a[i] > hi ? a[i] : hi;
+    }
+    *min_out = lo;
+    *max_out = hi;
+}
+
+#if DYNEMIT_ARCH_X86
+
+__attribute__((target("sse2")))
+static void
+minmax_f32_sse2(const float *a, size_t n, float *min_out, float *max_out)
+{
+    if (n < 4) {
+        minmax_f32_scalar(a, n, min_out, max_out);
+        return;
+    }
+    __m128 lo0 = _mm_loadu_ps(a), hi0 = lo0;
+    __m128 lo1 = lo0, hi1 = lo0;
+    size_t i = 4;
+    for (; i + 8 <= n; i += 8) {
+        __m128 v0 = _mm_loadu_ps(a + i);
+        __m128 v1 = _mm_loadu_ps(a + i + 4);
+        lo0 = _mm_min_ps(lo0, v0);
+        hi0 = _mm_max_ps(hi0, v0);
+        lo1 = _mm_min_ps(lo1, v1);
+        hi1 = _mm_max_ps(hi1, v1);
+    }
+    // Overlapping final vector covers the remainder without a scalar loop
+    if (i < n) {
+        __m128 v = _mm_loadu_ps(a + n - 4);
+        lo0 = _mm_min_ps(lo0, v);
+        hi0 = _mm_max_ps(hi0, v);
+        if (i + 4 < n) {
+            v = _mm_loadu_ps(a + i);
+            lo1 = _mm_min_ps(lo1, v);
+            hi1 = _mm_max_ps(hi1, v);
+        }
+    }
+    *min_out = hmin_ps_sse2(_mm_min_ps(lo0, lo1));
+    *max_out = hmax_ps_sse2(_mm_max_ps(hi0, hi1));
+}
+
+__attribute__((target("avx")))
+static void
+minmax_f32_avx(const float *a, size_t n, float *min_out, float *max_out)
+{
+    if (n < 8) {
+        minmax_f32_sse2(a, n, min_out, max_out);
+        return;
+    }
+    __m256 lo0 = _mm256_loadu_ps(a), hi0 = lo0;
+    __m256 lo1 = lo0, hi1 = lo0;
+    size_t i = 8;
+    for (; i + 16 <= n; i += 16) {
+        __m256 v0 = _mm256_loadu_ps(a + i);
+        __m256 v1 = _mm256_loadu_ps(a + i + 8);
+        lo0 = _mm256_min_ps(lo0, v0);
+        hi0 = _mm256_max_ps(hi0, v0);
+        lo1 = _mm256_min_ps(lo1, v1);
+        hi1 = _mm256_max_ps(hi1, v1);
+    }
+    if (i < n) {
+        __m256 v = _mm256_loadu_ps(a + n - 8);
+        lo0 = _mm256_min_ps(lo0, v);
+        hi0 = _mm256_max_ps(hi0, v);
+        if (i + 8 < n) {
+            v = _mm256_loadu_ps(a + i);
+            lo1 = _mm256_min_ps(lo1, v);
+            hi1 = _mm256_max_ps(hi1, v);
+        }
+    }
+    __m256 lo = _mm256_min_ps(lo0, lo1);
+    __m256 hi = _mm256_max_ps(hi0, hi1);
+    *min_out = hmin_ps_sse2(_mm_min_ps(_mm256_castps256_ps128(lo), _mm256_extractf128_ps(lo, 1)));
+    *max_out = hmax_ps_sse2(_mm_max_ps(_mm256_castps256_ps128(hi), _mm256_extractf128_ps(hi, 1)));
+}
+
+__attribute__((target("avx512f")))
+static void
+minmax_f32_avx512f(const float *a, size_t n, float *min_out, float *max_out)
+{
+    if (n == 0) {
+        *min_out = INFINITY;
+        *max_out = -INFINITY;
+        return;
+    }
+    __m512 lo0 = _mm512_set1_ps(a[0]), hi0 = lo0;
+    __m512 lo1 = lo0, hi1 = lo0;
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        __m512 v0 = _mm512_loadu_ps(a + i);
+        __m512 v1 = _mm512_loadu_ps(a + i + 16);
+        lo0 = _mm512_min_ps(lo0, v0);
+        hi0 = _mm512_max_ps(hi0, v0);
+        lo1 = _mm512_min_ps(lo1, v1);
+        hi1 = _mm512_max_ps(hi1, v1);
+    }
+    for (; i + 16 <= n; i += 16) {
+        __m512 v = _mm512_loadu_ps(a + i);
+        lo0 = _mm512_min_ps(lo0, v);
+        hi0 = _mm512_max_ps(hi0, v);
+    }
+    if (i < n) {
+        // Masked-off lanes keep their previous value
+        __mmask16 m = dynemit_mask16(n - i);
+        __m512 v = _mm512_maskz_loadu_ps(m, a + i);
+        lo1 = _mm512_mask_min_ps(lo1, m, lo1, v);
+        hi1 = _mm512_mask_max_ps(hi1, m, hi1, v);
+    }
+    *min_out = _mm512_reduce_min_ps(_mm512_min_ps(lo0, lo1));
+    *max_out = _mm512_reduce_max_ps(_mm512_max_ps(hi0, hi1));
+}
+
+#endif // DYNEMIT_ARCH_X86
+
+// ===================================================
+// Deterministic-order variants
+// ===================================================
+
+// Every level accumulates into the same 16 virtual lanes (element i goes to
+// lane i % 16), adds products without fusing, and combines the lanes with the
+// same fixed pairwise tree. The result is therefore bit-identical no matter
+// which SIMD level the resolver picks, at the cost of FMA and extra
+// accumulators. fp-contract is disabled so the compiler cannot fuse either.
+
+#define DET_LANES 16
+
+static inline float
+det_combine_lanes(float lanes[DET_LANES])
+{
+    for (size_t w = DET_LANES / 2; w >= 1; w /= 2)
+        for (size_t j = 0; j < w; j++)
+            lanes[j] = lanes[j] + lanes[j + w];
+    return lanes[0];
+}
+
+DYNEMIT_SCALAR_KERNEL_ATTRS
+__attribute__((optimize("fp-contract=off")))
+static float
+dot_f32_det_scalar(const float *a, const float *b, size_t n)
+{
+    float lanes[DET_LANES] = {0};
+    size_t i = 0;
+    for (; i + DET_LANES <= n; i += DET_LANES)
+        for (size_t j = 0; j < DET_LANES; j++)
+            lanes[j] = lanes[j] + a[i + j] * b[i + j];
+    for (size_t j = 0; i + j < n; j++)
+        lanes[j] = lanes[j] + a[i + j] * b[i + j];
+    return det_combine_lanes(lanes);
+}
+
+#if DYNEMIT_ARCH_X86
+
+__attribute__((target("sse2")))
+__attribute__((optimize("fp-contract=off")))
+static float
+dot_f32_det_sse2(const float *a, const float *b, size_t n)
+{
+    __m128 acc0 = _mm_setzero_ps(), acc1 = _mm_setzero_ps();
+    __m128 acc2 = _mm_setzero_ps(), acc3 = _mm_setzero_ps();
+    size_t i = 0;
+    for (; i + DET_LANES <= n; i += DET_LANES) {
+        acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(a + i + 0),  _mm_loadu_ps(b + i + 0)));
+        acc1 = _mm_add_ps(acc1, _mm_mul_ps(_mm_loadu_ps(a + i + 4),  _mm_loadu_ps(b + i + 4)));
+        acc2 = _mm_add_ps(acc2, _mm_mul_ps(_mm_loadu_ps(a + i + 8),  _mm_loadu_ps(b + i + 8)));
+        acc3 = _mm_add_ps(acc3, _mm_mul_ps(_mm_loadu_ps(a + i + 12), _mm_loadu_ps(b + i + 12)));
+    }
+    float lanes[DET_LANES];
+    _mm_storeu_ps(lanes + 0,  acc0);
+    _mm_storeu_ps(lanes + 4,  acc1);
+    _mm_storeu_ps(lanes + 8,  acc2);
+    _mm_storeu_ps(lanes + 12, acc3);
+    for (size_t j = 0; i + j < n; j++)
+        lanes[j] = lanes[j] + a[i + j] * b[i + j];
+    return det_combine_lanes(lanes);
+}
+
+__attribute__((target("avx")))
+__attribute__((optimize("fp-contract=off")))
+static float
+dot_f32_det_avx(const float *a, const float *b, size_t n)
+{
+    __m256 acc0 = _mm256_setzero_ps(), acc1 = _mm256_setzero_ps();
+    size_t i = 0;
+    for (; i + DET_LANES <= n; i += DET_LANES) {
+        acc0 = _mm256_add_ps(acc0, _mm256_mul_ps(_mm256_loadu_ps(a + i + 0), _mm256_loadu_ps(b + i + 0)));
+        acc1 = _mm256_add_ps(acc1, _mm256_mul_ps(_mm256_loadu_ps(a + i + 8), _mm256_loadu_ps(b + i + 8)));
+    }
+    float lanes[DET_LANES];
+    _mm256_storeu_ps(lanes + 0, acc0);
+    _mm256_storeu_ps(lanes + 8, acc1);
+    for (size_t j = 0; i + j < n; j++)
+        lanes[j] = lanes[j] + a[i + j] * b[i + j];
+    return det_combine_lanes(lanes);
+}
+
+__attribute__((target("avx512f")))
+__attribute__((optimize("fp-contract=off")))
+static float
+dot_f32_det_avx512f(const float *a, const float *b, size_t n)
+{
+    __m512 acc = _mm512_setzero_ps();
+    size_t i = 0;
+    for (; i + DET_LANES <= n; i += DET_LANES)
+        acc = _mm512_add_ps(acc, _mm512_mul_ps(_mm512_loadu_ps(a + i), _mm512_loadu_ps(b + i)));
+    float lanes[DET_LANES];
+    _mm512_storeu_ps(lanes, acc);
+    for (size_t j = 0; i + j < n; j++)
+        lanes[j] = lanes[j] + a[i + j] * b[i + j];
+    return det_combine_lanes(lanes);
+}
+
+#endif // DYNEMIT_ARCH_X86
+
+DYNEMIT_SCALAR_KERNEL_ATTRS
+__attribute__((optimize("fp-contract=off")))
+static float
+sum_f32_det_scalar(const float *a, size_t n)
+{
+    float lanes[DET_LANES] = {0};
+    size_t i = 0;
+    for (; i + DET_LANES <= n; i += DET_LANES)
+        for (size_t j = 0; j < DET_LANES; j++)
+            lanes[j] = lanes[j] + a[i + j];
+    for (size_t j = 0; i + j < n; j++)
+        lanes[j] = lanes[j] + a[i + j];
+    return det_combine_lanes(lanes);
+}
+
+#if DYNEMIT_ARCH_X86
+
+__attribute__((target("sse2")))
+__attribute__((optimize("fp-contract=off")))
+static float
+sum_f32_det_sse2(const float *a, size_t n)
+{
+    __m128 acc0 = _mm_setzero_ps(), acc1 = _mm_setzero_ps();
+    __m128 acc2 = _mm_setzero_ps(), acc3 = _mm_setzero_ps();
+    size_t i = 0;
+    for (; i + DET_LANES <= n; i += DET_LANES) {
+        acc0 = _mm_add_ps(acc0, _mm_loadu_ps(a + i + 0));
+        acc1 = _mm_add_ps(acc1, _mm_loadu_ps(a + i + 4));
+        acc2 = _mm_add_ps(acc2, _mm_loadu_ps(a + i + 8));
+        acc3 = _mm_add_ps(acc3, _mm_loadu_ps(a + i + 12));
+    }
+    float lanes[DET_LANES];
+    _mm_storeu_ps(lanes + 0,  acc0);
+    _mm_storeu_ps(lanes + 4,  acc1);
+    _mm_storeu_ps(lanes + 8,  acc2);
+    _mm_storeu_ps(lanes + 12, acc3);
+    for (size_t j = 0; i + j < n; j++)
+        lanes[j] = lanes[j] + a[i + j];
+    return det_combine_lanes(lanes);
+}
+
+__attribute__((target("avx")))
+__attribute__((optimize("fp-contract=off")))
+static float
+sum_f32_det_avx(const float *a, size_t n)
+{
+    __m256 acc0 = _mm256_setzero_ps(), acc1 = _mm256_setzero_ps();
+    size_t i = 0;
+    for (; i + DET_LANES <= n; i += DET_LANES) {
+        acc0 = _mm256_add_ps(acc0, _mm256_loadu_ps(a + i + 0));
+        acc1 = _mm256_add_ps(acc1, _mm256_loadu_ps(a + i + 8));
+    }
+    float lanes[DET_LANES];
+    _mm256_storeu_ps(lanes + 0, acc0);
+    _mm256_storeu_ps(lanes + 8, acc1);
+    for (size_t j = 0; i + j < n; j++)
+        lanes[j] = lanes[j] + a[i + j];
+    return det_combine_lanes(lanes);
+}
+
+__attribute__((target("avx512f")))
+__attribute__((optimize("fp-contract=off")))
+static float
+sum_f32_det_avx512f(const float *a, size_t n)
+{
+    __m512 acc = _mm512_setzero_ps();
+    size_t i = 0;
+    for (; i + DET_LANES <= n; i += DET_LANES)
+        acc = _mm512_add_ps(acc, _mm512_loadu_ps(a + i));
+    float lanes[DET_LANES];
+    _mm512_storeu_ps(lanes, acc);
+    for (size_t j = 0; i + j < n; j++)
+        lanes[j] = lanes[j] + a[i + j];
+    return det_combine_lanes(lanes);
+}
+
+#endif // DYNEMIT_ARCH_X86
+
+DYNEMIT_SCALAR_KERNEL_ATTRS
+__attribute__((optimize("fp-contract=off")))
+static float
+norm2_f32_det_scalar(const float *a, size_t n)
+{
+    return sqrtf(dot_f32_det_scalar(a, a, n));
+}
+
+#if DYNEMIT_ARCH_X86
+
+__attribute__((target("sse2")))
+__attribute__((optimize("fp-contract=off")))
+static float
+norm2_f32_det_sse2(const float *a, size_t n)
+{
+    return sqrtf(dot_f32_det_sse2(a, a, n));
+}
+
+__attribute__((target("avx")))
+__attribute__((optimize("fp-contract=off")))
+static float
+norm2_f32_det_avx(const float *a, size_t n)
+{
+    return sqrtf(dot_f32_det_avx(a, a, n));
+}
+
+__attribute__((target("avx512f")))
+__attribute__((optimize("fp-contract=off")))
+static float
+norm2_f32_det_avx512f(const float *a, size_t n)
+{
+    return sqrtf(dot_f32_det_avx512f(a, a, n));
+}
+
+#endif // DYNEMIT_ARCH_X86
+
+// ===================================================
+// NEON kernels
+// ===================================================
+
+// ASIMD has one width, and FMA and NaN-ignoring min/max (minNum/maxNum, the
+// scalar kernel's behaviour for a NaN past the first element) in the base
+// ISA, so each operation has a single NEON kernel.
+
+#if defined(__aarch64__)
+
+static float
+dot_f32_neon(const float *a, const float *b, size_t n)
+{
+    float32x4_t acc0 = vdupq_n_f32(0.0f), acc1 = acc0, acc2 = acc0, acc3 = acc0;
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        acc0 = vfmaq_f32(acc0, vld1q_f32(a + i + 0),  vld1q_f32(b + i + 0));
+        acc1 = vfmaq_f32(acc1, vld1q_f32(a + i + 4),  vld1q_f32(b + i + 4));
+        acc2 = vfmaq_f32(acc2, vld1q_f32(a + i + 8),  vld1q_f32(b + i + 8));
+        acc3 = vfmaq_f32(acc3, vld1q_f32(a + i + 12), vld1q_f32(b + i + 12));
+    }
+    for (; i + 4 <= n; i += 4)
+        acc0 = vfmaq_f32(acc0, vld1q_f32(a + i), vld1q_f32(b + i));
+    float s = vaddvq_f32(vaddq_f32(vaddq_f32(acc0, acc1), vaddq_f32(acc2, acc3)));
+    for (; i < n; i++)
+        s += a[i] * b[i];
+    return s;
+}
+
+static float
+sum_f32_neon(const float *a, size_t n)
+{
+    float32x4_t acc0 = vdupq_n_f32(0.0f), acc1 = acc0, acc2 = acc0, acc3 = acc0;
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        acc0 = vaddq_f32(acc0, vld1q_f32(a + i + 0));
+        acc1 = vaddq_f32(acc1, vld1q_f32(a + i + 4));
+        acc2 = vaddq_f32(acc2, vld1q_f32(a + i + 8));
+        acc3 = vaddq_f32(acc3, vld1q_f32(a + i + 12));
+    }
+    for (; i + 4 <= n; i += 4)
+        acc0 = vaddq_f32(acc0, vld1q_f32(a + i));
+    float s = vaddvq_f32(vaddq_f32(vaddq_f32(acc0, acc1), vaddq_f32(acc2, acc3)));
+    for (; i < n; i++)
+        s += a[i];
+    return s;
+}
+
+static float
+norm2_f32_neon(const float *a, size_t n)
+{
+    return sqrtf(dot_f32_neon(a, a, n));
+}
+
+static void
+minmax_f32_neon(const float *a, size_t n, float *min_out, float *max_out)
+{
+    if (n < 4) {
+        minmax_f32_scalar(a, n, min_out, max_out);
+        return;
+    }
+    float32x4_t lo0 = vld1q_f32(a), hi0 = lo0;
+    float32x4_t lo1 = lo0, hi1 = lo0;
+    size_t i = 4;
+    for (; i + 8 <= n; i += 8) {
+        float32x4_t v0 = vld1q_f32(a + i);
+        float32x4_t v1 = vld1q_f32(a + i + 4);
+        lo0 = vminnmq_f32(lo0, v0);
+        hi0 = vmaxnmq_f32(hi0, v0);
+        lo1 = vminnmq_f32(lo1, v1);
+        hi1 = vmaxnmq_f32(hi1, v1);
+    }
+    // Overlapping final vector covers the remainder without a scalar loop
+    if (i < n) {
+        float32x4_t v = vld1q_f32(a + n - 4);
+        lo0 = vminnmq_f32(lo0, v);
+        hi0 = vmaxnmq_f32(hi0, v);
+        if (i + 4 < n) {
+            v = vld1q_f32(a + i);
+            lo1 = vminnmq_f32(lo1, v);
+            hi1 = vmaxnmq_f32(hi1, v);
+        }
+    }
+    *min_out = vminnmvq_f32(vminnmq_f32(lo0, lo1));
+    *max_out = vmaxnmvq_f32(vmaxnmq_f32(hi0, hi1));
+}
+
+// Four vectors are the 16 deterministic lanes, so the SVE levels use these
+// too: a scalable vector would change the lane assignment
+__attribute__((optimize("fp-contract=off")))
+static float
+dot_f32_det_neon(const float *a, const float *b, size_t n)
+{
+    float32x4_t acc0 = vdupq_n_f32(0.0f), acc1 = acc0, acc2 = acc0, acc3 = acc0;
+    size_t i = 0;
+    for (; i + DET_LANES <= n; i += DET_LANES) {
+        acc0 = vaddq_f32(acc0, vmulq_f32(vld1q_f32(a + i + 0),  vld1q_f32(b + i + 0)));
+        acc1 = vaddq_f32(acc1, vmulq_f32(vld1q_f32(a + i + 4),  vld1q_f32(b + i + 4)));
+        acc2 = vaddq_f32(acc2, vmulq_f32(vld1q_f32(a + i + 8),  vld1q_f32(b + i + 8)));
+        acc3 = vaddq_f32(acc3, vmulq_f32(vld1q_f32(a + i + 12), vld1q_f32(b + i + 12)));
+    }
+    float lanes[DET_LANES];
+    vst1q_f32(lanes + 0,  acc0);
+    vst1q_f32(lanes + 4,  acc1);
+    vst1q_f32(lanes + 8,  acc2);
+    vst1q_f32(lanes + 12, acc3);
+    for (size_t j = 0; i + j < n; j++)
+        lanes[j] = lanes[j] + a[i + j] * b[i + j];
+    return det_combine_lanes(lanes);
+}
+
+__attribute__((optimize("fp-contract=off")))
+static float
+sum_f32_det_neon(const float *a, size_t n)
+{
+    float32x4_t acc0 = vdupq_n_f32(0.0f), acc1 = acc0, acc2 = acc0, acc3 = acc0;
+    size_t i = 0;
+    for (; i + DET_LANES <= n; i += DET_LANES) {
+        acc0 = vaddq_f32(acc0, vld1q_f32(a + i + 0));
+        acc1 = vaddq_f32(acc1, vld1q_f32(a + i + 4));
+        acc2 = vaddq_f32(acc2, vld1q_f32(a + i + 8));
+        acc3 = vaddq_f32(acc3, vld1q_f32(a + i + 12));
+    }
+    float lanes[DET_LANES];
+    vst1q_f32(lanes + 0,  acc0);
+    vst1q_f32(lanes + 4,  acc1);
+    vst1q_f32(lanes + 8,  acc2);
+    vst1q_f32(lanes + 12, acc3);
+    for (size_t j = 0; i + j < n; j++)
+        lanes[j] = lanes[j] + a[i + j];
+    return det_combine_lanes(lanes);
+}
+
+__attribute__((optimize("fp-contract=off")))
+static float
+norm2_f32_det_neon(const float *a, size_t n)
+{
+    return sqrtf(dot_f32_det_neon(a, a, n));
+}
+
+#endif // __aarch64__
+
+// ===================================================
+// Resolver functions for ifunc
+// ===================================================
+
+typedef float (*dot_f32_func_t)(const float *, const float *, size_t);
+typedef float (*unary_reduce_f32_func_t)(const float *, size_t);
+typedef void (*minmax_f32_func_t)(const float *, size_t, float *, float *);
+
+#if DYNEMIT_ARCH_X86
+
+static dot_f32_func_t
+dot_f32_select(simd_level_t level)
+{
+    int fma3 = dynemit_cpu_has(DYNEMIT_CPU_FMA);
+
+    switch (level) {
+    case SIMD_AVX512F: return dot_f32_avx512f;
+    case SIMD_AVX2:
+    case SIMD_AVX:     return fma3 ? dot_f32_fma3 : dot_f32_avx;
+    case SIMD_SSE4_2:
+    case SIMD_SSE2:    return dot_f32_sse2;
+    case SIMD_SCALAR:
+    default:           return dot_f32_scalar;
+    }
+}
+
+DYNEMIT_DISPATCH(dot_f32, float, (const float *a, const float *b, size_t n), (a, b, n), n)
+
+static unary_reduce_f32_func_t
+sum_f32_select(simd_level_t level)
+{
+    switch (level) {
+    case SIMD_AVX512F: return sum_f32_avx512f;
+    case SIMD_AVX2:
+    case SIMD_AVX:     return sum_f32_avx;
+    case SIMD_SSE4_2:
+    case SIMD_SSE2:    return sum_f32_sse2;
+    case SIMD_SCALAR:
+    default:           return sum_f32_scalar;
+    }
+}
+
+DYNEMIT_DISPATCH(sum_f32, float, (const float *a, size_t n), (a, n), n)
+
+static unary_reduce_f32_func_t
+norm2_f32_select(simd_level_t level)
+{
+    int fma3 = dynemit_cpu_has(DYNEMIT_CPU_FMA);
+
+    switch (level) {
+    case SIMD_AVX512F: return norm2_f32_avx512f;
+    case SIMD_AVX2:
+    case SIMD_AVX:     return fma3 ? norm2_f32_fma3 : norm2_f32_avx;
+    case SIMD_SSE4_2:
+    case SIMD_SSE2:    return norm2_f32_sse2;
+    case SIMD_SCALAR:
+    default:           return norm2_f32_scalar;
+    }
+}
+
+DYNEMIT_DISPATCH(norm2_f32, float, (const float *a, size_t n), (a, n), n)
+
+static minmax_f32_func_t
+minmax_f32_select(simd_level_t level)
+{
+    switch (level) {
+    case SIMD_AVX512F: return minmax_f32_avx512f;
+    case SIMD_AVX2:
+    case SIMD_AVX:     return minmax_f32_avx;
+    case SIMD_SSE4_2:
+    case SIMD_SSE2:    return minmax_f32_sse2;
+    case SIMD_SCALAR:
+    default:           return minmax_f32_scalar;
+    }
+}
+
+DYNEMIT_DISPATCH(minmax_f32, void, (const float *a, size_t n, float *min_out, float *max_out),
+                 (a, n, min_out, max_out), n)
+
+static dot_f32_func_t
+dot_f32_det_select(simd_level_t level)
+{
+    switch (level) {
+    case SIMD_AVX512F: return dot_f32_det_avx512f;
+    case SIMD_AVX2:
+    case SIMD_AVX:     return dot_f32_det_avx;
+    case SIMD_SSE4_2:
+    case SIMD_SSE2:    return dot_f32_det_sse2;
+    case SIMD_SCALAR:
+    default:           return dot_f32_det_scalar;
+    }
+}
+
+DYNEMIT_DISPATCH(dot_f32_det, float, (const float *a, const float *b, size_t n), (a, b, n), n)
+
+static unary_reduce_f32_func_t
+sum_f32_det_select(simd_level_t level)
+{
+    switch (level) {
+    case SIMD_AVX512F: return sum_f32_det_avx512f;
+    case SIMD_AVX2:
+    case SIMD_AVX:     return sum_f32_det_avx;
+    case SIMD_SSE4_2:
+    case SIMD_SSE2:    return sum_f32_det_sse2;
+    case SIMD_SCALAR:
+    default:           return sum_f32_det_scalar;
+    }
+}
+
+DYNEMIT_DISPATCH(sum_f32_det, float, (const float *a, size_t n), (a, n), n)
+
+static unary_reduce_f32_func_t
+norm2_f32_det_select(simd_level_t level)
+{
+    switch (level) {
+    case SIMD_AVX512F: return norm2_f32_det_avx512f;
+    case SIMD_AVX2:
+    case SIMD_AVX:     return norm2_f32_det_avx;
+    case SIMD_SSE4_2:
+    case SIMD_SSE2:    return norm2_f32_det_sse2;
+    case SIMD_SCALAR:
+    default:           return norm2_f32_det_scalar;
+    }
+}
+
+DYNEMIT_DISPATCH(norm2_f32_det, float, (const float *a, size_t n), (a, n), n)
+
+#else // aarch64 (NEON, SVE), RISC-V (RVV) or scalar only; see portable.h
+
+DYNEMIT_EXTERN_KERNEL(dot_f32, float, (const float *a, const float *b, size_t n))
+DYNEMIT_EXTERN_KERNEL(sum_f32, float, (const float *a, size_t n))
+DYNEMIT_EXTERN_KERNEL(norm2_f32, float, (const float *a, size_t n))
+DYNEMIT_EXTERN_KERNEL(minmax_f32, void, (const float *a, size_t n, float *min_out, float *max_out))
+
+// The portable selectors return name##_func_t
+typedef unary_reduce_f32_func_t sum_f32_func_t;
+typedef unary_reduce_f32_func_t norm2_f32_func_t;
+
+DYNEMIT_PORTABLE_SELECT(dot_f32)
+DYNEMIT_DISPATCH(dot_f32, float, (const float *a, const float *b, size_t n), (a, b, n), n)
+
+DYNEMIT_PORTABLE_SELECT(sum_f32)
+DYNEMIT_DISPATCH(sum_f32, float, (const float *a, size_t n), (a, n), n)
+
+DYNEMIT_PORTABLE_SELECT(norm2_f32)
+DYNEMIT_DISPATCH(norm2_f32, float, (const float *a, size_t n), (a, n), n)
+
+DYNEMIT_PORTABLE_SELECT(minmax_f32)
+DYNEMIT_DISPATCH(minmax_f32, void, (const float *a, size_t n, float *min_out, float *max_out),
+                 (a, n, min_out, max_out), n)
+
+// The deterministic kernels have a fixed 16-lane order that the scalable
+// SVE and RVV registers do not map onto, so those levels use NEON or scalar
+static dot_f32_func_t
+dot_f32_det_select(simd_level_t level)
+{
+    switch (level) {
+    case SIMD_SVE2:
+    case SIMD_SVE:
+    case SIMD_NEON:    return DYNEMIT_NEON_KERNEL(dot_f32_det);
+    case SIMD_SCALAR:
+    default:           return dot_f32_det_scalar;
+    }
+}
+
+DYNEMIT_DISPATCH(dot_f32_det, float, (const float *a, const float *b, size_t n), (a, b, n), n)
+
+static unary_reduce_f32_func_t
+sum_f32_det_select(simd_level_t level)
+{
+    switch (level) {
+    case SIMD_SVE2:
+    case SIMD_SVE:
+    case SIMD_NEON:    return DYNEMIT_NEON_KERNEL(sum_f32_det);
+    case SIMD_SCALAR:
+    default:           return sum_f32_det_scalar;
+    }
+}
+
+DYNEMIT_DISPATCH(sum_f32_det, float, (const float *a, size_t n), (a, n), n)
+
+static unary_reduce_f32_func_t
+norm2_f32_det_select(simd_level_t level)
+{
+    switch (level) {
+    case SIMD_SVE2:
+    case SIMD_SVE:
+    case SIMD_NEON:    return DYNEMIT_NEON_KERNEL(norm2_f32_det);
+    case SIMD_SCALAR:
+    default:           return norm2_f32_det_scalar;
+    }
+}
+
+DYNEMIT_DISPATCH(norm2_f32_det, float, (const float *a, size_t n), (a, n), n)
+
+#endif
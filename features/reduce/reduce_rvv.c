@@ -0,0 +1,67 @@
+/* SPDX-License-Identifier: BSL-1.0 */
+#include <math.h>
+#include <stddef.h>
+#include <dynemit/core.h>
+#include "../common/elementwise.h"
+
+// RVV kernels of reduce.c, built with the V extension enabled and only
+// reached through the resolvers there. Each kernel accumulates element-wise
+// into one LMUL=8 register group with tail-undisturbed (_tu) operations, so
+// the lanes past a short last strip keep their partial results, and
+// reduces the group once at the end.
+
+float
+dot_f32_rvv(const float *a, const float *b, size_t n)
+{
+    size_t vlmax = __riscv_vsetvlmax_e32m8();
+    vfloat32m8_t acc = __riscv_vfmv_v_f_f32m8(0.0f, vlmax);
+    for (size_t i = 0, vl; i < n; i += vl) {
+        vl = __riscv_vsetvl_e32m8(n - i);
+        acc = __riscv_vfmacc_vv_f32m8_tu(acc, __riscv_vle32_v_f32m8(a + i, vl),
+                                         __riscv_vle32_v_f32m8(b + i, vl), vl);
+    }
+    vfloat32m1_t zero = __riscv_vfmv_s_f_f32m1(0.0f, 1);
+    return __riscv_vfmv_f_s_f32m1_f32(__riscv_vfredusum_vs_f32m8_f32m1(acc, zero, vlmax));
+}
+
+float
+sum_f32_rvv(const float *a, size_t n)
+{
+    size_t vlmax = __riscv_vsetvlmax_e32m8();
+    vfloat32m8_t acc = __riscv_vfmv_v_f_f32m8(0.0f, vlmax);
+    for (size_t i = 0, vl; i < n; i += vl) {
+        vl = __riscv_vsetvl_e32m8(n - i);
+        acc = __riscv_vfadd_vv_f32m8_tu(acc, acc, __riscv_vle32_v_f32m8(a + i, vl), vl);
+    }
+    vfloat32m1_t zero = __riscv_vfmv_s_f_f32m1(0.0f, 1);
+    return __riscv_vfmv_f_s_f32m1_f32(__riscv_vfredusum_vs_f32m8_f32m1(acc, zero, vlmax));
+}
+
+float
+norm2_f32_rvv(const float *a, size_t n)
+{
+    return sqrtf(dot_f32_rvv(a, a, n));
+}
+
+// vfmin/vfmax are IEEE minNum/maxNum, which ignore a NaN operand like the
+// scalar kernel does past the first element
+void
+minmax_f32_rvv(const float *a, size_t n, float *min_out, float *max_out)
+{
+    if (n == 0) {
+        *min_out = INFINITY;
+        *max_out = -INFINITY;
+        return;
+    }
+    size_t vlmax = __riscv_vsetvlmax_e32m8();
+    vfloat32m8_t lo = __riscv_vfmv_v_f_f32m8(a[0], vlmax), hi = lo;
+    for (size_t i = 0, vl; i < n; i += vl) {
+        vl = __riscv_vsetvl_e32m8(n - i);
+        vfloat32m8_t v = __riscv_vle32_v_f32m8(a + i, vl);
+        lo = __riscv_vfmin_vv_f32m8_tu(lo, lo, v, vl);
+        hi = __riscv_vfmax_vv_f32m8_tu(hi, hi, v, vl);
+    }
+    vfloat32m1_t first = __riscv_vfmv_s_f_f32m1(a[0], 1);
+    *min_out = __riscv_vfmv_f_s_f32m1_f32(__riscv_vfredmin_vs_f32m8_f32m1(lo, first, vlmax));
+    *max_out = __riscv_vfmv_f_s_f32m1_f32(__riscv_vfredmax_vs_f32m8_f32m1(hi, first, vlmax));
+}
@@ -0,0 +1,78 @@
+/* SPDX-License-Identifier: BSL-1.0 */
+#include <math.h>
+#include <stddef.h>
+#include <dynemit/core.h>
+#include "../common/elementwise.h"
+
+// SVE kernels of reduce.c, built with SVE enabled and only reached through
+// the resolvers there. The main loops keep four accumulators like the x86
+// and NEON kernels; the predicated loop after them takes the remainder one
+// vector at a time into the first, inactive lanes adding nothing.
+
+float
+dot_f32_sve(const float *a, const float *b, size_t n)
+{
+    const size_t vl = svcntw();
+    const svbool_t all = svptrue_b32();
+    svfloat32_t acc0 = svdup_f32(0.0f), acc1 = acc0, acc2 = acc0, acc3 = acc0;
+    size_t i = 0;
+    for (; i + 4 * vl <= n; i += 4 * vl) {
+        acc0 = svmla_x(all, acc0, svld1(all, a + i),          svld1(all, b + i));
+        acc1 = svmla_x(all, acc1, svld1(all, a + i + vl),     svld1(all, b + i + vl));
+        acc2 = svmla_x(all, acc2, svld1(all, a + i + 2 * vl), svld1(all, b + i + 2 * vl));
+        acc3 = svmla_x(all, acc3, svld1(all, a + i + 3 * vl), svld1(all, b + i + 3 * vl));
+    }
+    for (; i < n; i += vl) {
+        svbool_t pg = svwhilelt_b32((uint64_t)i, (uint64_t)n);
+        acc0 = svmla_m(pg, acc0, svld1(pg, a + i), svld1(pg, b + i));
+    }
+    return svaddv(all, svadd_x(all, svadd_x(all, acc0, acc1), svadd_x(all, acc2, acc3)));
+}
+
+float
+sum_f32_sve(const float *a, size_t n)
+{
+    const size_t vl = svcntw();
+    const svbool_t all = svptrue_b32();
+    svfloat32_t acc0 = svdup_f32(0.0f), acc1 = acc0, acc2 = acc0, acc3 = acc0;
+    size_t i = 0;
+    for (; i + 4 * vl <= n; i += 4 * vl) {
+        acc0 = svadd_x(all, acc0, svld1(all, a + i));
+        acc1 = svadd_x(all, acc1, svld1(all, a + i + vl));
+        acc2 = svadd_x(all, acc2, svld1(all, a + i + 2 * vl));
+        acc3 = svadd_x(all, acc3, svld1(all, a + i + 3 * vl));
+    }
+    for (; i < n; i += vl) {
+        svbool_t pg = svwhilelt_b32((uint64_t)i, (uint64_t)n);
+        acc0 = svadd_m(pg, acc0, svld1(pg, a + i));
+    }
+    return svaddv(all, svadd_x(all, svadd_x(all, acc0, acc1), svadd_x(all, acc2, acc3)));
+}
+
+float
+norm2_f32_sve(const float *a, size_t n)
+{
+    return sqrtf(dot_f32_sve(a, a, n));
+}
+
+// minNum/maxNum, so a NaN past the first element is ignored like in the
+// scalar kernel
+void
+minmax_f32_sve(const float *a, size_t n, float *min_out, float *max_out)
+{
+    if (n == 0) {
+        *min_out = INFINITY;
+        *max_out = -INFINITY;
+        return;
+    }
+    const svbool_t all = svptrue_b32();
+    svfloat32_t lo = svdup_f32(a[0]), hi = lo;
+    for (size_t i = 0; i < n; i += svcntw()) {
+        svbool_t pg = svwhilelt_b32((uint64_t)i, (uint64_t)n);
+        svfloat32_t v = svld1(pg, a + i);
+        lo = svminnm_m(pg, lo, v);
+        hi = svmaxnm_m(pg, hi, v);
+    }
+    *min_out = svminnmv(all, lo);
+    *max_out = svmaxnmv(all, hi);
+}
@@ -0,0 +1,296 @@
+/* SPDX-License-Identifier: BSL-1.0 */
+#include <stddef.h>
+#include <stdint.h>
+#include <dynemit/core.h>
+#include <dynemit/sparse.h>
+#include "../common/elementwise.h"
+
+// Indexed kernels. Below AVX2 there is no gather instruction and emulating
+// one with scalar loads and inserts is slower than the plain loop, so SSE
+// and AVX run the scalar kernels. A gather costs roughly one load per lane,
+// so the vector kernels win by overlapping the loads of several vectors and
+// by doing the arithmetic and stores a vector at a time.
+//
+// Gathers run through microcode that is much slower on Intel cores with the
+// Gather Data Sampling mitigation; benchmark_sparse shows whether the AVX2
+// and AVX-512F kernels still beat the scalar loop on a given machine.
+
+#if DYNEMIT_ARCH_X86
+
+__attribute__((target("avx")))
+static inline float
+hsum_ps_avx(__m256 v)
+{
+    __m128 s = _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+    s = _mm_add_ps(s, _mm_movehl_ps(s, s));
+    s = _mm_add_ss(s, _mm_shuffle_ps(s, s, _MM_SHUFFLE(1, 1, 1, 1)));
+    return _mm_cvtss_f32(s);
+}
+
+#endif // DYNEMIT_ARCH_X86
+
+// ===================================================
+// vector_gather_mul_f32: out[i] = a[idx[i]] * b[i]
+// ===================================================
+
+DYNEMIT_SCALAR_KERNEL_ATTRS
+static void
+vector_gather_mul_f32_scalar(const float *a, const int32_t *idx, const float *b, float *out, size_t n)
+{
+    for (size_t i = 0; i < n; i++)
+        out[i] = a[idx[i]] * b[i];
+}
+
+#if DYNEMIT_ARCH_X86
+
+__attribute__((target("avx2")))
+static void
+vector_gather_mul_f32_avx2(const float *a, const int32_t *idx, const float *b, float *out, size_t n)
+{
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m256 g0 = _mm256_i32gather_ps(a, _mm256_loadu_si256((const __m256i *)(idx + i)), 4);
+        __m256 g1 = _mm256_i32gather_ps(a, _mm256_loadu_si256((const __m256i *)(idx + i + 8)), 4);
+        _mm256_storeu_ps(out + i, _mm256_mul_ps(g0, _mm256_loadu_ps(b + i)));
+        _mm256_storeu_ps(out + i + 8, _mm256_mul_ps(g1, _mm256_loadu_ps(b + i + 8)));
+    }
+    for (; i + 8 <= n; i += 8) {
+        __m256 g = _mm256_i32gather_ps(a, _mm256_loadu_si256((const __m256i *)(idx + i)), 4);
+        _mm256_storeu_ps(out + i, _mm256_mul_ps(g, _mm256_loadu_ps(b + i)));
+    }
+    if (i < n) {
+        // Masked-off lanes are not gathered, so their (zero) indices never load
+        __m256i m = dynemit_mask8(n - i);
+        __m256i vi = _mm256_maskload_epi32(idx + i, m);
+        __m256 g = _mm256_mask_i32gather_ps(_mm256_setzero_ps(), a, vi, _mm256_castsi256_ps(m), 4);
+        _mm256_maskstore_ps(out + i, m, _mm256_mul_ps(g, _mm256_maskload_ps(b + i, m)));
+    }
+}
+
+__attribute__((target("avx512f")))
+static void
+vector_gather_mul_f32_avx512f(const float *a, const int32_t *idx, const float *b, float *out, size_t n)
+{
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        __m512 g0 = _mm512_i32gather_ps(_mm512_loadu_si512(idx + i), a, 4);
+        __m512 g1 = _mm512_i32gather_ps(_mm512_loadu_si512(idx + i + 16), a, 4);
+        _mm512_storeu_ps(out + i, _mm512_mul_ps(g0, _mm512_loadu_ps(b + i)));
+        _mm512_storeu_ps(out + i + 16, _mm512_mul_ps(g1, _mm512_loadu_ps(b + i + 16)));
+    }
+    for (; i + 16 <= n; i += 16) {
+        __m512 g = _mm512_i32gather_ps(_mm512_loadu_si512(idx + i), a, 4);
+        _mm512_storeu_ps(out + i, _mm512_mul_ps(g, _mm512_loadu_ps(b + i)));
+    }
+    if (i < n) {
+        __mmask16 m = dynemit_mask16(n - i);
+        __m512i vi = _mm512_maskz_loadu_epi32(m, idx + i);
+        __m512 g = _mm512_mask_i32gather_ps(_mm512_setzero_ps(), m, vi, a, 4);
+        _mm512_mask_storeu_ps(out + i, m, _mm512_mul_ps(g, _mm512_maskz_loadu_ps(m, b + i)));
+    }
+}
+
+#endif // DYNEMIT_ARCH_X86
+
+// ===================================================
+// dot_sparse_f32: sum(values[k] * dense[indices[k]])
+// ===================================================
+
+DYNEMIT_SCALAR_KERNEL_ATTRS
+static float
+dot_sparse_f32_scalar(const float *values, const int32_t *indices, size_t nnz, const float *dense)
+{
+    float s0 = 0.0f, s1 = 0.0f, s2 = 0.0f, s3 = 0.0f;
+    size_t k = 0;
+    for (; k + 4 <= nnz; k += 4) {
+        s0 += values[k + 0] * dense[indices[k + 0]];
+        s1 += values[k + 1] * dense[indices[k + 1]];
+        s2 += values[k + 2] * dense[indices[k + 2]];
+        s3 += values[k + 3] * dense[indices[k + 3]];
+    }
+    for (; k < nnz; k++)
+        s0 += values[k] * dense[indices[k]];
+    return (s0 + s1) + (s2 + s3);
+}
+
+#if DYNEMIT_ARCH_X86
+
+// Gathers bound the loop long before the adds do, so AVX2 needs no FMA
+__attribute__((target("avx2")))
+static float
+dot_sparse_f32_avx2(const float *values, const int32_t *indices, size_t nnz, const float *dense)
+{
+    __m256 acc0 = _mm256_setzero_ps(), acc1 = _mm256_setzero_ps();
+    size_t k = 0;
+    for (; k + 16 <= nnz; k += 16) {
+        __m256 g0 = _mm256_i32gather_ps(dense, _mm256_loadu_si256((const __m256i *)(indices + k)), 4);
+        __m256 g1 = _mm256_i32gather_ps(dense, _mm256_loadu_si256((const __m256i *)(indices + k + 8)), 4);
+        acc0 = _mm256_add_ps(acc0, _mm256_mul_ps(_mm256_loadu_ps(values + k), g0));
+        acc1 = _mm256_add_ps(acc1, _mm256_mul_ps(_mm256_loadu_ps(values + k + 8), g1));
+    }
+    for (; k + 8 <= nnz; k += 8) {
+        __m256 g = _mm256_i32gather_ps(dense, _mm256_loadu_si256((const __m256i *)(indices + k)), 4);
+        acc0 = _mm256_add_ps(acc0, _mm256_mul_ps(_mm256_loadu_ps(values + k), g));
+    }
+    if (k < nnz) {
+        // Masked-off lanes gather and load as zero and contribute nothing
+        __m256i m = dynemit_mask8(nnz - k);
+        __m256i vi = _mm256_maskload_epi32(indices + k, m);
+        __m256 g = _mm256_mask_i32gather_ps(_mm256_setzero_ps(), dense, vi, _mm256_castsi256_ps(m), 4);
+        acc1 = _mm256_add_ps(acc1, _mm256_mul_ps(_mm256_maskload_ps(values + k, m), g));
+    }
+    return hsum_ps_avx(_mm256_add_ps(acc0, acc1));
+}
+
+__attribute__((target("avx512f")))
+static float
+dot_sparse_f32_avx512f(const float *values, const int32_t *indices, size_t nnz, const float *dense)
+{
+    __m512 acc0 = _mm512_setzero_ps(), acc1 = _mm512_setzero_ps();
+    size_t k = 0;
+    for (; k + 32 <= nnz; k += 32) {
+        __m512 g0 = _mm512_i32gather_ps(_mm512_loadu_si512(indices + k), dense, 4);
+        __m512 g1 = _mm512_i32gather_ps(_mm512_loadu_si512(indices + k + 16), dense, 4);
+        acc0 = _mm512_fmadd_ps(_mm512_loadu_ps(values + k), g0, acc0);
+        acc1 = _mm512_fmadd_ps(_mm512_loadu_ps(values + k + 16), g1, acc1);
+    }
+    for (; k + 16 <= nnz; k += 16) {
+        __m512 g = _mm512_i32gather_ps(_mm512_loadu_si512(indices + k), dense, 4);
+        acc0 = _mm512_fmadd_ps(_mm512_loadu_ps(values + k), g, acc0);
+    }
+    if (k < nnz) {
+        __mmask16 m = dynemit_mask16(nnz - k);
+        __m512i vi = _mm512_maskz_loadu_epi32(m, indices + k);
+        __m512 g = _mm512_mask_i32gather_ps(_mm512_setzero_ps(), m, vi, dense, 4);
+        acc1 = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(m, values + k), g, acc1);
+    }
+    return _mm512_reduce_add_ps(_mm512_add_ps(acc0, acc1));
+}
+
+#endif // DYNEMIT_ARCH_X86
+
+// ===================================================
+// scatter_add_f32: out[idx[i]] += values[i]
+// ===================================================
+
+DYNEMIT_SCALAR_KERNEL_ATTRS
+static void
+scatter_add_f32_scalar(float *out, const int32_t *idx, const float *values, size_t n)
+{
+    for (size_t i = 0; i < n; i++)
+        out[idx[i]] += values[i];
+}
+
+#if DYNEMIT_ARCH_X86
+
+// A gather-add-scatter of a whole vector loses updates when two lanes share
+// an index. vpconflictd gives each lane the set of earlier lanes with the
+// same index; each round commits the pending lanes none of whose earlier
+// duplicates is still pending, so the indices within a round are distinct
+// and every index is updated in lane order, exactly like the scalar loop.
+// Without duplicates that is a single round.
+__attribute__((target("avx512f,avx512cd")))
+static void
+scatter_add_f32_avx512cd(float *out, const int32_t *idx, const float *values, size_t n)
+{
+    for (size_t i = 0; i < n; i += 16) {
+        __mmask16 todo = n - i >= 16 ? (__mmask16)0xffff : dynemit_mask16(n - i);
+        __m512i vi = _mm512_maskz_loadu_epi32(todo, idx + i);
+        __m512 v = _mm512_maskz_loadu_ps(todo, values + i);
+        __m512i conflicts = _mm512_conflict_epi32(vi);
+        do {
+            __mmask16 ready = _mm512_mask_testn_epi32_mask(todo, conflicts, _mm512_set1_epi32(todo));
+            __m512 g = _mm512_mask_i32gather_ps(_mm512_setzero_ps(), ready, vi, out, 4);
+            _mm512_mask_i32scatter_ps(out, ready, vi, _mm512_add_ps(g, v), 4);
+            todo &= (__mmask16)~ready;
+        } while (todo);
+    }
+}
+
+#endif // DYNEMIT_ARCH_X86
+
+// ===================================================
+// Resolver functions for ifunc
+// ===================================================
+
+typedef void (*vector_gather_mul_f32_func_t)(const float *, const int32_t *, const float *, float *, size_t);
+typedef float (*dot_sparse_f32_func_t)(const float *, const int32_t *, size_t, const float *);
+typedef void (*scatter_add_f32_func_t)(float *, const int32_t *, const float *, size_t);
+
+#if DYNEMIT_ARCH_X86
+
+static vector_gather_mul_f32_func_t
+vector_gather_mul_f32_select(simd_level_t level)
+{
+    switch (level) {
+    case SIMD_AVX512F: return vector_gather_mul_f32_avx512f;
+    case SIMD_AVX2:    return vector_gather_mul_f32_avx2;
+    case SIMD_AVX:
+    case SIMD_SSE4_2:
+    case SIMD_SSE2:
+    case SIMD_SCALAR:
+    default:           return vector_gather_mul_f32_scalar;
+    }
+}
+
+static dot_sparse_f32_func_t
+dot_sparse_f32_select(simd_level_t level)
+{
+    switch (level) {
+    case SIMD_AVX512F: return dot_sparse_f32_avx512f;
+    case SIMD_AVX2:    return dot_sparse_f32_avx2;
+    case SIMD_AVX:
+    case SIMD_SSE4_2:
+    case SIMD_SSE2:
+    case SIMD_SCALAR:
+    default:           return dot_sparse_f32_scalar;
+    }
+}
+
+// AVX2 has gathers but no scatters. The AVX-512CD kernel is offered at
+// AVX-512F for dynemit_get_kernel() and dynemit_rebind(), but the symbol
+// binds the scalar loop, see below
+static scatter_add_f32_func_t
+scatter_add_f32_select(simd_level_t level)
+{
+    if (level == SIMD_AVX512F && dynemit_cpu_has(DYNEMIT_CPU_AVX512CD))
+        return scatter_add_f32_avx512cd;
+    return scatter_add_f32_scalar;
+}
+
+#else // aarch64, RISC-V or scalar only: no gather kernels yet, every level is scalar
+
+static vector_gather_mul_f32_func_t
+vector_gather_mul_f32_select(simd_level_t level)
+{
+    (void)level;
+    return vector_gather_mul_f32_scalar;
+}
+
+static dot_sparse_f32_func_t
+dot_sparse_f32_select(simd_level_t level)
+{
+    (void)level;
+    return dot_sparse_f32_scalar;
+}
+
+static scatter_add_f32_func_t
+scatter_add_f32_select(simd_level_t level)
+{
+    (void)level;
+    return scatter_add_f32_scalar;
+}
+
+#endif
+
+DYNEMIT_DISPATCH(vector_gather_mul_f32, void,
+                 (const float *a, const int32_t *idx, const float *b, float *out, size_t n),
+                 (a, idx, b, out, n), n)
+DYNEMIT_DISPATCH(dot_sparse_f32, float,
+                 (const float *values, const int32_t *indices, size_t nnz, const float *dense),
+                 (values, indices, nnz, dense), nnz)
+// vpscatterdps is microcoded: the AVX-512CD kernel measured 0.6-0.9x of the
+// scalar loop at every size (see benchmark_sparse), so the scalar loop is
+// the default at every level
+DYNEMIT_DISPATCH_BIND(scatter_add_f32, scatter_add_f32_select(SIMD_SCALAR), SIMD_SCALAR, void,
+                      (float *out, const int32_t *idx, const float *values, size_t n), (out, idx, values, n), n)
@@ -1,120 +1,65 @@
 /* SPDX-License-Identifier: BSL-1.0 */
-#include <immintrin.h>
 #include <stddef.h>
+#include <stdint.h>
 #include <dynemit/core.h>
+#include <dynemit/vector_add.h>
+#include <dynemit/kernel.h>
+#include "../common/elementwise.h"
 
-// Scalar version - disable auto-vectorization to get true scalar code
-__attribute__((target("default")))
-__attribute__((optimize("no-tree-vectorize")))
-static void
-vector_add_f32_scalar(const float *a, const float *b, float *out, size_t n)
-{
-    for (size_t i = 0; i < n; i++)
-        out[i] = a[i] + b[i];
-}
+#if DYNEMIT_ARCH_X86
 
-__attribute__((target("sse2")))
-static void
-vector_add_f32_sse2(const float *a, const float *b, float *out, size_t n)
-{
-    size_t i = 0;
-    const size_t step = 4;
-    for (; i + step <= n; i += step) {
-        __m128 va = _mm_loadu_ps(a + i);
-        __m128 vb = _mm_loadu_ps(b + i);
-        __m128 vc = _mm_add_ps(va, vb);
-        _mm_storeu_ps(out + i, vc);
-    }
-    for (; i < n; i++)
-        out[i] = a[i] + b[i];
-}
+// float and double: every level generated from the lane-wise operation by
+// <dynemit/kernel.h>; AVX and up are dispatched by size between a loop-free
+// path for tiny inputs, a 4x-unrolled cache-resident body and a
+// prefetching, streaming body for inputs past L2
+DYNEMIT_KERNEL_BINARY_LEVELS(vector_add_f32, float, DYNEMIT_SCALAR_ADD)
 
-__attribute__((target("sse4.2")))
-static void
-vector_add_f32_sse42(const float *a, const float *b, float *out, size_t n)
-{
-    size_t i = 0;
-    const size_t step = 4;
-    for (; i + step <= n; i += step) {
-        __m128 va = _mm_loadu_ps(a + i);
-        __m128 vb = _mm_loadu_ps(b + i);
-        __m128 vc = _mm_add_ps(va, vb);
-        _mm_storeu_ps(out + i, vc);
-    }
-    for (; i < n; i++)
-        out[i] = a[i] + b[i];
-}
+DYNEMIT_BINARY_AUTOTUNE_DISPATCH(vector_add_f32)
 
-__attribute__((target("avx")))
-static void
-vector_add_f32_avx(const float *a, const float *b, float *out, size_t n)
-{
-    size_t i = 0;
-    const size_t step = 8;
-    for (; i + step <= n; i += step) {
-        __m256 va = _mm256_loadu_ps(a + i);
-        __m256 vb = _mm256_loadu_ps(b + i);
-        __m256 vc = _mm256_add_ps(va, vb);
-        _mm256_storeu_ps(out + i, vc);
-    }
-    for (; i < n; i++)
-        out[i] = a[i] + b[i];
-}
+// Many small vectors per call: vector_add_f32_batch/_batch_strided
+DYNEMIT_BINARY_BATCH(vector_add_f32, float)
 
-__attribute__((target("avx2")))
-static void
-vector_add_f32_avx2(const float *a, const float *b, float *out, size_t n)
-{
-    size_t i = 0;
-    const size_t step = 8;
-    for (; i + step <= n; i += step) {
-        __m256 va = _mm256_loadu_ps(a + i);
-        __m256 vb = _mm256_loadu_ps(b + i);
-        __m256 vc = _mm256_add_ps(va, vb);
-        _mm256_storeu_ps(out + i, vc);
-    }
-    for (; i < n; i++)
-        out[i] = a[i] + b[i];
-}
+// In place and with a broadcast scalar: vector_add_f32_ip, vector_add_scalar_f32
+// and vector_add_scalar_f32_ip
+DYNEMIT_BINARY_IP(vector_add_f32, float)
+DYNEMIT_BROADCAST_F32(vector_add_scalar_f32, DYNEMIT_SCALAR_ADD,
+                      _mm_add_ps, _mm256_add_ps, _mm512_add_ps)
 
-__attribute__((target("avx512f")))
-static void
-vector_add_f32_avx512f(const float *a, const float *b, float *out, size_t n)
-{
-    size_t i = 0;
-    const size_t step = 16;
-    for (; i + step <= n; i += step) {
-        __m512 va = _mm512_loadu_ps(a + i);
-        __m512 vb = _mm512_loadu_ps(b + i);
-        __m512 vc = _mm512_add_ps(va, vb);
-        _mm512_storeu_ps(out + i, vc);
-    }
-    for (; i < n; i++)
-        out[i] = a[i] + b[i];
-}
+DYNEMIT_KERNEL_BINARY(vector_add_f64, double, DYNEMIT_SCALAR_ADD)
+DYNEMIT_BINARY_IP(vector_add_f64, double)
+DYNEMIT_BROADCAST_F64(vector_add_scalar_f64, DYNEMIT_SCALAR_ADD,
+                      _mm_add_pd, _mm256_add_pd, _mm512_add_pd)
 
 // ===================================================
-// Resolver function for ifunc
+// int32_t (wrapping) and int16_t (saturating)
 // ===================================================
 
-typedef void (*vector_add_f32_func_t)(const float *, const float *, float *, size_t);
+DYNEMIT_BINARY_I32(vector_add_i32, dynemit_add_i32,
+                   _mm_add_epi32, _mm_add_epi32, _mm256_add_epi32, _mm512_add_epi32)
 
-static vector_add_f32_func_t
-vector_add_f32_resolver(void)
-{
-    simd_level_t level = detect_simd_level();
-    
-    switch (level) {
-    case SIMD_AVX512F: return vector_add_f32_avx512f;
-    case SIMD_AVX2:    return vector_add_f32_avx2;
-    case SIMD_AVX:     return vector_add_f32_avx;
-    case SIMD_SSE4_2:  return vector_add_f32_sse42;
-    case SIMD_SSE2:    return vector_add_f32_sse2;
-    case SIMD_SCALAR:
-    default:           return vector_add_f32_scalar;
-    }
-}
+DYNEMIT_BINARY_I16(vector_add_i16, dynemit_adds_i16,
+                   _mm_adds_epi16, _mm256_adds_epi16, _mm512_adds_epi16)
 
-__attribute__((target("avx512f,avx2,avx,sse4.2,sse2")))
-void vector_add_f32(const float *a, const float *b, float *out, size_t n)
-    __attribute__((ifunc("vector_add_f32_resolver")));
+#else // aarch64 (NEON, SVE, SVE2), RISC-V (RVV) or scalar only; see portable.h
+
+DYNEMIT_PORTABLE_BINARY_KERNELS(vector_add_f32, float, DYNEMIT_SCALAR_ADD,
+                                float32x4_t, 4, vld1q_f32, vst1q_f32, vaddq_f32)
+DYNEMIT_BINARY_AUTOTUNE_DISPATCH(vector_add_f32)
+DYNEMIT_PORTABLE_BATCH(vector_add_f32, float)
+DYNEMIT_PORTABLE_IP(vector_add_f32, float)
+DYNEMIT_PORTABLE_BROADCAST(vector_add_scalar_f32, float, DYNEMIT_SCALAR_ADD, float32x4_t, 4,
+                           vdupq_n_f32, vld1q_f32, vst1q_f32, vaddq_f32)
+
+DYNEMIT_PORTABLE_BINARY(vector_add_f64, double, DYNEMIT_SCALAR_ADD,
+                        float64x2_t, 2, vld1q_f64, vst1q_f64, vaddq_f64)
+DYNEMIT_PORTABLE_IP(vector_add_f64, double)
+DYNEMIT_PORTABLE_BROADCAST(vector_add_scalar_f64, double, DYNEMIT_SCALAR_ADD, float64x2_t, 2,
+                           vdupq_n_f64, vld1q_f64, vst1q_f64, vaddq_f64)
+
+DYNEMIT_PORTABLE_BINARY(vector_add_i32, int32_t, dynemit_add_i32,
+                        int32x4_t, 4, vld1q_s32, vst1q_s32, vaddq_s32)
+
+DYNEMIT_PORTABLE_BINARY(vector_add_i16, int16_t, dynemit_adds_i16,
+                        int16x8_t, 8, vld1q_s16, vst1q_s16, vqaddq_s16)
+
+#endif
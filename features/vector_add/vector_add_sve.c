@@ -0,0 +1,19 @@
+/* SPDX-License-Identifier: BSL-1.0 */
+#include <stddef.h>
+#include <stdint.h>
+#include <dynemit/core.h>
+#include "../common/elementwise.h"
+
+// SVE kernels of vector_add.c. This file is built with SVE enabled and its
+// functions are only reached through the resolvers there.
+
+DYNEMIT_SVE_BINARY(vector_add_f32, float, 32, svadd_x)
+DYNEMIT_SVE_BROADCAST(vector_add_scalar_f32, float, 32, svadd_x)
+
+DYNEMIT_SVE_BINARY(vector_add_f64, double, 64, svadd_x)
+DYNEMIT_SVE_BROADCAST(vector_add_scalar_f64, double, 64, svadd_x)
+
+DYNEMIT_SVE_BINARY(vector_add_i32, int32_t, 32, svadd_x)
+
+#define QOP(pg, x, y) svqadd(x, y)  // saturating, no predicate needed
+DYNEMIT_SVE_BINARY(vector_add_i16, int16_t, 16, QOP)
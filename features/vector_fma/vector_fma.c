@@ -0,0 +1,393 @@
+/* SPDX-License-Identifier: BSL-1.0 */
+#include <stddef.h>
+#include <dynemit/core.h>
+#include <dynemit/vector_fma.h>
+#include "../common/elementwise.h"
+
+// ===================================================
+// vector_fma_f32: out[i] = a[i] * b[i] + c[i]
+// ===================================================
+
+// Scalar version - disable auto-vectorization to get true scalar code
+DYNEMIT_SCALAR_KERNEL_ATTRS
+static void
+vector_fma_f32_scalar(const float *a, const float *b, const float *c, float *out, size_t n)
+{
+    for (size_t i = 0; i < n; i++)
+        out[i] = a[i] * b[i] + c[i];
+}
+
+#if DYNEMIT_ARCH_X86
+
+__attribute__((target("sse2")))
+static void
+vector_fma_f32_sse2(const float *a, const float *b, const float *c, float *out, size_t n)
+{
+    size_t i = 0;
+    const size_t step = 4;
+    for (; i + step <= n; i += step) {
+        __m128 va = _mm_loadu_ps(a + i);
+        __m128 vb = _mm_loadu_ps(b + i);
+        __m128 vc = _mm_loadu_ps(c + i);
+        __m128 vr = _mm_add_ps(_mm_mul_ps(va, vb), vc);
+        _mm_storeu_ps(out + i, vr);
+    }
+    for (; i < n; i++)
+        out[i] = a[i] * b[i] + c[i];
+}
+
+__attribute__((target("sse4.2")))
+static void
+vector_fma_f32_sse42(const float *a, const float *b, const float *c, float *out, size_t n)
+{
+    size_t i = 0;
+    const size_t step = 4;
+    for (; i + step <= n; i += step) {
+        __m128 va = _mm_loadu_ps(a + i);
+        __m128 vb = _mm_loadu_ps(b + i);
+        __m128 vc = _mm_loadu_ps(c + i);
+        __m128 vr = _mm_add_ps(_mm_mul_ps(va, vb), vc);
+        _mm_storeu_ps(out + i, vr);
+    }
+    for (; i < n; i++)
+        out[i] = a[i] * b[i] + c[i];
+}
+
+__attribute__((target("avx")))
+static void
+vector_fma_f32_avx(const float *a, const float *b, const float *c, float *out, size_t n)
+{
+    size_t i = 0;
+    const size_t step = 8;
+
+    // Masked head so the full-width stores below never split a cache line
+    size_t head = n >= DYNEMIT_PEEL_MIN_VECTORS * step ? dynemit_head_count(out, 32, n) : 0;
+    if (head) {
+        __m256i m = dynemit_mask8(head);
+        __m256 va = _mm256_maskload_ps(a, m);
+        __m256 vb = _mm256_maskload_ps(b, m);
+        __m256 vc = _mm256_maskload_ps(c, m);
+        _mm256_maskstore_ps(out, m, _mm256_add_ps(_mm256_mul_ps(va, vb), vc));
+        i = head;
+    }
+    for (; i + step <= n; i += step) {
+        __m256 va = _mm256_loadu_ps(a + i);
+        __m256 vb = _mm256_loadu_ps(b + i);
+        __m256 vc = _mm256_loadu_ps(c + i);
+        __m256 vr = _mm256_add_ps(_mm256_mul_ps(va, vb), vc);
+        _mm256_storeu_ps(out + i, vr);
+    }
+    // Masked tail instead of a scalar remainder loop
+    if (i < n) {
+        __m256i m = dynemit_mask8(n - i);
+        __m256 va = _mm256_maskload_ps(a + i, m);
+        __m256 vb = _mm256_maskload_ps(b + i, m);
+        __m256 vc = _mm256_maskload_ps(c + i, m);
+        _mm256_maskstore_ps(out + i, m, _mm256_add_ps(_mm256_mul_ps(va, vb), vc));
+    }
+}
+
+// FMA3 (Haswell+, Piledriver+) only needs AVX state, so it does not require AVX2
+__attribute__((target("avx,fma")))
+static void
+vector_fma_f32_fma3(const float *a, const float *b, const float *c, float *out, size_t n)
+{
+    size_t i = 0;
+    const size_t step = 8;
+
+    // Masked head so the full-width stores below never split a cache line
+    size_t head = n >= DYNEMIT_PEEL_MIN_VECTORS * step ? dynemit_head_count(out, 32, n) : 0;
+    if (head) {
+        __m256i m = dynemit_mask8(head);
+        __m256 va = _mm256_maskload_ps(a, m);
+        __m256 vb = _mm256_maskload_ps(b, m);
+        __m256 vc = _mm256_maskload_ps(c, m);
+        _mm256_maskstore_ps(out, m, _mm256_fmadd_ps(va, vb, vc));
+        i = head;
+    }
+    for (; i + step <= n; i += step) {
+        __m256 va = _mm256_loadu_ps(a + i);
+        __m256 vb = _mm256_loadu_ps(b + i);
+        __m256 vc = _mm256_loadu_ps(c + i);
+        __m256 vr = _mm256_fmadd_ps(va, vb, vc);
+        _mm256_storeu_ps(out + i, vr);
+    }
+    // Masked tail instead of a scalar remainder loop
+    if (i < n) {
+        __m256i m = dynemit_mask8(n - i);
+        __m256 va = _mm256_maskload_ps(a + i, m);
+        __m256 vb = _mm256_maskload_ps(b + i, m);
+        __m256 vc = _mm256_maskload_ps(c + i, m);
+        _mm256_maskstore_ps(out + i, m, _mm256_fmadd_ps(va, vb, vc));
+    }
+}
+
+__attribute__((target("avx512f")))
+static void
+vector_fma_f32_avx512f(const float *a, const float *b, const float *c, float *out, size_t n)
+{
+    size_t i = 0;
+    const size_t step = 16;
+
+    // Masked head so the full-width stores below are cache-line aligned
+    size_t head = n >= DYNEMIT_PEEL_MIN_VECTORS * step ? dynemit_head_count(out, 64, n) : 0;
+    if (head) {
+        __mmask16 m = dynemit_mask16(head);
+        __m512 va = _mm512_maskz_loadu_ps(m, a);
+        __m512 vb = _mm512_maskz_loadu_ps(m, b);
+        __m512 vc = _mm512_maskz_loadu_ps(m, c);
+        _mm512_mask_storeu_ps(out, m, _mm512_fmadd_ps(va, vb, vc));
+        i = head;
+    }
+    for (; i + step <= n; i += step) {
+        __m512 va = _mm512_loadu_ps(a + i);
+        __m512 vb = _mm512_loadu_ps(b + i);
+        __m512 vc = _mm512_loadu_ps(c + i);
+        __m512 vr = _mm512_fmadd_ps(va, vb, vc);
+        _mm512_storeu_ps(out + i, vr);
+    }
+    // Single masked tail instead of a scalar remainder loop
+    if (i < n) {
+        __mmask16 m = dynemit_mask16(n - i);
+        __m512 va = _mm512_maskz_loadu_ps(m, a + i);
+        __m512 vb = _mm512_maskz_loadu_ps(m, b + i);
+        __m512 vc = _mm512_maskz_loadu_ps(m, c + i);
+        _mm512_mask_storeu_ps(out + i, m, _mm512_fmadd_ps(va, vb, vc));
+    }
+}
+
+#endif // DYNEMIT_ARCH_X86
+
+// ===================================================
+// vector_axpy_f32: y[i] += alpha * x[i]
+// ===================================================
+
+DYNEMIT_SCALAR_KERNEL_ATTRS
+static void
+vector_axpy_f32_scalar(float alpha, const float *x, float *y, size_t n)
+{
+    for (size_t i = 0; i < n; i++)
+        y[i] = alpha * x[i] + y[i];
+}
+
+#if DYNEMIT_ARCH_X86
+
+__attribute__((target("sse2")))
+static void
+vector_axpy_f32_sse2(float alpha, const float *x, float *y, size_t n)
+{
+    size_t i = 0;
+    const size_t step = 4;
+    __m128 valpha = _mm_set1_ps(alpha);
+    for (; i + step <= n; i += step) {
+        __m128 vx = _mm_loadu_ps(x + i);
+        __m128 vy = _mm_loadu_ps(y + i);
+        __m128 vr = _mm_add_ps(_mm_mul_ps(valpha, vx), vy);
+        _mm_storeu_ps(y + i, vr);
+    }
+    for (; i < n; i++)
+        y[i] = alpha * x[i] + y[i];
+}
+
+__attribute__((target("sse4.2")))
+static void
+vector_axpy_f32_sse42(float alpha, const float *x, float *y, size_t n)
+{
+    size_t i = 0;
+    const size_t step = 4;
+    __m128 valpha = _mm_set1_ps(alpha);
+    for (; i + step <= n; i += step) {
+        __m128 vx = _mm_loadu_ps(x + i);
+        __m128 vy = _mm_loadu_ps(y + i);
+        __m128 vr = _mm_add_ps(_mm_mul_ps(valpha, vx), vy);
+        _mm_storeu_ps(y + i, vr);
+    }
+    for (; i < n; i++)
+        y[i] = alpha * x[i] + y[i];
+}
+
+__attribute__((target("avx")))
+static void
+vector_axpy_f32_avx(float alpha, const float *x, float *y, size_t n)
+{
+    size_t i = 0;
+    const size_t step = 8;
+    __m256 valpha = _mm256_set1_ps(alpha);
+
+    // Masked head so the full-width stores below never split a cache line
+    size_t head = n >= DYNEMIT_PEEL_MIN_VECTORS * step ? dynemit_head_count(y, 32, n) : 0;
+    if (head) {
+        __m256i m = dynemit_mask8(head);
+        __m256 vx = _mm256_maskload_ps(x, m);
+        __m256 vy = _mm256_maskload_ps(y, m);
+        _mm256_maskstore_ps(y, m, _mm256_add_ps(_mm256_mul_ps(valpha, vx), vy));
+        i = head;
+    }
+    for (; i + step <= n; i += step) {
+        __m256 vx = _mm256_loadu_ps(x + i);
+        __m256 vy = _mm256_loadu_ps(y + i);
+        __m256 vr = _mm256_add_ps(_mm256_mul_ps(valpha, vx), vy);
+        _mm256_storeu_ps(y + i, vr);
+    }
+    // Masked tail instead of a scalar remainder loop
+    if (i < n) {
+        __m256i m = dynemit_mask8(n - i);
+        __m256 vx = _mm256_maskload_ps(x + i, m);
+        __m256 vy = _mm256_maskload_ps(y + i, m);
+        _mm256_maskstore_ps(y + i, m, _mm256_add_ps(_mm256_mul_ps(valpha, vx), vy));
+    }
+}
+
+__attribute__((target("avx,fma")))
+static void
+vector_axpy_f32_fma3(float alpha, const float *x, float *y, size_t n)
+{
+    size_t i = 0;
+    const size_t step = 8;
+    __m256 valpha = _mm256_set1_ps(alpha);
+
+    // Masked head so the full-width stores below never split a cache line
+    size_t head = n >= DYNEMIT_PEEL_MIN_VECTORS * step ? dynemit_head_count(y, 32, n) : 0;
+    if (head) {
+        __m256i m = dynemit_mask8(head);
+        __m256 vx = _mm256_maskload_ps(x, m);
+        __m256 vy = _mm256_maskload_ps(y, m);
+        _mm256_maskstore_ps(y, m, _mm256_fmadd_ps(valpha, vx, vy));
+        i = head;
+    }
+    for (; i + step <= n; i += step) {
+        __m256 vx = _mm256_loadu_ps(x + i);
+        __m256 vy = _mm256_loadu_ps(y + i);
+        __m256 vr = _mm256_fmadd_ps(valpha, vx, vy);
+        _mm256_storeu_ps(y + i, vr);
+    }
+    // Masked tail instead of a scalar remainder loop
+    if (i < n) {
+        __m256i m = dynemit_mask8(n - i);
+        __m256 vx = _mm256_maskload_ps(x + i, m);
+        __m256 vy = _mm256_maskload_ps(y + i, m);
+        _mm256_maskstore_ps(y + i, m, _mm256_fmadd_ps(valpha, vx, vy));
+    }
+}
+
+__attribute__((target("avx512f")))
+static void
+vector_axpy_f32_avx512f(float alpha, const float *x, float *y, size_t n)
+{
+    size_t i = 0;
+    const size_t step = 16;
+    __m512 valpha = _mm512_set1_ps(alpha);
+
+    // Masked head so the full-width stores below are cache-line aligned
+    size_t head = n >= DYNEMIT_PEEL_MIN_VECTORS * step ? dynemit_head_count(y, 64, n) : 0;
+    if (head) {
+        __mmask16 m = dynemit_mask16(head);
+        __m512 vx = _mm512_maskz_loadu_ps(m, x);
+        __m512 vy = _mm512_maskz_loadu_ps(m, y);
+        _mm512_mask_storeu_ps(y, m, _mm512_fmadd_ps(valpha, vx, vy));
+        i = head;
+    }
+    for (; i + step <= n; i += step) {
+        __m512 vx = _mm512_loadu_ps(x + i);
+        __m512 vy = _mm512_loadu_ps(y + i);
+        __m512 vr = _mm512_fmadd_ps(valpha, vx, vy);
+        _mm512_storeu_ps(y + i, vr);
+    }
+    // Single masked tail instead of a scalar remainder loop
+    if (i < n) {
+        __mmask16 m = dynemit_mask16(n - i);
+        __m512 vx = _mm512_maskz_loadu_ps(m, x + i);
+        __m512 vy = _mm512_maskz_loadu_ps(m, y + i);
+        _mm512_mask_storeu_ps(y + i, m, _mm512_fmadd_ps(valpha, vx, vy));
+    }
+}
+
+// ===================================================
+// Resolver functions for ifunc
+// ===================================================
+
+typedef void (*vector_fma_f32_func_t)(const float *, const float *, const float *, float *, size_t);
+typedef void (*vector_axpy_f32_func_t)(float, const float *, float *, size_t);
+
+// FMA3 is not part of the simd_level_t ladder, so the AVX/AVX2 cases also
+// consult the feature bitmask before picking the fused variant
+static vector_fma_f32_func_t
+vector_fma_f32_select(simd_level_t level)
+{
+    int fma3 = dynemit_cpu_has(DYNEMIT_CPU_FMA);
+
+    switch (level) {
+    case SIMD_AVX512F: return vector_fma_f32_avx512f;
+    case SIMD_AVX2:
+    case SIMD_AVX:     return fma3 ? vector_fma_f32_fma3 : vector_fma_f32_avx;
+    case SIMD_SSE4_2:  return vector_fma_f32_sse42;
+    case SIMD_SSE2:    return vector_fma_f32_sse2;
+    case SIMD_SCALAR:
+    default:           return vector_fma_f32_scalar;
+    }
+}
+
+DYNEMIT_DISPATCH(vector_fma_f32, void,
+                 (const float *a, const float *b, const float *c, float *out, size_t n),
+                 (a, b, c, out, n), n)
+
+static vector_axpy_f32_func_t
+vector_axpy_f32_select(simd_level_t level)
+{
+    int fma3 = dynemit_cpu_has(DYNEMIT_CPU_FMA);
+
+    switch (level) {
+    case SIMD_AVX512F: return vector_axpy_f32_avx512f;
+    case SIMD_AVX2:
+    case SIMD_AVX:     return fma3 ? vector_axpy_f32_fma3 : vector_axpy_f32_avx;
+    case SIMD_SSE4_2:  return vector_axpy_f32_sse42;
+    case SIMD_SSE2:    return vector_axpy_f32_sse2;
+    case SIMD_SCALAR:
+    default:           return vector_axpy_f32_scalar;
+    }
+}
+
+DYNEMIT_DISPATCH(vector_axpy_f32, void, (float alpha, const float *x, float *y, size_t n),
+                 (alpha, x, y, n), n)
+
+#else // aarch64 (NEON, SVE), RISC-V (RVV) or scalar only; see portable.h
+
+#if defined(__aarch64__)
+static void
+vector_fma_f32_neon(const float *a, const float *b, const float *c, float *out, size_t n)
+{
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+        vst1q_f32(out + i, vfmaq_f32(vld1q_f32(c + i), vld1q_f32(a + i), vld1q_f32(b + i)));
+    for (; i < n; i++)
+        out[i] = a[i] * b[i] + c[i];
+}
+
+static void
+vector_axpy_f32_neon(float alpha, const float *x, float *y, size_t n)
+{
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+        vst1q_f32(y + i, vfmaq_n_f32(vld1q_f32(y + i), vld1q_f32(x + i), alpha));
+    for (; i < n; i++)
+        y[i] = alpha * x[i] + y[i];
+}
+#endif
+
+DYNEMIT_EXTERN_KERNEL(vector_fma_f32, void,
+                      (const float *a, const float *b, const float *c, float *out, size_t n))
+DYNEMIT_EXTERN_KERNEL(vector_axpy_f32, void, (float alpha, const float *x, float *y, size_t n))
+
+typedef void (*vector_fma_f32_func_t)(const float *, const float *, const float *, float *, size_t);
+typedef void (*vector_axpy_f32_func_t)(float, const float *, float *, size_t);
+
+DYNEMIT_PORTABLE_SELECT(vector_fma_f32)
+DYNEMIT_DISPATCH(vector_fma_f32, void,
+                 (const float *a, const float *b, const float *c, float *out, size_t n),
+                 (a, b, c, out, n), n)
+
+DYNEMIT_PORTABLE_SELECT(vector_axpy_f32)
+DYNEMIT_DISPATCH(vector_axpy_f32, void, (float alpha, const float *x, float *y, size_t n),
+                 (alpha, x, y, n), n)
+
+#endif
@@ -0,0 +1,31 @@
+/* SPDX-License-Identifier: BSL-1.0 */
+#include <stddef.h>
+#include <dynemit/core.h>
+#include "../common/elementwise.h"
+
+// RVV kernels of vector_fma.c, built with the V extension enabled and only
+// reached through the resolvers there. LMUL=8 leaves room for the four
+// operand groups.
+
+void
+vector_fma_f32_rvv(const float *a, const float *b, const float *c, float *out, size_t n)
+{
+    for (size_t i = 0, vl; i < n; i += vl) {
+        vl = __riscv_vsetvl_e32m8(n - i);
+        vfloat32m8_t acc = __riscv_vle32_v_f32m8(c + i, vl);
+        acc = __riscv_vfmacc_vv_f32m8(acc, __riscv_vle32_v_f32m8(a + i, vl),
+                                      __riscv_vle32_v_f32m8(b + i, vl), vl);
+        __riscv_vse32_v_f32m8(out + i, acc, vl);
+    }
+}
+
+void
+vector_axpy_f32_rvv(float alpha, const float *x, float *y, size_t n)
+{
+    for (size_t i = 0, vl; i < n; i += vl) {
+        vl = __riscv_vsetvl_e32m8(n - i);
+        vfloat32m8_t acc = __riscv_vle32_v_f32m8(y + i, vl);
+        acc = __riscv_vfmacc_vf_f32m8(acc, alpha, __riscv_vle32_v_f32m8(x + i, vl), vl);
+        __riscv_vse32_v_f32m8(y + i, acc, vl);
+    }
+}
@@ -0,0 +1,26 @@
+/* SPDX-License-Identifier: BSL-1.0 */
+#include <stddef.h>
+#include <dynemit/core.h>
+#include "../common/elementwise.h"
+
+// SVE kernels of vector_fma.c, built with SVE enabled and only reached
+// through the resolvers there.
+
+void
+vector_fma_f32_sve(const float *a, const float *b, const float *c, float *out, size_t n)
+{
+    for (size_t i = 0; i < n; i += svcntw()) {
+        svbool_t pg = svwhilelt_b32((uint64_t)i, (uint64_t)n);
+        svfloat32_t r = svmla_x(pg, svld1(pg, c + i), svld1(pg, a + i), svld1(pg, b + i));
+        svst1(pg, out + i, r);
+    }
+}
+
+void
+vector_axpy_f32_sve(float alpha, const float *x, float *y, size_t n)
+{
+    for (size_t i = 0; i < n; i += svcntw()) {
+        svbool_t pg = svwhilelt_b32((uint64_t)i, (uint64_t)n);
+        svst1(pg, y + i, svmla_x(pg, svld1(pg, y + i), svld1(pg, x + i), alpha));
+    }
+}
@@ -1,121 +1,145 @@
 /* SPDX-License-Identifier: BSL-1.0 */
-#include <immintrin.h>
 #include <stddef.h>
+#include <stdint.h>
 #include <dynemit/core.h>
+#include <dynemit/vector_mul.h>
+#include <dynemit/kernel.h>
+#include "../common/elementwise.h"
 
-// Scalar version - disable auto-vectorization to get true scalar code
-__attribute__((target("default")))
-__attribute__((optimize("no-tree-vectorize")))
-static void
-vector_mul_f32_scalar(const float *a, const float *b, float *out, size_t n)
-{
-    for (size_t i = 0; i < n; i++)
-        out[i] = a[i] * b[i];
-}
+#if DYNEMIT_ARCH_X86
+
+// float and double: every level generated from the lane-wise operation by
+// <dynemit/kernel.h>; AVX and up are dispatched by size between a loop-free
+// path for tiny inputs, a 4x-unrolled cache-resident body and a
+// prefetching, streaming body for inputs past L2
+DYNEMIT_KERNEL_BINARY_LEVELS(vector_mul_f32, float, DYNEMIT_SCALAR_MUL)
+
+DYNEMIT_BINARY_AUTOTUNE_DISPATCH(vector_mul_f32)
+
+// Many small vectors per call: vector_mul_f32_batch/_batch_strided
+DYNEMIT_BINARY_BATCH(vector_mul_f32, float)
+
+// In place and with a broadcast scalar: vector_mul_f32_ip, vector_mul_scalar_f32
+// and vector_mul_scalar_f32_ip
+DYNEMIT_BINARY_IP(vector_mul_f32, float)
+DYNEMIT_BROADCAST_F32(vector_mul_scalar_f32, DYNEMIT_SCALAR_MUL,
+                      _mm_mul_ps, _mm256_mul_ps, _mm512_mul_ps)
+
+DYNEMIT_KERNEL_BINARY(vector_mul_f64, double, DYNEMIT_SCALAR_MUL)
+DYNEMIT_BINARY_IP(vector_mul_f64, double)
+DYNEMIT_BROADCAST_F64(vector_mul_scalar_f64, DYNEMIT_SCALAR_MUL,
+                      _mm_mul_pd, _mm256_mul_pd, _mm512_mul_pd)
 
+// ===================================================
+// int32_t (wrapping) and int16_t (saturating)
+// ===================================================
+
+// SSE2 has no 32-bit low multiply (pmulld is SSE4.1): multiply the even and
+// odd lanes as 64-bit products and interleave the low halves back
 __attribute__((target("sse2")))
-static void
-vector_mul_f32_sse2(const float *a, const float *b, float *out, size_t n)
+static inline __m128i
+mullo_epi32_sse2(__m128i a, __m128i b)
 {
-    size_t i = 0;
-    const size_t step = 4;
-    for (; i + step <= n; i += step) {
-        __m128 va = _mm_loadu_ps(a + i);
-        __m128 vb = _mm_loadu_ps(b + i);
-        __m128 vc = _mm_mul_ps(va, vb);
-        _mm_storeu_ps(out + i, vc);
-    }
-    for (; i < n; i++)
-        out[i] = a[i] * b[i];
+    __m128i even = _mm_mul_epu32(a, b);
+    __m128i odd  = _mm_mul_epu32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32));
+    return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)),
+                              _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
 }
 
-__attribute__((target("sse4.2")))
-static void
-vector_mul_f32_sse42(const float *a, const float *b, float *out, size_t n)
+DYNEMIT_BINARY_I32(vector_mul_i32, dynemit_mul_i32,
+                   mullo_epi32_sse2, _mm_mullo_epi32, _mm256_mullo_epi32, _mm512_mullo_epi32)
+
+// Saturating 16-bit multiply: rebuild the full 32-bit products from the low
+// and high halves, then pack them back with signed saturation. Unpack and
+// pack both work per 128-bit lane, so element order is preserved.
+__attribute__((target("sse2")))
+static inline __m128i
+mulsat_epi16_sse2(__m128i a, __m128i b)
 {
-    size_t i = 0;
-    const size_t step = 4;
-    for (; i + step <= n; i += step) {
-        __m128 va = _mm_loadu_ps(a + i);
-        __m128 vb = _mm_loadu_ps(b + i);
-        __m128 vc = _mm_mul_ps(va, vb);
-        _mm_storeu_ps(out + i, vc);
-    }
-    for (; i < n; i++)
-        out[i] = a[i] * b[i];
+    __m128i lo = _mm_mullo_epi16(a, b);
+    __m128i hi = _mm_mulhi_epi16(a, b);
+    return _mm_packs_epi32(_mm_unpacklo_epi16(lo, hi), _mm_unpackhi_epi16(lo, hi));
 }
 
-__attribute__((target("avx")))
-static void
-vector_mul_f32_avx(const float *a, const float *b, float *out, size_t n)
+__attribute__((target("avx2")))
+static inline __m256i
+mulsat_epi16_avx2(__m256i a, __m256i b)
 {
-    size_t i = 0;
-    const size_t step = 8;
-    for (; i + step <= n; i += step) {
-        __m256 va = _mm256_loadu_ps(a + i);
-        __m256 vb = _mm256_loadu_ps(b + i);
-        __m256 vc = _mm256_mul_ps(va, vb);
-        _mm256_storeu_ps(out + i, vc);
-    }
-    for (; i < n; i++)
-        out[i] = a[i] * b[i];
+    __m256i lo = _mm256_mullo_epi16(a, b);
+    __m256i hi = _mm256_mulhi_epi16(a, b);
+    return _mm256_packs_epi32(_mm256_unpacklo_epi16(lo, hi), _mm256_unpackhi_epi16(lo, hi));
 }
 
-__attribute__((target("avx2")))
-static void
-vector_mul_f32_avx2(const float *a, const float *b, float *out, size_t n)
+__attribute__((target("avx512f,avx512bw")))
+static inline __m512i
+mulsat_epi16_avx512bw(__m512i a, __m512i b)
 {
-    size_t i = 0;
-    const size_t step = 8;
-    for (; i + step <= n; i += step) {
-        __m256 va = _mm256_loadu_ps(a + i);
-        __m256 vb = _mm256_loadu_ps(b + i);
-        __m256 vc = _mm256_mul_ps(va, vb);
-        _mm256_storeu_ps(out + i, vc);
-    }
-    for (; i < n; i++)
-        out[i] = a[i] * b[i];
+    __m512i lo = _mm512_mullo_epi16(a, b);
+    __m512i hi = _mm512_mulhi_epi16(a, b);
+    return _mm512_packs_epi32(_mm512_unpacklo_epi16(lo, hi), _mm512_unpackhi_epi16(lo, hi));
 }
 
-__attribute__((target("avx512f")))
-static void
-vector_mul_f32_avx512f(const float *a, const float *b, float *out, size_t n)
+DYNEMIT_BINARY_I16(vector_mul_i16, dynemit_muls_i16,
+                   mulsat_epi16_sse2, mulsat_epi16_avx2, mulsat_epi16_avx512bw)
+
+#else // aarch64 (NEON, SVE, SVE2), RISC-V (RVV) or scalar only; see portable.h
+
+#if defined(__aarch64__)
+// Saturating 16-bit multiply: widening multiplies of each half, then
+// narrowing with signed saturation
+static inline int16x8_t
+mulsat_s16_neon(int16x8_t a, int16x8_t b)
 {
-    size_t i = 0;
-    const size_t step = 16;
-    for (; i + step <= n; i += step) {
-        __m512 va = _mm512_loadu_ps(a + i);
-        __m512 vb = _mm512_loadu_ps(b + i);
-        __m512 vc = _mm512_mul_ps(va, vb);
-        _mm512_storeu_ps(out + i, vc);
-    }
-    for (; i < n; i++)
-        out[i] = a[i] * b[i];
+    int32x4_t lo = vmull_s16(vget_low_s16(a), vget_low_s16(b));
+    int32x4_t hi = vmull_high_s16(a, b);
+    return vcombine_s16(vqmovn_s32(lo), vqmovn_s32(hi));
 }
+#endif
 
-// ===================================================
-// Resolver function for ifunc
-// ===================================================
+DYNEMIT_PORTABLE_BINARY_KERNELS(vector_mul_f32, float, DYNEMIT_SCALAR_MUL,
+                                float32x4_t, 4, vld1q_f32, vst1q_f32, vmulq_f32)
+DYNEMIT_BINARY_AUTOTUNE_DISPATCH(vector_mul_f32)
+DYNEMIT_PORTABLE_BATCH(vector_mul_f32, float)
+DYNEMIT_PORTABLE_IP(vector_mul_f32, float)
+DYNEMIT_PORTABLE_BROADCAST(vector_mul_scalar_f32, float, DYNEMIT_SCALAR_MUL, float32x4_t, 4,
+                           vdupq_n_f32, vld1q_f32, vst1q_f32, vmulq_f32)
+
+DYNEMIT_PORTABLE_BINARY(vector_mul_f64, double, DYNEMIT_SCALAR_MUL,
+                        float64x2_t, 2, vld1q_f64, vst1q_f64, vmulq_f64)
+DYNEMIT_PORTABLE_IP(vector_mul_f64, double)
+DYNEMIT_PORTABLE_BROADCAST(vector_mul_scalar_f64, double, DYNEMIT_SCALAR_MUL, float64x2_t, 2,
+                           vdupq_n_f64, vld1q_f64, vst1q_f64, vmulq_f64)
+
+DYNEMIT_PORTABLE_BINARY(vector_mul_i32, int32_t, dynemit_mul_i32,
+                        int32x4_t, 4, vld1q_s32, vst1q_s32, vmulq_s32)
+
+// SVE2 has widening multiplies of the even/odd lanes and saturating narrows
+// into them, so vector_mul_i16 has a kernel of its own there
+DYNEMIT_BINARY_KERNEL_SCALAR(vector_mul_i16, int16_t, dynemit_muls_i16)
+DYNEMIT_NEON_BINARY_KERNEL(vector_mul_i16, int16_t, int16x8_t, 8,
+                           vld1q_s16, vst1q_s16, mulsat_s16_neon, dynemit_muls_i16)
+DYNEMIT_EXTERN_KERNEL(vector_mul_i16, void,
+                      (const int16_t *a, const int16_t *b, int16_t *out, size_t n))
+DYNEMIT_EXTERN_KERNEL_SVE2(vector_mul_i16, void,
+                           (const int16_t *a, const int16_t *b, int16_t *out, size_t n))
 
-typedef void (*vector_mul_f32_func_t)(const float *, const float *, float *, size_t);
+typedef void (*vector_mul_i16_func_t)(const int16_t *, const int16_t *, int16_t *, size_t);
 
-static vector_mul_f32_func_t
-vector_mul_f32_resolver(void)
+static vector_mul_i16_func_t
+vector_mul_i16_select(simd_level_t level)
 {
-    simd_level_t level = detect_simd_level();
-    
     switch (level) {
-    case SIMD_AVX512F: return vector_mul_f32_avx512f;
-    case SIMD_AVX2:    return vector_mul_f32_avx2;
-    case SIMD_AVX:     return vector_mul_f32_avx;
-    case SIMD_SSE4_2:  return vector_mul_f32_sse42;
-    case SIMD_SSE2:    return vector_mul_f32_sse2;
+    case SIMD_SVE2:    return DYNEMIT_SVE2_KERNEL(vector_mul_i16);
+    case SIMD_SVE:     return DYNEMIT_SVE_KERNEL(vector_mul_i16);
+    case SIMD_NEON:    return DYNEMIT_NEON_KERNEL(vector_mul_i16);
+    case SIMD_RVV:     return DYNEMIT_RVV_KERNEL(vector_mul_i16);
     case SIMD_SCALAR:
-    default:           return vector_mul_f32_scalar;
+    default:           return vector_mul_i16_scalar;
     }
 }
 
-__attribute__((target("avx512f,avx2,avx,sse4.2,sse2")))
-void vector_mul_f32(const float *a, const float *b, float *out, size_t n)
-    __attribute__((ifunc("vector_mul_f32_resolver")));
+DYNEMIT_DISPATCH(vector_mul_i16, void,
+                 (const int16_t *a, const int16_t *b, int16_t *out, size_t n),
+                 (a, b, out, n), n)
 
+#endif
@@ -0,0 +1,36 @@
+/* SPDX-License-Identifier: BSL-1.0 */
+#include <stddef.h>
+#include <stdint.h>
+#include <dynemit/core.h>
+#include "../common/elementwise.h"
+
+// RVV kernels of vector_mul.c, built with the V extension enabled and only
+// reached through the resolvers there. LMUL=8 groups eight vector registers
+// per operand, which leaves enough for the three streams.
+
+DYNEMIT_RVV_BINARY(vector_mul_f32, float, __riscv_vsetvl_e32m8,
+                   __riscv_vle32_v_f32m8, __riscv_vse32_v_f32m8, __riscv_vfmul_vv_f32m8)
+DYNEMIT_RVV_BROADCAST(vector_mul_scalar_f32, float, __riscv_vsetvl_e32m8,
+                      __riscv_vle32_v_f32m8, __riscv_vse32_v_f32m8, __riscv_vfmul_vf_f32m8)
+
+DYNEMIT_RVV_BINARY(vector_mul_f64, double, __riscv_vsetvl_e64m8,
+                   __riscv_vle64_v_f64m8, __riscv_vse64_v_f64m8, __riscv_vfmul_vv_f64m8)
+DYNEMIT_RVV_BROADCAST(vector_mul_scalar_f64, double, __riscv_vsetvl_e64m8,
+                      __riscv_vle64_v_f64m8, __riscv_vse64_v_f64m8, __riscv_vfmul_vf_f64m8)
+
+DYNEMIT_RVV_BINARY(vector_mul_i32, int32_t, __riscv_vsetvl_e32m8,
+                   __riscv_vle32_v_i32m8, __riscv_vse32_v_i32m8, __riscv_vmul_vv_i32m8)
+
+// Saturating 16-bit multiply: widening multiply at half the register group,
+// clamp, then a plain narrowing conversion
+void
+vector_mul_i16_rvv(const int16_t *a, const int16_t *b, int16_t *out, size_t n)
+{
+    for (size_t i = 0, vl; i < n; i += vl) {
+        vl = __riscv_vsetvl_e16m4(n - i);
+        vint32m8_t p = __riscv_vwmul_vv_i32m8(__riscv_vle16_v_i16m4(a + i, vl),
+                                              __riscv_vle16_v_i16m4(b + i, vl), vl);
+        p = __riscv_vmin_vx_i32m8(__riscv_vmax_vx_i32m8(p, INT16_MIN, vl), INT16_MAX, vl);
+        __riscv_vse16_v_i16m4(out + i, __riscv_vncvt_x_x_w_i16m4(p, vl), vl);
+    }
+}
@@ -0,0 +1,32 @@
+/* SPDX-License-Identifier: BSL-1.0 */
+#include <stddef.h>
+#include <stdint.h>
+#include <dynemit/core.h>
+#include "../common/elementwise.h"
+
+// SVE kernels of vector_mul.c. This file is built with SVE enabled and its
+// functions are only reached through the resolvers there.
+
+DYNEMIT_SVE_BINARY(vector_mul_f32, float, 32, svmul_x)
+DYNEMIT_SVE_BROADCAST(vector_mul_scalar_f32, float, 32, svmul_x)
+
+DYNEMIT_SVE_BINARY(vector_mul_f64, double, 64, svmul_x)
+DYNEMIT_SVE_BROADCAST(vector_mul_scalar_f64, double, 64, svmul_x)
+
+DYNEMIT_SVE_BINARY(vector_mul_i32, int32_t, 32, svmul_x)
+
+// Saturating 16-bit multiply: widen each half to 32 bits, multiply, clamp
+// and keep the low halves, which svuzp1 gathers back in element order
+static inline svint16_t
+mulsat_s16_sve(svbool_t pg, svint16_t a, svint16_t b)
+{
+    (void)pg;
+    svbool_t all = svptrue_b32();
+    svint32_t lo = svmul_x(all, svunpklo(a), svunpklo(b));
+    svint32_t hi = svmul_x(all, svunpkhi(a), svunpkhi(b));
+    lo = svmax_x(all, svmin_x(all, lo, INT16_MAX), INT16_MIN);
+    hi = svmax_x(all, svmin_x(all, hi, INT16_MAX), INT16_MIN);
+    return svuzp1(svreinterpret_s16(lo), svreinterpret_s16(hi));
+}
+
+DYNEMIT_SVE_BINARY(vector_mul_i16, int16_t, 16, mulsat_s16_sve)
@@ -0,0 +1,19 @@
+/* SPDX-License-Identifier: BSL-1.0 */
+#include <stddef.h>
+#include <stdint.h>
+#include <dynemit/core.h>
+#include "../common/elementwise.h"
+
+// SVE2 kernel of vector_mul_i16, built with SVE2 enabled. svmullb/svmullt
+// form the full 32-bit products of the even and odd lanes and
+// svqxtnb/svqxtnt narrow them back into the same lanes with saturation, with
+// no unpacking or permutes.
+
+static inline svint16_t
+mulsat_s16_sve2(svbool_t pg, svint16_t a, svint16_t b)
+{
+    (void)pg;
+    return svqxtnt(svqxtnb(svmullb(a, b)), svmullt(a, b));
+}
+
+DYNEMIT_SVE_BINARY_KERNEL(vector_mul_i16, sve2, int16_t, 16, mulsat_s16_sve2)
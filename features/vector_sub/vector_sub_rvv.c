@@ -0,0 +1,25 @@
+/* SPDX-License-Identifier: BSL-1.0 */
+#include <stddef.h>
+#include <stdint.h>
+#include <dynemit/core.h>
+#include "../common/elementwise.h"
+
+// RVV kernels of vector_sub.c, built with the V extension enabled and only
+// reached through the resolvers there. LMUL=8 groups eight vector registers
+// per operand, which leaves enough for the three streams.
+
+DYNEMIT_RVV_BINARY(vector_sub_f32, float, __riscv_vsetvl_e32m8,
+                   __riscv_vle32_v_f32m8, __riscv_vse32_v_f32m8, __riscv_vfsub_vv_f32m8)
+DYNEMIT_RVV_BROADCAST(vector_sub_scalar_f32, float, __riscv_vsetvl_e32m8,
+                      __riscv_vle32_v_f32m8, __riscv_vse32_v_f32m8, __riscv_vfsub_vf_f32m8)
+
+DYNEMIT_RVV_BINARY(vector_sub_f64, double, __riscv_vsetvl_e64m8,
+                   __riscv_vle64_v_f64m8, __riscv_vse64_v_f64m8, __riscv_vfsub_vv_f64m8)
+DYNEMIT_RVV_BROADCAST(vector_sub_scalar_f64, double, __riscv_vsetvl_e64m8,
+                      __riscv_vle64_v_f64m8, __riscv_vse64_v_f64m8, __riscv_vfsub_vf_f64m8)
+
+DYNEMIT_RVV_BINARY(vector_sub_i32, int32_t, __riscv_vsetvl_e32m8,
+                   __riscv_vle32_v_i32m8, __riscv_vse32_v_i32m8, __riscv_vsub_vv_i32m8)
+
+DYNEMIT_RVV_BINARY(vector_sub_i16, int16_t, __riscv_vsetvl_e16m8,
+                   __riscv_vle16_v_i16m8, __riscv_vse16_v_i16m8, __riscv_vssub_vv_i16m8)
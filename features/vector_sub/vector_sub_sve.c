@@ -0,0 +1,19 @@
+/* SPDX-License-Identifier: BSL-1.0 */
+#include <stddef.h>
+#include <stdint.h>
+#include <dynemit/core.h>
+#include "../common/elementwise.h"
+
+// SVE kernels of vector_sub.c. This file is built with SVE enabled and its
+// functions are only reached through the resolvers there.
+
+DYNEMIT_SVE_BINARY(vector_sub_f32, float, 32, svsub_x)
+DYNEMIT_SVE_BROADCAST(vector_sub_scalar_f32, float, 32, svsub_x)
+
+DYNEMIT_SVE_BINARY(vector_sub_f64, double, 64, svsub_x)
+DYNEMIT_SVE_BROADCAST(vector_sub_scalar_f64, double, 64, svsub_x)
+
+DYNEMIT_SVE_BINARY(vector_sub_i32, int32_t, 32, svsub_x)
+
+#define QOP(pg, x, y) svqsub(x, y)  // saturating, no predicate needed
+DYNEMIT_SVE_BINARY(vector_sub_i16, int16_t, 16, QOP)
@@ -0,0 +1,125 @@
+/* SPDX-License-Identifier: BSL-1.0 */
+#include <stddef.h>
+#include <stdint.h>
+#include <dynemit/core.h>
+#include <dynemit/vmath.h>
+#include "../common/elementwise.h"
+
+// Transcendental kernels. Each function is a range reduction, a polynomial
+// and a reconstruction, with no table lookups, so the same code vectorizes
+// at every width: vmath_kernels.h holds it once on GCC vector types and is
+// stamped out here per level. The polynomial coefficients are minimax fits
+// (exp, log and erf) or the Cephes ones (tanh near zero); the fast tier
+// differs from the precise one only in the polynomial degrees.
+//
+// No level has a transcendental instruction to offer, so the levels differ
+// in width and FMA only: SSE4.2 shares the SSE2 kernels, and AVX2 implies
+// FMA here, as it does on every AVX2 CPU shipped so far (checked anyway).
+
+#define VMATH_SUFFIX scalar
+#define VMATH_WIDTH  4
+#define VMATH_ATTRS  DYNEMIT_SCALAR_KERNEL_ATTRS
+#include "vmath_kernels.h"
+#undef VMATH_SUFFIX
+#undef VMATH_WIDTH
+#undef VMATH_ATTRS
+
+#if DYNEMIT_ARCH_X86
+
+#define VMATH_SUFFIX sse2
+#define VMATH_WIDTH  16
+#define VMATH_ATTRS  __attribute__((target("sse2")))
+#include "vmath_kernels.h"
+#undef VMATH_SUFFIX
+#undef VMATH_WIDTH
+#undef VMATH_ATTRS
+
+#define VMATH_SUFFIX avx
+#define VMATH_WIDTH  32
+#define VMATH_ATTRS  __attribute__((target("avx")))
+#include "vmath_kernels.h"
+#undef VMATH_SUFFIX
+#undef VMATH_WIDTH
+#undef VMATH_ATTRS
+
+#define VMATH_SUFFIX avx2
+#define VMATH_WIDTH  32
+#define VMATH_ATTRS  __attribute__((target("avx2,fma")))
+#include "vmath_kernels.h"
+#undef VMATH_SUFFIX
+#undef VMATH_WIDTH
+#undef VMATH_ATTRS
+
+#define VMATH_SUFFIX avx512f
+#define VMATH_WIDTH  64
+#define VMATH_ATTRS  __attribute__((target("avx512f")))
+#include "vmath_kernels.h"
+#undef VMATH_SUFFIX
+#undef VMATH_WIDTH
+#undef VMATH_ATTRS
+
+#elif defined(__aarch64__)
+
+// ASIMD is part of the base ISA; SVE adds nothing these kernels would use
+#define VMATH_SUFFIX neon
+#define VMATH_WIDTH  16
+#define VMATH_ATTRS
+#include "vmath_kernels.h"
+#undef VMATH_SUFFIX
+#undef VMATH_WIDTH
+#undef VMATH_ATTRS
+
+#endif
+
+// ===================================================
+// Resolver functions for ifunc
+// ===================================================
+
+typedef void (*vmath_f32_func_t)(const float *, float *, size_t);
+
+#if DYNEMIT_ARCH_X86
+
+#define VMATH_DISPATCH(name)                                                    \
+    static vmath_f32_func_t                                                     \
+    name##_select(simd_level_t level)                                           \
+    {                                                                           \
+        switch (level) {                                                        \
+        case SIMD_AVX512F: return name##_avx512f;                               \
+        case SIMD_AVX2:    return dynemit_cpu_has(DYNEMIT_CPU_FMA) ? name##_avx2 : name##_avx; \
+        case SIMD_AVX:     return name##_avx;                                   \
+        case SIMD_SSE4_2:                                                       \
+        case SIMD_SSE2:    return name##_sse2;                                  \
+        case SIMD_SCALAR:                                                       \
+        default:           return name##_scalar;                                \
+        }                                                                       \
+    }                                                                           \
+    DYNEMIT_DISPATCH(name, void, (const float *a, float *out, size_t n), (a, out, n), n)
+
+#else // aarch64: NEON at every ARM level; RISC-V and others: scalar
+
+#define VMATH_DISPATCH(name)                                                    \
+    static vmath_f32_func_t                                                     \
+    name##_select(simd_level_t level)                                           \
+    {                                                                           \
+        switch (level) {                                                        \
+        case SIMD_SVE2:                                                         \
+        case SIMD_SVE:                                                          \
+        case SIMD_NEON:    return DYNEMIT_NEON_KERNEL(name);                    \
+        case SIMD_SCALAR:                                                       \
+        default:           return name##_scalar;                                \
+        }                                                                       \
+    }                                                                           \
+    DYNEMIT_DISPATCH(name, void, (const float *a, float *out, size_t n), (a, out, n), n)
+
+#endif
+
+VMATH_DISPATCH(vector_exp_f32)
+VMATH_DISPATCH(vector_exp_f32_fast)
+VMATH_DISPATCH(vector_log_f32)
+VMATH_DISPATCH(vector_log_f32_fast)
+VMATH_DISPATCH(vector_tanh_f32)
+VMATH_DISPATCH(vector_tanh_f32_fast)
+VMATH_DISPATCH(vector_sigmoid_f32)
+VMATH_DISPATCH(vector_sigmoid_f32_fast)
+VMATH_DISPATCH(vector_erf_f32)
+VMATH_DISPATCH(vector_erf_f32_fast)
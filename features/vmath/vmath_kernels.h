@@ -0,0 +1,215 @@
+/* SPDX-License-Identifier: BSL-1.0 */
+
+// Width-generic bodies of the vmath kernels. vmath.c includes this file
+// once per level with:
+//
+//   VMATH_SUFFIX  kernel name suffix (scalar, sse2, avx, ...)
+//   VMATH_WIDTH   vector width in bytes (4 for the one-lane scalar kernels)
+//   VMATH_ATTRS   attributes of every function, e.g. the target ISA
+//
+// The math is written once on GCC vector types, so every level runs the
+// same algorithm and only the instruction selection differs. Where the
+// target has FMA the compiler contracts the polynomials into it, so results
+// may differ between levels by rounding, always within the documented
+// bounds. Not part of the installed API.
+
+#define VM_PASTE(a, b) a##_##b
+#define VM_NAME(a, b)  VM_PASTE(a, b)
+#define VM(name)       VM_NAME(name, VMATH_SUFFIX)
+#define VM_LANES       (VMATH_WIDTH / (int)sizeof(float))
+
+typedef float   VM(vf) __attribute__((vector_size(VMATH_WIDTH)));
+typedef int32_t VM(vi) __attribute__((vector_size(VMATH_WIDTH)));
+
+#define vf VM(vf)
+#define vi VM(vi)
+#define VM_INLINE VMATH_ATTRS static inline __attribute__((always_inline))
+
+// ===================================================
+// Lane helpers
+// ===================================================
+
+VM_INLINE vf VM(splat)(float c) { return (vf){} + c; }
+
+// m is a comparison result: all ones where a is taken
+VM_INLINE vf VM(select)(vi m, vf a, vf b) { return (vf)((m & (vi)a) | (~m & (vi)b)); }
+
+VM_INLINE vf VM(min)(vf a, float b) { return VM(select)(a < b, a, VM(splat)(b)); }
+VM_INLINE vf VM(max)(vf a, float b) { return VM(select)(a > b, a, VM(splat)(b)); }
+VM_INLINE vf VM(abs)(vf x) { return (vf)((vi)x & 0x7fffffff); }
+VM_INLINE vf VM(copysign)(vf mag, vf sgn) { return (vf)((vi)mag | ((vi)sgn & INT32_MIN)); }
+
+// Round to nearest integer, for |x| < 2^22
+VM_INLINE vf VM(round)(vf x) { return (x + 0x1.8p23f) - 0x1.8p23f; }
+
+// ===================================================
+// exp: x = k ln2 + r, |r| <= ln2 / 2, e^x = 2^k e^r
+// ===================================================
+
+VM_INLINE vf
+VM(exp)(vf x, int fast)
+{
+    // Below -104 the result rounds to zero, above 88.8 to infinity; the
+    // clamp keeps k in [-150, 128]
+    vf xc = VM(max)(VM(min)(x, 88.8f), -104.0f);
+    vf k = VM(round)(xc * 1.44269504f);
+    // ln2 in two parts (Cody-Waite), so k * ln2 loses nothing
+    vf r = xc - k * 0.693359375f;
+    r = r - k * -2.12194440e-4f;
+
+    vf p;
+    if (fast)
+        p = ((8.312521502e-3f * r + 4.189014807e-2f) * r + 1.666711420e-1f) * r + 4.999923110e-1f;
+    else
+        p = (((1.381460228e-3f * r + 8.368715644e-3f) * r + 4.166838899e-2f) * r + 1.666652113e-1f) * r +
+            4.999999404e-1f;
+    vf y = (r + r * r * p) + 1.0f;
+
+    // 2^k as two factors, so the subnormal results and k = 128 both work
+    vi ki = __builtin_convertvector(k, vi);
+    vi k1 = ki >> 1;
+    vi k2 = ki - k1;
+    y = y * (vf)((k1 + 127) << 23) * (vf)((k2 + 127) << 23);
+    return VM(select)(x != x, x, y);
+}
+
+// ===================================================
+// log: x = m 2^e, sqrt(1/2) <= m < sqrt(2), log x = e ln2 + log1p(m - 1)
+// ===================================================
+
+VM_INLINE vf
+VM(log)(vf x, int fast)
+{
+    // Subnormals are scaled into the normal range first
+    vi sub = x < 0x1p-126f;
+    vf xs = VM(select)(sub, x * 0x1p23f, x);
+    vi bits = (vi)xs;
+    vi e = ((bits >> 23) & 0xff) - 127 - (sub & 23);
+    vf m = (vf)((bits & 0x007fffff) | 0x3f800000);
+    vi high = m > 1.41421356f;
+    m = VM(select)(high, m * 0.5f, m);
+    e = e - high;
+
+    vf f = m - 1.0f;
+    vf z = f * f;
+    vf p;
+    if (fast)
+        p = (((((8.700434864e-2f * f - 1.426748633e-1f) * f + 1.491476893e-1f) * f - 1.657758504e-1f) * f +
+              1.996306330e-1f) * f - 2.500133812e-1f) * f + 3.333390951e-1f;
+    else
+        p = ((((((-7.634496689e-2f * f + 1.276157647e-1f) * f - 1.316018254e-1f) * f + 1.420175731e-1f) * f -
+               1.662335694e-1f) * f + 2.000122666e-1f) * f - 2.500081956e-1f) * f + 3.333333135e-1f;
+
+    vf ef = __builtin_convertvector(e, vf);
+    vf y = f * z * p + ef * -2.12194440e-4f - 0.5f * z;
+    y = (f + y) + ef * 0.693359375f;
+
+    y = VM(select)(x == 0.0f, VM(splat)(-__builtin_inff()), y);
+    y = VM(select)(x < 0.0f, VM(splat)(__builtin_nanf("")), y);
+    y = VM(select)(x == __builtin_inff(), x, y);
+    return VM(select)(x != x, x, y);
+}
+
+// ===================================================
+// tanh, sigmoid and erf on top of exp
+// ===================================================
+
+VM_INLINE vf
+VM(tanh)(vf x, int fast)
+{
+    // Odd polynomial near zero, where 1 - e would cancel
+    vf z = x * x;
+    vf small = ((((-5.70498872745e-3f * z + 2.06390887954e-2f) * z - 5.37397155531e-2f) * z +
+                 1.33314422036e-1f) * z - 3.33332819422e-1f) * z * x + x;
+
+    // tanh |x| = (1 - e) / (1 + e) with e = exp(-2|x|) in (0, 0.29]
+    vf ax = VM(abs)(x);
+    vf e = VM(exp)(ax * -2.0f, fast);
+    vf big = VM(copysign)((1.0f - e) / (1.0f + e), x);
+    return VM(select)(ax < 0.625f, small, big);
+}
+
+VM_INLINE vf
+VM(sigmoid)(vf x, int fast)
+{
+    // t = exp(-|x|) never overflows; for x < 0 the result is t / (1 + t),
+    // which keeps the tiny results of x << 0 instead of flushing them
+    vf t = VM(exp)(-VM(abs)(x), fast);
+    return VM(select)(x >= 0.0f, VM(splat)(1.0f), t) / (1.0f + t);
+}
+
+VM_INLINE vf
+VM(erf)(vf x, int fast)
+{
+    // |x| < 1: erf x = x P(x^2), summed as x + x (P - 1) so that only the
+    // last addition rounds at the scale of the result
+    vf t = x * x;
+    vf a;
+    if (fast)
+        a = ((((-5.631422391e-4f * t + 4.917551298e-3f) * t - 2.671131119e-2f) * t + 1.128017977e-1f) * t -
+             3.761232495e-1f) * t + 1.283791671e-1f;
+    else
+        a = (((((7.853864372e-5f * t - 8.010194870e-4f) * t + 5.188327748e-3f) * t - 2.685381286e-2f) * t +
+              1.128358543e-1f) * t - 3.761262596e-1f) * t + 1.283791671e-1f;
+    a = x + x * a;
+
+    // 1 <= |x| < 4: erf |x| = 1 - exp(Q(|x| - 2.5)), Q fitted to log erfc;
+    // from about 3.9 on, the result rounds to 1
+    vf u = VM(min)(VM(abs)(x), 4.0f) - 2.5f;
+    vf q;
+    if (fast)
+        q = ((((((-1.334549233e-5f * u + 8.464368148e-5f) * u - 4.199998220e-4f) * u + 2.154993126e-3f) * u -
+               1.085868385e-2f) * u - 9.438890815e-1f) * u - 5.352680683e+0f) * u - 7.806815624e+0f;
+    else
+        q = (((((((1.599815732e-6f * u - 1.330170653e-5f) * u + 7.745493349e-5f) * u - 4.201731354e-4f) * u +
+                2.165081445e-3f) * u - 1.085848734e-2f) * u - 9.438936114e-1f) * u - 5.352680683e+0f) * u -
+            7.806815147e+0f;
+    vf b = VM(copysign)(VM(min)(1.0f - VM(exp)(q, fast), 1.0f), x);
+
+    vf y = VM(select)(VM(abs)(x) < 1.0f, a, b);
+    return VM(select)(x != x, x, y);
+}
+
+// ===================================================
+// Kernels: out[i] = f(a[i])
+// ===================================================
+
+// The remainder goes through one zero-padded vector
+#define VM_KERNEL(name, fn, fast)                                              \
+    VMATH_ATTRS static void                                                    \
+    VM(name)(const float *a, float *out, size_t n)                             \
+    {                                                                          \
+        size_t i = 0;                                                          \
+        for (; i + VM_LANES <= n; i += VM_LANES) {                             \
+            vf v;                                                              \
+            __builtin_memcpy(&v, a + i, sizeof(v));                            \
+            v = fn(v, fast);                                                   \
+            __builtin_memcpy(out + i, &v, sizeof(v));                          \
+        }                                                                      \
+        if (i < n) {                                                           \
+            vf v = {};                                                         \
+            __builtin_memcpy(&v, a + i, (n - i) * sizeof(float));              \
+            v = fn(v, fast);                                                   \
+            __builtin_memcpy(out + i, &v, (n - i) * sizeof(float));            \
+        }                                                                      \
+    }
+
+VM_KERNEL(vector_exp_f32,          VM(exp),     0)
+VM_KERNEL(vector_exp_f32_fast,     VM(exp),     1)
+VM_KERNEL(vector_log_f32,          VM(log),     0)
+VM_KERNEL(vector_log_f32_fast,     VM(log),     1)
+VM_KERNEL(vector_tanh_f32,         VM(tanh),    0)
+VM_KERNEL(vector_tanh_f32_fast,    VM(tanh),    1)
+VM_KERNEL(vector_sigmoid_f32,      VM(sigmoid), 0)
+VM_KERNEL(vector_sigmoid_f32_fast, VM(sigmoid), 1)
+VM_KERNEL(vector_erf_f32,          VM(erf),     0)
+VM_KERNEL(vector_erf_f32_fast,     VM(erf),     1)
+
+#undef VM_KERNEL
+#undef VM_INLINE
+#undef vi
+#undef vf
+#undef VM_LANES
+#undef VM
+#undef VM_NAME
+#undef VM_PASTE
@@ -7,6 +7,14 @@
  * 
  * This is the main umbrella header for the Dynemit library.
  * Include this header to get access to all features and CPU detection APIs.
+ *
+ * Aliasing: an output array may be the very same array as any of the inputs
+ * of the call (out == a), which computes in place; inputs may also be the
+ * same array as each other. An output that partially overlaps an input
+ * (out == a + 1, say) is undefined. Arrays need no particular alignment.
+ * The _ip forms (vector_add_f32_ip(a, b, n): a[i] += b[i]) make the in-place
+ * case explicit. In place, no kernel uses non-temporal stores, which only
+ * pay off for a separate output.
  */
 
 #ifdef __cplusplus
@@ -21,9 +29,18 @@ extern "C" {
 
 // Features - automatically included when using the all-in-one library
 #ifdef DYNEMIT_ALL_FEATURES
+#include <dynemit/expr.h>
+#include <dynemit/half.h>
+#include <dynemit/multiout.h>
+#include <dynemit/parallel.h>
+#include <dynemit/queue.h>
+#include <dynemit/reduce.h>
+#include <dynemit/sparse.h>
 #include <dynemit/vector_add.h>
+#include <dynemit/vector_fma.h>
 #include <dynemit/vector_mul.h>
 #include <dynemit/vector_sub.h>
+#include <dynemit/vmath.h>
 #endif
 
 // Alternatively, users can include individual feature headers:
@@ -0,0 +1,408 @@
+/* SPDX-License-Identifier: BSL-1.0 */
+#ifndef DYNEMIT_HPP
+#define DYNEMIT_HPP
+
+/**
+ * @file dynemit.hpp
+ * @brief Header-only C++20 interface with compile-time dispatch
+ *
+ * Typed wrappers in namespace dynemit over the C kernels, taking either raw
+ * pointers or std::span. The element-wise operations pick their
+ * implementation at compile time:
+ *
+ * - If the translation unit is compiled for a level that is already
+ *   guaranteed (-mavx512f, -mavx2, -mavx, or a -march that implies one), the
+ *   kernel for that level is inlined into the caller, so small inputs skip
+ *   the ifunc PLT call entirely. Inputs larger than dynemit::inline_max_elements
+ *   still call the library, which adds alignment peeling and streaming stores
+ *   that only pay off at that size.
+ * - Otherwise every call goes through the runtime-dispatched ifunc symbol.
+ *
+ * The inlined kernels compute exactly what the library does at the same
+ * level: they use the same unfused add/sub/mul and, for fma/axpy, are only
+ * inlined when __FMA__ is also defined, so results do not depend on the size
+ * of the input. The double/int32_t/int16_t overloads and the reductions always
+ * go through the library.
+ *
+ * Span overloads require out.size() elements in every input (checked with
+ * assert()).
+ *
+ * dynemit::queue and dynemit::future wrap the asynchronous queue of
+ * <dynemit/queue.h>; a future can be co_await-ed from a coroutine, which
+ * then resumes on the queue thread once the operation has completed.
+ */
+
+#if __cplusplus < 202002L
+#error "dynemit.hpp requires C++20 (std::span); use <dynemit.h> from older C++"
+#endif
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <type_traits>
+#include <utility>
+
+#if defined(__cpp_impl_coroutine)
+#include <coroutine>
+#endif
+
+#include <dynemit/core.h>
+#include <dynemit/queue.h>
+#include <dynemit/reduce.h>
+#include <dynemit/vector_add.h>
+#include <dynemit/vector_fma.h>
+#include <dynemit/vector_mul.h>
+#include <dynemit/vector_sub.h>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#endif
+
+namespace dynemit {
+
+// ===================================================
+// Compile-time level
+// ===================================================
+
+#if defined(__AVX512F__)
+inline constexpr simd_level_t compile_time_level = SIMD_AVX512F;
+#elif defined(__AVX2__)
+inline constexpr simd_level_t compile_time_level = SIMD_AVX2;
+#elif defined(__AVX__)
+inline constexpr simd_level_t compile_time_level = SIMD_AVX;
+#else
+inline constexpr simd_level_t compile_time_level = SIMD_SCALAR;
+#endif
+
+/** True when element-wise kernels are inlined instead of called through ifunc. */
+inline constexpr bool compile_time_dispatch = compile_time_level >= SIMD_AVX;
+
+/**
+ * Inputs up to this many elements use the inlined kernel; larger ones call the
+ * library, where call overhead is negligible and the large-n paths live.
+ */
+inline constexpr std::size_t inline_max_elements = 4096;
+
+namespace detail {
+
+#if defined(__AVX512F__)
+
+using vec = __m512;
+inline constexpr std::size_t width = 16;
+
+inline vec load(const float *p) { return _mm512_loadu_ps(p); }
+inline void store(float *p, vec v) { _mm512_storeu_ps(p, v); }
+inline vec load_partial(const float *p, std::size_t k)
+{
+    return _mm512_maskz_loadu_ps((__mmask16)((1u << k) - 1u), p);
+}
+inline void store_partial(float *p, std::size_t k, vec v)
+{
+    _mm512_mask_storeu_ps(p, (__mmask16)((1u << k) - 1u), v);
+}
+inline vec set1(float x) { return _mm512_set1_ps(x); }
+inline vec add(vec a, vec b) { return _mm512_add_ps(a, b); }
+inline vec sub(vec a, vec b) { return _mm512_sub_ps(a, b); }
+inline vec mul(vec a, vec b) { return _mm512_mul_ps(a, b); }
+inline vec fmadd(vec a, vec b, vec c) { return _mm512_fmadd_ps(a, b, c); }
+#define DYNEMIT_HPP_INLINE_FMA 1
+
+#elif defined(__AVX__)
+
+using vec = __m256;
+inline constexpr std::size_t width = 8;
+
+inline __m256i tail_mask(std::size_t k)
+{
+    alignas(32) static constexpr int lanes[16] = { -1, -1, -1, -1, -1, -1, -1, -1, 0, 0, 0, 0, 0, 0, 0, 0 };
+    return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(lanes + 8 - k));
+}
+inline vec load(const float *p) { return _mm256_loadu_ps(p); }
+inline void store(float *p, vec v) { _mm256_storeu_ps(p, v); }
+inline vec load_partial(const float *p, std::size_t k) { return _mm256_maskload_ps(p, tail_mask(k)); }
+inline void store_partial(float *p, std::size_t k, vec v) { _mm256_maskstore_ps(p, tail_mask(k), v); }
+inline vec set1(float x) { return _mm256_set1_ps(x); }
+inline vec add(vec a, vec b) { return _mm256_add_ps(a, b); }
+inline vec sub(vec a, vec b) { return _mm256_sub_ps(a, b); }
+inline vec mul(vec a, vec b) { return _mm256_mul_ps(a, b); }
+#if defined(__FMA__)
+inline vec fmadd(vec a, vec b, vec c) { return _mm256_fmadd_ps(a, b, c); }
+#define DYNEMIT_HPP_INLINE_FMA 1
+#endif
+
+#endif
+
+#if defined(__AVX__)
+
+// out = op(a, b): full vectors, then one masked tail
+template <class Op>
+inline void binary(const float *a, const float *b, float *out, std::size_t n, Op op)
+{
+    std::size_t i = 0;
+    for (; i + width <= n; i += width)
+        store(out + i, op(load(a + i), load(b + i)));
+    if (i < n)
+        store_partial(out + i, n - i, op(load_partial(a + i, n - i), load_partial(b + i, n - i)));
+}
+
+#endif
+
+} // namespace detail
+
+// ===================================================
+// Element-wise operations
+// ===================================================
+
+/** out[i] = a[i] + b[i] */
+inline void add(const float *a, const float *b, float *out, std::size_t n)
+{
+#if defined(__AVX__)
+    if (n <= inline_max_elements)
+        return detail::binary(a, b, out, n, [](detail::vec x, detail::vec y) { return detail::add(x, y); });
+#endif
+    vector_add_f32(a, b, out, n);
+}
+
+/** out[i] = a[i] - b[i] */
+inline void sub(const float *a, const float *b, float *out, std::size_t n)
+{
+#if defined(__AVX__)
+    if (n <= inline_max_elements)
+        return detail::binary(a, b, out, n, [](detail::vec x, detail::vec y) { return detail::sub(x, y); });
+#endif
+    vector_sub_f32(a, b, out, n);
+}
+
+/** out[i] = a[i] * b[i] */
+inline void mul(const float *a, const float *b, float *out, std::size_t n)
+{
+#if defined(__AVX__)
+    if (n <= inline_max_elements)
+        return detail::binary(a, b, out, n, [](detail::vec x, detail::vec y) { return detail::mul(x, y); });
+#endif
+    vector_mul_f32(a, b, out, n);
+}
+
+/** out[i] = a[i] * b[i] + c[i] (fused where the CPU supports it) */
+inline void fma(const float *a, const float *b, const float *c, float *out, std::size_t n)
+{
+#if defined(DYNEMIT_HPP_INLINE_FMA)
+    if (n <= inline_max_elements) {
+        std::size_t i = 0;
+        for (; i + detail::width <= n; i += detail::width)
+            detail::store(out + i, detail::fmadd(detail::load(a + i), detail::load(b + i), detail::load(c + i)));
+        if (i < n) {
+            std::size_t k = n - i;
+            detail::store_partial(out + i, k, detail::fmadd(detail::load_partial(a + i, k),
+                                                            detail::load_partial(b + i, k),
+                                                            detail::load_partial(c + i, k)));
+        }
+        return;
+    }
+#endif
+    vector_fma_f32(a, b, c, out, n);
+}
+
+/** y[i] += alpha * x[i] */
+inline void axpy(float alpha, const float *x, float *y, std::size_t n)
+{
+#if defined(DYNEMIT_HPP_INLINE_FMA)
+    if (n <= inline_max_elements) {
+        detail::vec va = detail::set1(alpha);
+        return detail::binary(x, y, y, n, [va](detail::vec vx, detail::vec vy) { return detail::fmadd(va, vx, vy); });
+    }
+#endif
+    vector_axpy_f32(alpha, x, y, n);
+}
+
+inline void add(std::span<const float> a, std::span<const float> b, std::span<float> out)
+{
+    assert(a.size() >= out.size() && b.size() >= out.size());
+    add(a.data(), b.data(), out.data(), out.size());
+}
+
+inline void sub(std::span<const float> a, std::span<const float> b, std::span<float> out)
+{
+    assert(a.size() >= out.size() && b.size() >= out.size());
+    sub(a.data(), b.data(), out.data(), out.size());
+}
+
+inline void mul(std::span<const float> a, std::span<const float> b, std::span<float> out)
+{
+    assert(a.size() >= out.size() && b.size() >= out.size());
+    mul(a.data(), b.data(), out.data(), out.size());
+}
+
+inline void fma(std::span<const float> a, std::span<const float> b, std::span<const float> c,
+                std::span<float> out)
+{
+    assert(a.size() >= out.size() && b.size() >= out.size() && c.size() >= out.size());
+    fma(a.data(), b.data(), c.data(), out.data(), out.size());
+}
+
+inline void axpy(float alpha, std::span<const float> x, std::span<float> y)
+{
+    assert(x.size() >= y.size());
+    axpy(alpha, x.data(), y.data(), y.size());
+}
+
+// double, int32_t (wrapping) and int16_t (saturating) element types
+#define DYNEMIT_HPP_TYPED_BINARY(op, T, suffix)                               \
+    inline void op(const T *a, const T *b, T *out, std::size_t n) { vector_##op##_##suffix(a, b, out, n); } \
+    inline void op(std::span<const T> a, std::span<const T> b, std::span<T> out) \
+    {                                                                         \
+        assert(a.size() >= out.size() && b.size() >= out.size());             \
+        vector_##op##_##suffix(a.data(), b.data(), out.data(), out.size());   \
+    }
+
+DYNEMIT_HPP_TYPED_BINARY(add, double, f64)
+DYNEMIT_HPP_TYPED_BINARY(sub, double, f64)
+DYNEMIT_HPP_TYPED_BINARY(mul, double, f64)
+DYNEMIT_HPP_TYPED_BINARY(add, std::int32_t, i32)
+DYNEMIT_HPP_TYPED_BINARY(sub, std::int32_t, i32)
+DYNEMIT_HPP_TYPED_BINARY(mul, std::int32_t, i32)
+DYNEMIT_HPP_TYPED_BINARY(add, std::int16_t, i16)
+DYNEMIT_HPP_TYPED_BINARY(sub, std::int16_t, i16)
+DYNEMIT_HPP_TYPED_BINARY(mul, std::int16_t, i16)
+
+#undef DYNEMIT_HPP_TYPED_BINARY
+
+// ===================================================
+// Reductions (always runtime-dispatched)
+// ===================================================
+
+struct minmax_result {
+    float min;
+    float max;
+};
+
+inline float dot(std::span<const float> a, std::span<const float> b)
+{
+    assert(a.size() == b.size());
+    return dot_f32(a.data(), b.data(), a.size());
+}
+
+inline float sum(std::span<const float> a) { return sum_f32(a.data(), a.size()); }
+
+inline float norm2(std::span<const float> a) { return norm2_f32(a.data(), a.size()); }
+
+inline minmax_result minmax(std::span<const float> a)
+{
+    minmax_result r;
+    minmax_f32(a.data(), a.size(), &r.min, &r.max);
+    return r;
+}
+
+// ===================================================
+// Asynchronous queue
+// ===================================================
+
+/** Owning handle to a dynemit_future. Awaitable where coroutines are available. */
+class future {
+public:
+    future() noexcept = default;
+    explicit future(dynemit_future *f) noexcept : f_(f) {}
+    future(future &&other) noexcept : f_(std::exchange(other.f_, nullptr)) {}
+    future &operator=(future &&other) noexcept
+    {
+        if (this != &other) {
+            dynemit_future_release(f_);
+            f_ = std::exchange(other.f_, nullptr);
+        }
+        return *this;
+    }
+    future(const future &) = delete;
+    future &operator=(const future &) = delete;
+    ~future() { dynemit_future_release(f_); }
+
+    /** False if the submission failed. */
+    explicit operator bool() const noexcept { return f_ != nullptr; }
+    dynemit_future *get() const noexcept { return f_; }
+
+    bool ready() const noexcept { return dynemit_future_done(f_); }
+    void wait() const { dynemit_future_wait(f_); }
+
+#if defined(__cpp_impl_coroutine)
+    bool await_ready() const noexcept { return ready(); }
+    bool await_suspend(std::coroutine_handle<> h) const
+    {
+        int r = dynemit_future_then(
+            f_, [](void *p) { std::coroutine_handle<>::from_address(p).resume(); }, h.address());
+        // Could not register a callback: wait here and carry on
+        if (r < 0)
+            wait();
+        return r == 0;
+    }
+    void await_resume() const noexcept {}
+#endif
+
+private:
+    dynemit_future *f_ = nullptr;
+};
+
+/**
+ * Owning handle to a dynemit_queue. The element-wise members take the
+ * futures to wait for as trailing arguments.
+ */
+class queue {
+public:
+    explicit queue(dynemit_threadpool *pool = nullptr) : q_(dynemit_queue_create(pool)) {}
+    queue(const queue &) = delete;
+    queue &operator=(const queue &) = delete;
+    ~queue() { dynemit_queue_destroy(q_); }
+
+    /** False if the queue could not be created. */
+    explicit operator bool() const noexcept { return q_ != nullptr; }
+    dynemit_queue *get() const noexcept { return q_; }
+
+    template <class... After>
+    future add(const float *a, const float *b, float *out, std::size_t n, const After &...after)
+    {
+        return submit(DYNEMIT_OP_ADD_F32, { a, b, nullptr, out, n, nullptr, nullptr, nullptr, 0 }, after...);
+    }
+
+    template <class... After>
+    future sub(const float *a, const float *b, float *out, std::size_t n, const After &...after)
+    {
+        return submit(DYNEMIT_OP_SUB_F32, { a, b, nullptr, out, n, nullptr, nullptr, nullptr, 0 }, after...);
+    }
+
+    template <class... After>
+    future mul(const float *a, const float *b, float *out, std::size_t n, const After &...after)
+    {
+        return submit(DYNEMIT_OP_MUL_F32, { a, b, nullptr, out, n, nullptr, nullptr, nullptr, 0 }, after...);
+    }
+
+    template <class... After>
+    future fma(const float *a, const float *b, const float *c, float *out, std::size_t n, const After &...after)
+    {
+        return submit(DYNEMIT_OP_FMA_F32, { a, b, c, out, n, nullptr, nullptr, nullptr, 0 }, after...);
+    }
+
+    /** fn(ctx) on the queue thread, after the given futures */
+    template <class... After>
+    future call(void (*fn)(void *), void *ctx, const After &...after)
+    {
+        return submit(DYNEMIT_OP_CALL, { nullptr, nullptr, nullptr, nullptr, 0, fn, ctx, nullptr, 0 }, after...);
+    }
+
+    void wait_all() { dynemit_queue_wait_all(q_); }
+
+private:
+    template <class... After>
+    future submit(dynemit_op_t op, dynemit_op_args args, const After &...after)
+    {
+        static_assert((std::is_same_v<After, future> && ...), "dependencies must be dynemit::future");
+        dynemit_future *deps[sizeof...(After) + 1] = { after.get()..., nullptr };
+        args.after = deps;
+        args.num_after = sizeof...(After);
+        return future(dynemit_queue_submit(q_, op, &args));
+    }
+
+    dynemit_queue *q_;
+};
+
+} // namespace dynemit
+
+#endif // DYNEMIT_HPP
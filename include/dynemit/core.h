@@ -2,26 +2,37 @@
 #ifndef DYNEMIT_CORE_H
 #define DYNEMIT_CORE_H
 
+#include <stddef.h>
 #include <stdint.h>
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+// The library is built with -fvisibility=hidden; everything declared in the
+// public headers is exported (see src/dynemit.map)
+#pragma GCC visibility push(default)
+
 // CPU feature detection helpers
 void cpuid_x86(uint32_t leaf, uint32_t subleaf,
                uint32_t *eax, uint32_t *ebx, uint32_t *ecx, uint32_t *edx);
 
 uint64_t xgetbv_x86(uint32_t xcr);
 
-// SIMD levels
+// SIMD levels: one ladder per architecture above the shared SIMD_SCALAR.
+// Only levels of the running architecture are ever detected, and within a
+// ladder a higher value supersedes the ones below it.
 typedef enum {
     SIMD_SCALAR = 0,
     SIMD_SSE2 = 1,
     SIMD_SSE4_2 = 2,
     SIMD_AVX = 3,
     SIMD_AVX2 = 4,
-    SIMD_AVX512F = 5
+    SIMD_AVX512F = 5,
+    SIMD_NEON = 6,      // aarch64 Advanced SIMD (ASIMD)
+    SIMD_SVE = 7,       // aarch64 Scalable Vector Extension
+    SIMD_SVE2 = 8,
+    SIMD_RVV = 9        // RISC-V Vector extension 1.0
 } simd_level_t;
 
 /**
@@ -29,15 +40,25 @@ typedef enum {
  * 
  * This function performs runtime CPU feature detection using CPUID to determine
  * the most advanced SIMD instruction set available. It checks both CPU support
- * and OS support (via XGETBV) for each SIMD level.
+ * and OS support (via XGETBV) for each SIMD level. On aarch64 and RISC-V
+ * the kernel's hardware capabilities (getauxval(AT_HWCAP)) are used instead.
  * 
  * Note: This function performs CPUID calls each time it's invoked, which can
  * add overhead if called frequently. For performance-critical paths or
  * multi-threaded contexts (especially IFUNC resolvers), use detect_simd_level_ts()
  * instead, which caches the result.
  * 
- * @return The highest supported SIMD level, from SIMD_SCALAR (baseline) to
- *         SIMD_AVX512F (most advanced). On non-x86 architectures, returns SIMD_SCALAR.
+ * The DYNEMIT_MAX_LEVEL environment variable caps the result, e.g.
+ * DYNEMIT_MAX_LEVEL=avx2 makes every resolver pick its AVX2 kernel (or a
+ * lower one) on an AVX-512 machine. Names are those accepted by
+ * simd_level_from_name(); unknown values and levels of another
+ * architecture are ignored, and a cap above the hardware level has no
+ * effect. The cap only applies to the simd_level_t ladder:
+ * dynemit_cpu_features() still reports the raw CPU features.
+ * 
+ * @return The highest supported SIMD level: SIMD_SCALAR (baseline) up to
+ *         SIMD_AVX512F on x86, SIMD_NEON up to SIMD_SVE2 on aarch64 and
+ *         SIMD_RVV on RISC-V; SIMD_SCALAR on other architectures.
  * @see detect_simd_level_ts() for cached, thread-safe version
  */
 simd_level_t detect_simd_level(void);
@@ -65,6 +86,700 @@ simd_level_t detect_simd_level_ts(void);
 
 const char *simd_level_name(simd_level_t level);
 
+/**
+ * Parse a SIMD level name: "scalar", "sse2", "sse4.2", "avx", "avx2",
+ * "avx512f", "neon", "sve", "sve2" or "rvv". Case, '-', '_' and '.' are
+ * ignored, so the names returned by simd_level_name() ("AVX-512F",
+ * "SSE4.2", ...) parse as well, and "avx512" is accepted for AVX-512F.
+ *
+ * @param name  Level name
+ * @param level Receives the parsed level on success
+ * @return 0 on success, -1 if the name is not recognised
+ */
+int simd_level_from_name(const char *name, simd_level_t *level);
+
+/*
+ * CPU feature flags reported by dynemit_cpu_features().
+ *
+ * Unlike simd_level_t, these are independent bits, so a resolver can require
+ * an arbitrary combination (e.g. AVX2 + FMA + F16C, or AVX-512 BW/VL/DQ).
+ * Every flag that depends on extended register state is only reported when
+ * the OS has enabled that state in XCR0, so a set bit always means the
+ * instructions are safe to execute.
+ */
+#define DYNEMIT_CPU_SSE2             (UINT64_C(1) << 0)
+#define DYNEMIT_CPU_SSE3             (UINT64_C(1) << 1)
+#define DYNEMIT_CPU_SSSE3            (UINT64_C(1) << 2)
+#define DYNEMIT_CPU_SSE4_1           (UINT64_C(1) << 3)
+#define DYNEMIT_CPU_SSE4_2           (UINT64_C(1) << 4)
+#define DYNEMIT_CPU_POPCNT           (UINT64_C(1) << 5)
+#define DYNEMIT_CPU_AVX              (UINT64_C(1) << 6)
+#define DYNEMIT_CPU_F16C             (UINT64_C(1) << 7)
+#define DYNEMIT_CPU_FMA              (UINT64_C(1) << 8)
+#define DYNEMIT_CPU_AVX2             (UINT64_C(1) << 9)
+#define DYNEMIT_CPU_BMI1             (UINT64_C(1) << 10)
+#define DYNEMIT_CPU_BMI2             (UINT64_C(1) << 11)
+#define DYNEMIT_CPU_AVX_VNNI         (UINT64_C(1) << 12)
+#define DYNEMIT_CPU_AVX512F          (UINT64_C(1) << 13)
+#define DYNEMIT_CPU_AVX512CD         (UINT64_C(1) << 14)
+#define DYNEMIT_CPU_AVX512BW         (UINT64_C(1) << 15)
+#define DYNEMIT_CPU_AVX512DQ         (UINT64_C(1) << 16)
+#define DYNEMIT_CPU_AVX512VL         (UINT64_C(1) << 17)
+#define DYNEMIT_CPU_AVX512IFMA       (UINT64_C(1) << 18)
+#define DYNEMIT_CPU_AVX512VBMI       (UINT64_C(1) << 19)
+#define DYNEMIT_CPU_AVX512VBMI2      (UINT64_C(1) << 20)
+#define DYNEMIT_CPU_AVX512VNNI       (UINT64_C(1) << 21)
+#define DYNEMIT_CPU_AVX512BITALG     (UINT64_C(1) << 22)
+#define DYNEMIT_CPU_AVX512VPOPCNTDQ  (UINT64_C(1) << 23)
+#define DYNEMIT_CPU_AVX512BF16       (UINT64_C(1) << 24)
+#define DYNEMIT_CPU_AVX512FP16       (UINT64_C(1) << 25)
+#define DYNEMIT_CPU_AMX_TILE         (UINT64_C(1) << 26)
+#define DYNEMIT_CPU_AMX_INT8         (UINT64_C(1) << 27)
+#define DYNEMIT_CPU_AMX_BF16         (UINT64_C(1) << 28)
+#define DYNEMIT_CPU_AVX10_1          (UINT64_C(1) << 29)  // AVX10 version >= 1
+#define DYNEMIT_CPU_AVX10_2          (UINT64_C(1) << 30)  // AVX10 version >= 2
+#define DYNEMIT_CPU_AVX10_512        (UINT64_C(1) << 31)  // AVX10 with 512-bit vectors
+#define DYNEMIT_CPU_NEON             (UINT64_C(1) << 32)  // aarch64 ASIMD
+#define DYNEMIT_CPU_SVE              (UINT64_C(1) << 33)
+#define DYNEMIT_CPU_SVE2             (UINT64_C(1) << 34)
+#define DYNEMIT_CPU_RVV              (UINT64_C(1) << 35)  // RISC-V V
+
+/**
+ * Thread-safe cached CPU feature detection.
+ *
+ * Returns a bitmask of DYNEMIT_CPU_* flags for the running CPU. CPUID is
+ * executed once on the first call and the result is cached atomically, with
+ * the same guarantees as detect_simd_level_ts(), so this is safe to call from
+ * IFUNC resolvers. On aarch64 and RISC-V only the NEON/SVE/SVE2 and RVV bits
+ * can be set, from the kernel's HWCAP; other architectures report 0.
+ *
+ * Note: DYNEMIT_CPU_AMX_* only reports that the CPU and XCR0 support tile
+ * state. On Linux, a process must still request permission with
+ * arch_prctl(ARCH_REQ_XCOMP_PERM, XFEATURE_XTILEDATA) before using AMX.
+ *
+ * @return Bitmask of supported DYNEMIT_CPU_* features (cached after first call)
+ * @see dynemit_cpu_has() to test a combination of features
+ */
+uint64_t dynemit_cpu_features(void);
+
+/**
+ * Check whether the CPU supports every feature in a mask.
+ *
+ * @param required Bitwise OR of DYNEMIT_CPU_* flags
+ * @return Non-zero if all requested features are available, 0 otherwise
+ */
+int dynemit_cpu_has(uint64_t required);
+
+/**
+ * Human-readable name of a single DYNEMIT_CPU_* flag (e.g. "AVX-512BW").
+ * Returns "Unknown" if the argument is not exactly one known flag.
+ */
+const char *dynemit_cpu_feature_name(uint64_t feature);
+
+/**
+ * Size in bytes of the last-level data/unified cache.
+ *
+ * Read from CPUID leaf 4 (Intel) or 0x8000001D (AMD), falling back to the
+ * legacy 0x80000006 descriptors. The value is per cache instance, e.g. the L3
+ * shared by one socket or CCX. Cached after the first call.
+ *
+ * @return LLC size in bytes, or 0 if it could not be determined
+ */
+size_t dynemit_llc_size(void);
+
+/**
+ * Size in bytes of the data (or unified) cache at a given level.
+ *
+ * Level 1 is the L1 data cache, 2 the L2, 3 the L3; level 0 means the last
+ * level, i.e. dynemit_llc_size(). Read from CPUID leaf 4 (Intel) or
+ * 0x8000001D (AMD), falling back to the legacy 0x80000005/0x80000006
+ * descriptors. Sizes are per cache instance. Cached after the first call.
+ *
+ * @param level Cache level, 0-3
+ * @return Cache size in bytes, or 0 if there is no such level or it could
+ *         not be determined
+ */
+size_t dynemit_cache_size(unsigned level);
+
+/*
+ * Size classes of a kernel's working set (all inputs and outputs, in bytes),
+ * by the smallest cache level that holds it.
+ */
+typedef enum {
+    DYNEMIT_SIZE_L1 = 0,
+    DYNEMIT_SIZE_L2 = 1,
+    DYNEMIT_SIZE_LLC = 2,
+    DYNEMIT_SIZE_DRAM = 3,
+    DYNEMIT_SIZE_CLASSES = 4
+} dynemit_size_class_t;
+
+/**
+ * Size class of a working set of the given size, from dynemit_cache_size()
+ * (32 KiB L1, 1 MiB L2 and 8 MiB LLC assumed where unknown).
+ */
+dynemit_size_class_t dynemit_size_class(size_t bytes);
+
+/**
+ * Largest working set in bytes that still falls in size_class (SIZE_MAX for
+ * DYNEMIT_SIZE_DRAM). Lets hot paths compare against a cached bound instead
+ * of calling dynemit_size_class() per call.
+ */
+size_t dynemit_size_class_limit(dynemit_size_class_t size_class);
+
+/**
+ * Output size in bytes above which element-wise kernels use streaming stores.
+ *
+ * Once the output is this large, a binary kernel's working set (two inputs and
+ * the output) no longer fits in the last-level cache, so regular stores only
+ * cost read-for-ownership traffic and evict the inputs. Kernels then write the
+ * output with non-temporal stores that bypass the cache.
+ *
+ * Defaults to half of dynemit_llc_size() (8 MiB LLC assumed if unknown).
+ * Override with the DYNEMIT_STREAM_THRESHOLD environment variable, in bytes,
+ * before the first kernel call; 0 always streams. Cached after the first call.
+ *
+ * @return Threshold in bytes of output
+ */
+size_t dynemit_stream_threshold(void);
+
+/**
+ * Software prefetch distance, in bytes ahead of the loads, of the
+ * element-wise kernels once their working set leaves L2 (0 disables the
+ * prefetches).
+ *
+ * Hardware prefetchers of older cores lose track of two input streams
+ * written out alongside a third, so the large-n paths prefetch each input
+ * themselves. The distance is, in order of precedence: the
+ * DYNEMIT_PREFETCH_DISTANCE environment variable, in bytes, read at the
+ * first call; with DYNEMIT_AUTOTUNE set, the fastest of a few candidates
+ * (see dynemit_autotune_prefetch_distance()); otherwise
+ * dynemit_default_prefetch_distance(). Cached after the first call.
+ */
+size_t dynemit_prefetch_distance(void);
+
+/** Per-microarchitecture prefetch distance used when nothing overrides it. */
+size_t dynemit_default_prefetch_distance(void);
+
+/**
+ * Replace the prefetch distance for all following calls, from any thread.
+ * For benchmarks and tuning; meant to be called while no kernels run.
+ */
+void dynemit_set_prefetch_distance(size_t bytes);
+
+/**
+ * Cache and core topology of the machine.
+ *
+ * Cache sizes are those of dynemit_cache_size(). Core counts come from the
+ * Linux sysfs topology, falling back to CPUID leaf 0xB (SMT width) when it is
+ * unavailable. On hybrid CPUs (CPUID.7.EDX[15]) each CPU in the process
+ * affinity mask is visited to read its core type from CPUID leaf 0x1A and
+ * its AVX-512 support; perf_cpus and efficiency_cpus then count those CPUs
+ * only. Otherwise every logical CPU counts as a performance CPU. NUMA nodes
+ * are those online in sysfs.
+ */
+typedef struct {
+    size_t   l1d_size;          // bytes, 0 if unknown
+    size_t   l2_size;           // bytes, 0 if unknown
+    size_t   l3_size;           // bytes, 0 if there is no L3
+    unsigned line_size;         // cache line in bytes
+    unsigned logical_cpus;      // online logical CPUs
+    unsigned physical_cores;    // online physical cores
+    unsigned threads_per_core;  // SMT width (of the widest core)
+    int      hybrid;            // 1 if the CPU mixes performance and efficiency cores
+    unsigned perf_cpus;         // logical CPUs on performance cores
+    unsigned efficiency_cpus;   // logical CPUs on efficiency cores
+    int      avx512_all_cores;  // 1 if every CPU that was checked supports AVX-512F
+    unsigned numa_nodes;        // online NUMA nodes, 1 if unknown
+} dynemit_cpu_topology_t;
+
+/**
+ * Detect the topology once and return the cached result.
+ *
+ * The first call reads sysfs and, on hybrid CPUs, briefly pins the calling
+ * thread to each CPU in turn (its affinity is restored before returning), so
+ * it must not be used from an ifunc resolver. Safe to call from several
+ * threads; later calls only load a pointer.
+ *
+ * @return Topology, valid for the lifetime of the process
+ */
+const dynemit_cpu_topology_t *dynemit_cpu_topology(void);
+
+/**
+ * NUMA node of a logical CPU, from sysfs, or -1 if unknown. Detects the
+ * topology on the first call, like dynemit_cpu_topology().
+ */
+int dynemit_numa_node_of_cpu(int cpu);
+
+/**
+ * Physical core of a logical CPU, or -1 if unknown. SMT siblings share the
+ * same value; cores are numbered from 0 in sysfs order, distinct per
+ * (package, core_id) pair. Detects the topology on the first call, like
+ * dynemit_cpu_topology().
+ */
+int dynemit_core_of_cpu(int cpu);
+
+/*
+ * Memory for large vectors.
+ *
+ * dynemit_alloc() maps the buffer directly (mmap), so its pages are not
+ * backed until first touched and take the NUMA policy given in flags:
+ *
+ *   - DYNEMIT_ALLOC_LOCAL: each page on the node of the thread that first
+ *     touches it, whatever the process policy (numactl --interleave, ...).
+ *     Pair it with dynemit_first_touch() in <dynemit/parallel.h> so every
+ *     worker of a pool faults in the part of the array it will process.
+ *   - DYNEMIT_ALLOC_INTERLEAVE: pages spread round-robin over every node
+ *     the process may allocate on, for data read by every thread.
+ *   - neither: the process policy, usually local.
+ *
+ * The policy is applied with mbind() and is best effort: on kernels or
+ * containers without NUMA support the buffer is still returned. The pages
+ * are zero-filled. Each allocation takes at least one page, so this is
+ * meant for large arrays, not many small ones.
+ */
+
+/** 2 MiB alignment and transparent-huge-page advice (MADV_HUGEPAGE) */
+#define DYNEMIT_ALLOC_HUGE       0x1u
+#define DYNEMIT_ALLOC_LOCAL      0x2u
+#define DYNEMIT_ALLOC_INTERLEAVE 0x4u
+
+/**
+ * Allocate bytes zero-filled bytes, 64-byte aligned (2 MiB with
+ * DYNEMIT_ALLOC_HUGE). Returns nullptr if the mapping fails or flags combine
+ * LOCAL and INTERLEAVE. Release with dynemit_free().
+ */
+void *dynemit_alloc(size_t bytes, unsigned flags);
+
+/** Release a dynemit_alloc() buffer. Passing nullptr is a no-op. */
+void dynemit_free(void *p);
+
+/**
+ * NUMA node holding the page of each of count addresses, or -1 for a page
+ * not faulted in yet or when the kernel cannot tell (move_pages()).
+ *
+ * @return 0, or -1 if no node could be queried at all
+ */
+int dynemit_page_nodes(const void *const *addrs, size_t count, int *nodes);
+
+/*
+ * Kernel registry.
+ *
+ * Every ifunc-dispatched function registers the selector its resolver uses,
+ * so the kernel a given SIMD level would get can be fetched at run time and
+ * several levels compared in one process (benchmarks, A/B tests).
+ */
+typedef void (*dynemit_kernel_t)(void);
+
+struct dynemit_kernel_entry {
+    const char *name;
+    dynemit_kernel_t (*select)(simd_level_t level);
+    const char *prototype;
+};
+
+/**
+ * A registered function, as listed by dynemit_list_kernels().
+ */
+typedef struct {
+    const char *name;       ///< Public function name, e.g. "vector_mul_f32"
+    const char *prototype;  ///< Return type and parameter list as declared,
+                            ///< e.g. "void (const float *a, const float *b,
+                            ///< float *out, size_t n)", or nullptr if the
+                            ///< function was registered without one
+} dynemit_kernel_info_t;
+
+/**
+ * Look up the kernel a dispatched function uses at a given SIMD level.
+ *
+ * Returns exactly what the function's resolver would pick if
+ * detect_simd_level() returned level, including the extra feature checks
+ * some resolvers make (FMA, AVX-512BW, ...). DYNEMIT_MAX_LEVEL is not
+ * applied here. Cast the result to the function's own pointer type:
+ *
+ * @code
+ * typedef void (*mul_fn)(const float *, const float *, float *, size_t);
+ * mul_fn avx2 = (mul_fn)dynemit_get_kernel("vector_mul_f32", SIMD_AVX2);
+ * @endcode
+ *
+ * With libdynemit.so every function is registered. With the static
+ * archives only functions linked into the program are: the linker skips a
+ * feature's object file when the program references none of its symbols.
+ * Reference the dispatched function itself somewhere (or link with
+ * --whole-archive).
+ *
+ * @param name  Public function name, e.g. "vector_mul_f32"
+ * @param level SIMD level to select for
+ * @return The kernel, or nullptr if name is unknown, level is above what
+ *         the CPU supports or level belongs to another architecture
+ */
+dynemit_kernel_t dynemit_get_kernel(const char *name, simd_level_t level);
+
+/**
+ * List the registered functions, in link order. The same registration rules
+ * as for dynemit_get_kernel() apply.
+ *
+ * @param kernels Array receiving up to max entries (may be nullptr if max is 0)
+ * @param max     Capacity of kernels
+ * @return Number of registered functions, which may exceed max
+ */
+size_t dynemit_list_kernels(dynemit_kernel_info_t *kernels, size_t max);
+
+/*
+ * Rebindable dispatch table.
+ *
+ * An ifunc symbol is bound once and stays bound. Alongside it, every
+ * function defined with DYNEMIT_DISPATCH_BIND() has a table slot: one
+ * cache line holding a function pointer, read with a relaxed atomic load
+ * on each call through DYNEMIT_DISPATCH_CALL(). dynemit_rebind() swaps the
+ * pointer while other threads keep calling, e.g. to drop to a lower level
+ * after the process was moved to cores without AVX-512, or to apply an
+ * autotuning result. A call that has already loaded the old kernel
+ * finishes in it; no call ever sees a null pointer.
+ *
+ * A slot starts out pointing at a stub that binds, on the first call, the
+ * kernel the ifunc resolver would (including DYNEMIT_MAX_LEVEL, autotune
+ * routing and the stats wrapper) and then forwards the call. Kernels
+ * bound through dynemit_rebind() are called directly and not counted by
+ * DYNEMIT_STATS.
+ *
+ * The slots live in the "dynemit_dispatch" linker section, so the same
+ * registration rules as for dynemit_get_kernel() apply.
+ */
+typedef struct {
+    dynemit_kernel_t kernel;  // current kernel, only accessed atomically
+    dynemit_kernel_t first;   // first-call stub, the default binding
+    const char      *name;    // public function name
+} __attribute__((aligned(64))) dynemit_dispatch_t;
+
+/**
+ * Table slot of a dispatched function. Look it up once and keep it:
+ *
+ * @code
+ * const dynemit_dispatch_t *mul = dynemit_dispatch_lookup("vector_mul_f32");
+ * ...
+ * DYNEMIT_DISPATCH_CALL(mul, vector_mul_f32, a, b, out, n);
+ * @endcode
+ *
+ * @param name Public function name, e.g. "vector_mul_f32"
+ * @return The slot, or nullptr if name has none
+ */
+const dynemit_dispatch_t *dynemit_dispatch_lookup(const char *name);
+
+/**
+ * Call the kernel slot is currently bound to. name is the dispatched
+ * function, which only supplies the pointer type; the ifunc symbol itself
+ * is not called.
+ */
+#define DYNEMIT_DISPATCH_CALL(slot, name, ...)                                  \
+    ((__typeof__(&name))__atomic_load_n(&(slot)->kernel, __ATOMIC_RELAXED))(__VA_ARGS__)
+
+/**
+ * Bind the table slot of name to the kernel dynemit_get_kernel() returns
+ * for level. With name nullptr, do so for every slot; functions without a
+ * kernel at level keep theirs.
+ *
+ * @return 0, or -1 if name has no slot or there is no kernel at level
+ *         (level above what the CPU supports or of another architecture)
+ */
+int dynemit_rebind(const char *name, simd_level_t level);
+
+/**
+ * Bind the table slot of name to kernel, which must have the function's
+ * signature. nullptr restores the default binding, chosen again on the
+ * next call.
+ *
+ * @return 0, or -1 if name has no slot
+ */
+int dynemit_rebind_kernel(const char *name, dynemit_kernel_t kernel);
+
+/**
+ * Register a selector, a function returning the kernel for a simd_level_t,
+ * under name with dynemit_get_kernel(). Use at file scope. Entries live in
+ * the "dynemit_kernels" linker section, so registration needs no
+ * constructor and works before relocations are processed.
+ */
+#define DYNEMIT_REGISTER_KERNEL(name, select_fn)                                \
+    DYNEMIT_REGISTER_KERNEL_PROTO(name, select_fn, nullptr)
+
+/**
+ * DYNEMIT_REGISTER_KERNEL() with the prototype string reported by
+ * dynemit_list_kernels().
+ */
+#define DYNEMIT_REGISTER_KERNEL_PROTO(name, select_fn, proto)                   \
+    static dynemit_kernel_t                                                     \
+    name##_select_any(simd_level_t level)                                       \
+    {                                                                           \
+        return (dynemit_kernel_t)select_fn(level);                              \
+    }                                                                           \
+    __attribute__((used, section("dynemit_kernels"), aligned(sizeof(void *)))) \
+    static const struct dynemit_kernel_entry name##_kernel_entry = {            \
+        #name, name##_select_any, proto                                         \
+    };
+
+/**
+ * Define the ifunc resolver name##_resolver on top of the selector
+ * name##_select(simd_level_t) and register the selector as name. The
+ * resolver uses the cached detect_simd_level_ts(), so CPUID runs once per
+ * process however many symbols are bound, and, like
+ * EXPLICIT_RUNTIME_RESOLVER, traps rather than binding a null kernel. It
+ * returns the kernel's own pointer type, so GCC still checks it against
+ * the dispatched symbol.
+ */
+#define DYNEMIT_KERNEL_RESOLVER(name)                                           \
+    static __typeof__(name##_select(SIMD_SCALAR))                               \
+    name##_resolver(void)                                                       \
+    {                                                                           \
+        __typeof__(name##_select(SIMD_SCALAR)) kernel =                         \
+            name##_select(detect_simd_level_ts());                              \
+        if (!kernel)                                                            \
+            __builtin_trap();                                                   \
+        return kernel;                                                          \
+    }                                                                           \
+    DYNEMIT_REGISTER_KERNEL(name, name##_select)
+
+// Target of the ifunc declarations; the x86 ISA names mean nothing elsewhere
+#if defined(__x86_64__) || defined(__i386__)
+#define DYNEMIT_IFUNC_TARGET __attribute__((target("avx512f,avx2,avx,sse4.2,sse2")))
+#else
+#define DYNEMIT_IFUNC_TARGET
+#endif
+
+/*
+ * DYNEMIT_RETURN_CALL(ret, call): return call from a function returning
+ * ret. C forbids return with an expression in a void function, even a
+ * void one, so for ret void this is call; return;. ret must be void or a
+ * type that does not start with void (void * needs a typedef).
+ */
+#define DYNEMIT_RETURN_CALL(ret, call)                                          \
+    DYNEMIT_RETURN_CALL_SEL(DYNEMIT_IS_VOID(ret))(call)
+#define DYNEMIT_RETURN_CALL_SEL(is_void)  DYNEMIT_RETURN_CALL_SEL_(is_void)
+#define DYNEMIT_RETURN_CALL_SEL_(is_void) DYNEMIT_RETURN_CALL_##is_void
+#define DYNEMIT_RETURN_CALL_0(call)       return call;
+#define DYNEMIT_RETURN_CALL_1(call)       call; return;
+#define DYNEMIT_IS_VOID(ret)              DYNEMIT_IS_VOID_(DYNEMIT_VOID_PROBE_##ret, 0, 0)
+#define DYNEMIT_IS_VOID_(probe, ...)      DYNEMIT_IS_VOID__(probe, __VA_ARGS__)
+#define DYNEMIT_IS_VOID__(a, b, ...)      b
+#define DYNEMIT_VOID_PROBE_void           ~, 1
+
+/**
+ * Define the dispatched function name: the ifunc symbol, its resolver and
+ * the registry entry for name##_select. The resolver binds kernel_expr, a
+ * kernel pointer expression evaluated when the symbol is resolved, with the
+ * same null check as DYNEMIT_KERNEL_RESOLVER(). level_expr is the level
+ * of that kernel, evaluated alongside it, or DYNEMIT_STATS_LEVEL_TUNED for
+ * a kernel that picks a level per call. ret is the return type, params the
+ * parenthesised parameter list, args the matching argument list and
+ * elements the element count of a call.
+ *
+ * When call statistics are enabled (see dynemit_stats_mode()), the symbol is
+ * bound to a wrapper that records each call, reported under level_expr,
+ * and then calls the kernel; otherwise the kernel itself is bound and calls
+ * cost nothing extra.
+ *
+ * Also defines name's dispatch table slot, whose first-call stub binds
+ * what the resolver returns (see dynemit_dispatch_lookup()).
+ */
+#define DYNEMIT_DISPATCH_BIND(name, kernel_expr, level_expr, ret, params, args, elements) \
+    /* Written by the resolver, which may also run from the first call */       \
+    static __typeof__(name##_select(SIMD_SCALAR)) name##_stats_kernel;          \
+    static struct dynemit_stats_site name##_stats_site = { #name, SIMD_SCALAR, 0 }; \
+                                                                                \
+    static ret                                                                  \
+    name##_stats params                                                         \
+    {                                                                           \
+        __attribute__((cleanup(dynemit_stats_end))) struct dynemit_stats_call   \
+            call = dynemit_stats_begin(&name##_stats_site, (elements));         \
+        DYNEMIT_RETURN_CALL(ret, __atomic_load_n(&name##_stats_kernel,          \
+                                                 __ATOMIC_ACQUIRE) args)        \
+    }                                                                           \
+                                                                                \
+    static __typeof__(name##_select(SIMD_SCALAR))                               \
+    name##_resolver(void)                                                       \
+    {                                                                           \
+        __typeof__(name##_select(SIMD_SCALAR)) kernel = (kernel_expr);          \
+        if (!kernel)                                                            \
+            __builtin_trap();                                                   \
+        if (dynemit_stats_mode()) {                                             \
+            __atomic_store_n(&name##_stats_kernel, kernel, __ATOMIC_RELEASE);   \
+            dynemit_stats_bind(&name##_stats_site, (level_expr));               \
+            return name##_stats;                                                \
+        }                                                                       \
+        return kernel;                                                          \
+    }                                                                           \
+                                                                                \
+    DYNEMIT_REGISTER_KERNEL_PROTO(name, name##_select, #ret " " #params)        \
+                                                                                \
+    static ret name##_dispatch_first params;                                    \
+    __attribute__((used, section("dynemit_dispatch")))                          \
+    static dynemit_dispatch_t name##_dispatch_slot = {                          \
+        (dynemit_kernel_t)name##_dispatch_first,                                \
+        (dynemit_kernel_t)name##_dispatch_first, #name                          \
+    };                                                                          \
+                                                                                \
+    static ret                                                                  \
+    name##_dispatch_first params                                                \
+    {                                                                           \
+        dynemit_dispatch_bind_first(&name##_dispatch_slot,                      \
+                                    (dynemit_kernel_t)name##_resolver());       \
+        DYNEMIT_RETURN_CALL(ret, ((__typeof__(&name##_dispatch_first))__atomic_load_n( \
+            &name##_dispatch_slot.kernel, __ATOMIC_RELAXED)) args)              \
+    }                                                                           \
+                                                                                \
+    DYNEMIT_IFUNC_TARGET                                                        \
+    ret name params __attribute__((ifunc(#name "_resolver")));
+
+/**
+ * DYNEMIT_DISPATCH_BIND() of the kernel name##_select() returns for
+ * detect_simd_level_ts().
+ */
+#define DYNEMIT_DISPATCH(name, ret, params, args, elements)                     \
+    DYNEMIT_DISPATCH_BIND(name, name##_select(detect_simd_level_ts()),          \
+                          detect_simd_level_ts(), ret, params, args, elements)
+
+/*
+ * Autotuning (opt-in).
+ *
+ * With DYNEMIT_AUTOTUNE=1 in the environment at load time, the float
+ * element-wise operations (vector_add_f32, vector_sub_f32, vector_mul_f32)
+ * stop following "highest level wins". On the first call, outside the
+ * resolver, every level up to detect_simd_level() is timed on calibration
+ * buffers sized for each dynemit_size_class_t, and each call is then routed
+ * to the fastest level for its size class.
+ *
+ * Results are cached in a text file keyed by the CPUID signature, so later
+ * runs on the same host skip the measurement. The file is
+ * $DYNEMIT_AUTOTUNE_CACHE if set (empty disables caching), otherwise
+ * $XDG_CACHE_HOME/dynemit/autotune or ~/.cache/dynemit/autotune.
+ * DYNEMIT_AUTOTUNE=retune measures again and rewrites the entry.
+ */
+
+/**
+ * Autotune mode from the environment: 0 off, 1 on, 2 retune.
+ * Safe to call from IFUNC resolvers.
+ */
+int dynemit_autotune_mode(void);
+
+/**
+ * Tuned SIMD level per size class for a registered float binary operation
+ * (signature void (const float *, const float *, float *, size_t)).
+ *
+ * Looks the result up in the autotune cache, or measures and stores it.
+ * Works whether or not autotuning is enabled for dispatch. Levels never
+ * exceed detect_simd_level().
+ *
+ * @param name   Registered function name, e.g. "vector_mul_f32"
+ * @param levels Receives one level per dynemit_size_class_t
+ * @return 0 on success, -1 if name is not registered
+ */
+int dynemit_autotune_binary_f32(const char *name, simd_level_t levels[DYNEMIT_SIZE_CLASSES]);
+
+/**
+ * Fastest software prefetch distance in bytes on this host.
+ *
+ * Times vector_mul_f32 at detect_simd_level() on a DRAM-sized working set
+ * for each candidate distance (0, that is no prefetch, to 4 KiB) and keeps
+ * dynemit_default_prefetch_distance() unless another one is clearly
+ * faster. Cached in the autotune file like the level choices. Called by
+ * dynemit_prefetch_distance() when autotuning is enabled; leaves the
+ * distance of later calls set to the result.
+ */
+size_t dynemit_autotune_prefetch_distance(void);
+
+/*
+ * Call statistics (opt-in).
+ *
+ * With DYNEMIT_STATS=1 in the environment at load time, every dispatched
+ * function is bound to a wrapper that counts its calls and elements and
+ * keeps a histogram of call sizes; DYNEMIT_STATS=cycles also adds up the
+ * TSC cycles spent in the kernel. Counters are per thread, so recording
+ * never shares a cache line between threads, and are merged when read.
+ * Without the variable the kernels are bound directly and nothing is
+ * recorded.
+ *
+ * Only functions that have been resolved are reported. With lazy binding
+ * that is the functions called so far, with LD_BIND_NOW (or a static
+ * binary) every function the program references.
+ */
+
+// Histogram buckets: 0 counts empty calls, k counts 4^(k-1) <= n < 4^k,
+// and the last one every call from 4^14 elements up
+#define DYNEMIT_STATS_BUCKETS 16
+
+// Functions that can be tracked; further ones are bound without stats
+#define DYNEMIT_STATS_MAX_FUNCS 256
+
+// Level of a function bound to the autotuned kernel, which picks a level
+// per call by size class (see DYNEMIT_AUTOTUNE); dumped as "tuned"
+#define DYNEMIT_STATS_LEVEL_TUNED ((simd_level_t)-1)
+
+typedef struct {
+    const char  *name;      // public function name, e.g. "vector_add_f32"
+    simd_level_t level;     // level of the bound kernel, or DYNEMIT_STATS_LEVEL_TUNED
+    uint64_t     calls;
+    uint64_t     elements;  // sum of n over all calls (items for batches)
+    uint64_t     cycles;    // TSC cycles in the kernel, 0 unless DYNEMIT_STATS=cycles
+    uint64_t     size_hist[DYNEMIT_STATS_BUCKETS];
+} dynemit_stats_t;
+
+typedef enum {
+    DYNEMIT_STATS_TEXT = 0,
+    DYNEMIT_STATS_JSON = 1
+} dynemit_stats_format_t;
+
+/**
+ * Stats mode from the environment: 0 off, 1 counters, 2 counters and
+ * cycles. Safe to call from IFUNC resolvers.
+ */
+int dynemit_stats_mode(void);
+
+/**
+ * Merged counters of every tracked function, including threads that have
+ * exited, since the start or the last dynemit_stats_reset().
+ *
+ * @param stats Receives up to max entries, in the order functions were bound
+ * @param max   Capacity of stats
+ * @return Number of tracked functions, which may exceed max
+ */
+size_t dynemit_stats_snapshot(dynemit_stats_t *stats, size_t max);
+
+/**
+ * Start counting from zero again. Calls running concurrently are counted
+ * either before or after the reset.
+ */
+void dynemit_stats_reset(void);
+
+/**
+ * Format dynemit_stats_snapshot() into buf, with snprintf() semantics.
+ *
+ * DYNEMIT_STATS_TEXT gives one line per function with its level, calls,
+ * elements, cycles per element and the non-empty histogram buckets.
+ * DYNEMIT_STATS_JSON gives {"mode": ..., "functions": [{"name", "level",
+ * "calls", "elements", "cycles", "size_hist": [16 counts]}, ...]}.
+ *
+ * @return Length of the full output, excluding the terminating nul; the
+ *         output was truncated if this is >= size
+ */
+size_t dynemit_stats_dump(char *buf, size_t size, dynemit_stats_format_t format);
+
+// Used by DYNEMIT_DISPATCH_BIND(); not meant to be called directly
+struct dynemit_stats_site {
+    const char  *name;
+    simd_level_t level;
+    int          slot;  // 1-based slot in the stats table, 0 if untracked
+};
+
+struct dynemit_stats_call {
+    const struct dynemit_stats_site *site;
+    uint64_t elements;
+    uint64_t start;     // TSC at entry, 0 without cycle counting
+};
+
+void dynemit_stats_bind(struct dynemit_stats_site *site, simd_level_t level);
+struct dynemit_stats_call dynemit_stats_begin(const struct dynemit_stats_site *site, uint64_t elements);
+void dynemit_stats_end(struct dynemit_stats_call *call);
+
+// Replaces slot's first-call stub with kernel, unless it was rebound meanwhile
+void dynemit_dispatch_bind_first(dynemit_dispatch_t *slot, dynemit_kernel_t kernel);
+
 /**
  * Get list of available features in this build.
  * Returns nullptr-terminated array of feature names.
@@ -72,6 +787,8 @@ const char *simd_level_name(simd_level_t level);
  */
 const char **dynemit_features(void);
 
+#pragma GCC visibility pop
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,116 @@
+/* SPDX-License-Identifier: BSL-1.0 */
+#ifndef DYNEMIT_EXPR_H
+#define DYNEMIT_EXPR_H
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#pragma GCC visibility push(default)
+
+/**
+ * @file expr.h
+ * @brief Fused evaluation of chained element-wise float expressions
+ *
+ * Computing out = (a*b - c) + d with three library calls streams two full
+ * temporaries through memory. An expression built here is evaluated in a
+ * single pass instead: the inputs are walked in chunks of
+ * DYNEMIT_EXPR_CHUNK elements, each operation runs on the chunk through the
+ * regular ifunc-dispatched kernel, and intermediates stay in small scratch
+ * buffers that never leave L1. Only the inputs are read and only out is
+ * written, once.
+ *
+ * Results are bit-identical to the same chain of vector_*_f32() calls.
+ *
+ * @code
+ * dynemit_expr *e = dynemit_expr_create();
+ * int a = dynemit_expr_input(e, 0), b = dynemit_expr_input(e, 1);
+ * int c = dynemit_expr_input(e, 2), d = dynemit_expr_input(e, 3);
+ * int root = dynemit_expr_add(e, dynemit_expr_sub(e, dynemit_expr_mul(e, a, b), c), d);
+ * const float *in[] = { pa, pb, pc, pd };
+ * dynemit_expr_eval(e, root, in, out, n);
+ * dynemit_expr_destroy(e);
+ * @endcode
+ */
+
+/** Maximum number of nodes (inputs, constants and operations) per expression. */
+#define DYNEMIT_EXPR_MAX_NODES 32
+
+/** Maximum number of input arrays. */
+#define DYNEMIT_EXPR_MAX_INPUTS 8
+
+/**
+ * Elements per chunk: each live intermediate takes one chunk of scratch.
+ * Up to four chunks (8 KiB) live on the stack of dynemit_expr_eval(); an
+ * expression with more live intermediates allocates its scratch per call.
+ */
+#define DYNEMIT_EXPR_CHUNK 512
+
+/** Opaque expression under construction. */
+typedef struct dynemit_expr dynemit_expr;
+
+/**
+ * Create an empty expression.
+ *
+ * @return New expression, or nullptr if allocation failed
+ */
+dynemit_expr *dynemit_expr_create(void);
+
+/**
+ * Free an expression. Passing nullptr is a no-op.
+ */
+void dynemit_expr_destroy(dynemit_expr *e);
+
+/*
+ * Node constructors. Each returns the id of the new node (>= 0), or -1 if
+ * the expression is full, an index is out of range or an operand is not a
+ * valid node. An invalid operand, including -1 from an earlier constructor,
+ * makes the result -1 too, so a whole expression can be built first and
+ * checked once through dynemit_expr_eval().
+ */
+
+/** Element i of inputs[index] passed to dynemit_expr_eval() */
+int dynemit_expr_input(dynemit_expr *e, unsigned index);
+
+/** The same value for every element */
+int dynemit_expr_const(dynemit_expr *e, float value);
+
+/** x + y, as vector_add_f32() */
+int dynemit_expr_add(dynemit_expr *e, int x, int y);
+
+/** x - y, as vector_sub_f32() */
+int dynemit_expr_sub(dynemit_expr *e, int x, int y);
+
+/** x * y, as vector_mul_f32() */
+int dynemit_expr_mul(dynemit_expr *e, int x, int y);
+
+/** x * y + z, as vector_fma_f32() (fused where the CPU supports it) */
+int dynemit_expr_fma(dynemit_expr *e, int x, int y, int z);
+
+/**
+ * Evaluate node root for n elements into out.
+ *
+ * Only the nodes root depends on are computed. out may be the same array as
+ * one of the inputs, but must not partially overlap any of them.
+ *
+ * @param e      Expression
+ * @param root   Node to evaluate
+ * @param inputs Input arrays, indexed as in dynemit_expr_input(); each must
+ *               hold n elements
+ * @param out    Output array of n elements
+ * @param n      Number of elements
+ * @return 0 on success, -1 if root is not a valid node of e or the scratch
+ *         of a wide expression could not be allocated
+ */
+int dynemit_expr_eval(const dynemit_expr *e, int root, const float *const *inputs,
+                      float *out, size_t n);
+
+#pragma GCC visibility pop
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // DYNEMIT_EXPR_H
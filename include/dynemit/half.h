@@ -0,0 +1,101 @@
+/* SPDX-License-Identifier: BSL-1.0 */
+#ifndef DYNEMIT_HALF_H
+#define DYNEMIT_HALF_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#pragma GCC visibility push(default)
+
+/*
+ * Half-precision (IEEE 754 binary16) and bfloat16 storage kernels.
+ *
+ * Both types are stored as raw 16-bit patterns and only used for storage:
+ * inputs are widened to float in registers, the arithmetic is done in float
+ * and results are rounded back to nearest-even. For add and mul this gives
+ * the correctly rounded 16-bit result, identical on every SIMD level (float
+ * has more than twice the precision of either type, so the double rounding
+ * is harmless). Dot products accumulate in float.
+ *
+ * Conversions use F16C, AVX-512F, AVX512-FP16 and AVX-512 BF16 where the CPU
+ * has them, with a scalar fallback. The AVX-512 BF16 instructions flush
+ * float subnormals to zero, so on those CPUs bf16 results that would be
+ * subnormal may come out as (signed) zero, and dot_bf16 uses paired
+ * bf16 dot-product instructions whose rounding differs slightly from the
+ * other levels.
+ */
+
+typedef uint16_t dynemit_f16_t;   // IEEE 754 binary16 bit pattern
+typedef uint16_t dynemit_bf16_t;  // bfloat16 bit pattern (upper half of a float)
+
+/** Widen one fp16 value to float (exact). */
+float dynemit_f16_to_f32(dynemit_f16_t h);
+
+/** Round one float to fp16, nearest-even; overflows to infinity, NaN stays NaN. */
+dynemit_f16_t dynemit_f32_to_f16(float f);
+
+/** Widen one bf16 value to float (exact). */
+float dynemit_bf16_to_f32(dynemit_bf16_t h);
+
+/** Round one float to bf16, nearest-even; NaN stays NaN. */
+dynemit_bf16_t dynemit_f32_to_bf16(float f);
+
+/**
+ * Element-wise addition of two fp16 vectors: out[i] = a[i] + b[i]
+ * Automatically dispatches to the best SIMD implementation available.
+ */
+void vector_add_f16(const dynemit_f16_t *a, const dynemit_f16_t *b, dynemit_f16_t *out, size_t n);
+
+/**
+ * Element-wise multiplication of two fp16 vectors: out[i] = a[i] * b[i]
+ * Automatically dispatches to the best SIMD implementation available.
+ */
+void vector_mul_f16(const dynemit_f16_t *a, const dynemit_f16_t *b, dynemit_f16_t *out, size_t n);
+
+/** out[i] = a[i] + b[i] with fp16 inputs and a float output. */
+void vector_add_f16_f32(const dynemit_f16_t *a, const dynemit_f16_t *b, float *out, size_t n);
+
+/** out[i] = a[i] * b[i] with fp16 inputs and a float output. */
+void vector_mul_f16_f32(const dynemit_f16_t *a, const dynemit_f16_t *b, float *out, size_t n);
+
+/**
+ * Dot product of two fp16 vectors, accumulated in float.
+ * Returns 0.0f when n == 0.
+ */
+float dot_f16(const dynemit_f16_t *a, const dynemit_f16_t *b, size_t n);
+
+/**
+ * Element-wise addition of two bf16 vectors: out[i] = a[i] + b[i]
+ * Automatically dispatches to the best SIMD implementation available.
+ */
+void vector_add_bf16(const dynemit_bf16_t *a, const dynemit_bf16_t *b, dynemit_bf16_t *out, size_t n);
+
+/**
+ * Element-wise multiplication of two bf16 vectors: out[i] = a[i] * b[i]
+ * Automatically dispatches to the best SIMD implementation available.
+ */
+void vector_mul_bf16(const dynemit_bf16_t *a, const dynemit_bf16_t *b, dynemit_bf16_t *out, size_t n);
+
+/** out[i] = a[i] + b[i] with bf16 inputs and a float output. */
+void vector_add_bf16_f32(const dynemit_bf16_t *a, const dynemit_bf16_t *b, float *out, size_t n);
+
+/** out[i] = a[i] * b[i] with bf16 inputs and a float output. */
+void vector_mul_bf16_f32(const dynemit_bf16_t *a, const dynemit_bf16_t *b, float *out, size_t n);
+
+/**
+ * Dot product of two bf16 vectors, accumulated in float.
+ * Returns 0.0f when n == 0.
+ */
+float dot_bf16(const dynemit_bf16_t *a, const dynemit_bf16_t *b, size_t n);
+
+#pragma GCC visibility pop
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // DYNEMIT_HALF_H
@@ -0,0 +1,474 @@
+/* SPDX-License-Identifier: BSL-1.0 */
+#ifndef DYNEMIT_KERNEL_H
+#define DYNEMIT_KERNEL_H
+
+/**
+ * @file kernel.h
+ * @brief Generate a dispatched element-wise kernel from one lane-wise body
+ *
+ * The hand-written kernels of the library repeat the same loop at every
+ * level and differ only in the intrinsic in the middle. For an operation
+ * that is a plain expression of its operands, this header writes those
+ * loops instead: one macro invocation defines the scalar kernel, one kernel
+ * per SIMD level of the target architecture, the name##_select() selector,
+ * the ifunc symbol and its registry entry (DYNEMIT_DISPATCH() in
+ * <dynemit/core.h>). The library's own float and double add, sub and mul
+ * are defined this way.
+ *
+ *     #define AXPB(x, y) ((x) * 2.0f + (y))
+ *     DYNEMIT_KERNEL_BINARY(vector_axpb_f32, float, AXPB)
+ *
+ * defines void vector_axpb_f32(const float *a, const float *b, float *out,
+ * size_t n) computing out[i] = AXPB(a[i], b[i]). The _LEVELS forms stop
+ * after the selector, for a symbol that is dispatched some other way.
+ *
+ * The operation is a function-like macro that is expanded both on single
+ * elements and on GCC vector types of the element type (vector_size), so it
+ * may use the arithmetic and bitwise operators and constants of the element
+ * type (2.0f, not 2.0, for float), but not function calls, comparisons or
+ * ?:, which have no element-type lane-wise meaning in C. Each operand is
+ * loaded once, so an operation may use its arguments any number of times.
+ * Floating-point contraction is off in every generated kernel, so all levels
+ * compute the expression as written and agree bit for bit. Integer lanes
+ * wrap on overflow; keep integer operations free of signed overflow, which
+ * is undefined in the scalar kernel.
+ *
+ * On x86 the AVX, AVX2 and AVX-512F kernels of 32- and 64-bit element types
+ * are dispatched by size like the rest of the library's element-wise
+ * kernels:
+ *
+ *   - n <= 4 vectors: straight-line masked operations, no loop;
+ *   - working set within L2: a masked head that aligns out to the vector
+ *     width, a body unrolled 4x and a masked tail;
+ *   - larger (dynemit_sized_large_bytes()): the same body with software
+ *     prefetch dynemit_prefetch_distance() bytes ahead and, when the output
+ *     reaches dynemit_stream_threshold() bytes and is not an input,
+ *     non-temporal stores.
+ *
+ * The SSE kernels, and the AVX kernels of narrower types, which have no
+ * masked loads and stores, run the same body with scalar heads and tails
+ * and align a streamed output to a cache line. On aarch64 every ARM level
+ * runs the single NEON kernel, which prefetches but does not stream.
+ *
+ * Aliasing follows <dynemit.h>: out may be the same array as any input.
+ * Arrays need no particular alignment. The translation unit should be
+ * compiled without -m ISA flags, as the library's own kernels are; the
+ * per-level target attributes add to those flags rather than replace them.
+ * The registry entry is only visible to dynemit_get_kernel() when the
+ * program links the static library.
+ */
+
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <dynemit/core.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+/**
+ * Define name(const T *a, T *out, size_t n): out[i] = OP(a[i]).
+ */
+#define DYNEMIT_KERNEL_UNARY(name, T, OP)                                      \
+    DYNEMIT_KERNEL_IMPL_LEVELS(name, 1, T, OP)                                 \
+    DYNEMIT_KERNEL_IMPL_SYMBOL(name, 1, T)
+
+/**
+ * Define name(const T *a, const T *b, T *out, size_t n):
+ * out[i] = OP(a[i], b[i]).
+ */
+#define DYNEMIT_KERNEL_BINARY(name, T, OP)                                     \
+    DYNEMIT_KERNEL_IMPL_LEVELS(name, 2, T, OP)                                 \
+    DYNEMIT_KERNEL_IMPL_SYMBOL(name, 2, T)
+
+/**
+ * Define name(const T *a, const T *b, const T *c, T *out, size_t n):
+ * out[i] = OP(a[i], b[i], c[i]).
+ */
+#define DYNEMIT_KERNEL_TERNARY(name, T, OP)                                    \
+    DYNEMIT_KERNEL_IMPL_LEVELS(name, 3, T, OP)                                 \
+    DYNEMIT_KERNEL_IMPL_SYMBOL(name, 3, T)
+
+/**
+ * Only the kernels, name##_func_t and name##_select(): the level kernels
+ * are static functions name##_scalar and, on x86, name##_sse2, _sse42,
+ * _avx, _avx2 and _avx512f (name##_neon on aarch64). Dispatch them with
+ * DYNEMIT_DISPATCH() or a resolver of your own.
+ */
+#define DYNEMIT_KERNEL_UNARY_LEVELS(name, T, OP)   DYNEMIT_KERNEL_IMPL_LEVELS(name, 1, T, OP)
+#define DYNEMIT_KERNEL_BINARY_LEVELS(name, T, OP)  DYNEMIT_KERNEL_IMPL_LEVELS(name, 2, T, OP)
+#define DYNEMIT_KERNEL_TERNARY_LEVELS(name, T, OP) DYNEMIT_KERNEL_IMPL_LEVELS(name, 3, T, OP)
+
+/**
+ * Output size in bytes from which the size-dispatched kernels take their
+ * large path: the working set (a, b and out) outgrows L2, or the output
+ * reaches dynemit_stream_threshold(). Cached per translation unit, so the
+ * dispatch costs one load per call. Bit 63 marks the value as initialized.
+ */
+static inline size_t
+dynemit_sized_large_bytes(void)
+{
+    static _Atomic uint64_t cached;
+    const uint64_t initialized = UINT64_C(1) << 63;
+
+    uint64_t bytes = atomic_load_explicit(&cached, memory_order_relaxed);
+    if (!(bytes & initialized)) {
+        size_t l2 = dynemit_size_class_limit(DYNEMIT_SIZE_L2) / 3 + 1;
+        size_t stream = dynemit_stream_threshold();
+        bytes = (uint64_t)(l2 < stream ? l2 : stream) | initialized;
+        atomic_store_explicit(&cached, bytes, memory_order_relaxed);
+    }
+    return (size_t)(bytes & ~initialized);
+}
+
+/*
+ * Implementation. Everything below is expanded by the macros above and is
+ * not meant to be used directly.
+ */
+
+#define DYNEMIT_KERNEL_IMPL_PARAMS_1(T) (const T *a, T *out, size_t n)
+#define DYNEMIT_KERNEL_IMPL_PARAMS_2(T) (const T *a, const T *b, T *out, size_t n)
+#define DYNEMIT_KERNEL_IMPL_PARAMS_3(T) (const T *a, const T *b, const T *c, T *out, size_t n)
+
+#define DYNEMIT_KERNEL_IMPL_ARGS_1 (a, out, n)
+#define DYNEMIT_KERNEL_IMPL_ARGS_2 (a, b, out, n)
+#define DYNEMIT_KERNEL_IMPL_ARGS_3 (a, b, c, out, n)
+
+// The shared body of the cached and large paths takes the path as a flag
+#define DYNEMIT_KERNEL_IMPL_BODY_PARAMS_1(T) (const T *a, T *out, size_t n, const int large)
+#define DYNEMIT_KERNEL_IMPL_BODY_PARAMS_2(T) (const T *a, const T *b, T *out, size_t n, const int large)
+#define DYNEMIT_KERNEL_IMPL_BODY_PARAMS_3(T)                                   \
+    (const T *a, const T *b, const T *c, T *out, size_t n, const int large)
+
+#define DYNEMIT_KERNEL_IMPL_BODY_ARGS_1(large) (a, out, n, large)
+#define DYNEMIT_KERNEL_IMPL_BODY_ARGS_2(large) (a, b, out, n, large)
+#define DYNEMIT_KERNEL_IMPL_BODY_ARGS_3(large) (a, b, c, out, n, large)
+
+// Not in place: streaming only pays off for a separate output
+#define DYNEMIT_KERNEL_IMPL_APART_1 (out != a)
+#define DYNEMIT_KERNEL_IMPL_APART_2 (out != a && out != b)
+#define DYNEMIT_KERNEL_IMPL_APART_3 (out != a && out != b && out != c)
+
+// Prefetch every input dist bytes past the bytes bytes starting at element i
+#define DYNEMIT_KERNEL_IMPL_FETCH(p, i, off, dist)                             \
+    __builtin_prefetch((const char *)((p) + (i)) + (off) + (dist), 0, 3)
+#define DYNEMIT_KERNEL_IMPL_PREFETCH_1(i, bytes, dist)                         \
+    for (size_t p_ = 0; (dist) && p_ < (bytes); p_ += 64)                      \
+        DYNEMIT_KERNEL_IMPL_FETCH(a, i, p_, dist);
+#define DYNEMIT_KERNEL_IMPL_PREFETCH_2(i, bytes, dist)                         \
+    for (size_t p_ = 0; (dist) && p_ < (bytes); p_ += 64) {                    \
+        DYNEMIT_KERNEL_IMPL_FETCH(a, i, p_, dist);                             \
+        DYNEMIT_KERNEL_IMPL_FETCH(b, i, p_, dist);                             \
+    }
+#define DYNEMIT_KERNEL_IMPL_PREFETCH_3(i, bytes, dist)                         \
+    for (size_t p_ = 0; (dist) && p_ < (bytes); p_ += 64) {                    \
+        DYNEMIT_KERNEL_IMPL_FETCH(a, i, p_, dist);                             \
+        DYNEMIT_KERNEL_IMPL_FETCH(b, i, p_, dist);                             \
+        DYNEMIT_KERNEL_IMPL_FETCH(c, i, p_, dist);                             \
+    }
+
+// OP applied at element i, with each operand loaded once through LD(p, i)
+#define DYNEMIT_KERNEL_IMPL_EVAL_1(OP, LD, i)                                  \
+    ({                                                                         \
+        __typeof__(LD(a, i)) dynemit_x_ = LD(a, i);                            \
+        OP(dynemit_x_);                                                        \
+    })
+#define DYNEMIT_KERNEL_IMPL_EVAL_2(OP, LD, i)                                  \
+    ({                                                                         \
+        __typeof__(LD(a, i)) dynemit_x_ = LD(a, i), dynemit_y_ = LD(b, i);     \
+        OP(dynemit_x_, dynemit_y_);                                            \
+    })
+#define DYNEMIT_KERNEL_IMPL_EVAL_3(OP, LD, i)                                  \
+    ({                                                                         \
+        __typeof__(LD(a, i)) dynemit_x_ = LD(a, i), dynemit_y_ = LD(b, i),     \
+                             dynemit_z_ = LD(c, i);                            \
+        OP(dynemit_x_, dynemit_y_, dynemit_z_);                                \
+    })
+
+// Loaders: one element, or one unaligned vector of the kernel's width
+#define DYNEMIT_KERNEL_IMPL_LOAD(p, i) ((p)[i])
+#define DYNEMIT_KERNEL_IMPL_LOADV(p, i)                                        \
+    ({                                                                         \
+        dynemit_kvec_t dynemit_v_;                                             \
+        __builtin_memcpy(&dynemit_v_, (p) + (i), sizeof(dynemit_v_));          \
+        dynemit_v_;                                                            \
+    })
+
+#define DYNEMIT_KERNEL_IMPL_ELEM(ARITY, OP, i)                                 \
+    out[i] = DYNEMIT_KERNEL_IMPL_EVAL_##ARITY(OP, DYNEMIT_KERNEL_IMPL_LOAD, i)
+#define DYNEMIT_KERNEL_IMPL_VEC(ARITY, OP, i)                                  \
+    DYNEMIT_KERNEL_IMPL_EVAL_##ARITY(OP, DYNEMIT_KERNEL_IMPL_LOADV, i)
+#define DYNEMIT_KERNEL_IMPL_STOREV(p, v) __builtin_memcpy((p), &(v), sizeof(v))
+
+/*
+ * Four vectors per iteration, then one, writing each result with
+ * STORE(p, v); prefetching dist bytes ahead when dist is not 0.
+ */
+#define DYNEMIT_KERNEL_IMPL_LOOP(ARITY, OP, STORE, dist)                       \
+    for (; i + 4 * lanes <= n; i += 4 * lanes) {                               \
+        DYNEMIT_KERNEL_IMPL_PREFETCH_##ARITY(i, 4 * lanes * sizeof(*out), dist) \
+        dynemit_kvec_t r0 = DYNEMIT_KERNEL_IMPL_VEC(ARITY, OP, i);             \
+        dynemit_kvec_t r1 = DYNEMIT_KERNEL_IMPL_VEC(ARITY, OP, i + lanes);     \
+        dynemit_kvec_t r2 = DYNEMIT_KERNEL_IMPL_VEC(ARITY, OP, i + 2 * lanes); \
+        dynemit_kvec_t r3 = DYNEMIT_KERNEL_IMPL_VEC(ARITY, OP, i + 3 * lanes); \
+        STORE(out + i, r0);                                                    \
+        STORE(out + i + lanes, r1);                                            \
+        STORE(out + i + 2 * lanes, r2);                                        \
+        STORE(out + i + 3 * lanes, r3);                                        \
+    }                                                                          \
+    for (; i + lanes <= n; i += lanes) {                                       \
+        dynemit_kvec_t r_ = DYNEMIT_KERNEL_IMPL_VEC(ARITY, OP, i);             \
+        STORE(out + i, r_);                                                    \
+    }
+
+/*
+ * Kernel without masked operations, W bytes wide: scalar head and tail.
+ * Past dynemit_sized_large_bytes() it prefetches; with STREAM (x86) an
+ * output of dynemit_stream_threshold() bytes that is not an input is
+ * aligned to a cache line and written with non-temporal stores.
+ */
+#define DYNEMIT_KERNEL_IMPL_PLAIN(name, suffix, attrs, W, STREAM, ARITY, T, OP) \
+    attrs __attribute__((optimize("fp-contract=off"))) static void             \
+    name##_##suffix DYNEMIT_KERNEL_IMPL_PARAMS_##ARITY(T)                      \
+    {                                                                          \
+        typedef T dynemit_kvec_t __attribute__((vector_size(W)));              \
+        const size_t lanes = (W) / sizeof(T);                                  \
+        const size_t pf = n * sizeof(T) >= dynemit_sized_large_bytes()         \
+                              ? dynemit_prefetch_distance() : 0;               \
+        size_t i = 0;                                                          \
+                                                                               \
+        if (STREAM && DYNEMIT_KERNEL_IMPL_APART_##ARITY &&                     \
+            n * sizeof(T) >= dynemit_stream_threshold()) {                     \
+            for (; i < n && ((uintptr_t)(out + i) & 63); i++)                  \
+                DYNEMIT_KERNEL_IMPL_ELEM(ARITY, OP, i);                        \
+            DYNEMIT_KERNEL_IMPL_LOOP(ARITY, OP, DYNEMIT_KERNEL_IMPL_STREAM_##W, pf) \
+            DYNEMIT_KERNEL_IMPL_FENCE();                                       \
+        }                                                                      \
+        DYNEMIT_KERNEL_IMPL_LOOP(ARITY, OP, DYNEMIT_KERNEL_IMPL_STOREV, pf)    \
+        for (; i < n; i++)                                                     \
+            DYNEMIT_KERNEL_IMPL_ELEM(ARITY, OP, i);                            \
+    }
+
+#if defined(__x86_64__) || defined(__i386__)
+#define DYNEMIT_KERNEL_IMPL_SCALAR_ATTRS                                       \
+    __attribute__((target("default"), optimize("no-tree-vectorize", "fp-contract=off")))
+#else
+#define DYNEMIT_KERNEL_IMPL_SCALAR_ATTRS                                       \
+    __attribute__((optimize("no-tree-vectorize", "fp-contract=off")))
+#endif
+
+#define DYNEMIT_KERNEL_IMPL_SCALAR(name, ARITY, T, OP)                         \
+    DYNEMIT_KERNEL_IMPL_SCALAR_ATTRS static void                               \
+    name##_scalar DYNEMIT_KERNEL_IMPL_PARAMS_##ARITY(T)                        \
+    {                                                                          \
+        for (size_t i = 0; i < n; i++)                                         \
+            DYNEMIT_KERNEL_IMPL_ELEM(ARITY, OP, i);                            \
+    }
+
+#define DYNEMIT_KERNEL_IMPL_SYMBOL(name, ARITY, T)                             \
+    DYNEMIT_DISPATCH(name, void, DYNEMIT_KERNEL_IMPL_PARAMS_##ARITY(T),        \
+                     DYNEMIT_KERNEL_IMPL_ARGS_##ARITY, n)
+
+#if defined(__x86_64__) || defined(__i386__)
+
+#define DYNEMIT_KERNEL_IMPL_STREAM_16(p, v) _mm_stream_si128((__m128i *)(p), (__m128i)(v))
+#define DYNEMIT_KERNEL_IMPL_STREAM_32(p, v) _mm256_stream_si256((__m256i *)(p), (__m256i)(v))
+#define DYNEMIT_KERNEL_IMPL_STREAM_64(p, v) _mm512_stream_si512((__m512i *)(p), (__m512i)(v))
+#define DYNEMIT_KERNEL_IMPL_FENCE() _mm_sfence()
+
+// Masked loads and stores exist for 32- and 64-bit lanes only
+#define DYNEMIT_KERNEL_IMPL_MASKABLE(T) (sizeof(T) == 4 || sizeof(T) == 8)
+
+// Sliding window of 32-bit lane masks for AVX: 8 - k gives k lanes
+__attribute__((unused)) static const int32_t dynemit_kernel_tail_mask[16] = {
+    -1, -1, -1, -1, -1, -1, -1, -1, 0, 0, 0, 0, 0, 0, 0, 0,
+};
+
+/*
+ * Masks of k elements and the loads and stores under the mask m_ in scope,
+ * per kind of level. Masked loads leave the inactive lanes zero and never
+ * fault on them; 64-bit AVX lanes are covered by pairs of 32-bit mask lanes.
+ */
+#define DYNEMIT_KERNEL_IMPL_MASK_T_AVX __m256i
+#define DYNEMIT_KERNEL_IMPL_MASK_AVX(T, k)                                     \
+    _mm256_loadu_si256((const __m256i *)(dynemit_kernel_tail_mask + 8 - (k) * (sizeof(T) / 4)))
+#define DYNEMIT_KERNEL_IMPL_LOADM_AVX(p, i)                                    \
+    ((dynemit_kvec_t)_mm256_maskload_ps((const float *)((p) + (i)), m_))
+#define DYNEMIT_KERNEL_IMPL_STOREM_AVX(p, v) _mm256_maskstore_ps((float *)(p), m_, (__m256)(v))
+
+#define DYNEMIT_KERNEL_IMPL_MASK_T_AVX512 __mmask16
+#define DYNEMIT_KERNEL_IMPL_MASK_AVX512(T, k) ((__mmask16)((1u << (k)) - 1))
+#define DYNEMIT_KERNEL_IMPL_LOADM_AVX512(p, i)                                 \
+    (sizeof(*(p)) == 4 ? (dynemit_kvec_t)_mm512_maskz_loadu_epi32(m_, (p) + (i)) \
+                       : (dynemit_kvec_t)_mm512_maskz_loadu_epi64((__mmask8)m_, (p) + (i)))
+#define DYNEMIT_KERNEL_IMPL_STOREM_AVX512(p, v)                                \
+    do {                                                                       \
+        if (sizeof(*(p)) == 4)                                                 \
+            _mm512_mask_storeu_epi32((p), m_, (__m512i)(v));                   \
+        else                                                                   \
+            _mm512_mask_storeu_epi64((p), (__mmask8)m_, (__m512i)(v));         \
+    } while (0)
+
+// k elements at i under a mask, k below the vector width
+#define DYNEMIT_KERNEL_IMPL_MASKED(KIND, ARITY, T, OP, i, k)                   \
+    do {                                                                       \
+        const DYNEMIT_KERNEL_IMPL_MASK_T_##KIND m_ = DYNEMIT_KERNEL_IMPL_MASK_##KIND(T, k); \
+        dynemit_kvec_t r_ = DYNEMIT_KERNEL_IMPL_EVAL_##ARITY(OP, DYNEMIT_KERNEL_IMPL_LOADM_##KIND, i); \
+        DYNEMIT_KERNEL_IMPL_STOREM_##KIND(out + (i), r_);                      \
+    } while (0)
+
+/*
+ * Size-dispatched kernel W bytes wide for AVX and up, KIND naming its
+ * masks. name##_##suffix routes each call by n between name##_##suffix##_tiny,
+ * name##_##suffix##_cached and name##_##suffix##_large; types without
+ * masked operations skip the tiny path and take scalar heads and tails.
+ */
+#define DYNEMIT_KERNEL_IMPL_SIZED(name, suffix, tgt, W, KIND, ARITY, T, OP)    \
+    __attribute__((target(tgt), optimize("fp-contract=off"))) static void      \
+    name##_##suffix##_tiny DYNEMIT_KERNEL_IMPL_PARAMS_##ARITY(T)               \
+    {                                                                          \
+        typedef T dynemit_kvec_t __attribute__((vector_size(W)));              \
+        const size_t lanes = (W) / sizeof(T);                                  \
+        _Pragma("GCC unroll 4")                                                \
+        for (size_t i = 0; i < 4 * lanes; i += lanes) {                        \
+            DYNEMIT_KERNEL_IMPL_MASKED(KIND, ARITY, T, OP, i, n - i < lanes ? n - i : lanes); \
+            if (n - i <= lanes)                                                \
+                return;                                                        \
+        }                                                                      \
+    }                                                                          \
+                                                                               \
+    __attribute__((target(tgt), optimize("fp-contract=off"), always_inline))   \
+    static inline void                                                         \
+    name##_##suffix##_body DYNEMIT_KERNEL_IMPL_BODY_PARAMS_##ARITY(T)          \
+    {                                                                          \
+        typedef T dynemit_kvec_t __attribute__((vector_size(W)));              \
+        const size_t lanes = (W) / sizeof(T);                                  \
+        const size_t pf = large ? dynemit_prefetch_distance() : 0;             \
+        size_t i = 0;                                                          \
+                                                                               \
+        /* Head so the full-width stores are aligned */                        \
+        size_t head = (((W) - ((uintptr_t)out & ((W) - 1))) & ((W) - 1)) / sizeof(T); \
+        if (head > n)                                                          \
+            head = n;                                                          \
+        if (DYNEMIT_KERNEL_IMPL_MASKABLE(T)) {                                 \
+            if (head)                                                          \
+                DYNEMIT_KERNEL_IMPL_MASKED(KIND, ARITY, T, OP, 0, head);       \
+            i = head;                                                          \
+        } else {                                                               \
+            for (; i < head; i++)                                              \
+                DYNEMIT_KERNEL_IMPL_ELEM(ARITY, OP, i);                        \
+        }                                                                      \
+        if (large && DYNEMIT_KERNEL_IMPL_APART_##ARITY &&                      \
+            n * sizeof(T) >= dynemit_stream_threshold() &&                     \
+            ((uintptr_t)(out + i) & ((W) - 1)) == 0) {                         \
+            /* Output larger than the LLC budget: bypass the cache. Not in    \
+               place, where the loads already own the lines */                 \
+            DYNEMIT_KERNEL_IMPL_LOOP(ARITY, OP, DYNEMIT_KERNEL_IMPL_STREAM_##W, pf) \
+            DYNEMIT_KERNEL_IMPL_FENCE();                                       \
+        }                                                                      \
+        DYNEMIT_KERNEL_IMPL_LOOP(ARITY, OP, DYNEMIT_KERNEL_IMPL_STOREV, pf)    \
+        if (DYNEMIT_KERNEL_IMPL_MASKABLE(T)) {                                 \
+            if (i < n)                                                         \
+                DYNEMIT_KERNEL_IMPL_MASKED(KIND, ARITY, T, OP, i, n - i);      \
+        } else {                                                               \
+            for (; i < n; i++)                                                 \
+                DYNEMIT_KERNEL_IMPL_ELEM(ARITY, OP, i);                        \
+        }                                                                      \
+    }                                                                          \
+                                                                               \
+    __attribute__((target(tgt), optimize("fp-contract=off"), noinline))        \
+    static void                                                                \
+    name##_##suffix##_cached DYNEMIT_KERNEL_IMPL_PARAMS_##ARITY(T)             \
+    {                                                                          \
+        name##_##suffix##_body DYNEMIT_KERNEL_IMPL_BODY_ARGS_##ARITY(0);       \
+    }                                                                          \
+                                                                               \
+    __attribute__((target(tgt), optimize("fp-contract=off"), noinline))        \
+    static void                                                                \
+    name##_##suffix##_large DYNEMIT_KERNEL_IMPL_PARAMS_##ARITY(T)              \
+    {                                                                          \
+        name##_##suffix##_body DYNEMIT_KERNEL_IMPL_BODY_ARGS_##ARITY(1);       \
+    }                                                                          \
+                                                                               \
+    __attribute__((target(tgt), optimize("fp-contract=off")))                  \
+    static void                                                                \
+    name##_##suffix DYNEMIT_KERNEL_IMPL_PARAMS_##ARITY(T)                      \
+    {                                                                          \
+        if (DYNEMIT_KERNEL_IMPL_MASKABLE(T) && n <= 4 * ((W) / sizeof(T))) {   \
+            if (n)                                                             \
+                name##_##suffix##_tiny DYNEMIT_KERNEL_IMPL_ARGS_##ARITY;       \
+        } else if (n * sizeof(T) < dynemit_sized_large_bytes()) {              \
+            name##_##suffix##_cached DYNEMIT_KERNEL_IMPL_ARGS_##ARITY;         \
+        } else {                                                               \
+            name##_##suffix##_large DYNEMIT_KERNEL_IMPL_ARGS_##ARITY;          \
+        }                                                                      \
+    }
+
+#define DYNEMIT_KERNEL_IMPL_LEVELS(name, ARITY, T, OP)                         \
+    DYNEMIT_KERNEL_IMPL_SCALAR(name, ARITY, T, OP)                             \
+    DYNEMIT_KERNEL_IMPL_PLAIN(name, sse2, __attribute__((target("sse2"))), 16, 1, \
+                              ARITY, T, OP)                                    \
+    DYNEMIT_KERNEL_IMPL_PLAIN(name, sse42, __attribute__((target("sse4.2"))), 16, 1, \
+                              ARITY, T, OP)                                    \
+    DYNEMIT_KERNEL_IMPL_SIZED(name, avx, "avx", 32, AVX, ARITY, T, OP)         \
+    DYNEMIT_KERNEL_IMPL_SIZED(name, avx2, "avx2", 32, AVX, ARITY, T, OP)       \
+    DYNEMIT_KERNEL_IMPL_SIZED(name, avx512f, "avx512f", 64, AVX512, ARITY, T, OP) \
+                                                                               \
+    typedef void(*name##_func_t) DYNEMIT_KERNEL_IMPL_PARAMS_##ARITY(T);        \
+                                                                               \
+    static name##_func_t                                                       \
+    name##_select(simd_level_t level)                                          \
+    {                                                                          \
+        switch (level) {                                                       \
+        case SIMD_AVX512F: return name##_avx512f;                              \
+        case SIMD_AVX2:    return name##_avx2;                                 \
+        case SIMD_AVX:     return name##_avx;                                  \
+        case SIMD_SSE4_2:  return name##_sse42;                                \
+        case SIMD_SSE2:    return name##_sse2;                                 \
+        case SIMD_SCALAR:                                                      \
+        default:           return name##_scalar;                               \
+        }                                                                      \
+    }
+
+#elif defined(__aarch64__)
+
+#define DYNEMIT_KERNEL_IMPL_STREAM_16(p, v) DYNEMIT_KERNEL_IMPL_STOREV(p, v)
+#define DYNEMIT_KERNEL_IMPL_FENCE()         ((void)0)
+
+#define DYNEMIT_KERNEL_IMPL_LEVELS(name, ARITY, T, OP)                         \
+    DYNEMIT_KERNEL_IMPL_SCALAR(name, ARITY, T, OP)                             \
+    DYNEMIT_KERNEL_IMPL_PLAIN(name, neon, , 16, 0, ARITY, T, OP)               \
+                                                                               \
+    typedef void(*name##_func_t) DYNEMIT_KERNEL_IMPL_PARAMS_##ARITY(T);        \
+                                                                               \
+    static name##_func_t                                                       \
+    name##_select(simd_level_t level)                                          \
+    {                                                                          \
+        switch (level) {                                                       \
+        case SIMD_SVE2:                                                        \
+        case SIMD_SVE:                                                         \
+        case SIMD_NEON:    return name##_neon;                                 \
+        case SIMD_SCALAR:                                                      \
+        default:           return name##_scalar;                               \
+        }                                                                      \
+    }
+
+#else
+
+// Other architectures: the scalar kernel at every level
+#define DYNEMIT_KERNEL_IMPL_LEVELS(name, ARITY, T, OP)                         \
+    DYNEMIT_KERNEL_IMPL_SCALAR(name, ARITY, T, OP)                             \
+                                                                               \
+    typedef void(*name##_func_t) DYNEMIT_KERNEL_IMPL_PARAMS_##ARITY(T);        \
+                                                                               \
+    static name##_func_t                                                       \
+    name##_select(simd_level_t level)                                          \
+    {                                                                          \
+        (void)level;                                                           \
+        return name##_scalar;                                                  \
+    }
+
+#endif
+
+#endif // DYNEMIT_KERNEL_H
@@ -0,0 +1,53 @@
+/* SPDX-License-Identifier: BSL-1.0 */
+#ifndef DYNEMIT_MULTIOUT_H
+#define DYNEMIT_MULTIOUT_H
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#pragma GCC visibility push(default)
+
+/**
+ * @file multiout.h
+ * @brief Kernels with several outputs from one pass over their inputs
+ *
+ * Each function reads a and b once and writes all of its results, instead
+ * of one pass per result. At sizes beyond the caches, where the element-wise
+ * kernels are bound by memory bandwidth, that saves a full read of both
+ * inputs per extra output.
+ *
+ * Outputs may be the same array as an input, but must not partially
+ * overlap one. When together they reach dynemit_stream_threshold() bytes,
+ * are aligned to the vector width and none of them is an input, they are
+ * written with non-temporal stores.
+ */
+
+/**
+ * Butterfly: sum_out[i] = a[i] + b[i] and diff_out[i] = a[i] - b[i].
+ * Automatically dispatches to the best SIMD implementation available.
+ * The results are bit-identical to vector_add_f32() and vector_sub_f32().
+ * sum_out and diff_out must be different arrays; either may be a or b, so
+ * (a, b) -> (a + b, a - b) can be computed in place.
+ */
+void vector_addsub_f32(const float *a, const float *b, float *sum_out, float *diff_out, size_t n);
+
+/**
+ * Product and its sum: out[i] = a[i] * b[i], returning the sum of out.
+ * Automatically dispatches to the best SIMD implementation available.
+ * out is bit-identical to vector_mul_f32(). The products are added unfused,
+ * in sum_f32()'s order, so the result equals sum_f32(out, n) on x86 and
+ * NEON; like sum_f32(), its rounding depends on the SIMD level.
+ * Returns 0.0f when n == 0.
+ */
+float vector_mul_reduce_f32(const float *a, const float *b, float *out, size_t n);
+
+#pragma GCC visibility pop
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // DYNEMIT_MULTIOUT_H
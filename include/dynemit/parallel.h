@@ -0,0 +1,128 @@
+/* SPDX-License-Identifier: BSL-1.0 */
+#ifndef DYNEMIT_PARALLEL_H
+#define DYNEMIT_PARALLEL_H
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#pragma GCC visibility push(default)
+
+/**
+ * @file parallel.h
+ * @brief Opt-in multithreaded mode for element-wise kernels
+ *
+ * A single core cannot saturate the memory bandwidth of a multi-channel
+ * server once arrays leave cache. The *_mt entry points below split large
+ * inputs into cache-line-aligned chunks and run each chunk through the
+ * regular ifunc-dispatched kernel on a persistent pool of pinned worker
+ * threads. Inputs smaller than the pool's crossover threshold go straight to
+ * the single-threaded kernel, where waking workers would cost more than the
+ * work itself.
+ */
+
+/**
+ * Default crossover threshold in elements (256K floats = 1 MiB per array).
+ *
+ * Below roughly this size the three streams of a binary kernel still fit in
+ * L2/LLC and one core is faster than paying the worker wake-up latency
+ * (several microseconds). The best value depends on core count, cache sizes
+ * and memory bandwidth, so it can be tuned per machine with the
+ * DYNEMIT_MT_THRESHOLD environment variable (read by
+ * dynemit_threadpool_create()) or dynemit_threadpool_set_threshold().
+ */
+#define DYNEMIT_MT_DEFAULT_THRESHOLD ((size_t)262144)
+
+/** Chunk boundaries are aligned to this many bytes of the output array. */
+#define DYNEMIT_MT_CHUNK_ALIGN 64
+
+/** Opaque handle to a persistent worker pool. */
+typedef struct dynemit_threadpool dynemit_threadpool;
+
+/**
+ * Create a worker pool.
+ *
+ * The calling thread always executes the first chunk itself, so a pool of
+ * size N starts N - 1 worker threads. Workers are pinned to the CPUs in the
+ * process affinity mask, one per physical core (dynemit_core_of_cpu())
+ * before any SMT sibling, wrapping around when there are more workers than
+ * CPUs. The first CPU is never used, it is left to the caller.
+ *
+ * @param num_threads Total participating threads including the caller, or 0
+ *                    for one per physical core in the process affinity mask
+ * @return New pool, or nullptr if thread creation failed
+ */
+dynemit_threadpool *dynemit_threadpool_create(size_t num_threads);
+
+/**
+ * Stop all workers and free the pool. Passing nullptr is a no-op.
+ */
+void dynemit_threadpool_destroy(dynemit_threadpool *pool);
+
+/**
+ * Number of threads participating in each parallel call, including the caller.
+ */
+size_t dynemit_threadpool_size(const dynemit_threadpool *pool);
+
+/**
+ * Set the crossover threshold in elements. Calls with n below it run on the
+ * calling thread only. 0 always uses the pool.
+ */
+void dynemit_threadpool_set_threshold(dynemit_threadpool *pool, size_t min_elements);
+
+/**
+ * Current crossover threshold in elements.
+ */
+size_t dynemit_threadpool_threshold(const dynemit_threadpool *pool);
+
+/**
+ * Range callback for dynemit_threadpool_parallel_for(): processes [begin, end).
+ */
+typedef void (*dynemit_range_fn)(void *ctx, size_t begin, size_t end);
+
+/**
+ * Split [0, n) into one contiguous range per pool thread and run fn on each.
+ *
+ * Interior range boundaries are multiples of grain (pass 1 for no
+ * constraint). Returns once every range has completed. Concurrent calls on
+ * the same pool are serialized; calling back into the same pool from fn
+ * deadlocks.
+ */
+void dynemit_threadpool_parallel_for(dynemit_threadpool *pool, size_t n, size_t grain,
+                                     dynemit_range_fn fn, void *ctx);
+
+/**
+ * Fault in the pages of [p, p + bytes) from the pool threads, split the way
+ * the *_mt kernels split an array of the same size, so each page lands on
+ * the NUMA node of the thread that will process it. The contents are kept.
+ *
+ * Meant for buffers from dynemit_alloc() with DYNEMIT_ALLOC_LOCAL (see
+ * <dynemit/core.h>) before they are first written. On machines with more
+ * than one node the *_mt kernels also look up where the output's pages are
+ * and hand each chunk to a thread on that node, so arrays touched by a
+ * different pool or in a different order still get node-local chunks.
+ */
+void dynemit_first_touch(dynemit_threadpool *pool, void *p, size_t bytes);
+
+/*
+ * Multithreaded element-wise kernels.
+ *
+ * Same semantics as the single-threaded functions of the same name. pool may
+ * be nullptr, in which case the call is forwarded to the single-threaded
+ * kernel unchanged.
+ */
+void vector_add_f32_mt(dynemit_threadpool *pool, const float *a, const float *b, float *out, size_t n);
+void vector_sub_f32_mt(dynemit_threadpool *pool, const float *a, const float *b, float *out, size_t n);
+void vector_mul_f32_mt(dynemit_threadpool *pool, const float *a, const float *b, float *out, size_t n);
+void vector_fma_f32_mt(dynemit_threadpool *pool, const float *a, const float *b, const float *c,
+                       float *out, size_t n);
+
+#pragma GCC visibility pop
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // DYNEMIT_PARALLEL_H
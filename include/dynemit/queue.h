@@ -0,0 +1,141 @@
+/* SPDX-License-Identifier: BSL-1.0 */
+#ifndef DYNEMIT_QUEUE_H
+#define DYNEMIT_QUEUE_H
+
+#include <stddef.h>
+#include <dynemit/parallel.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#pragma GCC visibility push(default)
+
+/**
+ * @file queue.h
+ * @brief Asynchronous submission queue for element-wise kernels
+ *
+ * dynemit_queue_submit() returns as soon as an operation is queued; a
+ * background thread runs it and completes the returned future, so the
+ * submitting thread can read the next input in the meantime. An operation
+ * may name earlier futures it has to wait for, which is enough to express
+ * read -> compute -> write pipelines whose stages overlap across chunks.
+ *
+ * Operations at or above the pool's crossover threshold run through the
+ * *_mt kernels of <dynemit/parallel.h> on the threadpool given at creation.
+ * Smaller ones that are ready at the same time are taken as one batch:
+ * they cost one wake-up of the queue thread, and when the batch together
+ * reaches the threshold it is spread over the pool, a share of the
+ * operations per thread. Apart from dependencies, operations may run and
+ * complete in any order, including concurrently.
+ *
+ * The C++ wrapper in <dynemit.hpp> makes futures awaitable from coroutines.
+ */
+
+/** Opaque handle to a submission queue. */
+typedef struct dynemit_queue dynemit_queue;
+
+/** Completion handle of one submitted operation. */
+typedef struct dynemit_future dynemit_future;
+
+/** Operations accepted by dynemit_queue_submit(). */
+typedef enum {
+    DYNEMIT_OP_ADD_F32 = 0,  // out = a + b
+    DYNEMIT_OP_SUB_F32 = 1,  // out = a - b
+    DYNEMIT_OP_MUL_F32 = 2,  // out = a * b
+    DYNEMIT_OP_FMA_F32 = 3,  // out = a * b + c
+    DYNEMIT_OP_CALL = 4      // fn(ctx): any other work, e.g. an I/O stage
+} dynemit_op_t;
+
+/**
+ * Operands of a submitted operation. Fields an operation does not use are
+ * ignored. The arrays must stay valid, and must not be written by anyone
+ * else, until the future completes.
+ */
+typedef struct {
+    const float *a;
+    const float *b;
+    const float *c;
+    float       *out;
+    size_t       n;
+
+    void       (*fn)(void *ctx);   // DYNEMIT_OP_CALL only
+    void        *ctx;
+
+    // Futures of the same queue that must complete before this op starts
+    dynemit_future *const *after;
+    size_t       num_after;
+} dynemit_op_args;
+
+/**
+ * Create a queue and start its thread.
+ *
+ * @param pool Pool for large and batched operations, or nullptr to run
+ *             everything on the queue thread. The pool must outlive the
+ *             queue; it can still be used directly in the meantime, calls
+ *             are serialized as usual.
+ * @return New queue, or nullptr if allocation or thread creation failed
+ */
+dynemit_queue *dynemit_queue_create(dynemit_threadpool *pool);
+
+/**
+ * Wait for every submitted operation to complete, then stop the queue
+ * thread and free the queue. Passing nullptr is a no-op. Futures not yet
+ * released stay valid, and complete; no other thread may still be waiting
+ * on or registering callbacks with them while the queue is destroyed.
+ */
+void dynemit_queue_destroy(dynemit_queue *queue);
+
+/**
+ * Queue one operation.
+ *
+ * The returned future belongs to the caller, who must pass it to
+ * dynemit_future_release() eventually; releasing it early does not cancel
+ * the operation.
+ *
+ * @return Future of the operation, or nullptr if op is unknown, an entry of
+ *         after is nullptr or belongs to another queue, or allocation failed
+ */
+dynemit_future *dynemit_queue_submit(dynemit_queue *queue, dynemit_op_t op, const dynemit_op_args *args);
+
+/**
+ * Block until every operation submitted so far has completed and its
+ * callbacks have returned.
+ */
+void dynemit_queue_wait_all(dynemit_queue *queue);
+
+/**
+ * Nonzero once the operation has completed.
+ */
+int dynemit_future_done(const dynemit_future *future);
+
+/**
+ * Block until the operation has completed. Must not be called from a
+ * completion callback or a DYNEMIT_OP_CALL function for an operation that
+ * has not completed yet, since those run on the queue thread.
+ */
+void dynemit_future_wait(dynemit_future *future);
+
+/**
+ * Call fn(user) on the queue thread once the operation has completed.
+ * Callbacks run after the outputs are written and before dependent
+ * operations start, in the order they were registered.
+ *
+ * @return 0 if fn was registered, 1 if the operation had already completed
+ *         (fn is not called, the caller continues itself), -1 if allocation
+ *         failed
+ */
+int dynemit_future_then(dynemit_future *future, void (*fn)(void *user), void *user);
+
+/**
+ * Release the caller's reference. Passing nullptr is a no-op.
+ */
+void dynemit_future_release(dynemit_future *future);
+
+#pragma GCC visibility pop
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // DYNEMIT_QUEUE_H
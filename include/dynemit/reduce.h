@@ -0,0 +1,62 @@
+/* SPDX-License-Identifier: BSL-1.0 */
+#ifndef DYNEMIT_REDUCE_H
+#define DYNEMIT_REDUCE_H
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#pragma GCC visibility push(default)
+
+/**
+ * Dot product of two float vectors: sum(a[i] * b[i])
+ * Automatically dispatches to the best SIMD implementation available.
+ * Returns 0.0f when n == 0.
+ */
+float dot_f32(const float *a, const float *b, size_t n);
+
+/**
+ * Sum of a float vector: sum(a[i])
+ * Automatically dispatches to the best SIMD implementation available.
+ * Returns 0.0f when n == 0.
+ */
+float sum_f32(const float *a, size_t n);
+
+/**
+ * Euclidean (L2) norm of a float vector: sqrt(sum(a[i] * a[i]))
+ * Automatically dispatches to the best SIMD implementation available.
+ * Returns 0.0f when n == 0.
+ */
+float norm2_f32(const float *a, size_t n);
+
+/**
+ * Minimum and maximum of a float vector in a single pass.
+ * Automatically dispatches to the best SIMD implementation available.
+ * When n == 0, *min_out is set to +INFINITY and *max_out to -INFINITY.
+ * The result is unspecified if the input contains NaN.
+ */
+void minmax_f32(const float *a, size_t n, float *min_out, float *max_out);
+
+/*
+ * Deterministic-order variants.
+ *
+ * The fast reductions above split the work across several independent
+ * accumulators (and use FMA where available) to hide instruction latency, so
+ * the rounding of the result depends on the SIMD level picked at runtime.
+ * The _det variants always accumulate in the same order with unfused
+ * operations, so they return bit-identical results on every CPU, at
+ * somewhat lower throughput.
+ */
+float dot_f32_det(const float *a, const float *b, size_t n);
+float sum_f32_det(const float *a, size_t n);
+float norm2_f32_det(const float *a, size_t n);
+
+#pragma GCC visibility pop
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // DYNEMIT_REDUCE_H
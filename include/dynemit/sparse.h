@@ -0,0 +1,61 @@
+/* SPDX-License-Identifier: BSL-1.0 */
+#ifndef DYNEMIT_SPARSE_H
+#define DYNEMIT_SPARSE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#pragma GCC visibility push(default)
+
+/**
+ * @file sparse.h
+ * @brief Indexed (gather/scatter) kernels for sparse data
+ *
+ * These read or write one operand through an array of int32_t indices, so
+ * sparse feature vectors and histograms need no gathered copy first. Every
+ * index must be in range for the array it indexes; they are not checked.
+ * AVX2 and AVX-512F use hardware gathers. Other levels run a scalar loop,
+ * which is also what benchmark_sparse compares against.
+ */
+
+/**
+ * Gather-multiply: out[i] = a[idx[i]] * b[i].
+ * Automatically dispatches to the best SIMD implementation available.
+ * out may be the same array as b, but must not overlap a or idx.
+ */
+void vector_gather_mul_f32(const float *a, const int32_t *idx, const float *b, float *out, size_t n);
+
+/**
+ * Sparse-dense dot product: sum(values[k] * dense[indices[k]]) over the
+ * nnz stored entries of a sparse vector.
+ * Automatically dispatches to the best SIMD implementation available.
+ * Like dot_f32, the rounding of the sum depends on the SIMD level.
+ * Returns 0.0f when nnz == 0.
+ */
+float dot_sparse_f32(const float *values, const int32_t *indices, size_t nnz, const float *dense);
+
+/**
+ * Scatter-accumulate: out[idx[i]] += values[i], for i in order.
+ * Runs the scalar loop at every level: the AVX-512 scatter kernel with
+ * AVX-512CD conflict detection was slower than it wherever it was measured.
+ * That kernel is still returned by dynemit_get_kernel("scatter_add_f32",
+ * SIMD_AVX512F) on CPUs with AVX-512CD. dynemit_rebind() can bind it to the
+ * dispatch slot from dynemit_dispatch_lookup("scatter_add_f32"), which only
+ * affects calls made through DYNEMIT_DISPATCH_CALL(); calls of this symbol
+ * keep the scalar loop. Repeated indices accumulate every value, in the same
+ * order as a scalar loop, so every kernel gives bit-identical results. out
+ * must not overlap idx or values.
+ */
+void scatter_add_f32(float *out, const int32_t *idx, const float *values, size_t n);
+
+#pragma GCC visibility pop
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // DYNEMIT_SPARSE_H
@@ -0,0 +1,37 @@
+/* SPDX-License-Identifier: BSL-1.0 */
+#ifndef DYNEMIT_VECTOR_FMA_H
+#define DYNEMIT_VECTOR_FMA_H
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#pragma GCC visibility push(default)
+
+/**
+ * Element-wise fused multiply-add of float vectors: out[i] = a[i] * b[i] + c[i]
+ * Automatically dispatches to the best SIMD implementation available.
+ *
+ * Reads each input once, replacing a vector_mul_f32() + vector_add_f32() pair
+ * and the temporary between them. FMA3 and AVX-512F paths round once per
+ * element; SSE/AVX paths without FMA hardware round after the multiply and
+ * after the add, so results may differ in the last bit between hosts.
+ */
+void vector_fma_f32(const float *a, const float *b, const float *c, float *out, size_t n);
+
+/**
+ * In-place scaled accumulate (BLAS saxpy): y[i] = alpha * x[i] + y[i]
+ * Automatically dispatches to the best SIMD implementation available.
+ * Uses the same rounding rules as vector_fma_f32().
+ */
+void vector_axpy_f32(float alpha, const float *x, float *y, size_t n);
+
+#pragma GCC visibility pop
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // DYNEMIT_VECTOR_FMA_H
@@ -3,15 +3,75 @@
 #define VECTOR_MUL_H
 
 #include <stddef.h>
+#include <stdint.h>
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+#pragma GCC visibility push(default)
+
 // Vector multiplication function - dynamically dispatched at runtime
-// based on available CPU SIMD capabilities
+// based on available CPU SIMD capabilities. out may be a or b; see
+// "Aliasing" in <dynemit.h>.
 void vector_mul_f32(const float *a, const float *b, float *out, size_t n);
 
+/**
+ * Batched float multiplication of count independent vectors:
+ * out[k][i] = a[k][i] * b[k][i] for i < n[k].
+ *
+ * Resolves once for the whole batch and runs each item through the same
+ * kernel as vector_mul_f32() with masked tails, so many short vectors
+ * (tens of elements) cost about as much as one call over their total length.
+ * Items may have different lengths.
+ */
+void vector_mul_f32_batch(const float *const *a, const float *const *b, float *const *out,
+                      const size_t *n, size_t count);
+
+/**
+ * Strided batch of count equal-length vectors of n floats each: the k-th
+ * vector starts at a + k * stride (likewise b and out), stride in elements.
+ */
+void vector_mul_f32_batch_strided(const float *a, const float *b, float *out, size_t n,
+                              size_t count, size_t stride);
+
+/** In place: a[i] *= b[i] */
+void vector_mul_f32_ip(float *a, const float *b, size_t n);
+
+/**
+ * Broadcast scalar: out[i] = a[i] * s
+ * One input stream instead of two, so about a third less memory traffic
+ * than vector_mul_f32() with a filled array.
+ */
+void vector_mul_scalar_f32(const float *a, float s, float *out, size_t n);
+
+/** Broadcast scalar in place: a[i] *= s */
+void vector_mul_scalar_f32_ip(float *a, float s, size_t n);
+
+/**
+ * Element-wise multiplication of two double vectors: out[i] = a[i] * b[i]
+ */
+void vector_mul_f64(const double *a, const double *b, double *out, size_t n);
+
+/** double forms of vector_mul_f32_ip(), vector_mul_scalar_f32() and its _ip */
+void vector_mul_f64_ip(double *a, const double *b, size_t n);
+void vector_mul_scalar_f64(const double *a, double s, double *out, size_t n);
+void vector_mul_scalar_f64_ip(double *a, double s, size_t n);
+
+/**
+ * Element-wise multiplication of two int32 vectors: out[i] = a[i] * b[i]
+ * Wraps around on overflow (two's complement), like the SIMD instructions.
+ */
+void vector_mul_i32(const int32_t *a, const int32_t *b, int32_t *out, size_t n);
+
+/**
+ * Element-wise multiplication of two int16 vectors: out[i] = a[i] * b[i]
+ * Saturating: results are clamped to [INT16_MIN, INT16_MAX].
+ */
+void vector_mul_i16(const int16_t *a, const int16_t *b, int16_t *out, size_t n);
+
+#pragma GCC visibility pop
+
 #ifdef __cplusplus
 }
 #endif
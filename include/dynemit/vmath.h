@@ -0,0 +1,96 @@
+/* SPDX-License-Identifier: BSL-1.0 */
+#ifndef DYNEMIT_VMATH_H
+#define DYNEMIT_VMATH_H
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#pragma GCC visibility push(default)
+
+/**
+ * @file vmath.h
+ * @brief Element-wise exp, log, tanh, sigmoid and erf on float arrays
+ *
+ * Each function computes out[i] = f(a[i]) for i < n, so it can run between
+ * the arithmetic kernels of a pipeline without an intermediate copy; out
+ * may be the same array as a. Every function comes in two tiers: the plain
+ * name is the precise one, and the _fast variant trades a lower-degree
+ * polynomial for up to 4 ULP (see the table). The maximum errors against
+ * the correctly rounded result, over all finite inputs and every SIMD
+ * level:
+ *
+ * | function | precise | fast    |
+ * |----------|---------|---------|
+ * | exp      | 1.5 ULP | 2.5 ULP |
+ * | log      | 1 ULP   | 1.5 ULP |
+ * | tanh     | 2 ULP   | 2.5 ULP |
+ * | sigmoid  | 3 ULP   | 4 ULP   |
+ * | erf      | 3 ULP   | 3 ULP   |
+ *
+ * Levels with FMA round differently from the others, so results can differ
+ * in the last bits between machines, always within these bounds. Special
+ * values follow C99 Annex F: NaN propagates, exp(-inf) = 0, exp(+inf) and
+ * log(+inf) are +inf, log(0) = -inf, log of a negative number is NaN, and
+ * tanh, sigmoid and erf saturate exactly at their limits. Subnormal inputs
+ * and results are handled, not flushed.
+ */
+
+/**
+ * Exponential: out[i] = e^a[i].
+ * Automatically dispatches to the best SIMD implementation available.
+ * Overflows to +inf above about 88.72 and underflows through the subnormals
+ * to 0 below about -103.97.
+ */
+void vector_exp_f32(const float *a, float *out, size_t n);
+
+/** Exponential, fast tier. */
+void vector_exp_f32_fast(const float *a, float *out, size_t n);
+
+/**
+ * Natural logarithm: out[i] = ln(a[i]).
+ * Automatically dispatches to the best SIMD implementation available.
+ */
+void vector_log_f32(const float *a, float *out, size_t n);
+
+/** Natural logarithm, fast tier. */
+void vector_log_f32_fast(const float *a, float *out, size_t n);
+
+/**
+ * Hyperbolic tangent: out[i] = tanh(a[i]).
+ * Automatically dispatches to the best SIMD implementation available.
+ */
+void vector_tanh_f32(const float *a, float *out, size_t n);
+
+/** Hyperbolic tangent, fast tier. */
+void vector_tanh_f32_fast(const float *a, float *out, size_t n);
+
+/**
+ * Logistic sigmoid: out[i] = 1 / (1 + e^-a[i]).
+ * Automatically dispatches to the best SIMD implementation available.
+ * Keeps full relative accuracy for large negative inputs, where the result
+ * is tiny, instead of returning 1 - (something close to 1).
+ */
+void vector_sigmoid_f32(const float *a, float *out, size_t n);
+
+/** Logistic sigmoid, fast tier. */
+void vector_sigmoid_f32_fast(const float *a, float *out, size_t n);
+
+/**
+ * Error function: out[i] = erf(a[i]).
+ * Automatically dispatches to the best SIMD implementation available.
+ */
+void vector_erf_f32(const float *a, float *out, size_t n);
+
+/** Error function, fast tier. */
+void vector_erf_f32_fast(const float *a, float *out, size_t n);
+
+#pragma GCC visibility pop
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // DYNEMIT_VMATH_H
@@ -0,0 +1,122 @@
+#!/usr/bin/env python3
+"""
+Benchmark Comparison Script for libdynemit
+
+Compares two benchmark runs point by point (same function, SIMD level, size,
+offset, operands, threads, cache mode and prefetch distance) and reports the change of the
+median time. A point regresses when it is slower by more than the threshold
+and by more than twice the combined standard deviation of both runs, so
+noisy points do not trip the check. Exits with status 1 on any regression.
+
+Reads the CSV and JSON files of benchmark_kernels as well as the CSV files
+of benchmark_vector_mul (e.g. bench/data/results_*.csv).
+
+Usage:
+    python compare_benchmark.py baseline.csv new.csv [--threshold 5]
+"""
+
+import argparse
+import csv
+import json
+import math
+import sys
+from typing import Dict, List, Tuple
+
+# Columns identifying a point, where present in both runs
+KEY_COLUMNS = ['function', 'simd_level', 'array_size', 'offset', 'inplace', 'threads', 'cache', 'prefetch']
+
+
+def read_rows(filepath: str) -> List[Dict[str, str]]:
+    """
+    Read benchmark rows from a CSV file or a benchmark_kernels JSON file.
+    """
+    try:
+        with open(filepath, 'r') as f:
+            if filepath.endswith('.json'):
+                return [{k: str(v) for k, v in row.items()} for row in json.load(f)['results']]
+            return list(csv.DictReader(f))
+    except FileNotFoundError:
+        print(f"Error: File '{filepath}' not found.", file=sys.stderr)
+        sys.exit(2)
+    except (KeyError, ValueError) as e:
+        print(f"Error: Invalid data format in '{filepath}': {e}", file=sys.stderr)
+        sys.exit(2)
+
+
+def index_rows(rows: List[Dict[str, str]], keys: List[str]) -> Dict[Tuple[str, ...], Dict[str, str]]:
+    return {tuple(row[k] for k in keys): row for row in rows}
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description='Compare two libdynemit benchmark runs and flag regressions',
+        formatter_class=argparse.RawDescriptionHelpFormatter,
+        epilog="""
+Examples:
+  # Gate a change on the stored results of this machine
+  ./build/bench/benchmark_kernels --format csv --output new.csv
+  python compare_benchmark.py base.csv new.csv
+
+  # Only report changes above 10%
+  python compare_benchmark.py base.json new.json --threshold 10 --quiet
+        """
+    )
+    parser.add_argument('baseline', help='Baseline results (CSV or JSON)')
+    parser.add_argument('candidate', help='New results (CSV or JSON)')
+    parser.add_argument('--threshold', '-t', type=float, default=5.0,
+                        help='Minimum slowdown in percent to count as a regression (default: 5)')
+    parser.add_argument('--quiet', '-q', action='store_true',
+                        help='Only print points that changed by more than the threshold')
+    args = parser.parse_args()
+
+    base_rows = read_rows(args.baseline)
+    new_rows = read_rows(args.candidate)
+    if not base_rows or not new_rows:
+        print("Error: empty results file", file=sys.stderr)
+        sys.exit(2)
+
+    keys = [k for k in KEY_COLUMNS if k in base_rows[0] and k in new_rows[0]]
+    base = index_rows(base_rows, keys)
+    new = index_rows(new_rows, keys)
+    common = [k for k in base if k in new]
+    if not common:
+        print("Error: the runs have no point in common", file=sys.stderr)
+        sys.exit(2)
+
+    def label(key):
+        return ' '.join(f"{k}={v}" if k not in ('function', 'simd_level') else v
+                        for k, v in zip(keys, key))
+
+    limit = 1.0 + args.threshold / 100.0
+    regressions = improvements = 0
+    width = max(len(label(key)) for key in common)
+
+    print(f"{'point':<{width}} {'base_ms':>12} {'new_ms':>12} {'change':>8}")
+    for key in common:
+        b, n = base[key], new[key]
+        b_med, n_med = float(b['median_ms']), float(n['median_ms'])
+        noise = 2.0 * math.hypot(float(b['stddev_ms']), float(n['stddev_ms']))
+        ratio = n_med / b_med if b_med > 0 else 1.0
+
+        status = ''
+        if ratio > limit and n_med - b_med > noise:
+            status = 'REGRESSION'
+            regressions += 1
+        elif ratio < 1.0 / limit and b_med - n_med > noise:
+            status = 'improved'
+            improvements += 1
+        if args.quiet and not status:
+            continue
+
+        print(f"{label(key):<{width}} {b_med:>12.6f} {n_med:>12.6f} {(ratio - 1.0) * 100.0:>+7.1f}% {status}")
+
+    missing = len(base) - len(common)
+    print(f"\n{len(common)} points compared, {regressions} regressed, {improvements} improved"
+          f" (threshold {args.threshold:g}%)")
+    if missing:
+        print(f"{missing} baseline points not in the new run")
+    sys.exit(1 if regressions else 0)
+
+
+if __name__ == '__main__':
+    main()
@@ -13,6 +13,7 @@ Usage:
 
 import argparse
 import csv
+import json
 import sys
 from pathlib import Path
 from typing import Dict, List, Tuple
@@ -22,43 +23,54 @@ import matplotlib.ticker as ticker
 import numpy as np
 
 
-def read_csv_data(filepath: str) -> Tuple[List[int], List[float], List[float], List[float], List[float], List[float], List[float], List[float], str]:
+# Columns that identify a series in benchmark_kernels output; files from
+# benchmark_vector_mul only have simd_level
+SERIES_KEYS = ['function', 'simd_level', 'offset', 'inplace', 'threads', 'cache']
+
+
+def read_rows(filepath: str) -> List[Dict[str, str]]:
     """
-    Read benchmark CSV data from file.
-    
-    Returns:
-        Tuple of (array_sizes, median_ms, mean_ms, stddev_ms, min_ms, max_ms, p99_ms, gflops, simd_level)
+    Read benchmark rows from a CSV file or a benchmark_kernels JSON file.
     """
-    array_sizes = []
-    median_ms = []
-    mean_ms = []
-    stddev_ms = []
-    min_ms = []
-    max_ms = []
-    p99_ms = []
-    gflops = []
-    simd_level = None
-    
     try:
         with open(filepath, 'r') as f:
-            reader = csv.DictReader(f)
-            for row in reader:
-                array_sizes.append(int(row['array_size']))
-                median_ms.append(float(row['median_ms']))
-                mean_ms.append(float(row['mean_ms']))
-                stddev_ms.append(float(row['stddev_ms']))
-                min_ms.append(float(row['min_ms']))
-                max_ms.append(float(row['max_ms']))
-                p99_ms.append(float(row['p99_ms']))
-                gflops.append(float(row['gflops']))
-                if simd_level is None:
-                    simd_level = row['simd_level']
-        
-        return array_sizes, median_ms, mean_ms, stddev_ms, min_ms, max_ms, p99_ms, gflops, simd_level
-    
+            if filepath.endswith('.json'):
+                return [{k: str(v) for k, v in row.items()} for row in json.load(f)['results']]
+            return list(csv.DictReader(f))
     except FileNotFoundError:
         print(f"Error: File '{filepath}' not found.", file=sys.stderr)
         sys.exit(1)
+    except (KeyError, ValueError) as e:
+        print(f"Error: Invalid data format in '{filepath}': {e}", file=sys.stderr)
+        sys.exit(1)
+
+
+def split_series(rows: List[Dict[str, str]], filters: Dict[str, str]) -> Dict[str, List[Dict[str, str]]]:
+    """
+    Apply the column filters and group rows by the series columns that vary,
+    so a run sweeping several functions, levels or thread counts gives one
+    line per combination. Keys are label suffixes ('' for a single series).
+    """
+    rows = [r for r in rows if all(r.get(k) == v for k, v in filters.items() if v is not None)]
+    varying = [k for k in SERIES_KEYS if len({r.get(k) for r in rows}) > 1]
+    series: Dict[str, List[Dict[str, str]]] = {}
+    for row in rows:
+        suffix = ', '.join(f"{k}={row[k]}" if k not in ('function', 'simd_level') else row[k]
+                           for k in varying)
+        series.setdefault(suffix, []).append(row)
+    return series
+
+
+def to_dataset(rows: List[Dict[str, str]], filepath: str) -> Tuple[List[int], List[float], List[float], List[float], List[float], List[float], List[float], List[float], str]:
+    """
+    Convert rows to (array_sizes, median_ms, mean_ms, stddev_ms, min_ms, max_ms, p99_ms, gflops, simd_level)
+    """
+    try:
+        rows = sorted(rows, key=lambda r: int(r['array_size']))
+        columns = ['median_ms', 'mean_ms', 'stddev_ms', 'min_ms', 'max_ms', 'p99_ms', 'gflops']
+        return ([int(r['array_size']) for r in rows],
+                *[[float(r[c]) for r in rows] for c in columns],
+                rows[0]['simd_level'] if rows else None)
     except KeyError as e:
         print(f"Error: Missing column {e} in CSV file '{filepath}'.", file=sys.stderr)
         print("Expected columns: array_size,median_ms,mean_ms,stddev_ms,min_ms,max_ms,p99_ms,gflops,simd_level", file=sys.stderr)
@@ -69,7 +81,8 @@ def read_csv_data(filepath: str) -> Tuple[List[int], List[float], List[float], L
 
 
 def plot_benchmark(datasets: Dict[str, Tuple], output_path: str, title: str, 
-                  metric: str = 'time', auto_title: bool = False):
+                  metric: str = 'time', auto_title: bool = False,
+                  subject: str = 'Vector Multiply'):
     """
     Generate benchmark comparison chart.
     
@@ -79,6 +92,7 @@ def plot_benchmark(datasets: Dict[str, Tuple], output_path: str, title: str,
         title: Chart title
         metric: 'time' or 'gflops' - which metric to plot
         auto_title: Whether to auto-generate title from CPU names
+        subject: What the auto-generated title names, e.g. a function
     """
     plt.figure(figsize=(12, 7))
     
@@ -159,11 +173,11 @@ def plot_benchmark(datasets: Dict[str, Tuple], output_path: str, title: str,
     if auto_title:
         cpu_names = list(datasets.keys())
         if len(cpu_names) == 1:
-            title = f"Vector Multiply Performance - {cpu_names[0]}"
+            title = f"{subject} Performance - {cpu_names[0]}"
         elif len(cpu_names) == 2:
-            title = f"Vector Multiply Performance - {cpu_names[0]} vs {cpu_names[1]}"
+            title = f"{subject} Performance - {cpu_names[0]} vs {cpu_names[1]}"
         else:
-            title = f"Vector Multiply Performance - {len(cpu_names)} CPU Comparison"
+            title = f"{subject} Performance - {len(cpu_names)} CPU Comparison"
     
     # Labels and title
     xlabel = 'Number of elements (32-bit floats, 4 bytes each)'
@@ -370,7 +384,19 @@ Examples:
         help='Metric to plot: time (ms) or gflops (default: time)'
     )
     
+    # Filters for benchmark_kernels results, which hold several series
+    parser.add_argument('--function', help='Only rows of this function (benchmark_kernels results)')
+    parser.add_argument('--level', help='Only rows of this SIMD level, e.g. AVX2')
+    parser.add_argument('--threads', help='Only rows with this thread count')
+    parser.add_argument('--cache', choices=['warm', 'cold'], help='Only warm or cold cache rows')
+    parser.add_argument('--offset', help='Only rows with this alignment offset')
+    parser.add_argument('--inplace', choices=['0', '1'], help='Only out-of-place (0) or in-place (1) rows')
+    
     args = parser.parse_args()
+    filters = {
+        'function': args.function, 'simd_level': args.level, 'threads': args.threads,
+        'cache': args.cache, 'offset': args.offset, 'inplace': args.inplace,
+    }
     
     # Collect all input files
     input_specs = []
@@ -398,13 +424,18 @@ Examples:
             label = infer_label_from_filename(filepath)
         
         print(f"Reading {filepath} (label: {label})...")
-        data = read_csv_data(filepath)
-        datasets[label] = data
-        
-        array_sizes, median_ms, mean_ms, stddev_ms, min_ms, max_ms, p99_ms, gflops, simd_level = data
-        print(f"  - SIMD level: {simd_level}")
-        print(f"  - Data points: {len(array_sizes)}")
-        print(f"  - Statistical trials per size (10 trials with median, stddev, p99)")
+        for suffix, rows in split_series(read_rows(filepath), filters).items():
+            series_label = f"{label} {suffix}" if suffix else label
+            data = to_dataset(rows, filepath)
+            datasets[series_label] = data
+            
+            array_sizes, median_ms, mean_ms, stddev_ms, min_ms, max_ms, p99_ms, gflops, simd_level = data
+            print(f"  - Series: {series_label}")
+            print(f"  - SIMD level: {simd_level}")
+            print(f"  - Data points: {len(array_sizes)}")
+    
+    if not datasets:
+        parser.error("No rows left after filtering")
     
     # Determine if we should auto-generate title
     auto_title = args.title is None
@@ -412,7 +443,8 @@ Examples:
     
     # Generate the plot
     print(f"\nGenerating chart...")
-    plot_benchmark(datasets, args.output, title, args.metric, auto_title)
+    plot_benchmark(datasets, args.output, title, args.metric, auto_title,
+                   args.function or 'Vector Multiply')
     print("Done!")
 
 
@@ -0,0 +1,447 @@
+/* SPDX-License-Identifier: BSL-1.0 */
+#define _POSIX_C_SOURCE 200809L
+#include <dynemit/core.h>
+#include <errno.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+/*
+ * Startup autotuning. Everything here runs at the first call of an
+ * autotuned function, never inside a resolver, so libc is fully available.
+ */
+
+typedef void (*binary_f32_func_t)(const float *, const float *, float *, size_t);
+
+// A lower level must beat the higher one by this much to be picked, so
+// timing noise does not flip the choice between near-identical kernels
+#define AUTOTUNE_MARGIN 0.05
+
+// Per-trial time budget and trials per kernel and size class
+#define AUTOTUNE_TRIAL_SEC 0.0005
+#define AUTOTUNE_TRIALS    3
+
+// Prefetch distances tried, in bytes; a candidate must beat the default by
+// AUTOTUNE_MARGIN too
+static const size_t prefetch_candidates[] = { 0, 256, 512, 1024, 1536, 2048, 3072, 4096 };
+
+// Name of the prefetch distance entries in the cache
+#define PREFETCH_ENTRY "prefetch_distance"
+
+// Working set of the DRAM class, bounds
+#define AUTOTUNE_DRAM_MIN ((size_t)32 * 1024 * 1024)
+#define AUTOTUNE_DRAM_MAX ((size_t)96 * 1024 * 1024)
+
+static double
+now_sec(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+// CPUID vendor, family/model/stepping, feature bits and LLC size: hosts with
+// the same signature get the same tuning
+static void
+host_signature(char *buf, size_t size)
+{
+    uint32_t eax = 0, ebx = 0, ecx = 0, edx = 0;
+    char vendor[13] = "unknown";
+
+    cpuid_x86(0, 0, &eax, &ebx, &ecx, &edx);
+    if (eax) {
+        memcpy(vendor + 0, &ebx, 4);
+        memcpy(vendor + 4, &edx, 4);
+        memcpy(vendor + 8, &ecx, 4);
+        vendor[12] = '\0';
+        cpuid_x86(1, 0, &eax, &ebx, &ecx, &edx);
+    }
+    snprintf(buf, size, "%s-%08" PRIx32 "-%016" PRIx64 "-%zu",
+             vendor, eax, dynemit_cpu_features(), dynemit_llc_size());
+}
+
+// Autotune cache path, or 0 if caching is disabled
+static int
+cache_path(char *buf, size_t size)
+{
+    const char *env = getenv("DYNEMIT_AUTOTUNE_CACHE");
+    if (env)
+        return *env && snprintf(buf, size, "%s", env) < (int)size;
+
+    const char *xdg = getenv("XDG_CACHE_HOME");
+    if (xdg && *xdg)
+        return snprintf(buf, size, "%s/dynemit/autotune", xdg) < (int)size;
+
+    const char *home = getenv("HOME");
+    if (home && *home)
+        return snprintf(buf, size, "%s/.cache/dynemit/autotune", home) < (int)size;
+
+    return 0;
+}
+
+// Cache lines: "signature function max_level L1 L2 LLC DRAM" for levels,
+// "signature prefetch_distance max_level bytes" for the prefetch distance
+static int
+parse_entry(const char *line, const char *sig, const char *name, simd_level_t max,
+            simd_level_t levels[DYNEMIT_SIZE_CLASSES])
+{
+    char s[128], f[64], m[16], l[DYNEMIT_SIZE_CLASSES][16];
+    simd_level_t lm;
+
+    if (line[0] == '#' ||
+        sscanf(line, "%127s %63s %15s %15s %15s %15s %15s", s, f, m, l[0], l[1], l[2], l[3]) != 7)
+        return -1;
+    if (strcmp(s, sig) != 0 || strcmp(f, name) != 0 ||
+        simd_level_from_name(m, &lm) != 0 || lm != max)
+        return -1;
+
+    simd_level_t parsed[DYNEMIT_SIZE_CLASSES];
+    for (int c = 0; c < DYNEMIT_SIZE_CLASSES; c++) {
+        if (simd_level_from_name(l[c], &parsed[c]) != 0 || parsed[c] > max)
+            return -1;
+    }
+    memcpy(levels, parsed, sizeof(parsed));
+    return 0;
+}
+
+static int
+parse_prefetch_entry(const char *line, const char *sig, simd_level_t max, size_t *distance)
+{
+    char s[128], f[64], m[16];
+    size_t d;
+    simd_level_t lm;
+
+    if (line[0] == '#' || sscanf(line, "%127s %63s %15s %zu", s, f, m, &d) != 4)
+        return -1;
+    if (strcmp(s, sig) != 0 || strcmp(f, PREFETCH_ENTRY) != 0 ||
+        simd_level_from_name(m, &lm) != 0 || lm != max)
+        return -1;
+    *distance = d;
+    return 0;
+}
+
+static int
+cache_lookup(const char *path, const char *sig, const char *name, simd_level_t max,
+             simd_level_t levels[DYNEMIT_SIZE_CLASSES])
+{
+    FILE *fp = fopen(path, "r");
+    if (!fp)
+        return -1;
+
+    // The last matching entry wins
+    char line[512];
+    int found = -1;
+    while (fgets(line, sizeof(line), fp)) {
+        if (parse_entry(line, sig, name, max, levels) == 0)
+            found = 0;
+    }
+    fclose(fp);
+    return found;
+}
+
+static int
+cache_lookup_prefetch(const char *path, const char *sig, simd_level_t max, size_t *distance)
+{
+    FILE *fp = fopen(path, "r");
+    if (!fp)
+        return -1;
+
+    char line[512];
+    int found = -1;
+    while (fgets(line, sizeof(line), fp)) {
+        if (parse_prefetch_entry(line, sig, max, distance) == 0)
+            found = 0;
+    }
+    fclose(fp);
+    return found;
+}
+
+// 1 if line is an entry for signature, function and max_level key
+static int
+same_key(const char *line, const char *key)
+{
+    char s[128], f[64], m[16], k[256];
+    if (line[0] == '#' || sscanf(line, "%127s %63s %15s", s, f, m) != 3)
+        return 0;
+    snprintf(k, sizeof(k), "%s %s %s", s, f, m);
+    return strcmp(k, key) == 0;
+}
+
+// Create every missing parent directory of path
+static void
+make_parents(const char *path)
+{
+    char dir[1024];
+    snprintf(dir, sizeof(dir), "%s", path);
+    for (char *p = dir + 1; *p; p++) {
+        if (*p != '/')
+            continue;
+        *p = '\0';
+        if (mkdir(dir, 0755) != 0 && errno != EEXIST)
+            return;
+        *p = '/';
+    }
+}
+
+// Rewrite the cache with entry (key, then the values) replacing any older
+// one for the same key. Written to a temporary file and renamed, so
+// concurrent readers never see a partial file
+static void
+cache_store(const char *path, const char *key, const char *values)
+{
+    char tmp[1100];
+    snprintf(tmp, sizeof(tmp), "%s.%ld.tmp", path, (long)getpid());
+
+    make_parents(path);
+    FILE *out = fopen(tmp, "w");
+    if (!out)
+        return;
+
+    fprintf(out, "# dynemit autotune cache: signature function max_level L1 L2 LLC DRAM"
+                 " | signature " PREFETCH_ENTRY " max_level bytes\n");
+
+    FILE *in = fopen(path, "r");
+    if (in) {
+        char line[512];
+        while (fgets(line, sizeof(line), in)) {
+            if (line[0] != '#' && !same_key(line, key))
+                fputs(line, out);
+        }
+        fclose(in);
+    }
+
+    fprintf(out, "%s %s\n", key, values);
+
+    if (fclose(out) != 0 || rename(tmp, path) != 0)
+        remove(tmp);
+}
+
+// Best seconds per call over a few trials, each repeating the call until it
+// fills the trial budget
+static double
+time_kernel(binary_f32_func_t f, const float *a, const float *b, float *out, size_t n)
+{
+    f(a, b, out, n);
+
+    int reps = 1;
+    for (;;) {
+        double t0 = now_sec();
+        for (int r = 0; r < reps; r++)
+            f(a, b, out, n);
+        if (now_sec() - t0 >= AUTOTUNE_TRIAL_SEC || reps >= (1 << 20))
+            break;
+        reps *= 2;
+    }
+
+    double best = 0.0;
+    for (int trial = 0; trial < AUTOTUNE_TRIALS; trial++) {
+        double t0 = now_sec();
+        for (int r = 0; r < reps; r++)
+            f(a, b, out, n);
+        __asm__ volatile("" : : "r"(out) : "memory");
+        double t = (now_sec() - t0) / (double)reps;
+        if (trial == 0 || t < best)
+            best = t;
+    }
+    return best;
+}
+
+// Working set in bytes used to calibrate each size class: half of the cache
+// that defines the class and twice the LLC for DRAM, both capped to keep the
+// calibration short (on CPUs with a very large LLC, the DRAM class is then
+// partly measured in cache)
+static void
+calibration_sizes(size_t ws[DYNEMIT_SIZE_CLASSES])
+{
+    size_t l1  = dynemit_cache_size(1);
+    size_t l2  = dynemit_cache_size(2);
+    size_t llc = dynemit_llc_size();
+
+    l1  = l1 ? l1 : (size_t)32 * 1024;
+    l2  = l2 > l1 ? l2 : 32 * l1;
+    llc = llc > l2 ? llc : 8 * l2;
+
+    size_t dram = 2 * llc;
+    dram = dram < AUTOTUNE_DRAM_MIN ? AUTOTUNE_DRAM_MIN : dram;
+    dram = dram > AUTOTUNE_DRAM_MAX ? AUTOTUNE_DRAM_MAX : dram;
+
+    ws[DYNEMIT_SIZE_L1]   = l1 / 2;
+    ws[DYNEMIT_SIZE_L2]   = l2 / 2;
+    ws[DYNEMIT_SIZE_LLC]  = llc / 2 < dram / 4 ? llc / 2 : dram / 4;
+    ws[DYNEMIT_SIZE_DRAM] = dram;
+}
+
+static void
+measure(const char *name, simd_level_t max, simd_level_t levels[DYNEMIT_SIZE_CLASSES])
+{
+    size_t ws[DYNEMIT_SIZE_CLASSES];
+    calibration_sizes(ws);
+
+    for (int c = 0; c < DYNEMIT_SIZE_CLASSES; c++)
+        levels[c] = max;
+
+    // Three arrays per working set, 64-byte multiples
+    size_t max_n = (ws[DYNEMIT_SIZE_DRAM] / (3 * sizeof(float))) & ~(size_t)15;
+    float *a   = aligned_alloc(64, max_n * sizeof(float));
+    float *b   = aligned_alloc(64, max_n * sizeof(float));
+    float *out = aligned_alloc(64, max_n * sizeof(float));
+    if (!a || !b || !out) {
+        free(a);
+        free(b);
+        free(out);
+        return;
+    }
+    for (size_t i = 0; i < max_n; i++) {
+        a[i] = 1.0f + (float)(i & 1023) * 0x1p-10f;
+        b[i] = 0.5f;
+        out[i] = 0.0f;
+    }
+
+    for (int c = 0; c < DYNEMIT_SIZE_CLASSES; c++) {
+        size_t n = (ws[c] / (3 * sizeof(float))) & ~(size_t)15;
+        double best_t = 0.0;
+        binary_f32_func_t prev = nullptr;
+        double prev_t = 0.0;
+
+        // Highest level first, so it wins ties
+        for (int l = (int)max; l >= SIMD_SCALAR; l--) {
+            binary_f32_func_t f = (binary_f32_func_t)dynemit_get_kernel(name, (simd_level_t)l);
+            if (!f)
+                continue;
+            // Levels sharing a kernel need not be timed twice
+            double t = f == prev ? prev_t : time_kernel(f, a, b, out, n);
+            if (l == (int)max || t < best_t * (1.0 - AUTOTUNE_MARGIN)) {
+                best_t = t;
+                levels[c] = (simd_level_t)l;
+            }
+            prev = f;
+            prev_t = t;
+        }
+    }
+
+    free(a);
+    free(b);
+    free(out);
+}
+
+int
+dynemit_autotune_binary_f32(const char *name, simd_level_t levels[DYNEMIT_SIZE_CLASSES])
+{
+    simd_level_t max = detect_simd_level_ts();
+    if (!name || !dynemit_get_kernel(name, max))
+        return -1;
+
+    char sig[128], path[1024];
+    host_signature(sig, sizeof(sig));
+    int cached = cache_path(path, sizeof(path));
+
+    if (cached && dynemit_autotune_mode() != 2 &&
+        cache_lookup(path, sig, name, max, levels) == 0)
+        return 0;
+
+    measure(name, max, levels);
+    if (cached) {
+        char key[256], values[128];
+        int len = 0;
+        snprintf(key, sizeof(key), "%s %s %s", sig, name, simd_level_name(max));
+        for (int c = 0; c < DYNEMIT_SIZE_CLASSES; c++)
+            len += snprintf(values + len, sizeof(values) - (size_t)len, "%s%s", c ? " " : "",
+                            simd_level_name(levels[c]));
+        cache_store(path, key, values);
+    }
+    return 0;
+}
+
+// Time vector_mul_f32 with each candidate distance on the DRAM calibration
+// set. Candidates are interleaved over the trials, so slow drift of the
+// memory system (other tenants, frequency) hits all of them alike
+static size_t
+measure_prefetch(simd_level_t max)
+{
+    const size_t ncand = sizeof(prefetch_candidates) / sizeof(prefetch_candidates[0]);
+    size_t fallback = dynemit_default_prefetch_distance();
+    binary_f32_func_t f = (binary_f32_func_t)dynemit_get_kernel("vector_mul_f32", max);
+    if (!f)
+        return fallback;
+
+    size_t ws[DYNEMIT_SIZE_CLASSES];
+    calibration_sizes(ws);
+    size_t n = (ws[DYNEMIT_SIZE_DRAM] / (3 * sizeof(float))) & ~(size_t)15;
+    float *a   = aligned_alloc(64, n * sizeof(float));
+    float *b   = aligned_alloc(64, n * sizeof(float));
+    float *out = aligned_alloc(64, n * sizeof(float));
+    if (!a || !b || !out) {
+        free(a);
+        free(b);
+        free(out);
+        return fallback;
+    }
+    for (size_t i = 0; i < n; i++) {
+        a[i] = 1.0f + (float)(i & 1023) * 0x1p-10f;
+        b[i] = 0.5f;
+        out[i] = 0.0f;
+    }
+
+    double best[sizeof(prefetch_candidates) / sizeof(prefetch_candidates[0])];
+    f(a, b, out, n);
+    for (int trial = 0; trial < AUTOTUNE_TRIALS; trial++) {
+        for (size_t c = 0; c < ncand; c++) {
+            dynemit_set_prefetch_distance(prefetch_candidates[c]);
+            double t0 = now_sec();
+            f(a, b, out, n);
+            __asm__ volatile("" : : "r"(out) : "memory");
+            double t = now_sec() - t0;
+            if (trial == 0 || t < best[c])
+                best[c] = t;
+        }
+    }
+
+    free(a);
+    free(b);
+    free(out);
+
+    // The default is what runs untuned; keep it unless beaten by the margin
+    // (0.0 when a build-time default is not among the candidates)
+    double fallback_t = 0.0;
+    for (size_t c = 0; c < ncand; c++) {
+        if (prefetch_candidates[c] == fallback)
+            fallback_t = best[c];
+    }
+    size_t choice = fallback;
+    double choice_t = fallback_t;
+    for (size_t c = 0; c < ncand; c++) {
+        if ((fallback_t == 0.0 || best[c] < fallback_t * (1.0 - AUTOTUNE_MARGIN)) &&
+            (choice_t == 0.0 || best[c] < choice_t)) {
+            choice = prefetch_candidates[c];
+            choice_t = best[c];
+        }
+    }
+    return choice;
+}
+
+size_t
+dynemit_autotune_prefetch_distance(void)
+{
+    simd_level_t max = detect_simd_level_ts();
+    char sig[128], path[1024];
+    host_signature(sig, sizeof(sig));
+    int cached = cache_path(path, sizeof(path));
+
+    size_t distance;
+    if (!cached || dynemit_autotune_mode() == 2 ||
+        cache_lookup_prefetch(path, sig, max, &distance) != 0) {
+        distance = measure_prefetch(max);
+        if (cached) {
+            char key[256], values[32];
+            snprintf(key, sizeof(key), "%s " PREFETCH_ENTRY " %s", sig, simd_level_name(max));
+            snprintf(values, sizeof(values), "%zu", distance);
+            cache_store(path, key, values);
+        }
+    }
+    dynemit_set_prefetch_distance(distance);
+    return distance;
+}
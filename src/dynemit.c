@@ -1,7 +1,12 @@
 /* SPDX-License-Identifier: BSL-1.0 */
 #include <dynemit/core.h>
 #include <stddef.h>
+#include <stdlib.h>
 #include <stdatomic.h>
+#include <string.h>
+#if (defined(__aarch64__) || defined(__riscv)) && defined(__linux__)
+#include <sys/auxv.h>
+#endif
 
 void
 cpuid_x86(uint32_t leaf, uint32_t subleaf,
@@ -40,51 +45,275 @@ xgetbv_x86(uint32_t xcr)
 #endif
 }
 
-simd_level_t
-detect_simd_level(void)
+// XCR0 state components required by each register file
+#define XCR0_YMM_STATE  UINT64_C(0x06)     // SSE + AVX (bits 1-2)
+#define XCR0_ZMM_STATE  UINT64_C(0xE6)     // YMM + opmask + ZMM_Hi256 + Hi16_ZMM (bits 5-7)
+#define XCR0_OPMASK     UINT64_C(0x26)     // YMM + opmask, enough for 256-bit AVX10
+#define XCR0_TILE_STATE UINT64_C(0x60000)  // XTILECFG + XTILEDATA (bits 17-18)
+
+// Linux HWCAP bits, in case the libc headers predate them
+#define AARCH64_HWCAP_ASIMD  (1UL << 1)
+#define AARCH64_HWCAP_SVE    (1UL << 22)
+#define AARCH64_HWCAP2_SVE2  (1UL << 1)
+#define RISCV_HWCAP_V        (1UL << ('V' - 'A'))  // one bit per single-letter ISA extension
+
+// Run CPUID/XGETBV (or read the kernel's HWCAP) and build the DYNEMIT_CPU_*
+// bitmask (uncached). getauxval() only reads the auxiliary vector libc saved
+// at startup, so it is safe in resolvers.
+static uint64_t
+probe_cpu_features(void)
 {
-#if !(defined(__x86_64__) || defined(__i386__))
-    return SIMD_SCALAR; // non-x86
+#if defined(__aarch64__) && defined(__linux__)
+    unsigned long hwcap = getauxval(AT_HWCAP);
+    uint64_t f = 0;
+    if (hwcap & AARCH64_HWCAP_ASIMD) f |= DYNEMIT_CPU_NEON;
+    if (hwcap & AARCH64_HWCAP_SVE) {
+        f |= DYNEMIT_CPU_SVE;
+        if (getauxval(AT_HWCAP2) & AARCH64_HWCAP2_SVE2) f |= DYNEMIT_CPU_SVE2;
+    }
+    return f;
+#elif defined(__aarch64__)
+    return DYNEMIT_CPU_NEON;  // ASIMD is mandatory in the base aarch64 ISA
+#elif defined(__riscv) && defined(__linux__)
+    return (getauxval(AT_HWCAP) & RISCV_HWCAP_V) ? DYNEMIT_CPU_RVV : 0;
+#elif !(defined(__x86_64__) || defined(__i386__))
+    return 0; // no SIMD backend
 #else
     uint32_t eax, ebx, ecx, edx;
     cpuid_x86(0, 0, &eax, &ebx, &ecx, &edx);
-    if (eax == 0)
-        return SIMD_SCALAR;
+    uint32_t max_leaf = eax;
+    if (max_leaf == 0)
+        return 0;
+
+    uint64_t f = 0;
 
     cpuid_x86(1, 0, &eax, &ebx, &ecx, &edx);
-    int sse2    = (edx >> 26) & 1;
-    int sse42   = (ecx >> 20) & 1;
+    if ((edx >> 26) & 1) f |= DYNEMIT_CPU_SSE2;
+    if ((ecx >>  0) & 1) f |= DYNEMIT_CPU_SSE3;
+    if ((ecx >>  9) & 1) f |= DYNEMIT_CPU_SSSE3;
+    if ((ecx >> 19) & 1) f |= DYNEMIT_CPU_SSE4_1;
+    if ((ecx >> 20) & 1) f |= DYNEMIT_CPU_SSE4_2;
+    if ((ecx >> 23) & 1) f |= DYNEMIT_CPU_POPCNT;
+
     int osxsave = (ecx >> 27) & 1;
     int avx     = (ecx >> 28) & 1;
+    int fma     = (ecx >> 12) & 1;
+    int f16c    = (ecx >> 29) & 1;
 
     uint64_t xcr0 = 0;
     if (osxsave)
         xcr0 = xgetbv_x86(0);
 
+    int ymm_ok    = osxsave && ((xcr0 & XCR0_YMM_STATE) == XCR0_YMM_STATE);
+    int zmm_ok    = osxsave && ((xcr0 & XCR0_ZMM_STATE) == XCR0_ZMM_STATE);
+    int opmask_ok = osxsave && ((xcr0 & XCR0_OPMASK) == XCR0_OPMASK);
+    int tile_ok   = osxsave && ((xcr0 & XCR0_TILE_STATE) == XCR0_TILE_STATE);
+
+    // Every VEX/EVEX-encoded extension needs AVX itself plus YMM state
+    if (!(avx && ymm_ok)) {
+        ymm_ok = 0;
+        zmm_ok = 0;
+        opmask_ok = 0;
+    }
+
+    if (ymm_ok) {
+        f |= DYNEMIT_CPU_AVX;
+        if (fma)  f |= DYNEMIT_CPU_FMA;
+        if (f16c) f |= DYNEMIT_CPU_F16C;
+    }
+
+    if (max_leaf < 7)
+        return f;
+
     // Extended features
     uint32_t eax7, ebx7, ecx7, edx7;
     cpuid_x86(7, 0, &eax7, &ebx7, &ecx7, &edx7);
-    int avx2    = (ebx7 >> 5) & 1;
-    int avx512f = (ebx7 >> 16) & 1;
+    uint32_t max_subleaf7 = eax7;
+
+    // BMI1/BMI2 operate on general purpose registers, no OS state needed
+    if ((ebx7 >> 3) & 1) f |= DYNEMIT_CPU_BMI1;
+    if ((ebx7 >> 8) & 1) f |= DYNEMIT_CPU_BMI2;
+
+    if (ymm_ok && ((ebx7 >> 5) & 1))
+        f |= DYNEMIT_CPU_AVX2;
 
-    int ymm_ok = osxsave && ((xcr0 & 0x6) == 0x6);
-    int zmm_ok = osxsave && ((xcr0 & 0xE0) == 0xE0);
+    if (zmm_ok && ((ebx7 >> 16) & 1)) {
+        f |= DYNEMIT_CPU_AVX512F;
+        if ((ebx7 >> 17) & 1) f |= DYNEMIT_CPU_AVX512DQ;
+        if ((ebx7 >> 21) & 1) f |= DYNEMIT_CPU_AVX512IFMA;
+        if ((ebx7 >> 28) & 1) f |= DYNEMIT_CPU_AVX512CD;
+        if ((ebx7 >> 30) & 1) f |= DYNEMIT_CPU_AVX512BW;
+        if ((ebx7 >> 31) & 1) f |= DYNEMIT_CPU_AVX512VL;
+        if ((ecx7 >>  1) & 1) f |= DYNEMIT_CPU_AVX512VBMI;
+        if ((ecx7 >>  6) & 1) f |= DYNEMIT_CPU_AVX512VBMI2;
+        if ((ecx7 >> 11) & 1) f |= DYNEMIT_CPU_AVX512VNNI;
+        if ((ecx7 >> 12) & 1) f |= DYNEMIT_CPU_AVX512BITALG;
+        if ((ecx7 >> 14) & 1) f |= DYNEMIT_CPU_AVX512VPOPCNTDQ;
+        if ((edx7 >> 23) & 1) f |= DYNEMIT_CPU_AVX512FP16;
+    }
+
+    if (tile_ok && ((edx7 >> 24) & 1)) {
+        f |= DYNEMIT_CPU_AMX_TILE;
+        if ((edx7 >> 22) & 1) f |= DYNEMIT_CPU_AMX_BF16;
+        if ((edx7 >> 25) & 1) f |= DYNEMIT_CPU_AMX_INT8;
+    }
+
+    int avx10 = 0;
+    if (max_subleaf7 >= 1) {
+        uint32_t eax71, ebx71, ecx71, edx71;
+        cpuid_x86(7, 1, &eax71, &ebx71, &ecx71, &edx71);
+        if (ymm_ok && ((eax71 >> 4) & 1))
+            f |= DYNEMIT_CPU_AVX_VNNI;
+        if ((f & DYNEMIT_CPU_AVX512F) && ((eax71 >> 5) & 1))
+            f |= DYNEMIT_CPU_AVX512BF16;
+        avx10 = (edx71 >> 19) & 1;
+    }
+
+    // AVX10 converged ISA: version and vector lengths live in leaf 0x24
+    if (avx10 && opmask_ok && max_leaf >= 0x24) {
+        uint32_t eax24, ebx24, ecx24, edx24;
+        cpuid_x86(0x24, 0, &eax24, &ebx24, &ecx24, &edx24);
+        uint32_t version = ebx24 & 0xFF;
+        if (version >= 1) f |= DYNEMIT_CPU_AVX10_1;
+        if (version >= 2) f |= DYNEMIT_CPU_AVX10_2;
+        if (version >= 1 && zmm_ok && ((ebx24 >> 18) & 1))
+            f |= DYNEMIT_CPU_AVX10_512;
+    }
+
+    return f;
+#endif
+}
 
+static simd_level_t
+level_from_features(uint64_t f)
+{
     // Prioritize fastest version
-    if (avx && avx512f && zmm_ok) return SIMD_AVX512F;
-    if (avx && avx2 && ymm_ok) return SIMD_AVX2;
-    if (avx && ymm_ok) return SIMD_AVX;
-    if (sse42) return SIMD_SSE4_2;
-    if (sse2) return SIMD_SSE2;
+    if (f & DYNEMIT_CPU_AVX512F) return SIMD_AVX512F;
+    if (f & DYNEMIT_CPU_AVX2)    return SIMD_AVX2;
+    if (f & DYNEMIT_CPU_AVX)     return SIMD_AVX;
+    if (f & DYNEMIT_CPU_SSE4_2)  return SIMD_SSE4_2;
+    if (f & DYNEMIT_CPU_SSE2)    return SIMD_SSE2;
+    if (f & DYNEMIT_CPU_SVE2)    return SIMD_SVE2;
+    if (f & DYNEMIT_CPU_SVE)     return SIMD_SVE;
+    if (f & DYNEMIT_CPU_NEON)    return SIMD_NEON;
+    if (f & DYNEMIT_CPU_RVV)     return SIMD_RVV;
     return SIMD_SCALAR;
-#endif
+}
+
+// Ladder a level belongs to: 0 for SIMD_SCALAR, which every ladder shares,
+// then 1 for x86, 2 for aarch64 and 3 for RISC-V
+static int
+level_ladder(simd_level_t level)
+{
+    if (level == SIMD_SCALAR) return 0;
+    if (level <= SIMD_AVX512F) return 1;
+    if (level <= SIMD_SVE2)   return 2;
+    return 3;
+}
+
+/*
+ * getenv() for IFUNC resolvers. IRELATIVE relocations are processed before
+ * libc has initialized environ (and in static binaries before libc's own
+ * string functions are resolved), so this walks the environment by hand: via
+ * environ once it is set, otherwise from the initial process stack, which
+ * holds argc, argv[], a null pointer and then envp[].
+ */
+extern char **environ;
+extern void *__libc_stack_end __attribute__((weak));
+
+static const char *
+early_getenv(const char *name)
+{
+    char **envp = environ;
+
+    if (!envp && &__libc_stack_end && __libc_stack_end) {
+        char **argv = (char **)__libc_stack_end + 1;
+        while (*argv)
+            argv++;
+        envp = argv + 1;
+    }
+    if (!envp)
+        return nullptr;
+
+    for (; *envp; envp++) {
+        const char *e = *envp, *n = name;
+        while (*n && *e == *n) {
+            e++;
+            n++;
+        }
+        if (!*n && *e == '=')
+            return e + 1;
+    }
+    return nullptr;
+}
+
+int
+simd_level_from_name(const char *name, simd_level_t *level)
+{
+    static const struct { const char *name; simd_level_t level; } names[] = {
+        { "scalar",  SIMD_SCALAR },
+        { "sse2",    SIMD_SSE2 },
+        { "sse42",   SIMD_SSE4_2 },
+        { "avx",     SIMD_AVX },
+        { "avx2",    SIMD_AVX2 },
+        { "avx512f", SIMD_AVX512F },
+        { "avx512",  SIMD_AVX512F },
+        { "neon",    SIMD_NEON },
+        { "asimd",   SIMD_NEON },
+        { "sve",     SIMD_SVE },
+        { "sve2",    SIMD_SVE2 },
+        { "rvv",     SIMD_RVV },
+    };
+
+    if (!name)
+        return -1;
+
+    // Lowercase without separators; no libc calls, resolvers use this
+    char buf[16];
+    size_t len = 0;
+    for (const char *p = name; *p; p++) {
+        char c = *p;
+        if (c == '-' || c == '_' || c == '.')
+            continue;
+        if (len + 1 >= sizeof(buf))
+            return -1;
+        buf[len++] = (c >= 'A' && c <= 'Z') ? (char)(c - 'A' + 'a') : c;
+    }
+    buf[len] = '\0';
+
+    for (size_t i = 0; i < sizeof(names) / sizeof(names[0]); i++) {
+        const char *a = buf, *b = names[i].name;
+        while (*a && *a == *b) {
+            a++;
+            b++;
+        }
+        if (*a == *b) {
+            *level = names[i].level;
+            return 0;
+        }
+    }
+    return -1;
+}
+
+simd_level_t
+detect_simd_level(void)
+{
+    simd_level_t level = level_from_features(probe_cpu_features());
+
+    // A cap from another ladder (e.g. "avx2" on aarch64) says nothing about
+    // this CPU, as with an unknown name
+    simd_level_t cap;
+    if (simd_level_from_name(early_getenv("DYNEMIT_MAX_LEVEL"), &cap) == 0 && cap < level &&
+        (cap == SIMD_SCALAR || level_ladder(cap) == level_ladder(level)))
+        level = cap;
+    return level;
 }
 
 simd_level_t
 detect_simd_level_ts(void)
 {
     // Use -1 as sentinel for "not yet initialized"
-    // Valid simd_level_t values are 0-5 (SIMD_SCALAR to SIMD_AVX512F)
+    // Valid simd_level_t values are 0-9 (SIMD_SCALAR to SIMD_RVV)
     static _Atomic int cached_level = -1;
     
     int level = atomic_load_explicit(&cached_level, memory_order_acquire);
@@ -116,11 +345,482 @@ simd_level_name(simd_level_t level)
         case SIMD_AVX:     return "AVX";
         case SIMD_SSE4_2:  return "SSE4.2";
         case SIMD_SSE2:    return "SSE2";
+        case SIMD_NEON:    return "NEON";
+        case SIMD_SVE:     return "SVE";
+        case SIMD_SVE2:    return "SVE2";
+        case SIMD_RVV:     return "RVV";
         case SIMD_SCALAR:  return "Scalar";
         default:           return "Unknown";
     }
 }
 
+uint64_t
+dynemit_cpu_features(void)
+{
+    // Bit 63 marks the cache as initialized, so a CPU with no reported
+    // features (non-x86) is still only probed once
+    static _Atomic uint64_t cached_features = 0;
+    const uint64_t initialized = UINT64_C(1) << 63;
+
+    uint64_t features = atomic_load_explicit(&cached_features, memory_order_acquire);
+
+    if (!(features & initialized)) {
+        // Race is okay - every thread computes the same value
+        features = probe_cpu_features() | initialized;
+        atomic_store_explicit(&cached_features, features, memory_order_release);
+    }
+
+    return features & ~initialized;
+}
+
+int
+dynemit_cpu_has(uint64_t required)
+{
+    return (dynemit_cpu_features() & required) == required;
+}
+
+const char *
+dynemit_cpu_feature_name(uint64_t feature)
+{
+    switch (feature) {
+        case DYNEMIT_CPU_SSE2:            return "SSE2";
+        case DYNEMIT_CPU_SSE3:            return "SSE3";
+        case DYNEMIT_CPU_SSSE3:           return "SSSE3";
+        case DYNEMIT_CPU_SSE4_1:          return "SSE4.1";
+        case DYNEMIT_CPU_SSE4_2:          return "SSE4.2";
+        case DYNEMIT_CPU_POPCNT:          return "POPCNT";
+        case DYNEMIT_CPU_AVX:             return "AVX";
+        case DYNEMIT_CPU_F16C:            return "F16C";
+        case DYNEMIT_CPU_FMA:             return "FMA";
+        case DYNEMIT_CPU_AVX2:            return "AVX2";
+        case DYNEMIT_CPU_BMI1:            return "BMI1";
+        case DYNEMIT_CPU_BMI2:            return "BMI2";
+        case DYNEMIT_CPU_AVX_VNNI:        return "AVX-VNNI";
+        case DYNEMIT_CPU_AVX512F:         return "AVX-512F";
+        case DYNEMIT_CPU_AVX512CD:        return "AVX-512CD";
+        case DYNEMIT_CPU_AVX512BW:        return "AVX-512BW";
+        case DYNEMIT_CPU_AVX512DQ:        return "AVX-512DQ";
+        case DYNEMIT_CPU_AVX512VL:        return "AVX-512VL";
+        case DYNEMIT_CPU_AVX512IFMA:      return "AVX-512IFMA";
+        case DYNEMIT_CPU_AVX512VBMI:      return "AVX-512VBMI";
+        case DYNEMIT_CPU_AVX512VBMI2:     return "AVX-512VBMI2";
+        case DYNEMIT_CPU_AVX512VNNI:      return "AVX-512VNNI";
+        case DYNEMIT_CPU_AVX512BITALG:    return "AVX-512BITALG";
+        case DYNEMIT_CPU_AVX512VPOPCNTDQ: return "AVX-512VPOPCNTDQ";
+        case DYNEMIT_CPU_AVX512BF16:      return "AVX-512BF16";
+        case DYNEMIT_CPU_AVX512FP16:      return "AVX-512FP16";
+        case DYNEMIT_CPU_AMX_TILE:        return "AMX-TILE";
+        case DYNEMIT_CPU_AMX_INT8:        return "AMX-INT8";
+        case DYNEMIT_CPU_AMX_BF16:        return "AMX-BF16";
+        case DYNEMIT_CPU_AVX10_1:         return "AVX10.1";
+        case DYNEMIT_CPU_AVX10_2:         return "AVX10.2";
+        case DYNEMIT_CPU_AVX10_512:       return "AVX10/512";
+        case DYNEMIT_CPU_NEON:            return "NEON";
+        case DYNEMIT_CPU_SVE:             return "SVE";
+        case DYNEMIT_CPU_SVE2:            return "SVE2";
+        case DYNEMIT_CPU_RVV:             return "RVV";
+        default:                          return "Unknown";
+    }
+}
+
+// Size in bytes of one cache described by CPUID leaf 4 / 0x8000001D
+static size_t
+cache_descriptor_size(uint32_t ebx, uint32_t ecx)
+{
+    size_t ways       = ((ebx >> 22) & 0x3FF) + 1;
+    size_t partitions = ((ebx >> 12) & 0x3FF) + 1;
+    size_t line       = (ebx & 0xFFF) + 1;
+    size_t sets       = (size_t)ecx + 1;
+    return ways * partitions * line * sets;
+}
+
+// Data/unified cache at a given level (0 = the highest level) enumerated by a
+// deterministic cache parameters leaf, or 0 if the leaf reports nothing
+static size_t
+probe_cache_leaf(uint32_t leaf, unsigned want)
+{
+    size_t size = 0;
+    uint32_t best_level = 0;
+    for (uint32_t sub = 0; sub < 16; sub++) {
+        uint32_t eax, ebx, ecx, edx;
+        cpuid_x86(leaf, sub, &eax, &ebx, &ecx, &edx);
+        uint32_t type = eax & 0x1F;   // 1 = data, 2 = instruction, 3 = unified
+        if (type == 0)
+            break;
+        if (type == 2)
+            continue;
+        uint32_t level = (eax >> 5) & 0x7;
+        if (want ? level == want : level >= best_level) {
+            best_level = level;
+            size = cache_descriptor_size(ebx, ecx);
+        }
+    }
+    return size;
+}
+
+static size_t
+probe_cache_size(unsigned want)
+{
+#if !(defined(__x86_64__) || defined(__i386__))
+    (void)want;
+    return 0;
+#else
+    uint32_t eax, ebx, ecx, edx;
+    cpuid_x86(0, 0, &eax, &ebx, &ecx, &edx);
+    uint32_t max_leaf = eax;
+
+    // Intel: deterministic cache parameters
+    if (max_leaf >= 4) {
+        size_t size = probe_cache_leaf(4, want);
+        if (size)
+            return size;
+    }
+
+    cpuid_x86(0x80000000, 0, &eax, &ebx, &ecx, &edx);
+    uint32_t max_ext = eax;
+
+    // AMD: same layout in 0x8000001D when topology extensions are present
+    if (max_ext >= 0x8000001D) {
+        cpuid_x86(0x80000001, 0, &eax, &ebx, &ecx, &edx);
+        if ((ecx >> 22) & 1) {
+            size_t size = probe_cache_leaf(0x8000001D, want);
+            if (size)
+                return size;
+        }
+    }
+
+    // Legacy AMD descriptors: L1d in KiB, L2 in KiB, L3 in 512 KiB units
+    if (want == 1 && max_ext >= 0x80000005) {
+        cpuid_x86(0x80000005, 0, &eax, &ebx, &ecx, &edx);
+        return (size_t)(ecx >> 24) * 1024;
+    }
+    if (want != 1 && max_ext >= 0x80000006) {
+        cpuid_x86(0x80000006, 0, &eax, &ebx, &ecx, &edx);
+        if ((want == 0 || want == 3) && (edx >> 18))
+            return (size_t)(edx >> 18) * 512 * 1024;
+        if ((want == 0 || want == 2) && (ecx >> 16))
+            return (size_t)(ecx >> 16) * 1024;
+    }
+
+    return 0;
+#endif
+}
+
+size_t
+dynemit_cache_size(unsigned level)
+{
+    // One slot per level, 0 = LLC. Bit 63 marks a slot as initialized, as in
+    // dynemit_cpu_features()
+    static _Atomic uint64_t cached_sizes[4];
+    const uint64_t initialized = UINT64_C(1) << 63;
+
+    if (level > 3)
+        return 0;
+
+    uint64_t size = atomic_load_explicit(&cached_sizes[level], memory_order_acquire);
+
+    if (!(size & initialized)) {
+        size = (uint64_t)probe_cache_size(level) | initialized;
+        atomic_store_explicit(&cached_sizes[level], size, memory_order_release);
+    }
+
+    return (size_t)(size & ~initialized);
+}
+
+size_t
+dynemit_llc_size(void)
+{
+    return dynemit_cache_size(0);
+}
+
+// Cache sizes assumed when CPUID does not describe the cache hierarchy
+#define DYNEMIT_FALLBACK_L1_SIZE  ((size_t)32 * 1024)
+#define DYNEMIT_FALLBACK_L2_SIZE  ((size_t)1024 * 1024)
+#define DYNEMIT_FALLBACK_LLC_SIZE ((size_t)8 * 1024 * 1024)
+
+size_t
+dynemit_stream_threshold(void)
+{
+    static _Atomic uint64_t cached_threshold = 0;
+    const uint64_t initialized = UINT64_C(1) << 63;
+
+    uint64_t threshold = atomic_load_explicit(&cached_threshold, memory_order_acquire);
+
+    if (!(threshold & initialized)) {
+        // Never called from a resolver, so the environment is available
+        const char *env = getenv("DYNEMIT_STREAM_THRESHOLD");
+        char *end = nullptr;
+        unsigned long long v = env && *env ? strtoull(env, &end, 10) : 0;
+
+        if (end && *end == '\0') {
+            threshold = v;
+        } else {
+            size_t llc = dynemit_llc_size();
+            threshold = (llc ? llc : DYNEMIT_FALLBACK_LLC_SIZE) / 2;
+        }
+        threshold = (threshold & ~initialized) | initialized;
+        atomic_store_explicit(&cached_threshold, threshold, memory_order_release);
+    }
+
+    return (size_t)(threshold & ~initialized);
+}
+
+// Prefetch distance used where the microarchitecture is not in the table
+// below; a build-time -DDYNEMIT_PREFETCH_DISTANCE=<bytes> replaces it
+#ifndef DYNEMIT_PREFETCH_DISTANCE
+#define DYNEMIT_PREFETCH_DISTANCE 1024
+#endif
+
+// Starting points per microarchitecture. Nehalem/Westmere and Sandy/Ivy
+// Bridge have a weaker L2 streamer and a longer memory latency per line fill
+// buffer than later cores, so three concurrent streams need the loads
+// issued further ahead. Refine with DYNEMIT_AUTOTUNE or
+// benchmark_kernels --prefetch.
+static size_t
+microarch_prefetch_distance(void)
+{
+    uint32_t eax, ebx, ecx, edx;
+    char vendor[12];
+
+    cpuid_x86(0, 0, &eax, &ebx, &ecx, &edx);
+    memcpy(vendor + 0, &ebx, 4);
+    memcpy(vendor + 4, &edx, 4);
+    memcpy(vendor + 8, &ecx, 4);
+    if (eax < 1 || memcmp(vendor, "GenuineIntel", 12) != 0)
+        return DYNEMIT_PREFETCH_DISTANCE;
+
+    cpuid_x86(1, 0, &eax, &ebx, &ecx, &edx);
+    unsigned family = (eax >> 8) & 0xf;
+    unsigned model = ((eax >> 4) & 0xf) | (((eax >> 16) & 0xf) << 4);
+    if (family != 6)
+        return DYNEMIT_PREFETCH_DISTANCE;
+
+    switch (model) {
+    case 0x1a: case 0x1e: case 0x1f: case 0x2e:  // Nehalem
+    case 0x25: case 0x2c: case 0x2f:             // Westmere (X5650)
+        return 2048;
+    case 0x2a: case 0x2d:                        // Sandy Bridge (E5-2670)
+    case 0x3a: case 0x3e:                        // Ivy Bridge
+        return 1536;
+    default:
+        return DYNEMIT_PREFETCH_DISTANCE;
+    }
+}
+
+// Bit 63 marks the value as initialized
+static _Atomic uint64_t cached_prefetch_distance;
+
+size_t
+dynemit_prefetch_distance(void)
+{
+    const uint64_t initialized = UINT64_C(1) << 63;
+
+    uint64_t distance = atomic_load_explicit(&cached_prefetch_distance, memory_order_relaxed);
+
+    if (!(distance & initialized)) {
+        const char *env = getenv("DYNEMIT_PREFETCH_DISTANCE");
+        char *end = nullptr;
+        unsigned long long v = env && *env ? strtoull(env, &end, 10) : 0;
+
+        if (end && *end == '\0') {
+            distance = v;
+        } else if (dynemit_autotune_mode()) {
+            // Times kernels that read the distance, set to each candidate
+            // in turn by the tuner
+            dynemit_set_prefetch_distance(microarch_prefetch_distance());
+            distance = dynemit_autotune_prefetch_distance();
+        } else {
+            distance = microarch_prefetch_distance();
+        }
+        distance = (distance & ~initialized) | initialized;
+        atomic_store_explicit(&cached_prefetch_distance, distance, memory_order_relaxed);
+    }
+
+    return (size_t)(distance & ~initialized);
+}
+
+void
+dynemit_set_prefetch_distance(size_t bytes)
+{
+    const uint64_t initialized = UINT64_C(1) << 63;
+    atomic_store_explicit(&cached_prefetch_distance, ((uint64_t)bytes & ~initialized) | initialized,
+                          memory_order_relaxed);
+}
+
+size_t
+dynemit_default_prefetch_distance(void)
+{
+    return microarch_prefetch_distance();
+}
+
+size_t
+dynemit_size_class_limit(dynemit_size_class_t size_class)
+{
+    size_t size;
+
+    switch (size_class) {
+    case DYNEMIT_SIZE_L1:
+        size = dynemit_cache_size(1);
+        return size ? size : DYNEMIT_FALLBACK_L1_SIZE;
+    case DYNEMIT_SIZE_L2:
+        size = dynemit_cache_size(2);
+        return size ? size : DYNEMIT_FALLBACK_L2_SIZE;
+    case DYNEMIT_SIZE_LLC:
+        size = dynemit_llc_size();
+        return size ? size : DYNEMIT_FALLBACK_LLC_SIZE;
+    case DYNEMIT_SIZE_DRAM:
+    default:
+        return SIZE_MAX;
+    }
+}
+
+dynemit_size_class_t
+dynemit_size_class(size_t bytes)
+{
+    if (bytes <= dynemit_size_class_limit(DYNEMIT_SIZE_L1))
+        return DYNEMIT_SIZE_L1;
+    if (bytes <= dynemit_size_class_limit(DYNEMIT_SIZE_L2))
+        return DYNEMIT_SIZE_L2;
+    if (bytes <= dynemit_size_class_limit(DYNEMIT_SIZE_LLC))
+        return DYNEMIT_SIZE_LLC;
+    return DYNEMIT_SIZE_DRAM;
+}
+
+int
+dynemit_autotune_mode(void)
+{
+    // Read in resolvers, so through early_getenv()
+    const char *env = early_getenv("DYNEMIT_AUTOTUNE");
+    if (!env || !*env || (env[0] == '0' && env[1] == '\0'))
+        return 0;
+
+    const char *retune = "retune";
+    const char *e = env;
+    while (*retune && *e == *retune) {
+        e++;
+        retune++;
+    }
+    return (!*retune && !*e) ? 2 : 1;
+}
+
+int
+dynemit_stats_mode(void)
+{
+    // Read in resolvers, so through early_getenv()
+    const char *env = early_getenv("DYNEMIT_STATS");
+    if (!env || !*env || (env[0] == '0' && env[1] == '\0'))
+        return 0;
+
+    const char *cycles = "cycles";
+    const char *e = env;
+    while (*cycles && *e == *cycles) {
+        e++;
+        cycles++;
+    }
+    return (!*cycles && !*e) ? 2 : 1;
+}
+
+// Bounds of the "dynemit_kernels" section, provided by the linker. Weak, so
+// a program without any registered kernel still links
+extern const struct dynemit_kernel_entry __start_dynemit_kernels[]
+    __attribute__((weak, visibility("hidden")));
+extern const struct dynemit_kernel_entry __stop_dynemit_kernels[]
+    __attribute__((weak, visibility("hidden")));
+
+dynemit_kernel_t
+dynemit_get_kernel(const char *name, simd_level_t level)
+{
+    simd_level_t hw = level_from_features(dynemit_cpu_features());
+    if (!name || (int)level < 0 || level > hw)
+        return nullptr;
+    // Another architecture's levels would only alias the scalar kernel
+    if (level_ladder(level) != 0 && level_ladder(level) != level_ladder(hw))
+        return nullptr;
+
+    for (const struct dynemit_kernel_entry *e = __start_dynemit_kernels;
+         e < __stop_dynemit_kernels; e++) {
+        if (strcmp(e->name, name) == 0)
+            return e->select(level);
+    }
+    return nullptr;
+}
+
+size_t
+dynemit_list_kernels(dynemit_kernel_info_t *kernels, size_t max)
+{
+    size_t count = 0;
+    for (const struct dynemit_kernel_entry *e = __start_dynemit_kernels;
+         e < __stop_dynemit_kernels; e++, count++) {
+        if (count < max)
+            kernels[count] = (dynemit_kernel_info_t){ e->name, e->prototype };
+    }
+    return count;
+}
+
+// Bounds of the "dynemit_dispatch" section, like the registry's
+extern dynemit_dispatch_t __start_dynemit_dispatch[]
+    __attribute__((weak, visibility("hidden")));
+extern dynemit_dispatch_t __stop_dynemit_dispatch[]
+    __attribute__((weak, visibility("hidden")));
+
+static dynemit_dispatch_t *
+find_dispatch(const char *name)
+{
+    for (dynemit_dispatch_t *d = __start_dynemit_dispatch; d < __stop_dynemit_dispatch; d++) {
+        if (strcmp(d->name, name) == 0)
+            return d;
+    }
+    return nullptr;
+}
+
+const dynemit_dispatch_t *
+dynemit_dispatch_lookup(const char *name)
+{
+    return name ? find_dispatch(name) : nullptr;
+}
+
+void
+dynemit_dispatch_bind_first(dynemit_dispatch_t *slot, dynemit_kernel_t kernel)
+{
+    // Racing first calls bind the same kernel; a rebind in between wins
+    dynemit_kernel_t expected = slot->first;
+    __atomic_compare_exchange_n(&slot->kernel, &expected, kernel, 0,
+                                __ATOMIC_RELAXED, __ATOMIC_RELAXED);
+}
+
+int
+dynemit_rebind(const char *name, simd_level_t level)
+{
+    if (name) {
+        dynemit_dispatch_t *d = find_dispatch(name);
+        dynemit_kernel_t kernel = d ? dynemit_get_kernel(name, level) : nullptr;
+        if (!kernel)
+            return -1;
+        __atomic_store_n(&d->kernel, kernel, __ATOMIC_RELAXED);
+        return 0;
+    }
+
+    int bound = 0;
+    for (dynemit_dispatch_t *d = __start_dynemit_dispatch; d < __stop_dynemit_dispatch; d++) {
+        dynemit_kernel_t kernel = dynemit_get_kernel(d->name, level);
+        if (kernel) {
+            __atomic_store_n(&d->kernel, kernel, __ATOMIC_RELAXED);
+            bound++;
+        }
+    }
+    return bound ? 0 : -1;
+}
+
+int
+dynemit_rebind_kernel(const char *name, dynemit_kernel_t kernel)
+{
+    dynemit_dispatch_t *d = name ? find_dispatch(name) : nullptr;
+    if (!d)
+        return -1;
+    __atomic_store_n(&d->kernel, kernel ? kernel : d->first, __ATOMIC_RELAXED);
+    return 0;
+}
+
 // Default implementation (weak symbol, can be overridden)
 __attribute__((weak))
 const char **
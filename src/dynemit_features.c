@@ -9,9 +9,17 @@ dynemit_features(void)
 {
     static const char *features[] = {
         "core",
+        "expr",
+        "half",
+        "multiout",
+        "parallel",
+        "reduce",
+        "sparse",
         "vector_add",
+        "vector_fma",
         "vector_mul",
         "vector_sub",
+        "vmath",
         nullptr  // nullptr-terminated
     };
     return features;
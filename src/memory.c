@@ -0,0 +1,131 @@
+/* SPDX-License-Identifier: BSL-1.0 */
+#define _GNU_SOURCE
+#include <dynemit/core.h>
+#include <errno.h>
+#include <stdint.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <linux/mempolicy.h>
+
+/*
+ * Large-vector allocation with NUMA placement. The memory policy calls go
+ * through syscall() so the library needs neither libnuma nor its headers
+ * at run time; a kernel without NUMA support just fails them (ENOSYS) and
+ * the buffer keeps the default policy.
+ *
+ * Each buffer is its own anonymous mapping. The 64 bytes in front of the
+ * returned pointer hold the mapping's start and length for dynemit_free().
+ */
+
+#define HUGE_PAGE   ((size_t)2 << 20)
+#define HEADER_SIZE ((size_t)64)
+#define MAX_NODES   1024
+
+typedef struct {
+    void  *base;
+    size_t length;
+} alloc_header_t;
+
+static size_t
+align_up(size_t x, size_t a)
+{
+    return (x + a - 1) & ~(a - 1);
+}
+
+static void
+apply_policy(void *base, size_t length, unsigned flags)
+{
+    if (flags & DYNEMIT_ALLOC_LOCAL) {
+        syscall(SYS_mbind, base, length, MPOL_LOCAL, (void *)0, 0UL, 0U);
+    } else if (flags & DYNEMIT_ALLOC_INTERLEAVE) {
+        unsigned long mask[MAX_NODES / (8 * sizeof(unsigned long))] = { 0 };
+        if (syscall(SYS_get_mempolicy, (void *)0, mask, (unsigned long)MAX_NODES, (void *)0,
+                    MPOL_F_MEMS_ALLOWED) == 0)
+            syscall(SYS_mbind, base, length, MPOL_INTERLEAVE, mask, (unsigned long)MAX_NODES, 0U);
+    }
+}
+
+void *
+dynemit_alloc(size_t bytes, unsigned flags)
+{
+    if ((flags & DYNEMIT_ALLOC_LOCAL) && (flags & DYNEMIT_ALLOC_INTERLEAVE)) {
+        errno = EINVAL;
+        return nullptr;
+    }
+
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    size_t align = (flags & DYNEMIT_ALLOC_HUGE) ? HUGE_PAGE : page;
+    if (bytes > SIZE_MAX / 2 - 2 * HUGE_PAGE) {
+        errno = ENOMEM;
+        return nullptr;
+    }
+
+    // Huge buffers start on a 2 MiB boundary with the header in the page
+    // before it, so map one huge page extra and trim what is left over
+    size_t data = align_up(bytes, align);
+    size_t length = (flags & DYNEMIT_ALLOC_HUGE) ? data + HUGE_PAGE : align_up(bytes + HEADER_SIZE, page);
+    char *base = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (base == MAP_FAILED)
+        return nullptr;
+
+    char *p = base + HEADER_SIZE;
+    if (flags & DYNEMIT_ALLOC_HUGE) {
+        p = (char *)align_up((uintptr_t)p, HUGE_PAGE);
+        char *keep = p - page;
+        char *end = p + data;
+        if (keep > base)
+            munmap(base, (size_t)(keep - base));
+        if (end < base + length)
+            munmap(end, (size_t)(base + length - end));
+        base = keep;
+        length = (size_t)(end - keep);
+        madvise(p, data, MADV_HUGEPAGE);
+    }
+
+    apply_policy(base, length, flags);
+
+    alloc_header_t *header = (alloc_header_t *)(p - HEADER_SIZE);
+    header->base = base;
+    header->length = length;
+    return p;
+}
+
+void
+dynemit_free(void *p)
+{
+    if (!p)
+        return;
+    const alloc_header_t *header = (const alloc_header_t *)((char *)p - HEADER_SIZE);
+    munmap(header->base, header->length);
+}
+
+int
+dynemit_page_nodes(const void *const *addrs, size_t count, int *nodes)
+{
+    enum { BATCH = 256 };
+    uintptr_t mask = ~((uintptr_t)sysconf(_SC_PAGESIZE) - 1);
+    int queried = 0;
+
+    for (size_t i = 0; i < count; i += BATCH) {
+        size_t len = count - i < BATCH ? count - i : BATCH;
+        void *pages[BATCH];
+        int status[BATCH];
+        for (size_t k = 0; k < len; k++) {
+            pages[k] = (void *)((uintptr_t)addrs[i + k] & mask);
+            status[k] = -1;
+        }
+
+        // With no target nodes, move_pages() only reports where pages are;
+        // a page not faulted in yet gets -ENOENT
+        if (syscall(SYS_move_pages, 0, (unsigned long)len, pages, (void *)0, status, 0) == 0)
+            queried = 1;
+        else
+            for (size_t k = 0; k < len; k++)
+                status[k] = -1;
+
+        for (size_t k = 0; k < len; k++)
+            nodes[i + k] = status[k] >= 0 ? status[k] : -1;
+    }
+    return queried || !count ? 0 : -1;
+}
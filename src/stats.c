@@ -0,0 +1,340 @@
+/* SPDX-License-Identifier: BSL-1.0 */
+#define _POSIX_C_SOURCE 200809L
+#include <dynemit/core.h>
+#include <inttypes.h>
+#include <pthread.h>
+#include <stdarg.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ * Call statistics. dynemit_stats_bind() runs inside resolvers and only
+ * touches static data; everything else runs at call or read time.
+ *
+ * Each thread gets its own block of counters on its first recorded call.
+ * Its owner is the only writer, so counters are bumped with a relaxed load
+ * and store instead of an atomic read-modify-write, and readers see a
+ * consistent value per counter. Blocks are folded into the retired totals
+ * when their thread exits.
+ */
+
+typedef struct {
+    _Atomic uint64_t calls;
+    _Atomic uint64_t elements;
+    _Atomic uint64_t cycles;
+    _Atomic uint64_t size_hist[DYNEMIT_STATS_BUCKETS];
+} counters_t;
+
+typedef struct {
+    uint64_t calls;
+    uint64_t elements;
+    uint64_t cycles;
+    uint64_t size_hist[DYNEMIT_STATS_BUCKETS];
+} totals_t;
+
+struct stats_block {
+    struct stats_block *next;
+    counters_t counters[DYNEMIT_STATS_MAX_FUNCS];
+};
+
+// Tracked functions, in bind order. Slots are handed out by num_sites; a
+// slot whose site lost the race to bind is left empty
+static struct dynemit_stats_site *sites[DYNEMIT_STATS_MAX_FUNCS];
+static int num_sites;
+static int count_cycles;
+
+// Live thread blocks, and the totals of exited threads and at the last
+// reset, all under lock
+static pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+static struct stats_block *blocks;
+static totals_t retired[DYNEMIT_STATS_MAX_FUNCS];
+static totals_t baseline[DYNEMIT_STATS_MAX_FUNCS];
+
+static pthread_once_t key_once = PTHREAD_ONCE_INIT;
+static pthread_key_t block_key;
+
+static __thread struct stats_block *thread_block;
+static __thread int thread_exited;
+
+static uint64_t
+read_tsc(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __builtin_ia32_rdtsc();
+#else
+    return 0;
+#endif
+}
+
+static void
+add_totals(totals_t *t, counters_t *c)
+{
+    t->calls    += atomic_load_explicit(&c->calls, memory_order_relaxed);
+    t->elements += atomic_load_explicit(&c->elements, memory_order_relaxed);
+    t->cycles   += atomic_load_explicit(&c->cycles, memory_order_relaxed);
+    for (int k = 0; k < DYNEMIT_STATS_BUCKETS; k++)
+        t->size_hist[k] += atomic_load_explicit(&c->size_hist[k], memory_order_relaxed);
+}
+
+// Thread exit: keep the thread's counts in the retired totals
+static void
+retire_block(void *arg)
+{
+    struct stats_block *block = arg;
+
+    pthread_mutex_lock(&lock);
+    for (struct stats_block **p = &blocks; *p; p = &(*p)->next) {
+        if (*p == block) {
+            *p = block->next;
+            break;
+        }
+    }
+    for (int slot = 0; slot < DYNEMIT_STATS_MAX_FUNCS; slot++)
+        add_totals(&retired[slot], &block->counters[slot]);
+    pthread_mutex_unlock(&lock);
+
+    free(block);
+    thread_block = nullptr;
+    thread_exited = 1;
+}
+
+static void
+create_key(void)
+{
+    pthread_key_create(&block_key, retire_block);
+}
+
+static struct stats_block *
+attach_block(void)
+{
+    // Calls from other keys' destructors after ours ran are not counted
+    if (thread_exited)
+        return nullptr;
+
+    struct stats_block *block = calloc(1, sizeof(*block));
+    if (!block)
+        return nullptr;
+
+    pthread_once(&key_once, create_key);
+    pthread_setspecific(block_key, block);
+
+    pthread_mutex_lock(&lock);
+    block->next = blocks;
+    blocks = block;
+    pthread_mutex_unlock(&lock);
+
+    thread_block = block;
+    return block;
+}
+
+static void
+bump(_Atomic uint64_t *counter, uint64_t delta)
+{
+    atomic_store_explicit(counter, atomic_load_explicit(counter, memory_order_relaxed) + delta,
+                          memory_order_relaxed);
+}
+
+static int
+size_bucket(uint64_t n)
+{
+    if (!n)
+        return 0;
+    int bucket = 1 + (63 - __builtin_clzll(n)) / 2;
+    return bucket < DYNEMIT_STATS_BUCKETS ? bucket : DYNEMIT_STATS_BUCKETS - 1;
+}
+
+void
+dynemit_stats_bind(struct dynemit_stats_site *site, simd_level_t level)
+{
+    // The resolver can run again from a first call while stats are read
+    __atomic_store_n(&site->level, level, __ATOMIC_RELAXED);
+    __atomic_store_n(&count_cycles, dynemit_stats_mode() == 2, __ATOMIC_RELAXED);
+
+    if (__atomic_load_n(&site->slot, __ATOMIC_ACQUIRE))
+        return;
+    int slot = __atomic_fetch_add(&num_sites, 1, __ATOMIC_RELAXED);
+    if (slot >= DYNEMIT_STATS_MAX_FUNCS)
+        return;
+
+    __atomic_store_n(&sites[slot], site, __ATOMIC_RELEASE);
+    int expected = 0;
+    if (!__atomic_compare_exchange_n(&site->slot, &expected, slot + 1, 0,
+                                     __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+        __atomic_store_n(&sites[slot], nullptr, __ATOMIC_RELEASE);
+}
+
+struct dynemit_stats_call
+dynemit_stats_begin(const struct dynemit_stats_site *site, uint64_t elements)
+{
+    struct dynemit_stats_call call = { site, elements, 0 };
+    if (__atomic_load_n(&count_cycles, __ATOMIC_RELAXED))
+        call.start = read_tsc();
+    return call;
+}
+
+void
+dynemit_stats_end(struct dynemit_stats_call *call)
+{
+    uint64_t cycles = call->start ? read_tsc() - call->start : 0;
+
+    int slot = __atomic_load_n(&call->site->slot, __ATOMIC_RELAXED);
+    if (!slot)
+        return;
+    struct stats_block *block = thread_block ? thread_block : attach_block();
+    if (!block)
+        return;
+
+    counters_t *c = &block->counters[slot - 1];
+    bump(&c->calls, 1);
+    bump(&c->elements, call->elements);
+    if (cycles)
+        bump(&c->cycles, cycles);
+    bump(&c->size_hist[size_bucket(call->elements)], 1);
+}
+
+static int
+tracked_slots(void)
+{
+    int n = __atomic_load_n(&num_sites, __ATOMIC_ACQUIRE);
+    return n < DYNEMIT_STATS_MAX_FUNCS ? n : DYNEMIT_STATS_MAX_FUNCS;
+}
+
+// Counts of a slot since the start, under lock
+static totals_t
+slot_totals(int slot)
+{
+    totals_t t = retired[slot];
+    for (struct stats_block *b = blocks; b; b = b->next)
+        add_totals(&t, &b->counters[slot]);
+    return t;
+}
+
+size_t
+dynemit_stats_snapshot(dynemit_stats_t *stats, size_t max)
+{
+    size_t count = 0;
+    int n = tracked_slots();
+
+    pthread_mutex_lock(&lock);
+    for (int slot = 0; slot < n; slot++) {
+        const struct dynemit_stats_site *site = __atomic_load_n(&sites[slot], __ATOMIC_ACQUIRE);
+        if (!site)
+            continue;
+        if (count < max) {
+            totals_t t = slot_totals(slot);
+            const totals_t *base = &baseline[slot];
+            dynemit_stats_t *s = &stats[count];
+
+            s->name     = site->name;
+            s->level    = __atomic_load_n(&site->level, __ATOMIC_RELAXED);
+            s->calls    = t.calls - base->calls;
+            s->elements = t.elements - base->elements;
+            s->cycles   = t.cycles - base->cycles;
+            for (int k = 0; k < DYNEMIT_STATS_BUCKETS; k++)
+                s->size_hist[k] = t.size_hist[k] - base->size_hist[k];
+        }
+        count++;
+    }
+    pthread_mutex_unlock(&lock);
+    return count;
+}
+
+void
+dynemit_stats_reset(void)
+{
+    int n = tracked_slots();
+
+    pthread_mutex_lock(&lock);
+    for (int slot = 0; slot < n; slot++)
+        baseline[slot] = slot_totals(slot);
+    pthread_mutex_unlock(&lock);
+}
+
+// snprintf() onto the end of buf, tracking the full length
+__attribute__((format(printf, 4, 5)))
+static void
+append(char *buf, size_t size, size_t *len, const char *fmt, ...)
+{
+    va_list ap;
+    va_start(ap, fmt);
+    int r = vsnprintf(*len < size ? buf + *len : nullptr, *len < size ? size - *len : 0, fmt, ap);
+    va_end(ap);
+    if (r > 0)
+        *len += (size_t)r;
+}
+
+// Smallest element count of a histogram bucket
+static uint64_t
+bucket_low(int k)
+{
+    return k ? UINT64_C(1) << (2 * (k - 1)) : 0;
+}
+
+static const char *
+mode_name(int mode)
+{
+    return mode == 2 ? "cycles" : mode == 1 ? "counters" : "off";
+}
+
+static const char *
+level_name(simd_level_t level)
+{
+    return level == DYNEMIT_STATS_LEVEL_TUNED ? "tuned" : simd_level_name(level);
+}
+
+size_t
+dynemit_stats_dump(char *buf, size_t size, dynemit_stats_format_t format)
+{
+    size_t count = dynemit_stats_snapshot(nullptr, 0);
+    dynemit_stats_t *stats = count ? malloc(count * sizeof(*stats)) : nullptr;
+    if (stats)
+        count = dynemit_stats_snapshot(stats, count);
+    else
+        count = 0;
+
+    size_t len = 0;
+    if (size)
+        buf[0] = '\0';
+
+    if (format == DYNEMIT_STATS_JSON) {
+        append(buf, size, &len, "{\"mode\": \"%s\", \"functions\": [", mode_name(dynemit_stats_mode()));
+        for (size_t i = 0; i < count; i++) {
+            const dynemit_stats_t *s = &stats[i];
+            append(buf, size, &len,
+                   "%s{\"name\": \"%s\", \"level\": \"%s\", \"calls\": %" PRIu64
+                   ", \"elements\": %" PRIu64 ", \"cycles\": %" PRIu64 ", \"size_hist\": [",
+                   i ? ", " : "", s->name, level_name(s->level), s->calls, s->elements, s->cycles);
+            for (int k = 0; k < DYNEMIT_STATS_BUCKETS; k++)
+                append(buf, size, &len, "%s%" PRIu64, k ? ", " : "", s->size_hist[k]);
+            append(buf, size, &len, "]}");
+        }
+        append(buf, size, &len, "]}\n");
+    } else {
+        append(buf, size, &len, "# dynemit stats (%s): function level calls elements [cycles/element] sizes\n",
+               mode_name(dynemit_stats_mode()));
+        for (size_t i = 0; i < count; i++) {
+            const dynemit_stats_t *s = &stats[i];
+            append(buf, size, &len, "%-28s %-8s %12" PRIu64 " %14" PRIu64,
+                   s->name, level_name(s->level), s->calls, s->elements);
+            if (s->cycles)
+                append(buf, size, &len, " %8.3f", s->elements ? (double)s->cycles / (double)s->elements : 0.0);
+            for (int k = 0; k < DYNEMIT_STATS_BUCKETS; k++) {
+                if (!s->size_hist[k])
+                    continue;
+                if (k == 0)
+                    append(buf, size, &len, " 0:%" PRIu64, s->size_hist[k]);
+                else if (k == DYNEMIT_STATS_BUCKETS - 1)
+                    append(buf, size, &len, " %" PRIu64 "+:%" PRIu64, bucket_low(k), s->size_hist[k]);
+                else
+                    append(buf, size, &len, " %" PRIu64 "-%" PRIu64 ":%" PRIu64,
+                           bucket_low(k), bucket_low(k + 1) - 1, s->size_hist[k]);
+            }
+            append(buf, size, &len, "\n");
+        }
+    }
+
+    free(stats);
+    return len;
+}
@@ -0,0 +1,265 @@
+/* SPDX-License-Identifier: BSL-1.0 */
+#define _GNU_SOURCE
+#include <dynemit/core.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <unistd.h>
+
+/*
+ * Cache and core topology. Detected once, at the first call of
+ * dynemit_cpu_topology(), never inside a resolver, so libc and sysfs are
+ * available.
+ */
+
+#define SYSFS_CPU  "/sys/devices/system/cpu"
+#define SYSFS_NODE "/sys/devices/system/node"
+
+// CPUID leaf 0x1A core types
+#define CORE_TYPE_ATOM 0x20
+
+static int
+read_int(const char *path, int *value)
+{
+    FILE *fp = fopen(path, "r");
+    if (!fp)
+        return -1;
+    int ok = fscanf(fp, "%d", value) == 1;
+    fclose(fp);
+    return ok ? 0 : -1;
+}
+
+// NUMA node of each CPU, -1 where unknown
+static short cpu_node[CPU_SETSIZE];
+
+// Physical core of each CPU, numbered from 0 in order of first appearance;
+// -1 where unknown
+static short cpu_core[CPU_SETSIZE];
+
+// A sysfs CPU or node list ("0-3,8,10-11"), in ascending order
+static unsigned
+read_list(const char *path, int *items, unsigned max)
+{
+    FILE *fp = fopen(path, "r");
+    if (!fp)
+        return 0;
+
+    unsigned count = 0;
+    int first, last;
+    while (fscanf(fp, "%d", &first) == 1) {
+        last = first;
+        int c = fgetc(fp);
+        if (c == '-') {
+            if (fscanf(fp, "%d", &last) != 1)
+                break;
+            c = fgetc(fp);
+        }
+        for (int item = first; item <= last && count < max; item++)
+            items[count++] = item;
+        if (c != ',')
+            break;
+    }
+    fclose(fp);
+    return count;
+}
+
+// Logical CPUs per core from CPUID leaf 0xB, SMT level
+static unsigned
+cpuid_threads_per_core(void)
+{
+    uint32_t eax, ebx, ecx, edx;
+    cpuid_x86(0, 0, &eax, &ebx, &ecx, &edx);
+    if (eax < 0xB)
+        return 1;
+    cpuid_x86(0xB, 0, &eax, &ebx, &ecx, &edx);
+    unsigned threads = ebx & 0xffff;
+    return ((ecx >> 8) & 0xff) == 1 && threads ? threads : 1;
+}
+
+// Physical cores and SMT width: distinct (package, core) pairs among the
+// online CPUs, or CPUID when sysfs has no topology
+static void
+detect_cores(dynemit_cpu_topology_t *topo)
+{
+    static int cpus[CPU_SETSIZE];
+    static struct { int package, core, threads; } cores[CPU_SETSIZE];
+    unsigned ncpus = read_list(SYSFS_CPU "/online", cpus, CPU_SETSIZE);
+    unsigned ncores = 0, widest = 1;
+
+    for (int cpu = 0; cpu < CPU_SETSIZE; cpu++)
+        cpu_core[cpu] = -1;
+
+    for (unsigned i = 0; i < ncpus; i++) {
+        char path[128];
+        int package, core;
+        snprintf(path, sizeof(path), SYSFS_CPU "/cpu%d/topology/physical_package_id", cpus[i]);
+        if (read_int(path, &package) != 0)
+            break;
+        snprintf(path, sizeof(path), SYSFS_CPU "/cpu%d/topology/core_id", cpus[i]);
+        if (read_int(path, &core) != 0)
+            break;
+
+        unsigned c = 0;
+        while (c < ncores && (cores[c].package != package || cores[c].core != core))
+            c++;
+        if (c == ncores) {
+            cores[ncores].package = package;
+            cores[ncores].core = core;
+            cores[ncores].threads = 0;
+            ncores++;
+        }
+        if ((unsigned)++cores[c].threads > widest)
+            widest = (unsigned)cores[c].threads;
+        if (cpus[i] < CPU_SETSIZE)
+            cpu_core[cpus[i]] = (short)c;
+    }
+
+    long online = sysconf(_SC_NPROCESSORS_ONLN);
+    topo->logical_cpus = ncpus ? ncpus : online > 0 ? (unsigned)online : 1;
+
+    if (ncpus && ncores) {
+        topo->physical_cores = ncores;
+        topo->threads_per_core = widest;
+    } else {
+        topo->threads_per_core = cpuid_threads_per_core();
+        topo->physical_cores = (topo->logical_cpus + topo->threads_per_core - 1) / topo->threads_per_core;
+    }
+}
+
+// AVX-512F on the CPU this runs on, CPU and OS support
+static int
+has_avx512f_here(void)
+{
+    uint32_t eax, ebx, ecx, edx;
+    cpuid_x86(1, 0, &eax, &ebx, &ecx, &edx);
+    if (!((ecx >> 27) & 1))  // OSXSAVE
+        return 0;
+    // XMM, YMM, opmask, ZMM_Hi256 and Hi16_ZMM state enabled
+    if ((xgetbv_x86(0) & 0xe6) != 0xe6)
+        return 0;
+    cpuid_x86(7, 0, &eax, &ebx, &ecx, &edx);
+    return (ebx >> 16) & 1;
+}
+
+// Visit every CPU in the affinity mask: core type from leaf 0x1A and
+// AVX-512 support. The caller's affinity is restored afterwards.
+static void
+detect_hybrid(dynemit_cpu_topology_t *topo)
+{
+    cpu_set_t saved;
+    if (sched_getaffinity(0, sizeof(saved), &saved) != 0)
+        return;
+
+    topo->perf_cpus = 0;
+    topo->efficiency_cpus = 0;
+    topo->avx512_all_cores = 1;
+
+    for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+        if (!CPU_ISSET(cpu, &saved))
+            continue;
+        cpu_set_t one;
+        CPU_ZERO(&one);
+        CPU_SET(cpu, &one);
+        if (sched_setaffinity(0, sizeof(one), &one) != 0)
+            continue;
+
+        uint32_t eax, ebx, ecx, edx;
+        cpuid_x86(0x1A, 0, &eax, &ebx, &ecx, &edx);
+        if ((eax >> 24) == CORE_TYPE_ATOM)
+            topo->efficiency_cpus++;
+        else
+            topo->perf_cpus++;
+        if (!has_avx512f_here())
+            topo->avx512_all_cores = 0;
+    }
+
+    sched_setaffinity(0, sizeof(saved), &saved);
+}
+
+// Online NUMA nodes and the CPUs of each; one node when sysfs has none
+static void
+detect_numa(dynemit_cpu_topology_t *topo)
+{
+    static int nodes[CPU_SETSIZE], cpus[CPU_SETSIZE];
+
+    for (int cpu = 0; cpu < CPU_SETSIZE; cpu++)
+        cpu_node[cpu] = -1;
+
+    unsigned nnodes = read_list(SYSFS_NODE "/online", nodes, CPU_SETSIZE);
+    for (unsigned i = 0; i < nnodes; i++) {
+        char path[128];
+        snprintf(path, sizeof(path), SYSFS_NODE "/node%d/cpulist", nodes[i]);
+        unsigned ncpus = read_list(path, cpus, CPU_SETSIZE);
+        for (unsigned c = 0; c < ncpus; c++) {
+            if (cpus[c] < CPU_SETSIZE)
+                cpu_node[cpus[c]] = (short)nodes[i];
+        }
+    }
+    topo->numa_nodes = nnodes ? nnodes : 1;
+}
+
+static void
+detect_topology(dynemit_cpu_topology_t *topo)
+{
+    uint32_t eax, ebx, ecx, edx;
+
+    topo->l1d_size = dynemit_cache_size(1);
+    topo->l2_size  = dynemit_cache_size(2);
+    topo->l3_size  = dynemit_cache_size(3);
+
+    // CLFLUSH line size, in 8-byte units
+    cpuid_x86(1, 0, &eax, &ebx, &ecx, &edx);
+    topo->line_size = ((ebx >> 8) & 0xff) * 8;
+    if (!topo->line_size)
+        topo->line_size = 64;
+
+    detect_cores(topo);
+    detect_numa(topo);
+
+    topo->hybrid = 0;
+    topo->perf_cpus = topo->logical_cpus;
+    topo->efficiency_cpus = 0;
+    topo->avx512_all_cores = dynemit_cpu_has(DYNEMIT_CPU_AVX512F);
+
+    cpuid_x86(0, 0, &eax, &ebx, &ecx, &edx);
+    if (eax >= 0x1A) {
+        cpuid_x86(7, 0, &eax, &ebx, &ecx, &edx);
+        if ((edx >> 15) & 1) {
+            topo->hybrid = 1;
+            detect_hybrid(topo);
+        }
+    }
+}
+
+const dynemit_cpu_topology_t *
+dynemit_cpu_topology(void)
+{
+    static dynemit_cpu_topology_t topology;
+    static _Atomic int state;  // 0 new, 1 detecting, 2 ready
+
+    if (atomic_load_explicit(&state, memory_order_acquire) != 2) {
+        int expected = 0;
+        if (atomic_compare_exchange_strong(&state, &expected, 1)) {
+            detect_topology(&topology);
+            atomic_store_explicit(&state, 2, memory_order_release);
+        } else {
+            while (atomic_load_explicit(&state, memory_order_acquire) != 2)
+                sched_yield();
+        }
+    }
+    return &topology;
+}
+
+int
+dynemit_numa_node_of_cpu(int cpu)
+{
+    dynemit_cpu_topology();
+    return cpu >= 0 && cpu < CPU_SETSIZE ? cpu_node[cpu] : -1;
+}
+
+int
+dynemit_core_of_cpu(int cpu)
+{
+    dynemit_cpu_topology();
+    return cpu >= 0 && cpu < CPU_SETSIZE ? cpu_core[cpu] : -1;
+}
@@ -0,0 +1,144 @@
+/**
+ * @file test_alignment.c
+ * @brief Tests for the alignment peel and masked tails of the element-wise kernels
+ */
+
+#include <stdio.h>
+#include <math.h>
+#include <dynemit.h>
+
+// Covers short vectors (below the peel cutoff), every head length and every
+// tail length at each SIMD width
+#define MAX_N 300
+#define MAX_OFFSET 16
+#define GUARD 16
+#define SENTINEL -12345.0f
+
+static float a[MAX_N + MAX_OFFSET], b[MAX_N + MAX_OFFSET], c[MAX_N + MAX_OFFSET];
+static float buf[GUARD + MAX_N + MAX_OFFSET + GUARD] __attribute__((aligned(64)));
+
+static void fill_sentinel(void)
+{
+    for (size_t i = 0; i < sizeof(buf) / sizeof(buf[0]); i++)
+        buf[i] = SENTINEL;
+}
+
+// Masked heads/tails must not touch a single element outside [out, out + n)
+static int guards_intact(const float *out, size_t n)
+{
+    for (const float *p = buf; p < out; p++)
+        if (*p != SENTINEL) return 0;
+    for (const float *p = out + n; p < buf + sizeof(buf) / sizeof(buf[0]); p++)
+        if (*p != SENTINEL) return 0;
+    return 1;
+}
+
+// Fused and unfused paths round differently, allow a few ULPs of slack
+static int nearly_equal(float got, float expect)
+{
+    return fabsf(got - expect) <= 1e-6f * fmaxf(1.0f, fabsf(expect));
+}
+
+static int test_binary_ops(void)
+{
+    printf("  Testing add/sub/mul over sizes and offsets... ");
+
+    for (size_t off = 0; off < MAX_OFFSET; off++) {
+        for (size_t n = 0; n <= MAX_N; n++) {
+            float *out = buf + GUARD + off;
+            // Inputs are shifted too, so loads are misaligned as well
+            const float *x = a + (off * 3) % MAX_OFFSET, *y = b + (off * 5) % MAX_OFFSET;
+
+            for (int op = 0; op < 3; op++) {
+                fill_sentinel();
+                if (op == 0) vector_add_f32(x, y, out, n);
+                if (op == 1) vector_sub_f32(x, y, out, n);
+                if (op == 2) vector_mul_f32(x, y, out, n);
+                for (size_t i = 0; i < n; i++) {
+                    float expect = op == 0 ? x[i] + y[i] : op == 1 ? x[i] - y[i] : x[i] * y[i];
+                    if (out[i] != expect) {
+                        printf("FAIL (op %d, n=%zu, offset=%zu: out[%zu] = %f, expect %f)\n",
+                               op, n, off, i, out[i], expect);
+                        return 1;
+                    }
+                }
+                if (!guards_intact(out, n)) {
+                    printf("FAIL (op %d, n=%zu, offset=%zu: wrote outside the output)\n", op, n, off);
+                    return 1;
+                }
+            }
+        }
+    }
+
+    printf("OK\n");
+    return 0;
+}
+
+static int test_fma_ops(void)
+{
+    printf("  Testing fma/axpy over sizes and offsets... ");
+
+    const float alpha = 1.5f;
+    for (size_t off = 0; off < MAX_OFFSET; off++) {
+        for (size_t n = 0; n <= MAX_N; n++) {
+            float *out = buf + GUARD + off;
+
+            fill_sentinel();
+            vector_fma_f32(a + 1, b, c + 2, out, n);
+            for (size_t i = 0; i < n; i++) {
+                if (!nearly_equal(out[i], a[i + 1] * b[i] + c[i + 2])) {
+                    printf("FAIL (fma, n=%zu, offset=%zu: out[%zu] = %f)\n", n, off, i, out[i]);
+                    return 1;
+                }
+            }
+            if (!guards_intact(out, n)) {
+                printf("FAIL (fma, n=%zu, offset=%zu: wrote outside the output)\n", n, off);
+                return 1;
+            }
+
+            fill_sentinel();
+            for (size_t i = 0; i < n; i++)
+                out[i] = c[i];
+            vector_axpy_f32(alpha, a + 3, out, n);
+            for (size_t i = 0; i < n; i++) {
+                if (!nearly_equal(out[i], alpha * a[i + 3] + c[i])) {
+                    printf("FAIL (axpy, n=%zu, offset=%zu: y[%zu] = %f)\n", n, off, i, out[i]);
+                    return 1;
+                }
+            }
+            if (!guards_intact(out, n)) {
+                printf("FAIL (axpy, n=%zu, offset=%zu: wrote outside y)\n", n, off);
+                return 1;
+            }
+        }
+    }
+
+    printf("OK\n");
+    return 0;
+}
+
+int main(void)
+{
+    int failures = 0;
+
+    printf("Testing alignment peel and masked tails:\n");
+    printf("  Current SIMD level: %s\n\n", simd_level_name(detect_simd_level()));
+
+    for (int i = 0; i < MAX_N + MAX_OFFSET; i++) {
+        a[i] = (float)i * 0.5f + 1.0f;
+        b[i] = (float)(i % 7) - 3.0f;
+        c[i] = (float)(MAX_N - i) * 0.25f;
+    }
+
+    failures += test_binary_ops();
+    failures += test_fma_ops();
+
+    printf("\n");
+    if (failures == 0) {
+        printf("All tests passed!\n");
+        return 0;
+    } else {
+        printf("%d test(s) failed!\n", failures);
+        return 1;
+    }
+}
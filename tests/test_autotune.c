@@ -0,0 +1,237 @@
+/**
+ * @file test_autotune.c
+ * @brief Tests for cache size detection, size classes and the autotune cache
+ */
+
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <dynemit.h>
+
+static char cache_file[256];
+
+static int test_cache_sizes(void)
+{
+    printf("  Testing dynemit_cache_size... ");
+
+    size_t l1 = dynemit_cache_size(1), l2 = dynemit_cache_size(2), llc = dynemit_llc_size();
+    printf("(L1d %zu KiB, L2 %zu KiB, LLC %zu KiB) ", l1 / 1024, l2 / 1024, llc / 1024);
+
+    if (dynemit_cache_size(0) != llc || dynemit_cache_size(4) != 0) {
+        printf("FAIL (level 0 / out of range)\n");
+        return 1;
+    }
+    if ((l1 && l2 && l1 >= l2) || (l2 && llc && l2 > llc)) {
+        printf("FAIL (sizes not increasing)\n");
+        return 1;
+    }
+
+    printf("OK\n");
+    return 0;
+}
+
+static int test_size_class(void)
+{
+    printf("  Testing dynemit_size_class/dynemit_size_class_limit... ");
+
+    if (dynemit_size_class(0) != DYNEMIT_SIZE_L1 || dynemit_size_class(SIZE_MAX) != DYNEMIT_SIZE_DRAM) {
+        printf("FAIL (bounds)\n");
+        return 1;
+    }
+
+    dynemit_size_class_t prev = DYNEMIT_SIZE_L1;
+    for (size_t bytes = 1; bytes < ((size_t)1 << 40); bytes *= 2) {
+        dynemit_size_class_t c = dynemit_size_class(bytes);
+        if (c < prev || c >= DYNEMIT_SIZE_CLASSES) {
+            printf("FAIL (class %d at %zu bytes)\n", (int)c, bytes);
+            return 1;
+        }
+        prev = c;
+    }
+
+    // Each class ends at its limit
+    for (int c = DYNEMIT_SIZE_L1; c < DYNEMIT_SIZE_DRAM; c++) {
+        size_t limit = dynemit_size_class_limit((dynemit_size_class_t)c);
+        if (dynemit_size_class(limit) != (dynemit_size_class_t)c ||
+            dynemit_size_class(limit + 1) != (dynemit_size_class_t)(c + 1)) {
+            printf("FAIL (class %d limit %zu)\n", c, limit);
+            return 1;
+        }
+    }
+    if (dynemit_size_class_limit(DYNEMIT_SIZE_DRAM) != SIZE_MAX) {
+        printf("FAIL (DRAM limit)\n");
+        return 1;
+    }
+
+    size_t l1 = dynemit_cache_size(1);
+    if (l1 && (dynemit_size_class(l1) != DYNEMIT_SIZE_L1 || dynemit_size_class(l1 + 1) == DYNEMIT_SIZE_L1)) {
+        printf("FAIL (L1 boundary)\n");
+        return 1;
+    }
+
+    printf("OK\n");
+    return 0;
+}
+
+static int test_autotune_cache(void)
+{
+    printf("  Testing dynemit_autotune_binary_f32... ");
+
+    simd_level_t max = detect_simd_level_ts();
+    simd_level_t levels[DYNEMIT_SIZE_CLASSES], again[DYNEMIT_SIZE_CLASSES];
+
+    if (dynemit_autotune_binary_f32("vector_mul_f33", levels) != -1) {
+        printf("FAIL (unknown name accepted)\n");
+        return 1;
+    }
+
+    // Measures and stores
+    remove(cache_file);
+    if (dynemit_autotune_binary_f32("vector_mul_f32", levels) != 0) {
+        printf("FAIL (vector_mul_f32 not tuned)\n");
+        return 1;
+    }
+    for (int c = 0; c < DYNEMIT_SIZE_CLASSES; c++) {
+        if (levels[c] > max) {
+            printf("FAIL (class %d tuned to %s above %s)\n", c, simd_level_name(levels[c]), simd_level_name(max));
+            return 1;
+        }
+    }
+    printf("(%s/%s/%s/%s) ", simd_level_name(levels[0]), simd_level_name(levels[1]),
+           simd_level_name(levels[2]), simd_level_name(levels[3]));
+
+    // The second lookup comes from the file. The kernels may have tuned the
+    // prefetch distance while being timed, so its entry can come first
+    FILE *fp = fopen(cache_file, "r");
+    char header[256], entry[512];
+    int found = 0;
+    if (fp && fgets(header, sizeof(header), fp))
+        while (!found && fgets(entry, sizeof(entry), fp))
+            found = strstr(entry, " vector_mul_f32 ") != nullptr;
+    if (fp)
+        fclose(fp);
+    if (!found) {
+        printf("FAIL (no cache entry written)\n");
+        return 1;
+    }
+    if (dynemit_autotune_binary_f32("vector_mul_f32", again) != 0 ||
+        memcmp(levels, again, sizeof(levels)) != 0) {
+        printf("FAIL (cached levels differ)\n");
+        return 1;
+    }
+
+    // A cached entry is taken as is: rewrite it to pick scalar everywhere
+    char sig[128], name[64], lvl[16];
+    if (sscanf(entry, "%127s %63s %15s", sig, name, lvl) != 3) {
+        printf("FAIL (malformed entry: %s)\n", entry);
+        return 1;
+    }
+    fp = fopen(cache_file, "w");
+    if (!fp) {
+        printf("FAIL (cannot rewrite cache)\n");
+        return 1;
+    }
+    fprintf(fp, "%s%s %s %s Scalar Scalar Scalar Scalar\n", header, sig, name, lvl);
+    fclose(fp);
+    if (dynemit_autotune_binary_f32("vector_mul_f32", again) != 0) {
+        printf("FAIL (edited cache not read)\n");
+        return 1;
+    }
+    for (int c = 0; c < DYNEMIT_SIZE_CLASSES; c++) {
+        if (again[c] != SIMD_SCALAR) {
+            printf("FAIL (edited cache ignored)\n");
+            return 1;
+        }
+    }
+
+    printf("OK\n");
+    return 0;
+}
+
+static int test_tuned_dispatch(void)
+{
+    printf("  Testing vector_mul_f32 with autotune %s... ", dynemit_autotune_mode() ? "on" : "off");
+
+    // One size per class, up to a working set past most LLCs
+    const size_t sizes[] = { 0, 1, 17, 1000, 30000, 1 << 20, 3 << 22 };
+    size_t max_n = sizes[sizeof(sizes) / sizeof(sizes[0]) - 1];
+    float *a = malloc(max_n * sizeof(float));
+    float *b = malloc(max_n * sizeof(float));
+    float *out = malloc((max_n + 1) * sizeof(float));
+    if (!a || !b || !out) {
+        printf("SKIP (alloc failed)\n");
+        free(a);
+        free(b);
+        free(out);
+        return 0;
+    }
+    for (size_t i = 0; i < max_n; i++) {
+        a[i] = (float)(i % 97) * 0.5f;
+        b[i] = (float)(i % 13) - 6.0f;
+    }
+
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+        size_t n = sizes[s];
+        out[n] = -1.0f;
+        vector_mul_f32(a, b, out, n);
+        for (size_t i = 0; i < n; i++) {
+            if (out[i] != a[i] * b[i]) {
+                printf("FAIL (n=%zu: out[%zu] = %f)\n", n, i, out[i]);
+                free(a);
+                free(b);
+                free(out);
+                return 1;
+            }
+        }
+        if (out[n] != -1.0f) {
+            printf("FAIL (n=%zu: wrote past the end)\n", n);
+            free(a);
+            free(b);
+            free(out);
+            return 1;
+        }
+    }
+
+    free(a);
+    free(b);
+    free(out);
+    printf("OK\n");
+    return 0;
+}
+
+int main(void)
+{
+    int failures = 0;
+
+    // Keep the test away from the user's real cache
+    const char *env = getenv("DYNEMIT_AUTOTUNE_CACHE");
+    if (env && *env) {
+        snprintf(cache_file, sizeof(cache_file), "%s", env);
+    } else {
+        snprintf(cache_file, sizeof(cache_file), "test_autotune_cache.%ld", (long)getpid());
+        setenv("DYNEMIT_AUTOTUNE_CACHE", cache_file, 1);
+    }
+
+    printf("Testing cache sizes and autotuning:\n");
+    printf("  Current SIMD level: %s\n\n", simd_level_name(detect_simd_level()));
+
+    failures += test_cache_sizes();
+    failures += test_size_class();
+    failures += test_tuned_dispatch();
+    failures += test_autotune_cache();
+
+    if (!env || !*env)
+        remove(cache_file);
+
+    printf("\n");
+    if (failures == 0) {
+        printf("All tests passed!\n");
+        return 0;
+    } else {
+        printf("%d test(s) failed!\n", failures);
+        return 1;
+    }
+}
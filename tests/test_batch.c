@@ -0,0 +1,164 @@
+/**
+ * @file test_batch.c
+ * @brief Tests for the batched and strided float add/sub/mul
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <dynemit.h>
+
+typedef void (*batch_fn)(const float *const *, const float *const *, float *const *,
+                         const size_t *, size_t);
+typedef void (*strided_fn)(const float *, const float *, float *, size_t, size_t, size_t);
+
+// Every length up to four AVX-512 vectors and a few past it
+#define COUNT 70
+#define STRIDE 80
+#define GUARD -1.0f
+
+static float a[COUNT * STRIDE], b[COUNT * STRIDE], out[COUNT * STRIDE];
+
+static float apply(char op, float x, float y)
+{
+    return op == '+' ? x + y : op == '-' ? x - y : x * y;
+}
+
+// Items of length k at offset k, so every start misalignment is covered
+static int check_batch(const char *name, batch_fn f, char op)
+{
+    const float *pa[COUNT], *pb[COUNT];
+    float *po[COUNT];
+    size_t n[COUNT];
+
+    for (size_t i = 0; i < COUNT * STRIDE; i++)
+        out[i] = GUARD;
+    for (size_t k = 0; k < COUNT; k++) {
+        pa[k] = a + k * STRIDE + k % 16;
+        pb[k] = b + k * STRIDE;
+        po[k] = out + k * STRIDE + k % 16;
+        n[k] = k;
+    }
+    f(pa, pb, po, n, COUNT);
+
+    for (size_t k = 0; k < COUNT; k++) {
+        float *row = out + k * STRIDE;
+        for (size_t i = 0; i < STRIDE; i++) {
+            size_t j = i - k % 16;
+            int inside = i >= k % 16 && j < n[k];
+            float expect = inside ? apply(op, pa[k][j], pb[k][j]) : GUARD;
+            if (row[i] != expect) {
+                printf("FAIL (%s item %zu, n=%zu: out[%zu] = %f, expect %f)\n", name, k, n[k], i, row[i], expect);
+                return 1;
+            }
+        }
+    }
+    return 0;
+}
+
+static int check_strided(const char *name, strided_fn f, char op)
+{
+    for (size_t n = 0; n <= STRIDE; n += 7) {
+        for (size_t i = 0; i < COUNT * STRIDE; i++)
+            out[i] = GUARD;
+        f(a, b, out, n, COUNT, STRIDE);
+        for (size_t i = 0; i < COUNT * STRIDE; i++) {
+            float expect = i % STRIDE < n ? apply(op, a[i], b[i]) : GUARD;
+            if (out[i] != expect) {
+                printf("FAIL (%s, n=%zu: out[%zu] = %f, expect %f)\n", name, n, i, out[i], expect);
+                return 1;
+            }
+        }
+    }
+
+    // count == 0 touches nothing
+    out[0] = GUARD;
+    f(a, b, out, STRIDE, 0, STRIDE);
+    if (out[0] != GUARD) {
+        printf("FAIL (%s wrote with count 0)\n", name);
+        return 1;
+    }
+    return 0;
+}
+
+static int test_batch(void)
+{
+    printf("  Testing vector_{add,sub,mul}_f32_batch at every level... ");
+
+    // Public symbols, which also link the feature objects for the registry
+    if (check_batch("vector_add_f32_batch", vector_add_f32_batch, '+') ||
+        check_batch("vector_sub_f32_batch", vector_sub_f32_batch, '-') ||
+        check_batch("vector_mul_f32_batch", vector_mul_f32_batch, '*'))
+        return 1;
+
+    const struct { const char *name; char op; } ops[] = {
+        { "vector_add_f32_batch", '+' }, { "vector_sub_f32_batch", '-' }, { "vector_mul_f32_batch", '*' },
+    };
+    int levels = 0;
+    for (size_t o = 0; o < sizeof(ops) / sizeof(ops[0]); o++) {
+        for (int l = SIMD_SCALAR; l <= SIMD_RVV; l++) {
+            batch_fn f = (batch_fn)dynemit_get_kernel(ops[o].name, (simd_level_t)l);
+            if (!f)
+                continue;
+            if (check_batch(ops[o].name, f, ops[o].op))
+                return 1;
+            levels++;
+        }
+    }
+
+    printf("OK (%d kernels)\n", levels);
+    return 0;
+}
+
+static int test_strided(void)
+{
+    printf("  Testing vector_{add,sub,mul}_f32_batch_strided at every level... ");
+
+    if (check_strided("vector_add_f32_batch_strided", vector_add_f32_batch_strided, '+') ||
+        check_strided("vector_sub_f32_batch_strided", vector_sub_f32_batch_strided, '-') ||
+        check_strided("vector_mul_f32_batch_strided", vector_mul_f32_batch_strided, '*'))
+        return 1;
+
+    const struct { const char *name; char op; } ops[] = {
+        { "vector_add_f32_batch_strided", '+' }, { "vector_sub_f32_batch_strided", '-' },
+        { "vector_mul_f32_batch_strided", '*' },
+    };
+    int levels = 0;
+    for (size_t o = 0; o < sizeof(ops) / sizeof(ops[0]); o++) {
+        for (int l = SIMD_SCALAR; l <= SIMD_RVV; l++) {
+            strided_fn f = (strided_fn)dynemit_get_kernel(ops[o].name, (simd_level_t)l);
+            if (!f)
+                continue;
+            if (check_strided(ops[o].name, f, ops[o].op))
+                return 1;
+            levels++;
+        }
+    }
+
+    printf("OK (%d kernels)\n", levels);
+    return 0;
+}
+
+int main(void)
+{
+    int failures = 0;
+
+    printf("Testing batched element-wise operations:\n");
+    printf("  Current SIMD level: %s\n\n", simd_level_name(detect_simd_level()));
+
+    for (size_t i = 0; i < COUNT * STRIDE; i++) {
+        a[i] = (float)(i % 101) * 0.5f - 20.0f;
+        b[i] = (float)(i % 7) + 0.25f;
+    }
+
+    failures += test_batch();
+    failures += test_strided();
+
+    printf("\n");
+    if (failures == 0) {
+        printf("All tests passed!\n");
+        return 0;
+    } else {
+        printf("%d test(s) failed!\n", failures);
+        return 1;
+    }
+}
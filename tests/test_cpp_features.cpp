@@ -23,7 +23,11 @@ int main()
         SIMD_SSE4_2,
         SIMD_AVX,
         SIMD_AVX2,
-        SIMD_AVX512F
+        SIMD_AVX512F,
+        SIMD_NEON,
+        SIMD_SVE,
+        SIMD_SVE2,
+        SIMD_RVV
     };
     
     const char* expected_names[] = {
@@ -32,7 +36,11 @@ int main()
         "SSE4.2",
         "AVX",
         "AVX2",
-        "AVX-512F"
+        "AVX-512F",
+        "NEON",
+        "SVE",
+        "SVE2",
+        "RVV"
     };
     
     bool enum_test_ok = true;
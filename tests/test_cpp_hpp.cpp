@@ -0,0 +1,209 @@
+/**
+ * C++ Header API Test
+ *
+ * Checks that the dynemit.hpp wrappers produce the same results as the C
+ * kernels, both when they are bound at compile time and when they forward to
+ * the ifunc symbols. This file is built several times with different -m
+ * flags; test_cpp_hpp_main.cpp checks the CPU before calling in.
+ */
+
+#include <dynemit.hpp>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+constexpr std::size_t MAX_N = 300;
+// Larger than dynemit::inline_max_elements, so the library path is exercised too
+constexpr std::size_t LARGE_N = 5003;
+
+bool same(const std::vector<float> &x, const std::vector<float> &y, std::size_t n)
+{
+    return std::memcmp(x.data(), y.data(), n * sizeof(float)) == 0;
+}
+
+int test_elementwise(const std::vector<float> &a, const std::vector<float> &b, const std::vector<float> &c)
+{
+    std::printf("  Testing element-wise wrappers against C kernels... ");
+
+    std::vector<float> got(LARGE_N), want(LARGE_N);
+    for (std::size_t n = 0; n <= LARGE_N; n = n < MAX_N ? n + 1 : n + (LARGE_N - MAX_N)) {
+        dynemit::add(a.data(), b.data(), got.data(), n);
+        vector_add_f32(a.data(), b.data(), want.data(), n);
+        if (!same(got, want, n)) { std::printf("FAIL (add, n=%zu)\n", n); return 1; }
+
+        dynemit::sub(a.data(), b.data(), got.data(), n);
+        vector_sub_f32(a.data(), b.data(), want.data(), n);
+        if (!same(got, want, n)) { std::printf("FAIL (sub, n=%zu)\n", n); return 1; }
+
+        dynemit::mul(a.data(), b.data(), got.data(), n);
+        vector_mul_f32(a.data(), b.data(), want.data(), n);
+        if (!same(got, want, n)) { std::printf("FAIL (mul, n=%zu)\n", n); return 1; }
+
+        dynemit::fma(a.data(), b.data(), c.data(), got.data(), n);
+        vector_fma_f32(a.data(), b.data(), c.data(), want.data(), n);
+        if (!same(got, want, n)) { std::printf("FAIL (fma, n=%zu)\n", n); return 1; }
+
+        got = c;
+        want = c;
+        dynemit::axpy(0.75f, a.data(), got.data(), n);
+        vector_axpy_f32(0.75f, a.data(), want.data(), n);
+        if (!same(got, want, n)) { std::printf("FAIL (axpy, n=%zu)\n", n); return 1; }
+    }
+
+    std::printf("OK\n");
+    return 0;
+}
+
+int test_spans(const std::vector<float> &a, const std::vector<float> &b)
+{
+    std::printf("  Testing span overloads with STL containers... ");
+
+    std::array<float, 37> out{};
+    std::vector<float> want(37);
+    std::span<const float> sa(a.data(), 37), sb(b.data(), 37);
+
+    dynemit::mul(sa, sb, out);
+    vector_mul_f32(a.data(), b.data(), want.data(), 37);
+    if (std::memcmp(out.data(), want.data(), sizeof(out)) != 0) {
+        std::printf("FAIL (mul span)\n");
+        return 1;
+    }
+
+    std::vector<float> y(a.begin(), a.begin() + 37);
+    dynemit::axpy(2.0f, sb, y);
+    for (std::size_t i = 0; i < 37; i++) {
+        if (y[i] != 2.0f * b[i] + a[i]) { std::printf("FAIL (axpy span)\n"); return 1; }
+    }
+
+    if (dynemit::dot(sa, sb) != dot_f32(a.data(), b.data(), 37) ||
+        dynemit::sum(sa) != sum_f32(a.data(), 37) ||
+        dynemit::norm2(sa) != norm2_f32(a.data(), 37)) {
+        std::printf("FAIL (reductions)\n");
+        return 1;
+    }
+
+    dynemit::minmax_result r = dynemit::minmax(sa);
+    float lo, hi;
+    minmax_f32(a.data(), 37, &lo, &hi);
+    if (r.min != lo || r.max != hi) {
+        std::printf("FAIL (minmax)\n");
+        return 1;
+    }
+
+    std::printf("OK\n");
+    return 0;
+}
+
+int test_typed_overloads()
+{
+    std::printf("  Testing double/int32_t/int16_t overloads... ");
+
+    std::vector<double> da{1.5, -2.0, 3.25}, db{0.5, 4.0, -1.0}, dout(3);
+    std::array<std::int32_t, 3> ia{INT32_MAX, 7, -9}, ib{1, 6, 9}, iout{};
+    std::array<std::int16_t, 3> sa{INT16_MAX, -300, 200}, sb{1, 200, 200}, sout{};
+
+    dynemit::add(std::span<const double>(da), std::span<const double>(db), std::span<double>(dout));
+    dynemit::mul(ia.data(), ib.data(), iout.data(), ia.size());
+    dynemit::mul(std::span<const std::int16_t>(sa), std::span<const std::int16_t>(sb),
+                 std::span<std::int16_t>(sout));
+    if (dout[0] != 2.0 || dout[1] != 2.0 || dout[2] != 2.25 ||
+        iout[0] != INT32_MAX || iout[1] != 42 || iout[2] != -81 ||
+        sout[0] != INT16_MAX || sout[1] != INT16_MIN || sout[2] != INT16_MAX) {
+        std::printf("FAIL\n");
+        return 1;
+    }
+
+    std::printf("OK\n");
+    return 0;
+}
+
+#if defined(__cpp_impl_coroutine)
+
+// Coroutine that starts at once and frees itself when it returns
+struct detached {
+    struct promise_type {
+        detached get_return_object() noexcept { return {}; }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() noexcept {}
+        void unhandled_exception() noexcept { std::abort(); }
+    };
+};
+
+// out = a * b + c through a temporary, awaiting each step in turn, then
+// out2 = out - c as a dependency of a future that is not awaited first
+detached pipeline(dynemit::queue &q, const float *a, const float *b, const float *c, float *t, float *out,
+                  float *out2, std::size_t n, std::atomic<int> &state)
+{
+    dynemit::future f = q.mul(a, b, t, n);
+    co_await f;
+    dynemit::future g = q.add(t, c, out, n);
+    dynemit::future h = q.sub(out, c, out2, n, g);
+    co_await h;
+    state.store(g.ready() ? 1 : 2);
+    state.notify_all();
+}
+
+int test_queue(const std::vector<float> &a, const std::vector<float> &b, const std::vector<float> &c)
+{
+    std::printf("  Testing co_await on queue futures... ");
+
+    const std::size_t n = LARGE_N;
+    std::vector<float> t(n), out(n), out2(n), want(n), want2(n);
+    vector_mul_f32(a.data(), b.data(), want.data(), n);
+    vector_add_f32(want.data(), c.data(), want.data(), n);
+    vector_sub_f32(want.data(), c.data(), want2.data(), n);
+
+    dynemit::queue q;
+    if (!q) {
+        std::printf("FAIL (queue not created)\n");
+        return 1;
+    }
+    std::atomic<int> state{0};
+    pipeline(q, a.data(), b.data(), c.data(), t.data(), out.data(), out2.data(), n, state);
+    state.wait(0);
+    q.wait_all();
+
+    if (state.load() != 1 || !same(out, want, n) || !same(out2, want2, n)) {
+        std::printf("FAIL (state %d)\n", state.load());
+        return 1;
+    }
+
+    std::printf("OK\n");
+    return 0;
+}
+
+#endif
+
+} // namespace
+
+int run_hpp_tests()
+{
+    std::printf("C++ Header API Test\n");
+    std::printf("===================\n\n");
+    std::printf("  Compile-time level: %s (%s)\n", simd_level_name(dynemit::compile_time_level),
+                dynemit::compile_time_dispatch ? "inlined kernels" : "ifunc dispatch");
+    std::printf("  Runtime level:      %s\n\n", simd_level_name(detect_simd_level()));
+
+    std::vector<float> a(LARGE_N), b(LARGE_N), c(LARGE_N);
+    for (std::size_t i = 0; i < LARGE_N; i++) {
+        a[i] = static_cast<float>(i % 97) * 0.37f - 11.0f;
+        b[i] = static_cast<float>(i % 13) * 1.25f + 0.5f;
+        c[i] = static_cast<float>(i % 31) * -0.125f;
+    }
+
+    int failures = 0;
+    failures += test_elementwise(a, b, c);
+    failures += test_spans(a, b);
+    failures += test_typed_overloads();
+#if defined(__cpp_impl_coroutine)
+    failures += test_queue(a, b, c);
+#endif
+    return failures;
+}
@@ -0,0 +1,34 @@
+/**
+ * Entry point for the dynemit.hpp tests.
+ *
+ * Compiled without -m flags so the CPU check below is safe to run anywhere;
+ * the test body in test_cpp_hpp.cpp may be built for a higher level.
+ */
+
+#include <dynemit/core.h>
+#include <cstdio>
+
+#ifndef HPP_REQUIRED_FEATURES
+#define HPP_REQUIRED_FEATURES 0
+#endif
+
+int run_hpp_tests();
+
+int main()
+{
+    if (!dynemit_cpu_has(HPP_REQUIRED_FEATURES)) {
+        std::printf("CPU lacks the instruction set this test was built for, skipping\n");
+        return 0;
+    }
+
+    int failures = run_hpp_tests();
+
+    std::printf("\n");
+    if (failures == 0) {
+        std::printf("All tests passed!\n");
+        return 0;
+    } else {
+        std::printf("%d test(s) failed!\n", failures);
+        return 1;
+    }
+}
@@ -0,0 +1,190 @@
+/**
+ * @file test_cpu_features.c
+ * @brief Tests for the dynemit_cpu_features() bitmask detection API
+ */
+
+#include <dynemit/core.h>
+#include <stdio.h>
+#include <string.h>
+
+// Highest DYNEMIT_CPU_* bit currently defined in <dynemit/core.h>
+#define LAST_FEATURE_BIT 31
+
+/**
+ * Print every detected feature (useful when reading CI logs)
+ */
+static void print_features(uint64_t features)
+{
+    printf("  Detected features:");
+    for (int bit = 0; bit <= LAST_FEATURE_BIT; bit++) {
+        uint64_t flag = UINT64_C(1) << bit;
+        if (features & flag)
+            printf(" %s", dynemit_cpu_feature_name(flag));
+    }
+    printf("\n\n");
+}
+
+/**
+ * Test that repeated calls return the same cached value
+ */
+static int test_caching(void)
+{
+    printf("  Testing caching behavior... ");
+
+    uint64_t first = dynemit_cpu_features();
+    uint64_t second = dynemit_cpu_features();
+
+    if (first != second) {
+        printf("FAIL\n");
+        printf("    Results differ: 0x%llx, 0x%llx\n",
+               (unsigned long long)first, (unsigned long long)second);
+        return 1;
+    }
+
+    printf("OK (0x%llx)\n", (unsigned long long)first);
+    return 0;
+}
+
+/**
+ * Test that the bitmask agrees with the simd_level_t ladder
+ */
+static int test_consistency_with_simd_level(void)
+{
+    printf("  Testing consistency with detect_simd_level()... ");
+
+    uint64_t f = dynemit_cpu_features();
+    simd_level_t level = detect_simd_level();
+
+    simd_level_t expected = SIMD_SCALAR;
+    if (f & DYNEMIT_CPU_SSE2)    expected = SIMD_SSE2;
+    if (f & DYNEMIT_CPU_SSE4_2)  expected = SIMD_SSE4_2;
+    if (f & DYNEMIT_CPU_AVX)     expected = SIMD_AVX;
+    if (f & DYNEMIT_CPU_AVX2)    expected = SIMD_AVX2;
+    if (f & DYNEMIT_CPU_AVX512F) expected = SIMD_AVX512F;
+    if (f & DYNEMIT_CPU_NEON)    expected = SIMD_NEON;
+    if (f & DYNEMIT_CPU_SVE)     expected = SIMD_SVE;
+    if (f & DYNEMIT_CPU_SVE2)    expected = SIMD_SVE2;
+    if (f & DYNEMIT_CPU_RVV)     expected = SIMD_RVV;
+
+    if (level != expected) {
+        printf("FAIL\n");
+        printf("    detect_simd_level() = %s, bitmask implies %s\n",
+               simd_level_name(level), simd_level_name(expected));
+        return 1;
+    }
+
+    printf("OK (%s)\n", simd_level_name(level));
+    return 0;
+}
+
+/**
+ * Test that dependent features are only reported with their prerequisites
+ */
+static int test_feature_dependencies(void)
+{
+    printf("  Testing feature dependencies... ");
+
+    uint64_t f = dynemit_cpu_features();
+    const uint64_t needs_avx = DYNEMIT_CPU_FMA | DYNEMIT_CPU_F16C |
+                               DYNEMIT_CPU_AVX2 | DYNEMIT_CPU_AVX_VNNI;
+    const uint64_t needs_avx512f = DYNEMIT_CPU_AVX512CD | DYNEMIT_CPU_AVX512BW |
+                                   DYNEMIT_CPU_AVX512DQ | DYNEMIT_CPU_AVX512VL |
+                                   DYNEMIT_CPU_AVX512VNNI | DYNEMIT_CPU_AVX512BF16 |
+                                   DYNEMIT_CPU_AVX512FP16;
+    const uint64_t needs_amx_tile = DYNEMIT_CPU_AMX_INT8 | DYNEMIT_CPU_AMX_BF16;
+
+    if ((f & needs_avx) && !(f & DYNEMIT_CPU_AVX)) {
+        printf("FAIL (VEX feature reported without AVX)\n");
+        return 1;
+    }
+    if ((f & needs_avx512f) && !(f & DYNEMIT_CPU_AVX512F)) {
+        printf("FAIL (AVX-512 subset reported without AVX-512F)\n");
+        return 1;
+    }
+    if ((f & needs_amx_tile) && !(f & DYNEMIT_CPU_AMX_TILE)) {
+        printf("FAIL (AMX type reported without AMX-TILE)\n");
+        return 1;
+    }
+    if ((f & DYNEMIT_CPU_AVX10_2) && !(f & DYNEMIT_CPU_AVX10_1)) {
+        printf("FAIL (AVX10.2 reported without AVX10.1)\n");
+        return 1;
+    }
+
+    printf("OK\n");
+    return 0;
+}
+
+/**
+ * Test dynemit_cpu_has() against the raw bitmask
+ */
+static int test_cpu_has(void)
+{
+    printf("  Testing dynemit_cpu_has()... ");
+
+    uint64_t f = dynemit_cpu_features();
+
+    if (!dynemit_cpu_has(0)) {
+        printf("FAIL (empty mask must be satisfied)\n");
+        return 1;
+    }
+    if (!dynemit_cpu_has(f)) {
+        printf("FAIL (full detected mask not satisfied)\n");
+        return 1;
+    }
+    for (int bit = 0; bit <= LAST_FEATURE_BIT; bit++) {
+        uint64_t flag = UINT64_C(1) << bit;
+        if (dynemit_cpu_has(flag) != ((f & flag) != 0)) {
+            printf("FAIL (%s)\n", dynemit_cpu_feature_name(flag));
+            return 1;
+        }
+    }
+
+    printf("OK\n");
+    return 0;
+}
+
+/**
+ * Test that every defined flag has a name and combinations do not
+ */
+static int test_feature_names(void)
+{
+    printf("  Testing feature names... ");
+
+    for (int bit = 0; bit <= LAST_FEATURE_BIT; bit++) {
+        uint64_t flag = UINT64_C(1) << bit;
+        if (strcmp(dynemit_cpu_feature_name(flag), "Unknown") == 0) {
+            printf("FAIL (bit %d has no name)\n", bit);
+            return 1;
+        }
+    }
+    if (strcmp(dynemit_cpu_feature_name(DYNEMIT_CPU_AVX | DYNEMIT_CPU_FMA), "Unknown") != 0) {
+        printf("FAIL (combined mask should be Unknown)\n");
+        return 1;
+    }
+
+    printf("OK\n");
+    return 0;
+}
+
+int main(void)
+{
+    int failures = 0;
+
+    printf("Testing dynemit_cpu_features():\n");
+    print_features(dynemit_cpu_features());
+
+    failures += test_caching();
+    failures += test_consistency_with_simd_level();
+    failures += test_feature_dependencies();
+    failures += test_cpu_has();
+    failures += test_feature_names();
+
+    printf("\n");
+    if (failures == 0) {
+        printf("All tests passed!\n");
+        return 0;
+    } else {
+        printf("%d test(s) failed!\n", failures);
+        return 1;
+    }
+}
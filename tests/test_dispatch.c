@@ -0,0 +1,257 @@
+/**
+ * @file test_dispatch.c
+ * @brief Tests for the DYNEMIT_MAX_LEVEL cap and the dynemit_get_kernel() registry
+ */
+
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <dynemit.h>
+
+typedef void (*mul_fn)(const float *, const float *, float *, size_t);
+
+// Covers every tail length of every SIMD width
+#define MAX_N 70
+
+// Hardware level, without the DYNEMIT_MAX_LEVEL cap
+static simd_level_t hw_level;
+
+// SIMD_SCALAR, or both levels from the x86, aarch64 or RISC-V ladder
+static int same_ladder(simd_level_t a, simd_level_t b)
+{
+    int la = a == SIMD_SCALAR ? 0 : a <= SIMD_AVX512F ? 1 : a <= SIMD_SVE2 ? 2 : 3;
+    int lb = b == SIMD_SCALAR ? 0 : b <= SIMD_AVX512F ? 1 : b <= SIMD_SVE2 ? 2 : 3;
+    return la == 0 || lb == 0 || la == lb;
+}
+
+static int test_level_names(void)
+{
+    printf("  Testing simd_level_from_name... ");
+
+    const struct { const char *name; simd_level_t level; } cases[] = {
+        { "scalar", SIMD_SCALAR }, { "SSE2", SIMD_SSE2 }, { "sse4.2", SIMD_SSE4_2 },
+        { "sse4_2", SIMD_SSE4_2 }, { "avx", SIMD_AVX }, { "Avx2", SIMD_AVX2 },
+        { "avx512f", SIMD_AVX512F }, { "avx512", SIMD_AVX512F }, { "NEON", SIMD_NEON },
+        { "asimd", SIMD_NEON }, { "sve", SIMD_SVE }, { "SVE2", SIMD_SVE2 }, { "rvv", SIMD_RVV },
+    };
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        simd_level_t level;
+        if (simd_level_from_name(cases[i].name, &level) != 0 || level != cases[i].level) {
+            printf("FAIL (\"%s\")\n", cases[i].name);
+            return 1;
+        }
+    }
+
+    // Every name simd_level_name() produces parses back
+    for (int l = SIMD_SCALAR; l <= SIMD_RVV; l++) {
+        simd_level_t level;
+        if (simd_level_from_name(simd_level_name((simd_level_t)l), &level) != 0 || (int)level != l) {
+            printf("FAIL (round trip of %s)\n", simd_level_name((simd_level_t)l));
+            return 1;
+        }
+    }
+
+    simd_level_t level = SIMD_AVX;
+    if (simd_level_from_name("avx3", &level) == 0 || simd_level_from_name("", &level) == 0 ||
+        simd_level_from_name(nullptr, &level) == 0 || level != SIMD_AVX) {
+        printf("FAIL (accepted an invalid name)\n");
+        return 1;
+    }
+
+    printf("OK\n");
+    return 0;
+}
+
+static int test_max_level(void)
+{
+    printf("  Testing DYNEMIT_MAX_LEVEL... ");
+
+    simd_level_t expect = hw_level;
+    simd_level_t cap;
+    if (simd_level_from_name(getenv("DYNEMIT_MAX_LEVEL"), &cap) == 0 && cap < expect)
+        expect = cap;
+
+    if (detect_simd_level() != expect || detect_simd_level_ts() != expect) {
+        printf("FAIL (level %s, expect %s)\n", simd_level_name(detect_simd_level()),
+               simd_level_name(expect));
+        return 1;
+    }
+
+    // The resolvers honour the cap too: a*b + c is exact when fused, 0 when
+    // rounded first, and FMA3 kernels are only picked from AVX upwards
+    float a[16], b[16], c[16], out[16];
+    for (int i = 0; i < 16; i++) {
+        a[i] = b[i] = 1.0f + 0x1p-12f;
+        c[i] = -(1.0f + 0x1p-11f);
+    }
+    vector_fma_f32(a, b, c, out, 16);
+    int fused = expect >= SIMD_AVX && dynemit_cpu_has(DYNEMIT_CPU_FMA);
+    for (int i = 0; i < 16; i++) {
+        if (out[i] != (fused ? 0x1p-24f : 0.0f)) {
+            printf("FAIL (vector_fma_f32 %s fused at %s)\n", fused ? "not" : "",
+                   simd_level_name(expect));
+            return 1;
+        }
+    }
+
+    printf("OK (%s)\n", simd_level_name(expect));
+    return 0;
+}
+
+static int test_get_kernel(void)
+{
+    printf("  Testing dynemit_get_kernel... ");
+
+    // Reference output, and links vector_mul.o
+    float expect[MAX_N];
+
+    float a[MAX_N], b[MAX_N], out[MAX_N + 1];
+    for (int i = 0; i < MAX_N; i++) {
+        a[i] = (float)i * 0.5f - 7.0f;
+        b[i] = (float)(i % 5) + 0.25f;
+    }
+    vector_mul_f32(a, b, expect, MAX_N);
+
+    for (int l = SIMD_SCALAR; l <= SIMD_RVV; l++) {
+        mul_fn f = (mul_fn)dynemit_get_kernel("vector_mul_f32", (simd_level_t)l);
+        if (l > (int)hw_level || !same_ladder((simd_level_t)l, hw_level)) {
+            if (f) {
+                printf("FAIL (kernel returned for unsupported %s)\n", simd_level_name((simd_level_t)l));
+                return 1;
+            }
+            continue;
+        }
+        if (!f) {
+            printf("FAIL (no kernel for %s)\n", simd_level_name((simd_level_t)l));
+            return 1;
+        }
+        for (size_t n = 0; n <= MAX_N; n++) {
+            out[n] = -1.0f;
+            f(a, b, out, n);
+            for (size_t i = 0; i < n; i++) {
+                if (out[i] != expect[i]) {
+                    printf("FAIL (%s, n=%zu: out[%zu] = %f)\n", simd_level_name((simd_level_t)l), n, i, out[i]);
+                    return 1;
+                }
+            }
+            if (out[n] != -1.0f) {
+                printf("FAIL (%s, n=%zu: wrote past the end)\n", simd_level_name((simd_level_t)l), n);
+                return 1;
+            }
+        }
+    }
+
+    // The scalar and best kernels of a feature are different functions
+#if defined(__riscv) && !defined(DYNEMIT_HAVE_RVV)
+    const int has_simd = 0;  // compiler without RVV support: scalar only
+#else
+    const int has_simd = hw_level > SIMD_SCALAR;
+#endif
+    if (has_simd &&
+        dynemit_get_kernel("vector_fma_f32", SIMD_SCALAR) == dynemit_get_kernel("vector_fma_f32", hw_level)) {
+        printf("FAIL (vector_fma_f32 scalar and %s kernels are identical)\n", simd_level_name(hw_level));
+        return 1;
+    }
+
+    // Every dispatched function registers its selector. Taking the address
+    // makes sure each feature's object file is linked from the archive
+    const struct { const char *name; dynemit_kernel_t fn; } funcs[] = {
+        { "vector_add_f32", (dynemit_kernel_t)vector_add_f32 },
+        { "vector_sub_f32", (dynemit_kernel_t)vector_sub_f32 },
+        { "vector_add_i16", (dynemit_kernel_t)vector_add_i16 },
+        { "vector_mul_f64", (dynemit_kernel_t)vector_mul_f64 },
+        { "vector_axpy_f32", (dynemit_kernel_t)vector_axpy_f32 },
+        { "dot_f32", (dynemit_kernel_t)dot_f32 },
+        { "minmax_f32", (dynemit_kernel_t)minmax_f32 },
+        { "norm2_f32_det", (dynemit_kernel_t)norm2_f32_det },
+        { "dot_f16", (dynemit_kernel_t)dot_f16 },
+        { "vector_mul_bf16_f32", (dynemit_kernel_t)vector_mul_bf16_f32 },
+    };
+    for (size_t i = 0; i < sizeof(funcs) / sizeof(funcs[0]); i++) {
+        if (!funcs[i].fn || !dynemit_get_kernel(funcs[i].name, SIMD_SCALAR)) {
+            printf("FAIL (%s not registered)\n", funcs[i].name);
+            return 1;
+        }
+    }
+
+    if (dynemit_get_kernel("vector_mul_f33", SIMD_SCALAR) || dynemit_get_kernel(nullptr, SIMD_SCALAR)) {
+        printf("FAIL (unknown name returned a kernel)\n");
+        return 1;
+    }
+
+    printf("OK\n");
+    return 0;
+}
+
+static int test_list_kernels(void)
+{
+    printf("  Testing dynemit_list_kernels... ");
+
+    size_t count = dynemit_list_kernels(nullptr, 0);
+    dynemit_kernel_info_t kernels[512];
+    if (count == 0 || count > 512 || dynemit_list_kernels(kernels, 512) != count) {
+        printf("FAIL (%zu kernels)\n", count);
+        return 1;
+    }
+
+    // Prototypes are the declarations as written, after macro expansion
+    const struct { const char *name, *prototype; } expect[] = {
+        { "vector_add_f32", "void (const float *a, const float *b, float *out, size_t n)" },
+        { "vector_mul_f64", "void (const double *a, const double *b, double *out, size_t n)" },
+        { "dot_f32", "float (const float *a, const float *b, size_t n)" },
+    };
+    for (size_t i = 0; i < sizeof(expect) / sizeof(expect[0]); i++) {
+        size_t k = 0;
+        while (k < count && strcmp(kernels[k].name, expect[i].name) != 0)
+            k++;
+        if (k == count || !kernels[k].prototype || strcmp(kernels[k].prototype, expect[i].prototype) != 0) {
+            printf("FAIL (%s: %s)\n", expect[i].name, k < count ? kernels[k].prototype : "not listed");
+            return 1;
+        }
+        if (!dynemit_get_kernel(kernels[k].name, SIMD_SCALAR)) {
+            printf("FAIL (%s listed but not found)\n", expect[i].name);
+            return 1;
+        }
+    }
+
+    printf("OK (%zu functions)\n", count);
+    return 0;
+}
+
+int main(void)
+{
+    int failures = 0;
+
+    // The feature bits are not capped, so they give the hardware level
+    uint64_t f = dynemit_cpu_features();
+    hw_level = (f & DYNEMIT_CPU_SVE2)    ? SIMD_SVE2
+             : (f & DYNEMIT_CPU_SVE)     ? SIMD_SVE
+             : (f & DYNEMIT_CPU_NEON)    ? SIMD_NEON
+             : (f & DYNEMIT_CPU_RVV)     ? SIMD_RVV
+             : (f & DYNEMIT_CPU_AVX512F) ? SIMD_AVX512F
+             : (f & DYNEMIT_CPU_AVX2)    ? SIMD_AVX2
+             : (f & DYNEMIT_CPU_AVX)     ? SIMD_AVX
+             : (f & DYNEMIT_CPU_SSE4_2)  ? SIMD_SSE4_2
+             : (f & DYNEMIT_CPU_SSE2)    ? SIMD_SSE2
+             : SIMD_SCALAR;
+
+    printf("Testing SIMD level override and kernel registry:\n");
+    printf("  Hardware SIMD level: %s\n", simd_level_name(hw_level));
+    printf("  Current SIMD level: %s\n\n", simd_level_name(detect_simd_level()));
+
+    failures += test_level_names();
+    failures += test_max_level();
+    failures += test_get_kernel();
+    failures += test_list_kernels();
+
+    printf("\n");
+    if (failures == 0) {
+        printf("All tests passed!\n");
+        return 0;
+    } else {
+        printf("%d test(s) failed!\n", failures);
+        return 1;
+    }
+}
@@ -0,0 +1,231 @@
+/**
+ * @file test_expr.c
+ * @brief Tests for fused expression evaluation
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <dynemit.h>
+
+// Around the chunk size, so partial and multiple chunks are covered
+#define MAX_N (3 * DYNEMIT_EXPR_CHUNK + 17)
+
+static float a[MAX_N], b[MAX_N], c[MAX_N], d[MAX_N];
+static float out[MAX_N + 1], ref[MAX_N], tmp[MAX_N];
+
+static const size_t sizes[] = { 0, 1, 15, DYNEMIT_EXPR_CHUNK - 1, DYNEMIT_EXPR_CHUNK,
+                                DYNEMIT_EXPR_CHUNK + 1, MAX_N };
+
+static int check(const char *name, size_t n)
+{
+    for (size_t i = 0; i < n; i++) {
+        if (out[i] != ref[i]) {
+            printf("FAIL (%s, n=%zu: out[%zu] = %f, expect %f)\n", name, n, i, out[i], ref[i]);
+            return 1;
+        }
+    }
+    if (out[n] != -1.0f) {
+        printf("FAIL (%s, n=%zu: wrote past the end)\n", name, n);
+        return 1;
+    }
+    return 0;
+}
+
+static int test_chain(void)
+{
+    printf("  Testing (a*b - c) + d against chained calls... ");
+
+    dynemit_expr *e = dynemit_expr_create();
+    int root = dynemit_expr_add(e,
+                   dynemit_expr_sub(e, dynemit_expr_mul(e, dynemit_expr_input(e, 0), dynemit_expr_input(e, 1)),
+                                    dynemit_expr_input(e, 2)),
+                   dynemit_expr_input(e, 3));
+    const float *in[] = { a, b, c, d };
+
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+        size_t n = sizes[s];
+        vector_mul_f32(a, b, tmp, n);
+        vector_sub_f32(tmp, c, tmp, n);
+        vector_add_f32(tmp, d, ref, n);
+        out[n] = -1.0f;
+        if (dynemit_expr_eval(e, root, in, out, n) != 0 || check("chain", n)) {
+            dynemit_expr_destroy(e);
+            return 1;
+        }
+    }
+
+    dynemit_expr_destroy(e);
+    printf("OK\n");
+    return 0;
+}
+
+static int test_shapes(void)
+{
+    printf("  Testing constants, fma, shared operands and in-place output... ");
+
+    dynemit_expr *e = dynemit_expr_create();
+    int x = dynemit_expr_input(e, 0);
+    int y = dynemit_expr_input(e, 1);
+    int k = dynemit_expr_const(e, 0.75f);
+    int xx = dynemit_expr_mul(e, x, x);                  // repeated operand
+    int f = dynemit_expr_fma(e, xx, k, y);               // x*x*0.75 + y
+    int g = dynemit_expr_sub(e, f, dynemit_expr_mul(e, xx, y));
+    int unused = dynemit_expr_add(e, x, y);              // not reachable from g
+    const float *in[] = { a, b };
+    size_t n = MAX_N;
+
+    (void)unused;
+    vector_mul_f32(a, a, tmp, n);
+    for (size_t i = 0; i < n; i++)
+        ref[i] = 0.75f;
+    vector_fma_f32(tmp, ref, b, ref, n);
+    vector_mul_f32(tmp, b, tmp, n);
+    vector_sub_f32(ref, tmp, ref, n);
+
+    out[n] = -1.0f;
+    if (dynemit_expr_eval(e, g, in, out, n) != 0 || check("constant/fma", n)) {
+        dynemit_expr_destroy(e);
+        return 1;
+    }
+
+    // Output over its own input
+    float *inplace = malloc(n * sizeof(float));
+    memcpy(inplace, a, n * sizeof(float));
+    const float *in2[] = { inplace, b };
+    dynemit_expr_eval(e, g, in2, inplace, n);
+    if (memcmp(inplace, ref, n * sizeof(float)) != 0) {
+        printf("FAIL (in-place output)\n");
+        free(inplace);
+        dynemit_expr_destroy(e);
+        return 1;
+    }
+    free(inplace);
+
+    // Bare input and constant as root
+    out[n] = -1.0f;
+    memcpy(ref, b, n * sizeof(float));
+    if (dynemit_expr_eval(e, y, in, out, n) != 0 || check("input root", n)) {
+        dynemit_expr_destroy(e);
+        return 1;
+    }
+    for (size_t i = 0; i < n; i++)
+        ref[i] = 0.75f;
+    if (dynemit_expr_eval(e, k, in, out, n) != 0 || check("constant root", n)) {
+        dynemit_expr_destroy(e);
+        return 1;
+    }
+
+    dynemit_expr_destroy(e);
+    printf("OK\n");
+    return 0;
+}
+
+static int test_wide(void)
+{
+    printf("  Testing many live intermediates... ");
+
+    // Six products, all live until the sums below, plus a constant: more
+    // scratch chunks than the evaluator keeps on the stack
+    dynemit_expr *e = dynemit_expr_create();
+    int x[4];
+    for (unsigned i = 0; i < 4; i++)
+        x[i] = dynemit_expr_input(e, i);
+    int k = dynemit_expr_const(e, 0.5f);
+    int p[6], np = 0;
+    for (int i = 0; i < 4; i++)
+        for (int j = i + 1; j < 4; j++)
+            p[np++] = dynemit_expr_mul(e, x[i], x[j]);
+    int root = k;
+    for (int i = 0; i < 6; i++)
+        root = dynemit_expr_add(e, root, p[i]);
+    const float *in[] = { a, b, c, d };
+    const float *arr[] = { a, b, c, d };
+    size_t n = MAX_N;
+
+    for (size_t i = 0; i < n; i++)
+        ref[i] = 0.5f;
+    for (int i = 0; i < 4; i++) {
+        for (int j = i + 1; j < 4; j++) {
+            vector_mul_f32(arr[i], arr[j], tmp, n);
+            vector_add_f32(ref, tmp, ref, n);
+        }
+    }
+
+    out[n] = -1.0f;
+    if (dynemit_expr_eval(e, root, in, out, n) != 0 || check("wide", n)) {
+        dynemit_expr_destroy(e);
+        return 1;
+    }
+
+    dynemit_expr_destroy(e);
+    printf("OK\n");
+    return 0;
+}
+
+static int test_errors(void)
+{
+    printf("  Testing invalid nodes... ");
+
+    dynemit_expr *e = dynemit_expr_create();
+    int x = dynemit_expr_input(e, 0);
+    const float *in[] = { a };
+
+    if (dynemit_expr_input(e, DYNEMIT_EXPR_MAX_INPUTS) != -1 ||
+        dynemit_expr_add(e, x, 5) != -1 || dynemit_expr_mul(e, -1, x) != -1 ||
+        dynemit_expr_fma(e, x, x, -1) != -1) {
+        printf("FAIL (invalid operand accepted)\n");
+        dynemit_expr_destroy(e);
+        return 1;
+    }
+    if (dynemit_expr_eval(e, -1, in, out, 4) != -1 || dynemit_expr_eval(e, 1, in, out, 4) != -1 ||
+        dynemit_expr_eval(nullptr, 0, in, out, 4) != -1) {
+        printf("FAIL (invalid root accepted)\n");
+        dynemit_expr_destroy(e);
+        return 1;
+    }
+
+    // Full expression
+    int last = x;
+    for (int i = 1; i < DYNEMIT_EXPR_MAX_NODES; i++)
+        last = dynemit_expr_add(e, last, x);
+    if (last < 0 || dynemit_expr_add(e, last, x) != -1) {
+        printf("FAIL (node limit)\n");
+        dynemit_expr_destroy(e);
+        return 1;
+    }
+
+    dynemit_expr_destroy(e);
+    dynemit_expr_destroy(nullptr);
+    printf("OK\n");
+    return 0;
+}
+
+int main(void)
+{
+    int failures = 0;
+
+    printf("Testing fused expressions:\n");
+    printf("  Current SIMD level: %s\n\n", simd_level_name(detect_simd_level()));
+
+    for (int i = 0; i < MAX_N; i++) {
+        a[i] = (float)(i % 101) * 0.37f - 15.0f;
+        b[i] = (float)(i % 13) * 1.13f + 0.5f;
+        c[i] = (float)(i % 29) - 14.0f;
+        d[i] = 1.0f / (float)(i + 1);
+    }
+
+    failures += test_chain();
+    failures += test_shapes();
+    failures += test_wide();
+    failures += test_errors();
+
+    printf("\n");
+    if (failures == 0) {
+        printf("All tests passed!\n");
+        return 0;
+    } else {
+        printf("%d test(s) failed!\n", failures);
+        return 1;
+    }
+}
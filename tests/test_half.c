@@ -0,0 +1,230 @@
+/**
+ * @file test_half.c
+ * @brief Tests for the fp16/bf16 conversion, add/mul and dot kernels
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#include <dynemit.h>
+
+// Covers every tail length of every SIMD width (up to 64 bf16 per dot step)
+#define MAX_N 140
+#define GUARD 8
+#define SENTINEL 0xabcd
+
+static dynemit_f16_t ha[MAX_N], hb[MAX_N], hout[MAX_N + GUARD];
+static dynemit_bf16_t ba[MAX_N], bb[MAX_N], bout[MAX_N + GUARD];
+static float fout[MAX_N + GUARD];
+
+static uint32_t bits(float f)
+{
+    uint32_t u;
+    memcpy(&u, &f, sizeof(u));
+    return u;
+}
+
+static float from_bits(uint32_t u)
+{
+    float f;
+    memcpy(&f, &u, sizeof(f));
+    return f;
+}
+
+static int test_conversions(void)
+{
+    printf("  Testing scalar conversions... ");
+
+    // Every finite fp16 value survives a round trip through float
+    for (uint32_t h = 0; h < 0x10000; h++) {
+        if ((h & 0x7c00) == 0x7c00 && (h & 0x3ff))
+            continue;  // NaN
+        if (dynemit_f32_to_f16(dynemit_f16_to_f32((dynemit_f16_t)h)) != h) {
+            printf("FAIL (fp16 round trip of 0x%04x)\n", h);
+            return 1;
+        }
+    }
+
+    const struct { float f; dynemit_f16_t h; } f16_cases[] = {
+        { 1.0f, 0x3c00 }, { -2.0f, 0xc000 }, { 65504.0f, 0x7bff },
+        { 65520.0f, 0x7c00 },                     // rounds up to infinity
+        { 0x1p-24f, 0x0001 },                     // smallest subnormal
+        { 0x1p-26f, 0x0000 },                     // below half of it
+        { 1.0f + 0x1p-11f, 0x3c00 },              // tie, even stays
+        { 1.0f + 3 * 0x1p-11f, 0x3c02 },          // tie, odd rounds up
+        { INFINITY, 0x7c00 }, { -INFINITY, 0xfc00 },
+    };
+    for (size_t i = 0; i < sizeof(f16_cases) / sizeof(f16_cases[0]); i++) {
+        if (dynemit_f32_to_f16(f16_cases[i].f) != f16_cases[i].h) {
+            printf("FAIL (f32_to_f16(%g) = 0x%04x, expect 0x%04x)\n", f16_cases[i].f,
+                   dynemit_f32_to_f16(f16_cases[i].f), f16_cases[i].h);
+            return 1;
+        }
+    }
+
+    const struct { uint32_t f; dynemit_bf16_t h; } bf16_cases[] = {
+        { 0x3f800000, 0x3f80 }, { 0x3f808000, 0x3f80 }, { 0x3f818000, 0x3f82 },
+        { 0x3f80c000, 0x3f81 }, { 0x7f7fffff, 0x7f80 }, { 0xff800000, 0xff80 },
+    };
+    for (size_t i = 0; i < sizeof(bf16_cases) / sizeof(bf16_cases[0]); i++) {
+        if (dynemit_f32_to_bf16(from_bits(bf16_cases[i].f)) != bf16_cases[i].h) {
+            printf("FAIL (f32_to_bf16(0x%08x) = 0x%04x)\n", bf16_cases[i].f,
+                   dynemit_f32_to_bf16(from_bits(bf16_cases[i].f)));
+            return 1;
+        }
+    }
+    if (bits(dynemit_bf16_to_f32(0x3fc0)) != 0x3fc00000) {
+        printf("FAIL (bf16_to_f32)\n");
+        return 1;
+    }
+
+    if (!isnan(dynemit_f16_to_f32(dynemit_f32_to_f16(NAN))) ||
+        !isnan(dynemit_bf16_to_f32(dynemit_f32_to_bf16(NAN)))) {
+        printf("FAIL (NaN not preserved)\n");
+        return 1;
+    }
+
+    printf("OK\n");
+    return 0;
+}
+
+static int test_f16_binary(void)
+{
+    printf("  Testing fp16 add/mul... ");
+
+    for (size_t n = 0; n <= MAX_N; n++) {
+        for (int op = 0; op < 2; op++) {
+            for (size_t i = 0; i < MAX_N + GUARD; i++) {
+                hout[i] = SENTINEL;
+                fout[i] = -1.0f;
+            }
+            if (op == 0) {
+                vector_add_f16(ha, hb, hout, n);
+                vector_add_f16_f32(ha, hb, fout, n);
+            } else {
+                vector_mul_f16(ha, hb, hout, n);
+                vector_mul_f16_f32(ha, hb, fout, n);
+            }
+            for (size_t i = 0; i < n; i++) {
+                float x = dynemit_f16_to_f32(ha[i]), y = dynemit_f16_to_f32(hb[i]);
+                float expect = op == 0 ? x + y : x * y;
+                if (hout[i] != dynemit_f32_to_f16(expect) || fout[i] != expect) {
+                    printf("FAIL (op %d, n=%zu: out[%zu] = 0x%04x / %g, expect 0x%04x / %g)\n", op, n, i,
+                           hout[i], fout[i], dynemit_f32_to_f16(expect), expect);
+                    return 1;
+                }
+            }
+            for (size_t i = n; i < MAX_N + GUARD; i++) {
+                if (hout[i] != SENTINEL || fout[i] != -1.0f) {
+                    printf("FAIL (op %d, n=%zu: wrote out[%zu])\n", op, n, i);
+                    return 1;
+                }
+            }
+        }
+    }
+
+    printf("OK\n");
+    return 0;
+}
+
+static int test_bf16_binary(void)
+{
+    printf("  Testing bf16 add/mul... ");
+
+    for (size_t n = 0; n <= MAX_N; n++) {
+        for (int op = 0; op < 2; op++) {
+            for (size_t i = 0; i < MAX_N + GUARD; i++) {
+                bout[i] = SENTINEL;
+                fout[i] = -1.0f;
+            }
+            if (op == 0) {
+                vector_add_bf16(ba, bb, bout, n);
+                vector_add_bf16_f32(ba, bb, fout, n);
+            } else {
+                vector_mul_bf16(ba, bb, bout, n);
+                vector_mul_bf16_f32(ba, bb, fout, n);
+            }
+            for (size_t i = 0; i < n; i++) {
+                float x = dynemit_bf16_to_f32(ba[i]), y = dynemit_bf16_to_f32(bb[i]);
+                float expect = op == 0 ? x + y : x * y;
+                if (bout[i] != dynemit_f32_to_bf16(expect) || fout[i] != expect) {
+                    printf("FAIL (op %d, n=%zu: out[%zu] = 0x%04x / %g, expect 0x%04x / %g)\n", op, n, i,
+                           bout[i], fout[i], dynemit_f32_to_bf16(expect), expect);
+                    return 1;
+                }
+            }
+            for (size_t i = n; i < MAX_N + GUARD; i++) {
+                if (bout[i] != SENTINEL || fout[i] != -1.0f) {
+                    printf("FAIL (op %d, n=%zu: wrote out[%zu])\n", op, n, i);
+                    return 1;
+                }
+            }
+        }
+    }
+
+    printf("OK\n");
+    return 0;
+}
+
+static int test_dot(void)
+{
+    printf("  Testing dot_f16/dot_bf16... ");
+
+    for (size_t n = 0; n <= MAX_N; n++) {
+        double ref_h = 0.0, ref_b = 0.0, mag_h = 0.0, mag_b = 0.0;
+        for (size_t i = 0; i < n; i++) {
+            double ph = (double)dynemit_f16_to_f32(ha[i]) * dynemit_f16_to_f32(hb[i]);
+            double pb = (double)dynemit_bf16_to_f32(ba[i]) * dynemit_bf16_to_f32(bb[i]);
+            ref_h += ph;
+            ref_b += pb;
+            mag_h += fabs(ph);
+            mag_b += fabs(pb);
+        }
+        // Float accumulation in an unspecified order: bound the error by the
+        // sum of magnitudes
+        float got_h = dot_f16(ha, hb, n);
+        float got_b = dot_bf16(ba, bb, n);
+        if (fabs(got_h - ref_h) > 1e-5 * (mag_h + 1.0) || fabs(got_b - ref_b) > 1e-5 * (mag_b + 1.0)) {
+            printf("FAIL (n=%zu: dot_f16 = %g, expect %g; dot_bf16 = %g, expect %g)\n",
+                   n, got_h, ref_h, got_b, ref_b);
+            return 1;
+        }
+    }
+
+    printf("OK\n");
+    return 0;
+}
+
+int main(void)
+{
+    int failures = 0;
+
+    printf("Testing fp16/bf16 kernels:\n");
+    printf("  Current SIMD level: %s\n\n", simd_level_name(detect_simd_level()));
+
+    // Inputs spanning several binades, including fp16 subnormals and sums
+    // that overflow to infinity; bf16 inputs stay in the normal range
+    for (int i = 0; i < MAX_N; i++) {
+        float x = ((float)(i % 23) - 11.0f) * 0.37f * (float)(1 << (i % 9));
+        float y = ((float)(i % 7) - 3.0f) * 1.13f;
+        ha[i] = dynemit_f32_to_f16(i % 11 == 0 ? x * 0x1p-20f : x);
+        hb[i] = dynemit_f32_to_f16(i % 13 == 0 ? 60000.0f : y);
+        ba[i] = dynemit_f32_to_bf16(x * 1e3f);
+        bb[i] = dynemit_f32_to_bf16(y * 1e-3f + 0.5f);
+    }
+
+    failures += test_conversions();
+    failures += test_f16_binary();
+    failures += test_bf16_binary();
+    failures += test_dot();
+
+    printf("\n");
+    if (failures == 0) {
+        printf("All tests passed!\n");
+        return 0;
+    } else {
+        printf("%d test(s) failed!\n", failures);
+        return 1;
+    }
+}
@@ -0,0 +1,244 @@
+/**
+ * @file test_inplace.c
+ * @brief Tests for the in-place (_ip) and broadcast-scalar add/sub/mul
+ *
+ * Every level kernel from the registry is checked against the scalar
+ * operation, bit for bit, over sizes around the vector widths and every
+ * misalignment within a cache line. Run once more with
+ * DYNEMIT_STREAM_THRESHOLD=0 so the streaming paths are taken too.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <dynemit.h>
+
+#define MAX_N 1031
+#define GUARD -1.0
+
+static const size_t sizes[] = { 0, 1, 3, 7, 8, 15, 16, 17, 31, 33, 63, 64, 65, 100, 1000, MAX_N };
+
+// Room for every misalignment of the operands within a cache line
+static float  af[MAX_N + 16] __attribute__((aligned(64)));
+static float  bf[MAX_N + 16] __attribute__((aligned(64)));
+static float  of[MAX_N + 17] __attribute__((aligned(64)));
+static double ad[MAX_N + 8] __attribute__((aligned(64)));
+static double bd[MAX_N + 8] __attribute__((aligned(64)));
+static double od[MAX_N + 9] __attribute__((aligned(64)));
+
+static const struct {
+    char op;
+    const char *name;
+} ops[] = { { '+', "add" }, { '-', "sub" }, { '*', "mul" } };
+
+static double apply(char op, double x, double y)
+{
+    return op == '+' ? x + y : op == '-' ? x - y : x * y;
+}
+
+static float apply_f(char op, float x, float y)
+{
+    return op == '+' ? x + y : op == '-' ? x - y : x * y;
+}
+
+typedef void (*scalar_f32_fn)(const float *, float, float *, size_t);
+typedef void (*ip_f32_fn)(float *, const float *, size_t);
+typedef void (*scalar_ip_f32_fn)(float *, float, size_t);
+typedef void (*scalar_f64_fn)(const double *, double, double *, size_t);
+typedef void (*ip_f64_fn)(double *, const double *, size_t);
+typedef void (*scalar_ip_f64_fn)(double *, double, size_t);
+
+/*
+ * form: 's' out = a op s, 'i' a op= b, 'j' a op= s. Results land in
+ * out (or in a, for the in-place forms) at element offset off; the element
+ * after the last must keep its guard.
+ */
+static int check_f32(const char *name, void *fn, char form, char op)
+{
+    const float s = 1.5f;
+    for (size_t off = 0; off < 16; off++) {
+        for (size_t k = 0; k < sizeof(sizes) / sizeof(sizes[0]); k++) {
+            size_t n = sizes[k];
+            float *a = af + off, *b = bf + (off * 3) % 16, *res = form == 's' ? of + off : a;
+            for (size_t i = 0; i <= n; i++) {
+                a[i] = (float)(i % 97) * 0.25f - 7.0f;
+                b[i] = (float)(i % 13) + 0.5f;
+            }
+            res[n] = (float)GUARD;
+
+            float expect[MAX_N];
+            for (size_t i = 0; i < n; i++)
+                expect[i] = apply_f(op, a[i], form == 'i' ? b[i] : s);
+
+            if (form == 's')
+                ((scalar_f32_fn)fn)(a, s, res, n);
+            else if (form == 'i')
+                ((ip_f32_fn)fn)(a, b, n);
+            else
+                ((scalar_ip_f32_fn)fn)(a, s, n);
+
+            if (memcmp(res, expect, n * sizeof(float)) != 0 || res[n] != (float)GUARD) {
+                printf("FAIL (%s, n=%zu, offset=%zu)\n", name, n, off);
+                return 1;
+            }
+        }
+    }
+    return 0;
+}
+
+static int check_f64(const char *name, void *fn, char form, char op)
+{
+    const double s = -2.25;
+    for (size_t off = 0; off < 8; off++) {
+        for (size_t k = 0; k < sizeof(sizes) / sizeof(sizes[0]); k++) {
+            size_t n = sizes[k];
+            double *a = ad + off, *b = bd + (off * 3) % 8, *res = form == 's' ? od + off : a;
+            for (size_t i = 0; i <= n; i++) {
+                a[i] = (double)(i % 97) * 0.125 - 3.0;
+                b[i] = (double)(i % 13) + 0.75;
+            }
+            res[n] = GUARD;
+
+            double expect[MAX_N];
+            for (size_t i = 0; i < n; i++)
+                expect[i] = apply(op, a[i], form == 'i' ? b[i] : s);
+
+            if (form == 's')
+                ((scalar_f64_fn)fn)(a, s, res, n);
+            else if (form == 'i')
+                ((ip_f64_fn)fn)(a, b, n);
+            else
+                ((scalar_ip_f64_fn)fn)(a, s, n);
+
+            if (memcmp(res, expect, n * sizeof(double)) != 0 || res[n] != GUARD) {
+                printf("FAIL (%s, n=%zu, offset=%zu)\n", name, n, off);
+                return 1;
+            }
+        }
+    }
+    return 0;
+}
+
+// Every distinct kernel of vector_<op><infix>_<type><suffix> in the registry
+static int check_levels(const char *infix, const char *type, const char *suffix, char form, int *kernels)
+{
+    for (size_t o = 0; o < sizeof(ops) / sizeof(ops[0]); o++) {
+        char name[64];
+        snprintf(name, sizeof(name), "vector_%s%s_%s%s", ops[o].name, infix, type, suffix);
+        if (!dynemit_get_kernel(name, SIMD_SCALAR)) {
+            printf("FAIL (%s not registered)\n", name);
+            return 1;
+        }
+        void *prev = nullptr;
+        for (int l = SIMD_SCALAR; l <= (int)detect_simd_level(); l++) {
+            // Levels of another architecture's ladder have no kernel
+            void *fn = dynemit_get_kernel(name, (simd_level_t)l);
+            if (!fn || fn == prev)
+                continue;
+            prev = fn;
+            int failed = strcmp(type, "f32") == 0 ? check_f32(name, fn, form, ops[o].op)
+                                                  : check_f64(name, fn, form, ops[o].op);
+            if (failed)
+                return 1;
+            (*kernels)++;
+        }
+    }
+    return 0;
+}
+
+static int test_public(void)
+{
+    printf("  Testing the public symbols... ");
+
+    if (check_f32("vector_mul_scalar_f32", (void *)vector_mul_scalar_f32, 's', '*') ||
+        check_f32("vector_add_f32_ip", (void *)vector_add_f32_ip, 'i', '+') ||
+        check_f32("vector_sub_scalar_f32_ip", (void *)vector_sub_scalar_f32_ip, 'j', '-') ||
+        check_f64("vector_sub_scalar_f64", (void *)vector_sub_scalar_f64, 's', '-') ||
+        check_f64("vector_mul_f64_ip", (void *)vector_mul_f64_ip, 'i', '*') ||
+        check_f64("vector_add_scalar_f64_ip", (void *)vector_add_scalar_f64_ip, 'j', '+'))
+        return 1;
+
+    printf("OK\n");
+    return 0;
+}
+
+static int test_scalar_forms(void)
+{
+    printf("  Testing vector_{add,sub,mul}_scalar_{f32,f64} at every level... ");
+
+    int kernels = 0;
+    if (check_levels("_scalar", "f32", "", 's', &kernels) ||
+        check_levels("_scalar", "f64", "", 's', &kernels))
+        return 1;
+
+    printf("OK (%d kernels)\n", kernels);
+    return 0;
+}
+
+static int test_inplace_forms(void)
+{
+    printf("  Testing the _ip forms at every level... ");
+
+    int kernels = 0;
+    if (check_levels("", "f32", "_ip", 'i', &kernels) ||
+        check_levels("", "f64", "_ip", 'i', &kernels) ||
+        check_levels("_scalar", "f32", "_ip", 'j', &kernels) ||
+        check_levels("_scalar", "f64", "_ip", 'j', &kernels))
+        return 1;
+
+    printf("OK (%d kernels)\n", kernels);
+    return 0;
+}
+
+static int test_aliased_binary(void)
+{
+    printf("  Testing vector_{add,sub,mul}_f32 with out == a and out == b... ");
+
+    void (*const fns[])(const float *, const float *, float *, size_t) = {
+        vector_add_f32, vector_sub_f32, vector_mul_f32,
+    };
+    for (size_t o = 0; o < sizeof(ops) / sizeof(ops[0]); o++) {
+        for (size_t k = 0; k < sizeof(sizes) / sizeof(sizes[0]); k++) {
+            for (int which = 0; which < 2; which++) {
+                size_t n = sizes[k];
+                float expect[MAX_N];
+                for (size_t i = 0; i < n; i++) {
+                    af[i] = (float)(i % 31) - 4.0f;
+                    bf[i] = (float)(i % 7) * 0.5f + 1.0f;
+                    expect[i] = apply_f(ops[o].op, af[i], bf[i]);
+                }
+                float *out = which ? bf : af;
+                fns[o](af, bf, out, n);
+                if (memcmp(out, expect, n * sizeof(float)) != 0) {
+                    printf("FAIL (vector_%s_f32, n=%zu, out == %s)\n", ops[o].name, n, which ? "b" : "a");
+                    return 1;
+                }
+            }
+        }
+    }
+
+    printf("OK\n");
+    return 0;
+}
+
+int main(void)
+{
+    int failures = 0;
+
+    printf("Testing in-place and broadcast-scalar kernels:\n");
+    printf("  CPU SIMD level: %s, stream threshold %zu bytes\n\n",
+           simd_level_name(detect_simd_level()), dynemit_stream_threshold());
+
+    failures += test_public();
+    failures += test_scalar_forms();
+    failures += test_inplace_forms();
+    failures += test_aliased_binary();
+
+    printf("\n");
+    if (failures == 0) {
+        printf("All tests passed!\n");
+        return 0;
+    } else {
+        printf("%d test(s) failed!\n", failures);
+        return 1;
+    }
+}
@@ -0,0 +1,215 @@
+/**
+ * @file test_kernel_macro.c
+ * @brief Tests for the DYNEMIT_KERNEL_* generators of <dynemit/kernel.h>
+ *
+ * A few operations of every arity and element width are defined here and
+ * each generated level kernel is checked bit for bit against the scalar
+ * kernel over sizes around the vector widths and every misalignment within
+ * a cache line. Run once more with DYNEMIT_STREAM_THRESHOLD=0 so the
+ * streaming paths are taken too.
+ */
+
+#include <dynemit/kernel.h>
+#include <stdio.h>
+#include <string.h>
+
+#define MAX_N 1031
+
+#define SUMSQ(x, y)   ((x) * (x) + (y) * (y))
+#define LERP(x, y, t) ((x) + ((y) - (x)) * (t))
+#define AFFINE(x)     ((x) * 3 + 7)
+#define MIX(x, y)     (((x) ^ (y)) + (x))
+
+DYNEMIT_KERNEL_BINARY(test_sumsq_f32, float, SUMSQ)
+DYNEMIT_KERNEL_TERNARY(test_lerp_f64, double, LERP)
+DYNEMIT_KERNEL_UNARY(test_affine_i32, int32_t, AFFINE)
+DYNEMIT_KERNEL_BINARY(test_mix_u8, uint8_t, MIX)
+
+static const size_t sizes[] = { 0, 1, 3, 7, 8, 15, 16, 17, 31, 33, 63, 64, 65, 100, 1000, MAX_N };
+
+// Room for every misalignment of the operands within a cache line
+static unsigned char in[3][(MAX_N + 64) * 8] __attribute__((aligned(64)));
+static unsigned char res[(MAX_N + 65) * 8] __attribute__((aligned(64)));
+static unsigned char expect[(MAX_N + 1) * 8];
+
+enum { GUARD = 0x5a };
+
+typedef void (*unary_fn)(const void *, void *, size_t);
+typedef void (*binary_fn)(const void *, const void *, void *, size_t);
+typedef void (*ternary_fn)(const void *, const void *, const void *, void *, size_t);
+
+static size_t elem_size(char type)
+{
+    return type == 'd' ? 8 : type == 'b' ? 1 : 4;
+}
+
+// type: 'f' float, 'd' double, 'i' int32_t, 'b' uint8_t
+static void fill(void *p, char type, size_t n, unsigned seed)
+{
+    for (size_t i = 0; i < n; i++) {
+        unsigned v = (unsigned)(i * 2654435761u + seed * 31) % 97;
+        if (type == 'f')
+            ((float *)p)[i] = (float)v * 0.25f - 7.0f;
+        else if (type == 'd')
+            ((double *)p)[i] = (double)v * 0.125 - 3.0 + seed;
+        else if (type == 'i')
+            ((int32_t *)p)[i] = (int32_t)v - 40;
+        else
+            ((uint8_t *)p)[i] = (uint8_t)(v * 7 + seed);
+    }
+}
+
+static void call(void *fn, int arity, void *const *ops, void *out, size_t n)
+{
+    if (arity == 1)
+        ((unary_fn)fn)(ops[0], out, n);
+    else if (arity == 2)
+        ((binary_fn)fn)(ops[0], ops[1], out, n);
+    else
+        ((ternary_fn)fn)(ops[0], ops[1], ops[2], out, n);
+}
+
+/*
+ * Check fn against scalar. With in_place the result goes to the first
+ * operand; the element after the last must keep its guard.
+ */
+static int check(const char *name, void *fn, void *scalar, int arity, char type, int in_place)
+{
+    size_t elem = elem_size(type);
+    size_t lanes = 64 / elem;
+    for (size_t off = 0; off < lanes; off++) {
+        for (size_t k = 0; k < sizeof(sizes) / sizeof(sizes[0]); k++) {
+            size_t n = sizes[k];
+            void *ops[3];
+            for (int o = 0; o < arity; o++) {
+                ops[o] = in[o] + ((off * (size_t)(o + 1)) % lanes) * elem;
+                fill(ops[o], type, n, (unsigned)o);
+            }
+            call(scalar, arity, ops, expect, n);
+
+            unsigned char *out = in_place ? ops[0] : res + off * elem;
+            memset(out + n * elem, GUARD, elem);
+            call(fn, arity, ops, out, n);
+
+            int guard_ok = 1;
+            for (size_t b = 0; b < elem; b++)
+                guard_ok &= out[n * elem + b] == GUARD;
+            if (memcmp(out, expect, n * elem) != 0 || !guard_ok) {
+                printf("FAIL (%s, n=%zu, offset=%zu%s)\n", name, n, off, in_place ? ", in place" : "");
+                return 1;
+            }
+        }
+    }
+    return 0;
+}
+
+// Every distinct registered kernel of name, out of place and in place
+static int check_levels(const char *name, int arity, char type, int *kernels)
+{
+    void *scalar = (void *)dynemit_get_kernel(name, SIMD_SCALAR);
+    if (!scalar) {
+        printf("FAIL (%s not registered)\n", name);
+        return 1;
+    }
+    void *prev = nullptr;
+    for (int l = SIMD_SCALAR; l <= (int)detect_simd_level(); l++) {
+        void *fn = (void *)dynemit_get_kernel(name, (simd_level_t)l);
+        if (!fn || fn == prev)
+            continue;
+        prev = fn;
+        if (check(name, fn, scalar, arity, type, 0) ||
+            check(name, fn, scalar, arity, type, 1))
+            return 1;
+        (*kernels)++;
+    }
+    return 0;
+}
+
+static int test_reference(void)
+{
+    printf("  Testing the scalar kernels against the operation... ");
+
+    float a[5] = { 1, 2, 3, 4, 5 }, b[5] = { -1, 0.5f, 2, 0, 3 }, o[5];
+    test_sumsq_f32_scalar(a, b, o, 5);
+    for (int i = 0; i < 5; i++)
+        if (o[i] != a[i] * a[i] + b[i] * b[i]) {
+            printf("FAIL (test_sumsq_f32[%d] = %g)\n", i, (double)o[i]);
+            return 1;
+        }
+
+    int32_t x[4] = { -3, 0, 5, 100 }, y[4];
+    test_affine_i32(x, y, 4);
+    if (y[0] != -2 || y[1] != 7 || y[2] != 22 || y[3] != 307) {
+        printf("FAIL (test_affine_i32)\n");
+        return 1;
+    }
+
+    printf("OK\n");
+    return 0;
+}
+
+static int test_levels(void)
+{
+    printf("  Testing every generated level kernel... ");
+
+    int kernels = 0;
+    if (check_levels("test_sumsq_f32", 2, 'f', &kernels) ||
+        check_levels("test_lerp_f64", 3, 'd', &kernels) ||
+        check_levels("test_affine_i32", 1, 'i', &kernels) ||
+        check_levels("test_mix_u8", 2, 'b', &kernels))
+        return 1;
+
+    printf("OK (%d kernels)\n", kernels);
+    return 0;
+}
+
+static int test_dispatched(void)
+{
+    printf("  Testing the dispatched symbols... ");
+
+    const size_t n = 777;
+    void *ops[3] = { in[0] + 4, in[1] + 8, in[2] };
+    fill(ops[0], 'd', n, 0);
+    fill(ops[1], 'd', n, 1);
+    fill(ops[2], 'd', n, 2);
+    test_lerp_f64_scalar(ops[0], ops[1], ops[2], (double *)expect, n);
+    test_lerp_f64(ops[0], ops[1], ops[2], (double *)res, n);
+    if (memcmp(res, expect, n * sizeof(double)) != 0) {
+        printf("FAIL (test_lerp_f64)\n");
+        return 1;
+    }
+
+    fill(ops[0], 'b', n, 3);
+    fill(ops[1], 'b', n, 4);
+    test_mix_u8_scalar(ops[0], ops[1], expect, n);
+    test_mix_u8(ops[0], ops[1], res, n);
+    if (memcmp(res, expect, n) != 0) {
+        printf("FAIL (test_mix_u8)\n");
+        return 1;
+    }
+
+    printf("OK\n");
+    return 0;
+}
+
+int main(void)
+{
+    int failures = 0;
+
+    printf("Testing generated kernels (kernel.h):\n");
+    printf("  CPU SIMD level: %s, stream threshold %zu bytes\n\n",
+           simd_level_name(detect_simd_level()), dynemit_stream_threshold());
+
+    failures += test_reference();
+    failures += test_levels();
+    failures += test_dispatched();
+
+    printf("\n");
+    if (failures == 0) {
+        printf("All tests passed!\n");
+        return 0;
+    } else {
+        printf("%d test(s) failed!\n", failures);
+        return 1;
+    }
+}
@@ -0,0 +1,217 @@
+/**
+ * @file test_multiout.c
+ * @brief Tests for the single-pass multi-output kernels of <dynemit/multiout.h>
+ *
+ * Every kernel dynemit_get_kernel() returns up to the CPU's level is
+ * checked against the single-output kernels of the same level, at sizes
+ * around every unroll boundary, at misaligned offsets and in place. Run
+ * with DYNEMIT_STREAM_THRESHOLD=0 as well, so the aligned out-of-place
+ * calls take the non-temporal path.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <dynemit.h>
+
+#define N      ((size_t)4099)
+#define MAX_N  (N + 16)
+
+typedef void (*binary_fn)(const float *, const float *, float *, size_t);
+typedef void (*addsub_fn)(const float *, const float *, float *, float *, size_t);
+typedef float (*mul_reduce_fn)(const float *, const float *, float *, size_t);
+typedef float (*sum_fn)(const float *, size_t);
+
+static float *a, *b, *sum, *diff, *ref_sum, *ref_diff, *x, *y;
+
+static const size_t sizes[] = { 0, 1, 3, 4, 7, 8, 15, 16, 17, 31, 32, 33, 63, 64, 65, 127, 128, 129, 1000, N };
+static const size_t offsets[] = { 0, 1, 3 };
+
+#define NUM(arr) (sizeof(arr) / sizeof((arr)[0]))
+
+static void fill(void)
+{
+    // Mixed magnitudes, so the order of the additions shows in the sum
+    unsigned s = 12345;
+    for (size_t i = 0; i < MAX_N; i++) {
+        s = s * 1103515245u + 12345u;
+        a[i] = (float)((s >> 8) % 20001) * 1e-3f - 10.0f;
+        s = s * 1103515245u + 12345u;
+        b[i] = (float)((s >> 8) % 20001) * (i % 7 == 0 ? 1e-1f : 1e-4f) - 1.0f;
+    }
+}
+
+static int test_addsub(simd_level_t level)
+{
+    addsub_fn k = (addsub_fn)dynemit_get_kernel("vector_addsub_f32", level);
+    binary_fn add = (binary_fn)dynemit_get_kernel("vector_add_f32", level);
+    binary_fn sub = (binary_fn)dynemit_get_kernel("vector_sub_f32", level);
+    if (!k || !add || !sub) {
+        printf("FAIL (%s: kernel missing)\n", simd_level_name(level));
+        return 1;
+    }
+
+    for (size_t o = 0; o < NUM(offsets); o++) {
+        size_t off = offsets[o];
+        for (size_t s = 0; s < NUM(sizes); s++) {
+            size_t n = sizes[s];
+            add(a + off, b + off, ref_sum, n);
+            sub(a + off, b + off, ref_diff, n);
+            memset(sum, 0, MAX_N * sizeof(float));
+            memset(diff, 0, MAX_N * sizeof(float));
+            k(a + off, b + off, sum + off, diff + off, n);
+            if (memcmp(sum + off, ref_sum, n * sizeof(float)) != 0 ||
+                memcmp(diff + off, ref_diff, n * sizeof(float)) != 0 || sum[off + n] != 0.0f ||
+                diff[off + n] != 0.0f) {
+                printf("FAIL (%s: n=%zu, offset %zu)\n", simd_level_name(level), n, off);
+                return 1;
+            }
+
+            // Butterfly in place, both ways round
+            memcpy(x, a + off, n * sizeof(float));
+            memcpy(y, b + off, n * sizeof(float));
+            k(x, y, x, y, n);
+            int bad = memcmp(x, ref_sum, n * sizeof(float)) != 0 || memcmp(y, ref_diff, n * sizeof(float)) != 0;
+            memcpy(x, a + off, n * sizeof(float));
+            memcpy(y, b + off, n * sizeof(float));
+            k(x, y, y, x, n);
+            bad |= memcmp(y, ref_sum, n * sizeof(float)) != 0 || memcmp(x, ref_diff, n * sizeof(float)) != 0;
+            if (bad) {
+                printf("FAIL (%s: in place, n=%zu)\n", simd_level_name(level), n);
+                return 1;
+            }
+        }
+    }
+    return 0;
+}
+
+static int test_mul_reduce(simd_level_t level)
+{
+    mul_reduce_fn k = (mul_reduce_fn)dynemit_get_kernel("vector_mul_reduce_f32", level);
+    binary_fn mul = (binary_fn)dynemit_get_kernel("vector_mul_f32", level);
+    sum_fn total = (sum_fn)dynemit_get_kernel("sum_f32", level);
+    if (!k || !mul || !total) {
+        printf("FAIL (%s: kernel missing)\n", simd_level_name(level));
+        return 1;
+    }
+#if defined(__x86_64__) || defined(__i386__) || defined(__aarch64__)
+    // sum_f32 has scalable SVE kernels that this one does not mirror
+    int exact = level < SIMD_SVE;
+#else
+    int exact = 0;
+#endif
+
+    for (size_t o = 0; o < NUM(offsets); o++) {
+        size_t off = offsets[o];
+        for (size_t s = 0; s < NUM(sizes); s++) {
+            size_t n = sizes[s];
+            mul(a + off, b + off, ref_sum, n);
+            float want = total(ref_sum, n);
+            memset(sum, 0, MAX_N * sizeof(float));
+            float got = k(a + off, b + off, sum + off, n);
+            if (memcmp(sum + off, ref_sum, n * sizeof(float)) != 0 || sum[off + n] != 0.0f) {
+                printf("FAIL (%s: products, n=%zu, offset %zu)\n", simd_level_name(level), n, off);
+                return 1;
+            }
+            double tol = exact ? 0.0 : 1e-5 * (double)n;
+            if (!(got - want <= tol && want - got <= tol)) {
+                printf("FAIL (%s: sum %.9g, sum_f32 %.9g, n=%zu, offset %zu)\n", simd_level_name(level), got,
+                       want, n, off);
+                return 1;
+            }
+
+            // In place on either operand
+            memcpy(x, a + off, n * sizeof(float));
+            float in_a = k(x, b + off, x, n);
+            int bad = memcmp(x, ref_sum, n * sizeof(float)) != 0;
+            memcpy(y, b + off, n * sizeof(float));
+            float in_b = k(a + off, y, y, n);
+            bad |= memcmp(y, ref_sum, n * sizeof(float)) != 0;
+            if (bad || in_a != got || in_b != got) {
+                printf("FAIL (%s: in place, n=%zu)\n", simd_level_name(level), n);
+                return 1;
+            }
+        }
+    }
+    return 0;
+}
+
+static int test_levels(void)
+{
+    printf("  Testing every level against the single-output kernels... ");
+
+    int levels = 0;
+    for (int l = SIMD_SCALAR; l <= SIMD_RVV; l++) {
+        if (!dynemit_get_kernel("vector_addsub_f32", (simd_level_t)l))
+            continue;
+        if (test_addsub((simd_level_t)l) || test_mul_reduce((simd_level_t)l))
+            return 1;
+        levels++;
+    }
+
+    printf("OK (%d levels)\n", levels);
+    return 0;
+}
+
+static int test_dispatched(void)
+{
+    printf("  Testing the dispatched symbols... ");
+
+    vector_add_f32(a, b, ref_sum, N);
+    vector_sub_f32(a, b, ref_diff, N);
+    vector_addsub_f32(a, b, sum, diff, N);
+    if (memcmp(sum, ref_sum, N * sizeof(float)) != 0 || memcmp(diff, ref_diff, N * sizeof(float)) != 0) {
+        printf("FAIL (vector_addsub_f32)\n");
+        return 1;
+    }
+
+    vector_mul_f32(a, b, ref_sum, N);
+    float got = vector_mul_reduce_f32(a, b, sum, N);
+    float want = sum_f32(ref_sum, N);
+    if (memcmp(sum, ref_sum, N * sizeof(float)) != 0 || got - want > 1e-2f || want - got > 1e-2f) {
+        printf("FAIL (vector_mul_reduce_f32: %.9g vs %.9g)\n", got, want);
+        return 1;
+    }
+    if (vector_mul_reduce_f32(a, b, sum, 0) != 0.0f) {
+        printf("FAIL (empty sum)\n");
+        return 1;
+    }
+
+    printf("OK\n");
+    return 0;
+}
+
+int main(void)
+{
+    int failures = 0;
+
+    printf("Testing multi-output kernels:\n");
+    printf("  CPU SIMD level: %s\n", simd_level_name(detect_simd_level()));
+    printf("  Stream threshold: %zu bytes\n", dynemit_stream_threshold());
+
+    // 64-byte aligned, so offset 0 meets every vector width
+    float **arrays[] = { &a, &b, &sum, &diff, &ref_sum, &ref_diff, &x, &y };
+    for (size_t k = 0; k < NUM(arrays); k++) {
+        *arrays[k] = aligned_alloc(64, (MAX_N * sizeof(float) + 63) / 64 * 64);
+        if (!*arrays[k]) {
+            printf("FAIL (alloc)\n");
+            return 1;
+        }
+    }
+    fill();
+
+    failures += test_levels();
+    failures += test_dispatched();
+
+    for (size_t k = 0; k < NUM(arrays); k++)
+        free(*arrays[k]);
+
+    printf("\n");
+    if (failures == 0) {
+        printf("All tests passed!\n");
+        return 0;
+    } else {
+        printf("%d test(s) failed!\n", failures);
+        return 1;
+    }
+}
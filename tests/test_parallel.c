@@ -0,0 +1,330 @@
+/**
+ * @file test_parallel.c
+ * @brief Tests for the thread pool and the *_mt element-wise kernels
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <dynemit.h>
+
+// Large enough to cross the default threshold, odd so the last chunk is short
+#define N ((size_t)1048579)
+
+static float *a, *b, *c, *out, *ref;
+
+static int check(const char *name, size_t n)
+{
+    if (memcmp(out, ref, n * sizeof(float)) != 0) {
+        for (size_t i = 0; i < n; i++) {
+            if (out[i] != ref[i]) {
+                printf("FAIL (%s, n=%zu: out[%zu] = %f, expect %f)\n", name, n, i, out[i], ref[i]);
+                break;
+            }
+        }
+        return 1;
+    }
+    return 0;
+}
+
+/**
+ * Every *_mt kernel must be bit-identical to its single-threaded counterpart,
+ * including with an output pointer that is not cache-line aligned
+ */
+static int test_mt_kernels(dynemit_threadpool *pool)
+{
+    printf("  Testing *_mt kernels against single-threaded results... ");
+
+    for (size_t offset = 0; offset < 3; offset++) {
+        float *o = out + offset;
+        float *r = ref + offset;
+        size_t n = N - offset;
+
+        vector_add_f32(a, b, r, n);
+        vector_add_f32_mt(pool, a, b, o, n);
+        if (memcmp(o, r, n * sizeof(float)) != 0) { printf("FAIL (add, offset %zu)\n", offset); return 1; }
+
+        vector_sub_f32(a, b, r, n);
+        vector_sub_f32_mt(pool, a, b, o, n);
+        if (memcmp(o, r, n * sizeof(float)) != 0) { printf("FAIL (sub, offset %zu)\n", offset); return 1; }
+
+        vector_mul_f32(a, b, r, n);
+        vector_mul_f32_mt(pool, a, b, o, n);
+        if (memcmp(o, r, n * sizeof(float)) != 0) { printf("FAIL (mul, offset %zu)\n", offset); return 1; }
+
+        vector_fma_f32(a, b, c, r, n);
+        vector_fma_f32_mt(pool, a, b, c, o, n);
+        if (memcmp(o, r, n * sizeof(float)) != 0) { printf("FAIL (fma, offset %zu)\n", offset); return 1; }
+    }
+
+    printf("OK (%zu threads)\n", dynemit_threadpool_size(pool));
+    return 0;
+}
+
+/**
+ * Below the threshold and with a nullptr pool the call must still be correct
+ */
+static int test_small_and_null_pool(dynemit_threadpool *pool)
+{
+    printf("  Testing small inputs and nullptr pool... ");
+
+    static const size_t sizes[] = { 0, 1, 15, 17, 1000 };
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+        size_t n = sizes[s];
+        vector_add_f32(a, b, ref, n);
+
+        vector_add_f32_mt(pool, a, b, out, n);
+        if (check("add small", n)) return 1;
+
+        vector_add_f32_mt(nullptr, a, b, out, n);
+        if (check("add nullptr pool", n)) return 1;
+    }
+
+    printf("OK\n");
+    return 0;
+}
+
+/**
+ * Threshold 0 forces the pool even for tiny inputs
+ */
+static int test_threshold(dynemit_threadpool *pool)
+{
+    printf("  Testing threshold setter... ");
+
+    size_t saved = dynemit_threadpool_threshold(pool);
+    dynemit_threadpool_set_threshold(pool, 0);
+    if (dynemit_threadpool_threshold(pool) != 0) {
+        printf("FAIL (threshold not updated)\n");
+        return 1;
+    }
+
+    for (size_t n = 0; n < 200; n++) {
+        vector_mul_f32(a, b, ref, n);
+        vector_mul_f32_mt(pool, a, b, out, n);
+        if (check("mul threshold 0", n)) return 1;
+    }
+
+    dynemit_threadpool_set_threshold(pool, saved);
+    printf("OK\n");
+    return 0;
+}
+
+struct coverage {
+    unsigned char *hits;
+    size_t grain;
+    size_t n;
+    int misaligned;
+};
+
+static void mark_range(void *ctx, size_t begin, size_t end)
+{
+    struct coverage *cov = ctx;
+    // Interior boundaries must be multiples of the grain
+    if ((begin != 0 && begin % cov->grain) || (end != cov->n && end % cov->grain))
+        cov->misaligned = 1;
+    for (size_t i = begin; i < end; i++)
+        cov->hits[i]++;
+}
+
+/**
+ * parallel_for must visit every index exactly once
+ */
+static int test_parallel_for(dynemit_threadpool *pool)
+{
+    printf("  Testing dynemit_threadpool_parallel_for() coverage... ");
+
+    static const size_t sizes[] = { 1, 7, 64, 1001, 100003 };
+    static const size_t grains[] = { 1, 16, 1000 };
+    unsigned char *hits = malloc(100003);
+    if (!hits) {
+        printf("FAIL (allocation)\n");
+        return 1;
+    }
+
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+        for (size_t g = 0; g < sizeof(grains) / sizeof(grains[0]); g++) {
+            struct coverage cov = { hits, grains[g], sizes[s], 0 };
+            memset(hits, 0, sizes[s]);
+            dynemit_threadpool_parallel_for(pool, sizes[s], grains[g], mark_range, &cov);
+            for (size_t i = 0; i < sizes[s]; i++) {
+                if (hits[i] != 1) {
+                    printf("FAIL (n=%zu grain=%zu: index %zu visited %d times)\n",
+                           sizes[s], grains[g], i, hits[i]);
+                    free(hits);
+                    return 1;
+                }
+            }
+            if (cov.misaligned) {
+                printf("FAIL (n=%zu grain=%zu: boundary not a multiple of grain)\n",
+                       sizes[s], grains[g]);
+                free(hits);
+                return 1;
+            }
+        }
+    }
+
+    free(hits);
+    printf("OK\n");
+    return 0;
+}
+
+/**
+ * dynemit_alloc() buffers: alignment, zero fill, every flag combination
+ */
+static int test_alloc(void)
+{
+    printf("  Testing dynemit_alloc()... ");
+
+    static const unsigned flags[] = {
+        0, DYNEMIT_ALLOC_HUGE, DYNEMIT_ALLOC_LOCAL, DYNEMIT_ALLOC_INTERLEAVE,
+        DYNEMIT_ALLOC_HUGE | DYNEMIT_ALLOC_LOCAL, DYNEMIT_ALLOC_HUGE | DYNEMIT_ALLOC_INTERLEAVE,
+    };
+    static const size_t sizes[] = { 0, 1, 4096, 3 << 20 };
+
+    for (size_t f = 0; f < sizeof(flags) / sizeof(flags[0]); f++) {
+        for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+            unsigned char *p = dynemit_alloc(sizes[s], flags[f]);
+            uintptr_t align = (flags[f] & DYNEMIT_ALLOC_HUGE) ? (uintptr_t)2 << 20 : 64;
+            if (!p || (uintptr_t)p % align) {
+                printf("FAIL (flags 0x%x, %zu bytes: %p)\n", flags[f], sizes[s], (void *)p);
+                return 1;
+            }
+            for (size_t i = 0; i < sizes[s]; i++) {
+                if (p[i]) {
+                    printf("FAIL (flags 0x%x: byte %zu not zero)\n", flags[f], i);
+                    return 1;
+                }
+            }
+            memset(p, 0xa5, sizes[s]);
+            dynemit_free(p);
+        }
+    }
+
+    if (dynemit_alloc(64, DYNEMIT_ALLOC_LOCAL | DYNEMIT_ALLOC_INTERLEAVE) != nullptr) {
+        printf("FAIL (LOCAL | INTERLEAVE accepted)\n");
+        return 1;
+    }
+    dynemit_free(nullptr);
+
+    printf("OK\n");
+    return 0;
+}
+
+/**
+ * First touch on node-local buffers keeps the data, faults in every page,
+ * and the *_mt kernels on such buffers match the single-threaded results
+ */
+static int test_first_touch(dynemit_threadpool *pool)
+{
+    printf("  Testing dynemit_first_touch() and node-local buffers... ");
+
+    size_t bytes = N * sizeof(float);
+    float *la = dynemit_alloc(bytes, DYNEMIT_ALLOC_LOCAL);
+    float *lb = dynemit_alloc(bytes, DYNEMIT_ALLOC_LOCAL);
+    float *lo = dynemit_alloc(bytes, DYNEMIT_ALLOC_LOCAL | DYNEMIT_ALLOC_HUGE);
+    if (!la || !lb || !lo) {
+        printf("FAIL (allocation)\n");
+        return 1;
+    }
+
+    dynemit_first_touch(pool, la, bytes);
+    dynemit_first_touch(pool, lb, bytes);
+    dynemit_first_touch(pool, lo, bytes);
+    memcpy(la, a, bytes);
+    memcpy(lb, b, bytes);
+
+    // Touching again must not change what is there
+    dynemit_first_touch(pool, la, bytes);
+    if (memcmp(la, a, bytes) != 0) {
+        printf("FAIL (first touch changed the contents)\n");
+        return 1;
+    }
+
+    const void *pages[16];
+    int nodes[16];
+    for (size_t i = 0; i < 16; i++)
+        pages[i] = lo + i * (N / 16);
+    int queried = dynemit_page_nodes(pages, 16, nodes) == 0;
+    for (size_t i = 0; queried && i < 16; i++) {
+        if (nodes[i] < -1) {
+            printf("FAIL (page %zu on node %d)\n", i, nodes[i]);
+            return 1;
+        }
+    }
+
+    vector_mul_f32(la, lb, ref, N);
+    vector_mul_f32_mt(pool, la, lb, lo, N);
+    memcpy(out, lo, bytes);
+    int failed = check("vector_mul_f32_mt on node-local buffers", N);
+
+    dynemit_free(la);
+    dynemit_free(lb);
+    dynemit_free(lo);
+    if (failed)
+        return 1;
+
+    printf("OK (page nodes %s)\n", queried ? "queried" : "unavailable");
+    return 0;
+}
+
+int main(void)
+{
+    int failures = 0;
+
+    printf("Testing multithreaded kernels:\n");
+    printf("  Current SIMD level: %s\n\n", simd_level_name(detect_simd_level()));
+
+    a = malloc(N * sizeof(float));
+    b = malloc(N * sizeof(float));
+    c = malloc(N * sizeof(float));
+    out = malloc(N * sizeof(float));
+    ref = malloc(N * sizeof(float));
+    if (!a || !b || !c || !out || !ref) {
+        printf("Allocation failed\n");
+        return 1;
+    }
+
+    srand(12345);
+    for (size_t i = 0; i < N; i++) {
+        a[i] = (float)rand() / (float)RAND_MAX * 100.0f;
+        b[i] = (float)rand() / (float)RAND_MAX * 100.0f;
+        c[i] = (float)rand() / (float)RAND_MAX * 100.0f;
+    }
+
+    // Force several workers even on a single-CPU runner
+    dynemit_threadpool *pool = dynemit_threadpool_create(4);
+    if (!pool) {
+        printf("dynemit_threadpool_create() failed\n");
+        return 1;
+    }
+
+    failures += test_mt_kernels(pool);
+    failures += test_small_and_null_pool(pool);
+    failures += test_threshold(pool);
+    failures += test_parallel_for(pool);
+    failures += test_alloc();
+    failures += test_first_touch(pool);
+
+    dynemit_threadpool_destroy(pool);
+
+    // A default-sized pool must also work
+    pool = dynemit_threadpool_create(0);
+    if (!pool) {
+        printf("dynemit_threadpool_create(0) failed\n");
+        return 1;
+    }
+    failures += test_mt_kernels(pool);
+    dynemit_threadpool_destroy(pool);
+
+    free(a); free(b); free(c); free(out); free(ref);
+
+    printf("\n");
+    if (failures == 0) {
+        printf("All tests passed!\n");
+        return 0;
+    } else {
+        printf("%d test(s) failed!\n", failures);
+        return 1;
+    }
+}
@@ -0,0 +1,349 @@
+/**
+ * @file test_queue.c
+ * @brief Tests for the asynchronous submission queue of <dynemit/queue.h>
+ *
+ * Every test runs once without a pool and once with a three-thread pool
+ * whose threshold is lowered, so large operations, batches spread over the
+ * pool and batches run on the queue thread are all taken.
+ */
+
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <dynemit.h>
+
+#define N      ((size_t)100003)
+#define SMALL  256
+#define CHUNKS 16
+
+static float *a, *b, *c, *out, *ref;
+
+static int check(const char *name, size_t n)
+{
+    if (memcmp(out, ref, n * sizeof(float)) != 0) {
+        printf("FAIL (%s, n=%zu)\n", name, n);
+        return 1;
+    }
+    return 0;
+}
+
+static dynemit_future *submit(dynemit_queue *q, dynemit_op_t op, const float *x, const float *y, float *o,
+                              size_t n, dynemit_future *const *after, size_t num_after)
+{
+    dynemit_op_args args = { .a = x, .b = y, .c = c, .out = o, .n = n, .after = after, .num_after = num_after };
+    return dynemit_queue_submit(q, op, &args);
+}
+
+static int test_elementwise(dynemit_queue *q)
+{
+    printf("  Testing element-wise operations against direct calls... ");
+
+    static const dynemit_op_t ops[] = { DYNEMIT_OP_ADD_F32, DYNEMIT_OP_SUB_F32, DYNEMIT_OP_MUL_F32,
+                                        DYNEMIT_OP_FMA_F32 };
+    static const char *const names[] = { "add", "sub", "mul", "fma" };
+    static const size_t sizes[] = { 0, 1, 17, SMALL, N };
+
+    for (int k = 0; k < 4; k++) {
+        for (int s = 0; s < 5; s++) {
+            size_t n = sizes[s];
+            switch (ops[k]) {
+            case DYNEMIT_OP_ADD_F32: vector_add_f32(a, b, ref, n); break;
+            case DYNEMIT_OP_SUB_F32: vector_sub_f32(a, b, ref, n); break;
+            case DYNEMIT_OP_MUL_F32: vector_mul_f32(a, b, ref, n); break;
+            default:                 vector_fma_f32(a, b, c, ref, n); break;
+            }
+            memset(out, 0, N * sizeof(float));
+            dynemit_future *f = submit(q, ops[k], a, b, out, n, nullptr, 0);
+            if (!f) {
+                printf("FAIL (%s: submit returned nullptr)\n", names[k]);
+                return 1;
+            }
+            dynemit_future_wait(f);
+            int bad = !dynemit_future_done(f) || check(names[k], n);
+            dynemit_future_release(f);
+            if (bad)
+                return 1;
+        }
+    }
+
+    printf("OK\n");
+    return 0;
+}
+
+// Many small independent operations, released right away
+static int test_batching(dynemit_queue *q)
+{
+    printf("  Testing many small submissions... ");
+
+    const size_t count = N / SMALL;
+    for (size_t i = 0; i < count; i++) {
+        dynemit_future *f = submit(q, DYNEMIT_OP_MUL_F32, a + i * SMALL, b + i * SMALL, out + i * SMALL, SMALL,
+                                   nullptr, 0);
+        if (!f) {
+            printf("FAIL (submit %zu returned nullptr)\n", i);
+            return 1;
+        }
+        dynemit_future_release(f);
+    }
+    dynemit_queue_wait_all(q);
+
+    vector_mul_f32(a, b, ref, count * SMALL);
+    if (check("mul batches", count * SMALL))
+        return 1;
+
+    printf("OK (%zu operations)\n", count);
+    return 0;
+}
+
+/*
+ * read -> compute -> write for every chunk: the stages record the order
+ * they ran in, and every write must see its own chunk's product
+ */
+struct stage {
+    atomic_int *clock;
+    int         ran_at;
+    size_t      chunk;
+    int         ok;
+};
+
+static void read_stage(void *p)
+{
+    struct stage *s = p;
+    size_t len = N / CHUNKS;
+    for (size_t i = s->chunk * len; i < (s->chunk + 1) * len; i++)
+        c[i] = (float)(i % 7) + 0.5f;
+    s->ran_at = atomic_fetch_add(s->clock, 1);
+}
+
+static void write_stage(void *p)
+{
+    struct stage *s = p;
+    size_t len = N / CHUNKS;
+    s->ok = 1;
+    for (size_t i = s->chunk * len; i < (s->chunk + 1) * len; i++)
+        if (out[i] != c[i] * b[i])
+            s->ok = 0;
+    s->ran_at = atomic_fetch_add(s->clock, 1);
+}
+
+static int test_pipeline(dynemit_queue *q)
+{
+    printf("  Testing read -> compute -> write dependency chains... ");
+
+    atomic_int clock = 0;
+    struct stage reads[CHUNKS], writes[CHUNKS];
+    dynemit_future *f[CHUNKS][3];
+    size_t len = N / CHUNKS;
+
+    memset(out, 0, N * sizeof(float));
+    for (size_t k = 0; k < CHUNKS; k++) {
+        reads[k] = (struct stage){ &clock, -1, k, 0 };
+        writes[k] = (struct stage){ &clock, -1, k, 0 };
+        dynemit_op_args r = { .fn = read_stage, .ctx = &reads[k] };
+        f[k][0] = dynemit_queue_submit(q, DYNEMIT_OP_CALL, &r);
+        f[k][1] = submit(q, DYNEMIT_OP_MUL_F32, c + k * len, b + k * len, out + k * len, len, &f[k][0], 1);
+        // Writes also stay in chunk order, like appending to a file
+        dynemit_future *deps[2] = { f[k][1], k > 0 ? f[k - 1][2] : f[k][1] };
+        dynemit_op_args w = { .fn = write_stage, .ctx = &writes[k], .after = deps, .num_after = 2 };
+        f[k][2] = dynemit_queue_submit(q, DYNEMIT_OP_CALL, &w);
+        if (!f[k][0] || !f[k][1] || !f[k][2]) {
+            printf("FAIL (chunk %zu: submit returned nullptr)\n", k);
+            return 1;
+        }
+    }
+
+    dynemit_future_wait(f[CHUNKS - 1][2]);
+    int failed = 0;
+    for (size_t k = 0; k < CHUNKS && !failed; k++) {
+        if (!writes[k].ok || writes[k].ran_at <= reads[k].ran_at ||
+            (k > 0 && writes[k].ran_at <= writes[k - 1].ran_at)) {
+            printf("FAIL (chunk %zu: read at %d, write at %d, ok %d)\n", k, reads[k].ran_at, writes[k].ran_at,
+                   writes[k].ok);
+            failed = 1;
+        }
+    }
+    dynemit_queue_wait_all(q);
+    for (size_t k = 0; k < CHUNKS; k++)
+        for (int s = 0; s < 3; s++)
+            dynemit_future_release(f[k][s]);
+    if (failed)
+        return 1;
+
+    printf("OK\n");
+    return 0;
+}
+
+static atomic_int gate_open;
+
+static void gate(void *p)
+{
+    (void)p;
+    while (!atomic_load(&gate_open))
+        sched_yield();
+}
+
+static void count_callback(void *p)
+{
+    atomic_fetch_add((atomic_int *)p, 1);
+}
+
+static int test_callbacks(dynemit_queue *q)
+{
+    printf("  Testing completion callbacks... ");
+
+    atomic_int calls = 0;
+    atomic_store(&gate_open, 0);
+    dynemit_op_args g = { .fn = gate };
+    dynemit_future *blocked = dynemit_queue_submit(q, DYNEMIT_OP_CALL, &g);
+    dynemit_future *f = submit(q, DYNEMIT_OP_ADD_F32, a, b, out, SMALL, &blocked, 1);
+
+    // Neither can have completed while the gate is closed
+    if (dynemit_future_done(blocked) || dynemit_future_done(f) ||
+        dynemit_future_then(f, count_callback, &calls) != 0 ||
+        dynemit_future_then(f, count_callback, &calls) != 0) {
+        printf("FAIL (completed before the gate opened)\n");
+        return 1;
+    }
+    atomic_store(&gate_open, 1);
+    dynemit_future_wait(f);
+    dynemit_queue_wait_all(q);
+
+    int r = dynemit_future_then(f, count_callback, &calls);
+    dynemit_future_release(blocked);
+    dynemit_future_release(f);
+    if (atomic_load(&calls) != 2 || r != 1) {
+        printf("FAIL (%d callbacks ran, late registration returned %d)\n", atomic_load(&calls), r);
+        return 1;
+    }
+
+    printf("OK\n");
+    return 0;
+}
+
+static int test_invalid(dynemit_queue *q)
+{
+    printf("  Testing rejected submissions... ");
+
+    dynemit_queue *other = dynemit_queue_create(nullptr);
+    dynemit_future *foreign = submit(other, DYNEMIT_OP_ADD_F32, a, b, out, 1, nullptr, 0);
+    dynemit_future *none = nullptr;
+    dynemit_op_args no_fn = { 0 };
+
+    int bad = !foreign || submit(q, (dynemit_op_t)99, a, b, out, 1, nullptr, 0) ||
+              submit(q, DYNEMIT_OP_ADD_F32, a, b, out, 1, &none, 1) ||
+              submit(q, DYNEMIT_OP_ADD_F32, a, b, out, 1, &foreign, 1) ||
+              dynemit_queue_submit(q, DYNEMIT_OP_CALL, &no_fn);
+
+    dynemit_queue_destroy(other);
+    // Completed futures outlive their queue
+    if (!dynemit_future_done(foreign))
+        bad = 1;
+    dynemit_future_wait(foreign);
+    dynemit_future_release(foreign);
+
+    if (bad) {
+        printf("FAIL\n");
+        return 1;
+    }
+    printf("OK\n");
+    return 0;
+}
+
+// destroy() runs everything still queued
+static int test_destroy(dynemit_threadpool *pool)
+{
+    printf("  Testing destroy with operations still queued... ");
+
+    dynemit_queue *q = dynemit_queue_create(pool);
+    atomic_store(&gate_open, 0);
+    dynemit_op_args g = { .fn = gate };
+    dynemit_future *blocked = dynemit_queue_submit(q, DYNEMIT_OP_CALL, &g);
+    dynemit_future *f = submit(q, DYNEMIT_OP_SUB_F32, a, b, out, N, &blocked, 1);
+    dynemit_future_release(blocked);
+    memset(out, 0, N * sizeof(float));
+    atomic_store(&gate_open, 1);
+    dynemit_queue_destroy(q);
+
+    vector_sub_f32(a, b, ref, N);
+    int bad = !dynemit_future_done(f) || check("sub after destroy", N);
+    dynemit_future_release(f);
+    if (bad)
+        return 1;
+
+    printf("OK\n");
+    return 0;
+}
+
+static int run_all(dynemit_threadpool *pool)
+{
+    int failures = 0;
+    dynemit_queue *q = dynemit_queue_create(pool);
+    if (!q) {
+        printf("  FAIL (dynemit_queue_create returned nullptr)\n");
+        return 1;
+    }
+    failures += test_elementwise(q);
+    failures += test_batching(q);
+    failures += test_pipeline(q);
+    failures += test_callbacks(q);
+    failures += test_invalid(q);
+    dynemit_queue_destroy(q);
+    failures += test_destroy(pool);
+    return failures;
+}
+
+int main(void)
+{
+    int failures = 0;
+
+    printf("Testing submission queue:\n");
+    printf("  CPU SIMD level: %s\n", simd_level_name(detect_simd_level()));
+
+    a = malloc(N * sizeof(float));
+    b = malloc(N * sizeof(float));
+    c = malloc(N * sizeof(float));
+    out = malloc(N * sizeof(float));
+    ref = malloc(N * sizeof(float));
+    if (!a || !b || !c || !out || !ref) {
+        printf("FAIL (alloc)\n");
+        return 1;
+    }
+    for (size_t i = 0; i < N; i++) {
+        a[i] = (float)(i % 97) * 0.25f - 12.0f;
+        b[i] = (float)(i % 13) + 0.5f;
+        c[i] = (float)(i % 31) * -0.125f;
+    }
+
+    printf("\n  Without a pool:\n");
+    failures += run_all(nullptr);
+
+    // A threshold between SMALL and N: large ops split, batches of small
+    // ones are spread over the pool once they add up to it
+    dynemit_threadpool *pool = dynemit_threadpool_create(3);
+    if (!pool) {
+        printf("FAIL (dynemit_threadpool_create returned nullptr)\n");
+        return 1;
+    }
+    dynemit_threadpool_set_threshold(pool, 4096);
+    printf("\n  With a pool of %zu threads:\n", dynemit_threadpool_size(pool));
+    failures += run_all(pool);
+    dynemit_threadpool_destroy(pool);
+
+    free(a);
+    free(b);
+    free(c);
+    free(out);
+    free(ref);
+
+    printf("\n");
+    if (failures == 0) {
+        printf("All tests passed!\n");
+        return 0;
+    } else {
+        printf("%d test(s) failed!\n", failures);
+        return 1;
+    }
+}
@@ -0,0 +1,273 @@
+/**
+ * @file test_rebind.c
+ * @brief Tests for the rebindable dispatch table (dynemit_rebind())
+ */
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <dynemit.h>
+
+#define N 1000
+#define THREADS 4
+
+static float a[N], b[N], out[N], ref[N];
+
+static dynemit_kernel_t bound(const dynemit_dispatch_t *slot)
+{
+    return __atomic_load_n(&slot->kernel, __ATOMIC_RELAXED);
+}
+
+static int test_lookup(void)
+{
+    printf("  Testing slot lookup... ");
+
+    const dynemit_dispatch_t *mul = dynemit_dispatch_lookup("vector_mul_f32");
+    const dynemit_dispatch_t *dot = dynemit_dispatch_lookup("dot_f32");
+    if (!mul || !dot || strcmp(mul->name, "vector_mul_f32") != 0 || strcmp(dot->name, "dot_f32") != 0) {
+        printf("FAIL (slots not found)\n");
+        return 1;
+    }
+    if ((uintptr_t)mul % 64 != 0 || (uintptr_t)dot % 64 != 0 || sizeof(dynemit_dispatch_t) != 64) {
+        printf("FAIL (slots not one cache line each)\n");
+        return 1;
+    }
+    if (dynemit_dispatch_lookup("no_such_function") || dynemit_dispatch_lookup(nullptr)) {
+        printf("FAIL (unknown name found)\n");
+        return 1;
+    }
+
+    printf("OK\n");
+    return 0;
+}
+
+static int test_default_binding(void)
+{
+    printf("  Testing first-call binding... ");
+
+    const dynemit_dispatch_t *mul = dynemit_dispatch_lookup("vector_mul_f32");
+    if (bound(mul) != mul->first) {
+        printf("FAIL (bound before the first call)\n");
+        return 1;
+    }
+
+    vector_mul_f32(a, b, ref, N);
+    memset(out, 0, sizeof(out));
+    DYNEMIT_DISPATCH_CALL(mul, vector_mul_f32, a, b, out, N);
+    if (memcmp(out, ref, sizeof(out)) != 0) {
+        printf("FAIL (first call through the stub)\n");
+        return 1;
+    }
+    // The resolver's choice, as the ifunc symbol got it
+    if (bound(mul) != dynemit_get_kernel("vector_mul_f32", detect_simd_level())) {
+        printf("FAIL (stub bound another kernel)\n");
+        return 1;
+    }
+
+    float d = DYNEMIT_DISPATCH_CALL(dynemit_dispatch_lookup("dot_f32"), dot_f32, a, b, N);
+    if (d != dot_f32(a, b, N)) {
+        printf("FAIL (dot_f32 through the table)\n");
+        return 1;
+    }
+
+    printf("OK\n");
+    return 0;
+}
+
+static int test_levels(void)
+{
+    printf("  Testing rebinding to every supported level... ");
+
+    const dynemit_dispatch_t *mul = dynemit_dispatch_lookup("vector_mul_f32");
+    int levels = 0;
+    for (int l = SIMD_SCALAR; l <= SIMD_RVV; l++) {
+        dynemit_kernel_t kernel = dynemit_get_kernel("vector_mul_f32", (simd_level_t)l);
+        int r = dynemit_rebind("vector_mul_f32", (simd_level_t)l);
+        if (!kernel) {
+            if (r != -1) {
+                printf("FAIL (%s accepted without a kernel)\n", simd_level_name((simd_level_t)l));
+                return 1;
+            }
+            continue;
+        }
+        memset(out, 0, sizeof(out));
+        DYNEMIT_DISPATCH_CALL(mul, vector_mul_f32, a, b, out, N);
+        if (r != 0 || bound(mul) != kernel || memcmp(out, ref, sizeof(out)) != 0) {
+            printf("FAIL (%s)\n", simd_level_name((simd_level_t)l));
+            return 1;
+        }
+        levels++;
+    }
+
+    printf("OK (%d levels)\n", levels);
+    return 0;
+}
+
+static atomic_int custom_calls;
+
+static void custom_mul(const float *x, const float *y, float *o, size_t n)
+{
+    atomic_fetch_add(&custom_calls, 1);
+    for (size_t i = 0; i < n; i++)
+        o[i] = x[i] * y[i];
+}
+
+static int test_custom_and_reset(void)
+{
+    printf("  Testing a custom kernel and restoring the default... ");
+
+    const dynemit_dispatch_t *mul = dynemit_dispatch_lookup("vector_mul_f32");
+    if (dynemit_rebind_kernel("vector_mul_f32", (dynemit_kernel_t)custom_mul) != 0) {
+        printf("FAIL (rebind_kernel)\n");
+        return 1;
+    }
+    DYNEMIT_DISPATCH_CALL(mul, vector_mul_f32, a, b, out, N);
+    // The ifunc symbol is not affected
+    vector_mul_f32(a, b, out, N);
+    if (atomic_load(&custom_calls) != 1) {
+        printf("FAIL (custom kernel called %d times)\n", atomic_load(&custom_calls));
+        return 1;
+    }
+
+    if (dynemit_rebind_kernel("vector_mul_f32", nullptr) != 0 || bound(mul) != mul->first) {
+        printf("FAIL (default not restored)\n");
+        return 1;
+    }
+    memset(out, 0, sizeof(out));
+    DYNEMIT_DISPATCH_CALL(mul, vector_mul_f32, a, b, out, N);
+    if (memcmp(out, ref, sizeof(out)) != 0 ||
+        bound(mul) != dynemit_get_kernel("vector_mul_f32", detect_simd_level())) {
+        printf("FAIL (default not bound again)\n");
+        return 1;
+    }
+
+    printf("OK\n");
+    return 0;
+}
+
+static int test_invalid(void)
+{
+    printf("  Testing rejected rebinds... ");
+
+    if (dynemit_rebind("no_such_function", SIMD_SCALAR) != -1 ||
+        dynemit_rebind_kernel("no_such_function", (dynemit_kernel_t)custom_mul) != -1 ||
+        dynemit_rebind_kernel(nullptr, (dynemit_kernel_t)custom_mul) != -1 ||
+        dynemit_rebind("vector_mul_f32", (simd_level_t)-1) != -1 ||
+        dynemit_rebind(nullptr, (simd_level_t)99) != -1) {
+        printf("FAIL\n");
+        return 1;
+    }
+
+    printf("OK\n");
+    return 0;
+}
+
+static int test_rebind_all(void)
+{
+    printf("  Testing rebinding every slot... ");
+
+    if (dynemit_rebind(nullptr, SIMD_SCALAR) != 0) {
+        printf("FAIL (rebind returned -1)\n");
+        return 1;
+    }
+    // Functions of two feature objects; both are linked in for calls made above
+    const char *names[] = { "vector_mul_f32", "dot_f32", "sum_f32" };
+    for (size_t i = 0; i < sizeof(names) / sizeof(names[0]); i++) {
+        const dynemit_dispatch_t *slot = dynemit_dispatch_lookup(names[i]);
+        if (!slot || bound(slot) != dynemit_get_kernel(names[i], SIMD_SCALAR)) {
+            printf("FAIL (%s not on its scalar kernel)\n", names[i]);
+            return 1;
+        }
+    }
+    for (size_t i = 0; i < sizeof(names) / sizeof(names[0]); i++)
+        dynemit_rebind_kernel(names[i], nullptr);
+
+    printf("OK\n");
+    return 0;
+}
+
+/*
+ * Callers keep going through the table while the main thread flips it
+ * between levels; every call must run some level's kernel to completion
+ */
+static atomic_int stop;
+
+static void *caller(void *p)
+{
+    const dynemit_dispatch_t *mul = dynemit_dispatch_lookup("vector_mul_f32");
+    float local[N];
+    long bad = 0;
+    while (!atomic_load_explicit(&stop, memory_order_relaxed)) {
+        DYNEMIT_DISPATCH_CALL(mul, vector_mul_f32, a, b, local, N);
+        if (memcmp(local, ref, sizeof(local)) != 0)
+            bad++;
+    }
+    *(long *)p = bad;
+    return nullptr;
+}
+
+static int test_concurrent(void)
+{
+    printf("  Testing rebinds during concurrent calls... ");
+
+    pthread_t threads[THREADS];
+    long bad[THREADS];
+    atomic_store(&stop, 0);
+    for (int t = 0; t < THREADS; t++)
+        pthread_create(&threads[t], nullptr, caller, &bad[t]);
+
+    simd_level_t top = detect_simd_level();
+    for (int i = 0; i < 20000; i++) {
+        if (i % 3 == 2)
+            dynemit_rebind_kernel("vector_mul_f32", nullptr);
+        else
+            dynemit_rebind("vector_mul_f32", i % 3 ? top : SIMD_SCALAR);
+    }
+    atomic_store(&stop, 1);
+
+    long total = 0;
+    for (int t = 0; t < THREADS; t++) {
+        pthread_join(threads[t], nullptr);
+        total += bad[t];
+    }
+    dynemit_rebind_kernel("vector_mul_f32", nullptr);
+    if (total) {
+        printf("FAIL (%ld wrong results)\n", total);
+        return 1;
+    }
+
+    printf("OK\n");
+    return 0;
+}
+
+int main(void)
+{
+    int failures = 0;
+
+    printf("Testing rebindable dispatch table:\n");
+    printf("  CPU SIMD level: %s\n", simd_level_name(detect_simd_level()));
+
+    for (int i = 0; i < N; i++) {
+        a[i] = (float)(i % 97) * 0.25f - 12.0f;
+        b[i] = (float)(i % 13) + 0.5f;
+    }
+
+    failures += test_lookup();
+    failures += test_default_binding();
+    failures += test_levels();
+    failures += test_custom_and_reset();
+    failures += test_invalid();
+    failures += test_rebind_all();
+    failures += test_concurrent();
+
+    printf("\n");
+    if (failures == 0) {
+        printf("All tests passed!\n");
+        return 0;
+    } else {
+        printf("%d test(s) failed!\n", failures);
+        return 1;
+    }
+}
@@ -0,0 +1,174 @@
+/**
+ * @file test_reduce.c
+ * @brief Tests for the dot/sum/minmax/norm2 reduction kernels
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <dynemit.h>
+
+#define MAX_N 4099
+
+// Sizes around every SIMD width and accumulator block boundary
+static const size_t sizes[] = { 0, 1, 3, 4, 7, 15, 16, 17, 31, 33, 63, 64, 65, 100, 1000, 4096, MAX_N };
+static const int num_sizes = sizeof(sizes) / sizeof(sizes[0]);
+
+static float a[MAX_N], b[MAX_N];
+
+// Accumulation order differs from the reference, so compare relative to the
+// magnitude of the terms rather than the (possibly cancelling) result
+static int
+close_enough(double got, double expect, double magnitude)
+{
+    return fabs(got - expect) <= 1e-5 * fmax(1.0, magnitude);
+}
+
+/**
+ * Reference for the deterministic variants: 16 lanes, lane i % 16, unfused,
+ * fixed pairwise combine. Every dispatched level must match this bit for bit.
+ */
+__attribute__((optimize("fp-contract=off")))
+static float
+det_reference(const float *x, const float *y, size_t n)
+{
+    volatile float lanes[16] = {0};
+    for (size_t i = 0; i < n; i++) {
+        float term = y ? x[i] * y[i] : x[i];
+        lanes[i % 16] = lanes[i % 16] + term;
+    }
+    for (size_t w = 8; w >= 1; w /= 2)
+        for (size_t j = 0; j < w; j++)
+            lanes[j] = lanes[j] + lanes[j + w];
+    return lanes[0];
+}
+
+static int test_dot_and_sum(void)
+{
+    printf("  Testing dot_f32 / sum_f32 / norm2_f32... ");
+
+    for (int s = 0; s < num_sizes; s++) {
+        size_t n = sizes[s];
+        double dot = 0.0, dot_mag = 0.0, sum = 0.0, sum_mag = 0.0, sq = 0.0;
+        for (size_t i = 0; i < n; i++) {
+            dot += (double)a[i] * b[i];
+            dot_mag += fabs((double)a[i] * b[i]);
+            sum += a[i];
+            sum_mag += fabs(a[i]);
+            sq += (double)a[i] * a[i];
+        }
+
+        float got_dot = dot_f32(a, b, n);
+        float got_sum = sum_f32(a, n);
+        float got_norm = norm2_f32(a, n);
+
+        if (!close_enough(got_dot, dot, dot_mag)) {
+            printf("FAIL (dot, n=%zu: got %f, expect %f)\n", n, got_dot, dot);
+            return 1;
+        }
+        if (!close_enough(got_sum, sum, sum_mag)) {
+            printf("FAIL (sum, n=%zu: got %f, expect %f)\n", n, got_sum, sum);
+            return 1;
+        }
+        if (!close_enough(got_norm, sqrt(sq), sqrt(sq))) {
+            printf("FAIL (norm2, n=%zu: got %f, expect %f)\n", n, got_norm, sqrt(sq));
+            return 1;
+        }
+    }
+
+    printf("OK\n");
+    return 0;
+}
+
+static int test_minmax(void)
+{
+    printf("  Testing minmax_f32... ");
+
+    for (int s = 0; s < num_sizes; s++) {
+        size_t n = sizes[s];
+        float lo = INFINITY, hi = -INFINITY;
+        for (size_t i = 0; i < n; i++) {
+            lo = fminf(lo, a[i]);
+            hi = fmaxf(hi, a[i]);
+        }
+
+        float got_lo = 0.0f, got_hi = 0.0f;
+        minmax_f32(a, n, &got_lo, &got_hi);
+        if (got_lo != lo || got_hi != hi) {
+            printf("FAIL (n=%zu: got [%f, %f], expect [%f, %f])\n", n, got_lo, got_hi, lo, hi);
+            return 1;
+        }
+    }
+
+    // Extremes placed in the tail must still be found
+    float t[37];
+    for (int i = 0; i < 37; i++)
+        t[i] = 1.0f;
+    t[36] = -5.0f;
+    t[35] = 9.0f;
+    float got_lo, got_hi;
+    minmax_f32(t, 37, &got_lo, &got_hi);
+    if (got_lo != -5.0f || got_hi != 9.0f) {
+        printf("FAIL (tail extremes: got [%f, %f])\n", got_lo, got_hi);
+        return 1;
+    }
+
+    printf("OK\n");
+    return 0;
+}
+
+static int test_deterministic(void)
+{
+    printf("  Testing deterministic-order variants... ");
+
+    for (int s = 0; s < num_sizes; s++) {
+        size_t n = sizes[s];
+        float dot = dot_f32_det(a, b, n);
+        float sum = sum_f32_det(a, n);
+        float norm = norm2_f32_det(a, n);
+
+        float ref_dot = det_reference(a, b, n);
+        float ref_sum = det_reference(a, NULL, n);
+        float ref_norm = sqrtf(det_reference(a, a, n));
+
+        if (memcmp(&dot, &ref_dot, sizeof(float)) != 0 ||
+            memcmp(&sum, &ref_sum, sizeof(float)) != 0 ||
+            memcmp(&norm, &ref_norm, sizeof(float)) != 0) {
+            printf("FAIL (n=%zu: dot %a vs %a, sum %a vs %a, norm %a vs %a)\n",
+                   n, dot, ref_dot, sum, ref_sum, norm, ref_norm);
+            return 1;
+        }
+    }
+
+    printf("OK (bit-identical to reference order)\n");
+    return 0;
+}
+
+int main(void)
+{
+    int failures = 0;
+
+    printf("Testing reduction kernels:\n");
+    printf("  Current SIMD level: %s\n\n", simd_level_name(detect_simd_level()));
+
+    // Mixed signs and magnitudes so accumulation order actually matters
+    srand(12345);
+    for (int i = 0; i < MAX_N; i++) {
+        a[i] = ((float)rand() / (float)RAND_MAX - 0.5f) * 8.0f;
+        b[i] = ((float)rand() / (float)RAND_MAX - 0.5f) * 2.0f;
+    }
+
+    failures += test_dot_and_sum();
+    failures += test_minmax();
+    failures += test_deterministic();
+
+    printf("\n");
+    if (failures == 0) {
+        printf("All tests passed!\n");
+        return 0;
+    } else {
+        printf("%d test(s) failed!\n", failures);
+        return 1;
+    }
+}
@@ -0,0 +1,158 @@
+/**
+ * @file test_shared.c
+ * @brief Tests for libdynemit.so loaded with dlopen(), as Python extensions
+ * and plugins do
+ */
+
+#define _GNU_SOURCE
+#include <dlfcn.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <dynemit/core.h>
+
+#define N 100
+
+typedef void (*binary_fn)(const float *, const float *, float *, size_t);
+typedef float (*dot_fn)(const float *, const float *, size_t);
+typedef simd_level_t (*level_fn)(void);
+typedef const char *(*level_name_fn)(simd_level_t);
+typedef dynemit_kernel_t (*get_kernel_fn)(const char *, simd_level_t);
+
+static void *lib;
+
+static int test_symbols(void)
+{
+    printf("  Testing exported symbols... ");
+
+    // Public functions carry the library's version
+    const char *names[] = {
+        "vector_add_f32", "vector_mul_f64", "dot_f32", "vector_mul_bf16_f32",
+        "dynemit_threadpool_create", "dynemit_expr_eval", "detect_simd_level_ts",
+    };
+    for (size_t i = 0; i < sizeof(names) / sizeof(names[0]); i++) {
+        void *sym = dlvsym(lib, names[i], "DYNEMIT_1.0");
+        if (!sym || sym != dlsym(lib, names[i])) {
+            printf("FAIL (%s not exported as DYNEMIT_1.0)\n", names[i]);
+            return 1;
+        }
+    }
+
+    // Kernels, selectors and helpers stay internal
+    const char *internal[] = {
+        "early_getenv", "vector_add_f32_avx2", "vector_add_f32_select",
+        "vector_add_f32_resolver", "__start_dynemit_kernels",
+    };
+    for (size_t i = 0; i < sizeof(internal) / sizeof(internal[0]); i++) {
+        if (dlsym(lib, internal[i])) {
+            printf("FAIL (%s exported)\n", internal[i]);
+            return 1;
+        }
+    }
+
+    printf("OK\n");
+    return 0;
+}
+
+static int test_calls(void)
+{
+    printf("  Testing dispatched calls... ");
+
+    binary_fn add = (binary_fn)dlsym(lib, "vector_add_f32");
+    dot_fn dot = (dot_fn)dlsym(lib, "dot_f32");
+    level_fn level = (level_fn)dlsym(lib, "detect_simd_level_ts");
+    get_kernel_fn get_kernel = (get_kernel_fn)dlsym(lib, "dynemit_get_kernel");
+    level_name_fn level_name = (level_name_fn)dlsym(lib, "simd_level_name");
+    if (!add || !dot || !level || !get_kernel || !level_name) {
+        printf("FAIL (missing symbol: %s)\n", dlerror());
+        return 1;
+    }
+
+    float a[N], b[N], out[N + 1];
+    for (int i = 0; i < N; i++) {
+        a[i] = (float)i * 0.5f;
+        b[i] = (float)(i % 7) - 3.0f;
+    }
+    out[N] = -1.0f;
+    add(a, b, out, N);
+    for (int i = 0; i < N; i++) {
+        if (out[i] != a[i] + b[i]) {
+            printf("FAIL (out[%d] = %f)\n", i, out[i]);
+            return 1;
+        }
+    }
+    if (out[N] != -1.0f) {
+        printf("FAIL (wrote past the end)\n");
+        return 1;
+    }
+
+    // Small integers: exact in every summation order
+    float expect = 0.0f;
+    for (int i = 0; i < N; i++)
+        expect += a[i] * b[i];
+    if (dot(a, b, N) != expect) {
+        printf("FAIL (dot_f32 = %f, expect %f)\n", dot(a, b, N), expect);
+        return 1;
+    }
+
+    // dlsym() resolves the ifunc to the kernel of the detected level
+    if ((dynemit_kernel_t)add != get_kernel("vector_add_f32", level())) {
+        printf("FAIL (vector_add_f32 is not the %s kernel)\n", level_name(level()));
+        return 1;
+    }
+
+    printf("OK (%s)\n", level_name(level()));
+    return 0;
+}
+
+static int test_registry(void)
+{
+    printf("  Testing kernel registry... ");
+
+    // Every feature is in the library, referenced or not
+    get_kernel_fn get_kernel = (get_kernel_fn)dlsym(lib, "dynemit_get_kernel");
+    const char *names[] = {
+        "vector_add_f32", "vector_sub_i16", "vector_mul_f32_batch", "vector_fma_f32",
+        "vector_axpy_f32", "dot_f32", "sum_f32", "minmax_f32", "norm2_f32_det",
+        "dot_f16", "vector_mul_bf16_f32",
+    };
+    for (size_t i = 0; i < sizeof(names) / sizeof(names[0]); i++) {
+        if (!get_kernel(names[i], SIMD_SCALAR)) {
+            printf("FAIL (%s not registered)\n", names[i]);
+            return 1;
+        }
+    }
+
+    printf("OK\n");
+    return 0;
+}
+
+int main(void)
+{
+    int failures = 0;
+
+    printf("Testing libdynemit.so via dlopen():\n");
+    printf("  Library: %s\n\n", DYNEMIT_SHARED_PATH);
+
+    // RTLD_NOW runs every resolver inside dlopen(), before the library's
+    // relocations are complete
+    lib = dlopen(DYNEMIT_SHARED_PATH, RTLD_NOW | RTLD_LOCAL);
+    if (!lib) {
+        printf("FAIL (dlopen: %s)\n", dlerror());
+        return 1;
+    }
+
+    failures += test_symbols();
+    failures += test_calls();
+    failures += test_registry();
+
+    dlclose(lib);
+
+    printf("\n");
+    if (failures == 0) {
+        printf("All tests passed!\n");
+        return 0;
+    } else {
+        printf("%d test(s) failed!\n", failures);
+        return 1;
+    }
+}
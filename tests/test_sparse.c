@@ -0,0 +1,192 @@
+/**
+ * @file test_sparse.c
+ * @brief Tests for the gather/scatter kernels of <dynemit/sparse.h>
+ *
+ * Every level kernel from the registry is checked against a plain loop over
+ * sizes around the vector widths: bit for bit for the gather-multiply and
+ * the scatter-add, within rounding for the sparse dot. The scatter-add runs
+ * on indices with no repeats, a few repeats and a single repeated index, so
+ * every conflict pattern of AVX-512CD is taken.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <dynemit.h>
+
+#define MAX_N 4099
+#define DENSE 1024
+
+static const size_t sizes[] = { 0, 1, 3, 7, 8, 15, 16, 17, 31, 32, 33, 63, 64, 65, 100, 1000, MAX_N };
+static const int num_sizes = sizeof(sizes) / sizeof(sizes[0]);
+
+static float dense[DENSE], values[MAX_N], b[MAX_N + 1], out[MAX_N + 1], expect[DENSE];
+static int32_t idx[MAX_N];
+
+typedef void (*gather_mul_fn)(const float *, const int32_t *, const float *, float *, size_t);
+typedef float (*dot_sparse_fn)(const float *, const int32_t *, size_t, const float *);
+typedef void (*scatter_add_fn)(float *, const int32_t *, const float *, size_t);
+
+// pattern 0: a permutation-like spread, 1: many repeats, 2: one index only
+static void
+fill_indices(int pattern, size_t n)
+{
+    for (size_t i = 0; i < n; i++) {
+        if (pattern == 0)
+            idx[i] = (int32_t)((i * 389) % DENSE);
+        else if (pattern == 1)
+            idx[i] = (int32_t)((i * 7 + i / 5) % 13);
+        else
+            idx[i] = 42;
+        values[i] = (float)(i % 29) * 0.125f - 1.5f;
+        b[i] = (float)(i % 11) - 4.25f;
+    }
+}
+
+static int
+close_enough(double got, double ref, double magnitude)
+{
+    return fabs(got - ref) <= 1e-5 * fmax(1.0, magnitude);
+}
+
+static int check_gather_mul(void *fn)
+{
+    for (int p = 0; p < 2; p++) {
+        for (int s = 0; s < num_sizes; s++) {
+            size_t n = sizes[s];
+            fill_indices(p, n);
+            out[n] = -7.0f;
+            ((gather_mul_fn)fn)(dense, idx, b, out, n);
+            for (size_t i = 0; i < n; i++) {
+                if (out[i] != dense[idx[i]] * b[i]) {
+                    printf("FAIL (n=%zu, out[%zu] = %f, expect %f)\n", n, i, out[i], dense[idx[i]] * b[i]);
+                    return 1;
+                }
+            }
+            if (out[n] != -7.0f) {
+                printf("FAIL (n=%zu, wrote past the end)\n", n);
+                return 1;
+            }
+
+            // In place over b
+            memcpy(out, b, n * sizeof(float));
+            ((gather_mul_fn)fn)(dense, idx, out, out, n);
+            for (size_t i = 0; i < n; i++) {
+                if (out[i] != dense[idx[i]] * b[i]) {
+                    printf("FAIL (n=%zu, out == b, out[%zu])\n", n, i);
+                    return 1;
+                }
+            }
+        }
+    }
+    return 0;
+}
+
+static int check_dot_sparse(void *fn)
+{
+    for (int p = 0; p < 3; p++) {
+        for (int s = 0; s < num_sizes; s++) {
+            size_t n = sizes[s];
+            fill_indices(p, n);
+            double ref = 0.0, mag = 0.0;
+            for (size_t i = 0; i < n; i++) {
+                ref += (double)values[i] * dense[idx[i]];
+                mag += fabs((double)values[i] * dense[idx[i]]);
+            }
+            float got = ((dot_sparse_fn)fn)(values, idx, n, dense);
+            if (!close_enough(got, ref, mag)) {
+                printf("FAIL (n=%zu: got %f, expect %f)\n", n, got, ref);
+                return 1;
+            }
+        }
+    }
+    return 0;
+}
+
+static int check_scatter_add(void *fn)
+{
+    for (int p = 0; p < 3; p++) {
+        for (int s = 0; s < num_sizes; s++) {
+            size_t n = sizes[s];
+            fill_indices(p, n);
+            for (size_t j = 0; j < DENSE; j++)
+                out[j] = expect[j] = (float)(j % 5) * 0.5f;
+            for (size_t i = 0; i < n; i++)
+                expect[idx[i]] += values[i];
+
+            ((scatter_add_fn)fn)(out, idx, values, n);
+            if (memcmp(out, expect, sizeof(expect)) != 0) {
+                printf("FAIL (n=%zu, index pattern %d)\n", n, p);
+                return 1;
+            }
+        }
+    }
+    return 0;
+}
+
+static int test_levels(const char *name, int (*check)(void *))
+{
+    printf("  Testing %s at every level... ", name);
+
+    int kernels = 0;
+    void *prev = nullptr;
+    for (int l = SIMD_SCALAR; l <= (int)detect_simd_level(); l++) {
+        // Levels of another architecture's ladder have no kernel
+        void *fn = dynemit_get_kernel(name, (simd_level_t)l);
+        if (!fn || fn == prev)
+            continue;
+        prev = fn;
+        if (check(fn))
+            return 1;
+        kernels++;
+    }
+    if (!kernels) {
+        printf("FAIL (%s not registered)\n", name);
+        return 1;
+    }
+
+    printf("OK (%d kernels)\n", kernels);
+    return 0;
+}
+
+static int test_public(void)
+{
+    printf("  Testing the dispatched symbols... ");
+
+    if (check_gather_mul((void *)vector_gather_mul_f32) || check_dot_sparse((void *)dot_sparse_f32) ||
+        check_scatter_add((void *)scatter_add_f32))
+        return 1;
+    if (dot_sparse_f32(values, idx, 0, dense) != 0.0f) {
+        printf("FAIL (dot_sparse_f32 of nnz == 0)\n");
+        return 1;
+    }
+
+    printf("OK\n");
+    return 0;
+}
+
+int main(void)
+{
+    int failures = 0;
+
+    printf("Testing sparse kernels:\n");
+    printf("  CPU SIMD level: %s, AVX-512CD: %s\n\n", simd_level_name(detect_simd_level()),
+           dynemit_cpu_has(DYNEMIT_CPU_AVX512CD) ? "yes" : "no");
+
+    for (size_t j = 0; j < DENSE; j++)
+        dense[j] = (float)((j * 37) % 101) * 0.0625f - 3.0f;
+
+    failures += test_levels("vector_gather_mul_f32", check_gather_mul);
+    failures += test_levels("dot_sparse_f32", check_dot_sparse);
+    failures += test_levels("scatter_add_f32", check_scatter_add);
+    failures += test_public();
+
+    printf("\n");
+    if (failures == 0) {
+        printf("All tests passed!\n");
+        return 0;
+    } else {
+        printf("%d test(s) failed!\n", failures);
+        return 1;
+    }
+}
@@ -0,0 +1,226 @@
+/**
+ * @file test_stats.c
+ * @brief Tests for the per-function call statistics (DYNEMIT_STATS)
+ */
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <dynemit.h>
+
+#define THREADS 4
+#define THREAD_CALLS 1000
+
+static float a[4096], b[4096], out[4096];
+
+static int find(const char *name, dynemit_stats_t *s)
+{
+    dynemit_stats_t all[DYNEMIT_STATS_MAX_FUNCS];
+    size_t n = dynemit_stats_snapshot(all, DYNEMIT_STATS_MAX_FUNCS);
+    for (size_t i = 0; i < n && i < DYNEMIT_STATS_MAX_FUNCS; i++) {
+        if (strcmp(all[i].name, name) == 0) {
+            *s = all[i];
+            return 0;
+        }
+    }
+    return -1;
+}
+
+static int test_disabled(void)
+{
+    printf("  Testing with stats off... ");
+
+    vector_add_f32(a, b, out, 100);
+    char buf[256];
+    if (dynemit_stats_snapshot(nullptr, 0) != 0 ||
+        dynemit_stats_dump(buf, sizeof(buf), DYNEMIT_STATS_JSON) == 0 ||
+        !strstr(buf, "\"functions\": []")) {
+        printf("FAIL (functions tracked: %s)\n", buf);
+        return 1;
+    }
+
+    printf("OK\n");
+    return 0;
+}
+
+static int test_counts(void)
+{
+    printf("  Testing call counts and size histogram... ");
+
+    // Sizes in buckets 0 (empty), 2 (4-15), 4 (64-255) and 6 (1024-4095)
+    const size_t sizes[] = { 0, 5, 100, 100, 4000 };
+    dynemit_stats_reset();
+    uint64_t elements = 0;
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+        vector_add_f32(a, b, out, sizes[i]);
+        elements += sizes[i];
+    }
+    (void)dot_f32(a, b, 64);
+
+    dynemit_stats_t s;
+    if (find("vector_add_f32", &s) != 0) {
+        printf("FAIL (vector_add_f32 not tracked)\n");
+        return 1;
+    }
+    // Autotuned, the float add routes each call by size instead of one level
+    simd_level_t level = dynemit_autotune_mode() ? DYNEMIT_STATS_LEVEL_TUNED : detect_simd_level_ts();
+    if (s.calls != 5 || s.elements != elements || s.level != level) {
+        printf("FAIL (calls %llu, elements %llu, level %s)\n", (unsigned long long)s.calls,
+               (unsigned long long)s.elements, simd_level_name(s.level));
+        return 1;
+    }
+    const uint64_t hist[DYNEMIT_STATS_BUCKETS] = { [0] = 1, [2] = 1, [4] = 2, [6] = 1 };
+    if (memcmp(s.size_hist, hist, sizeof(hist)) != 0) {
+        printf("FAIL (size histogram)\n");
+        return 1;
+    }
+    if ((dynemit_stats_mode() == 2) != (s.cycles > 0)) {
+        printf("FAIL (%llu cycles in mode %d)\n", (unsigned long long)s.cycles, dynemit_stats_mode());
+        return 1;
+    }
+
+    if (find("dot_f32", &s) != 0 || s.calls != 1 || s.elements != 64 || s.size_hist[4] != 1) {
+        printf("FAIL (dot_f32)\n");
+        return 1;
+    }
+
+    printf("OK\n");
+    return 0;
+}
+
+static int test_bound_level(void)
+{
+    printf("  Testing the level of a kernel bound below the detected one... ");
+
+    // scatter_add_f32 binds the scalar loop at every level
+    float hist[4] = { 0 };
+    const int32_t idx[3] = { 0, 2, 2 };
+    const float values[3] = { 1.0f, 2.0f, 3.0f };
+    scatter_add_f32(hist, idx, values, 3);
+
+    dynemit_stats_t s;
+    if (find("scatter_add_f32", &s) != 0 || s.level != SIMD_SCALAR) {
+        printf("FAIL (level %s)\n", simd_level_name(s.level));
+        return 1;
+    }
+
+    char buf[16384];
+    dynemit_stats_dump(buf, sizeof(buf), DYNEMIT_STATS_JSON);
+    if (!strstr(buf, "{\"name\": \"scatter_add_f32\", \"level\": \"Scalar\"") ||
+        (dynemit_autotune_mode() && !strstr(buf, "{\"name\": \"vector_add_f32\", \"level\": \"tuned\""))) {
+        printf("FAIL (json: %s)\n", buf);
+        return 1;
+    }
+
+    printf("OK\n");
+    return 0;
+}
+
+static void *mul_thread(void *arg)
+{
+    (void)arg;
+    float x[16], y[16], z[16];
+    for (int i = 0; i < 16; i++)
+        x[i] = y[i] = (float)i;
+    for (int i = 0; i < THREAD_CALLS; i++)
+        vector_mul_f32(x, y, z, 16);
+    return nullptr;
+}
+
+static int test_threads(void)
+{
+    printf("  Testing per-thread counters... ");
+
+    // Exited threads still count
+    dynemit_stats_reset();
+    pthread_t threads[THREADS];
+    for (int t = 0; t < THREADS; t++)
+        pthread_create(&threads[t], nullptr, mul_thread, nullptr);
+    for (int t = 0; t < THREADS; t++)
+        pthread_join(threads[t], nullptr);
+    mul_thread(nullptr);
+
+    dynemit_stats_t s;
+    const uint64_t calls = (THREADS + 1) * THREAD_CALLS;
+    if (find("vector_mul_f32", &s) != 0 || s.calls != calls || s.elements != 16 * calls ||
+        s.size_hist[3] != calls) {
+        printf("FAIL (%llu calls, expect %llu)\n", (unsigned long long)s.calls, (unsigned long long)calls);
+        return 1;
+    }
+
+    dynemit_stats_reset();
+    if (find("vector_mul_f32", &s) != 0 || s.calls != 0 || s.elements != 0) {
+        printf("FAIL (not zero after reset)\n");
+        return 1;
+    }
+
+    printf("OK\n");
+    return 0;
+}
+
+static int test_dump(void)
+{
+    printf("  Testing dynemit_stats_dump... ");
+
+    dynemit_stats_reset();
+    vector_sub_f32(a, b, out, 10);
+
+    char buf[16384];
+    size_t len = dynemit_stats_dump(buf, sizeof(buf), DYNEMIT_STATS_TEXT);
+    if (len >= sizeof(buf) || strlen(buf) != len || !strstr(buf, "vector_sub_f32") ||
+        !strstr(buf, " 4-15:1")) {
+        printf("FAIL (text: %s)\n", buf);
+        return 1;
+    }
+
+    len = dynemit_stats_dump(buf, sizeof(buf), DYNEMIT_STATS_JSON);
+    if (len >= sizeof(buf) || strncmp(buf, "{\"mode\": \"", 10) != 0 ||
+        !strstr(buf, "{\"name\": \"vector_sub_f32\", \"level\": ") ||
+        !strstr(buf, "\"calls\": 1, \"elements\": 10, ")) {
+        printf("FAIL (json: %s)\n", buf);
+        return 1;
+    }
+
+    // snprintf() semantics
+    char small[16];
+    if (dynemit_stats_dump(small, sizeof(small), DYNEMIT_STATS_JSON) != len ||
+        strlen(small) != sizeof(small) - 1 || strncmp(small, buf, sizeof(small) - 1) != 0) {
+        printf("FAIL (truncation)\n");
+        return 1;
+    }
+
+    printf("OK\n");
+    return 0;
+}
+
+int main(void)
+{
+    int failures = 0;
+
+    for (int i = 0; i < 4096; i++) {
+        a[i] = (float)i;
+        b[i] = 1.0f;
+    }
+
+    printf("Testing call statistics:\n");
+    printf("  Stats mode: %d\n\n", dynemit_stats_mode());
+
+    if (dynemit_stats_mode() == 0) {
+        failures += test_disabled();
+    } else {
+        failures += test_counts();
+        failures += test_bound_level();
+        failures += test_threads();
+        failures += test_dump();
+    }
+
+    printf("\n");
+    if (failures == 0) {
+        printf("All tests passed!\n");
+        return 0;
+    } else {
+        printf("%d test(s) failed!\n", failures);
+        return 1;
+    }
+}
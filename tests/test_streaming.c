@@ -0,0 +1,146 @@
+/**
+ * @file test_streaming.c
+ * @brief Tests for the non-temporal streaming-store path of add/sub/mul
+ *
+ * The streaming threshold is forced to 0, so every size also takes the
+ * prefetching large path; it is checked at several prefetch distances.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <dynemit.h>
+
+#define MAX_N 1031
+
+// Sizes around the vector widths plus the cache-line head peel
+static const size_t sizes[] = { 0, 1, 3, 4, 15, 16, 17, 31, 32, 33, 63, 64, 65, 100, 1000, MAX_N };
+static const int num_sizes = sizeof(sizes) / sizeof(sizes[0]);
+
+static float a[MAX_N], b[MAX_N];
+// Room for every misalignment of the output within a cache line
+static float out_buf[MAX_N + 16] __attribute__((aligned(64)));
+
+typedef void (*binary_f32_func_t)(const float *, const float *, float *, size_t);
+
+static int check_kernel(const char *name, binary_f32_func_t kernel, char op)
+{
+    for (size_t offset = 0; offset < 16; offset++) {
+        float *out = out_buf + offset;
+        for (int s = 0; s < num_sizes; s++) {
+            size_t n = sizes[s];
+            out[n] = -1.0f;  // guard past the end
+            kernel(a, b, out, n);
+            for (size_t i = 0; i < n; i++) {
+                float expect = op == '+' ? a[i] + b[i] : op == '-' ? a[i] - b[i] : a[i] * b[i];
+                if (out[i] != expect) {
+                    printf("FAIL (%s, n=%zu, offset=%zu: out[%zu] = %f, expect %f)\n",
+                           name, n, offset, i, out[i], expect);
+                    return 1;
+                }
+            }
+            if (out[n] != -1.0f) {
+                printf("FAIL (%s, n=%zu, offset=%zu: wrote past the end)\n", name, n, offset);
+                return 1;
+            }
+        }
+    }
+    return 0;
+}
+
+static int test_threshold(void)
+{
+    printf("  Testing dynemit_stream_threshold() override... ");
+
+    if (dynemit_stream_threshold() != 0) {
+        printf("FAIL (got %zu, expected 0 from DYNEMIT_STREAM_THRESHOLD)\n",
+               dynemit_stream_threshold());
+        return 1;
+    }
+
+    printf("OK (LLC %zu KiB)\n", dynemit_llc_size() / 1024);
+    return 0;
+}
+
+static int test_streaming_kernels(void)
+{
+    printf("  Testing streaming add/sub/mul at every output offset... ");
+
+    if (check_kernel("add", vector_add_f32, '+')) return 1;
+    if (check_kernel("sub", vector_sub_f32, '-')) return 1;
+    if (check_kernel("mul", vector_mul_f32, '*')) return 1;
+
+    printf("OK\n");
+    return 0;
+}
+
+static int test_prefetch_distances(void)
+{
+    printf("  Testing every level at several prefetch distances... ");
+
+    static const size_t distances[] = { 0, 64, 1000, 4096, 1 << 20 };
+    static const struct {
+        const char *name;
+        char op;
+    } ops[] = { { "vector_add_f32", '+' }, { "vector_sub_f32", '-' }, { "vector_mul_f32", '*' } };
+
+    size_t initial = dynemit_prefetch_distance();
+    if (dynemit_default_prefetch_distance() == 0) {
+        printf("FAIL (no default distance)\n");
+        return 1;
+    }
+
+    int kernels = 0;
+    for (size_t d = 0; d < sizeof(distances) / sizeof(distances[0]); d++) {
+        dynemit_set_prefetch_distance(distances[d]);
+        if (dynemit_prefetch_distance() != distances[d]) {
+            printf("FAIL (set %zu, got %zu)\n", distances[d], dynemit_prefetch_distance());
+            return 1;
+        }
+        for (size_t o = 0; o < sizeof(ops) / sizeof(ops[0]); o++) {
+            void *prev = nullptr;
+            for (int l = SIMD_SCALAR; l <= (int)detect_simd_level(); l++) {
+                void *k = dynemit_get_kernel(ops[o].name, (simd_level_t)l);
+                if (!k || k == prev)
+                    continue;
+                prev = k;
+                if (check_kernel(ops[o].name, (binary_f32_func_t)k, ops[o].op))
+                    return 1;
+                kernels++;
+            }
+        }
+    }
+    dynemit_set_prefetch_distance(initial);
+
+    printf("OK (%d kernel runs, default %zu bytes)\n", kernels, initial);
+    return 0;
+}
+
+int main(void)
+{
+    int failures = 0;
+
+    // Force the streaming path for every size, before the threshold is cached
+    setenv("DYNEMIT_STREAM_THRESHOLD", "0", 1);
+
+    printf("Testing streaming stores:\n");
+    printf("  Current SIMD level: %s\n\n", simd_level_name(detect_simd_level()));
+
+    for (int i = 0; i < MAX_N; i++) {
+        a[i] = (float)i * 0.5f + 1.0f;
+        b[i] = (float)(MAX_N - i) * 0.25f;
+    }
+
+    failures += test_threshold();
+    failures += test_streaming_kernels();
+    failures += test_prefetch_distances();
+
+    printf("\n");
+    if (failures == 0) {
+        printf("All tests passed!\n");
+        return 0;
+    } else {
+        printf("%d test(s) failed!\n", failures);
+        return 1;
+    }
+}
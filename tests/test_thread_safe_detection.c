@@ -143,7 +143,7 @@ static int test_valid_simd_level(void)
     
     simd_level_t level = detect_simd_level_ts();
     
-    if (level < SIMD_SCALAR || level > SIMD_AVX512F) {
+    if (level < SIMD_SCALAR || level > SIMD_RVV) {
         printf("FAIL\n");
         printf("    Got invalid level: %d\n", level);
         return 1;
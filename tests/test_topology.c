@@ -0,0 +1,183 @@
+/**
+ * @file test_topology.c
+ * @brief Tests for dynemit_cpu_topology()
+ */
+
+#define _GNU_SOURCE
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <dynemit.h>
+
+#define NUM_THREADS 8
+
+static int test_consistency(void)
+{
+    printf("  Testing topology consistency... ");
+
+    const dynemit_cpu_topology_t *t = dynemit_cpu_topology();
+    printf("(%u logical, %u cores, %u threads/core, %u-byte lines, L1d %zu KiB, L2 %zu KiB, L3 %zu KiB) ",
+           t->logical_cpus, t->physical_cores, t->threads_per_core, t->line_size,
+           t->l1d_size / 1024, t->l2_size / 1024, t->l3_size / 1024);
+
+    if (t->l1d_size != dynemit_cache_size(1) || t->l2_size != dynemit_cache_size(2) ||
+        t->l3_size != dynemit_cache_size(3)) {
+        printf("FAIL (cache sizes differ from dynemit_cache_size)\n");
+        return 1;
+    }
+    if (t->line_size < 16 || (t->line_size & (t->line_size - 1))) {
+        printf("FAIL (line size %u)\n", t->line_size);
+        return 1;
+    }
+    if (t->logical_cpus == 0 || t->physical_cores == 0 || t->threads_per_core == 0 ||
+        t->physical_cores > t->logical_cpus ||
+        t->physical_cores * t->threads_per_core < t->logical_cpus) {
+        printf("FAIL (core counts)\n");
+        return 1;
+    }
+    if (t->hybrid ? t->perf_cpus + t->efficiency_cpus > t->logical_cpus
+                  : t->perf_cpus != t->logical_cpus || t->efficiency_cpus != 0) {
+        printf("FAIL (core types: %u perf, %u efficiency)\n", t->perf_cpus, t->efficiency_cpus);
+        return 1;
+    }
+    if (t->avx512_all_cores && !dynemit_cpu_has(DYNEMIT_CPU_AVX512F)) {
+        printf("FAIL (AVX-512 on all cores without AVX-512F)\n");
+        return 1;
+    }
+
+    printf("OK\n");
+    return 0;
+}
+
+static int test_affinity_restored(void)
+{
+    printf("  Testing caller affinity is unchanged... ");
+
+    cpu_set_t before, after;
+    CPU_ZERO(&before);
+    CPU_ZERO(&after);
+    sched_getaffinity(0, sizeof(before), &before);
+    const dynemit_cpu_topology_t *t = dynemit_cpu_topology();
+    sched_getaffinity(0, sizeof(after), &after);
+
+    if (!CPU_EQUAL(&before, &after)) {
+        printf("FAIL\n");
+        return 1;
+    }
+
+    printf("OK (%s)\n", t->hybrid ? "hybrid" : "not hybrid");
+    return 0;
+}
+
+static void *topology_thread(void *arg)
+{
+    *(const dynemit_cpu_topology_t **)arg = dynemit_cpu_topology();
+    return nullptr;
+}
+
+static int test_cached(void)
+{
+    printf("  Testing concurrent calls share one result... ");
+
+    pthread_t threads[NUM_THREADS];
+    const dynemit_cpu_topology_t *results[NUM_THREADS];
+    for (int i = 0; i < NUM_THREADS; i++)
+        pthread_create(&threads[i], nullptr, topology_thread, &results[i]);
+    for (int i = 0; i < NUM_THREADS; i++)
+        pthread_join(threads[i], nullptr);
+
+    const dynemit_cpu_topology_t *t = dynemit_cpu_topology();
+    for (int i = 0; i < NUM_THREADS; i++) {
+        if (results[i] != t) {
+            printf("FAIL (thread %d got a different pointer)\n", i);
+            return 1;
+        }
+    }
+
+    printf("OK\n");
+    return 0;
+}
+
+static int test_numa(void)
+{
+    printf("  Testing NUMA nodes... ");
+
+    const dynemit_cpu_topology_t *t = dynemit_cpu_topology();
+    if (t->numa_nodes == 0) {
+        printf("FAIL (no nodes)\n");
+        return 1;
+    }
+    int cpu = sched_getcpu();
+    int node = dynemit_numa_node_of_cpu(cpu);
+    if (node < -1) {
+        printf("FAIL (cpu %d on node %d)\n", cpu, node);
+        return 1;
+    }
+    if (dynemit_numa_node_of_cpu(-1) != -1 || dynemit_numa_node_of_cpu(CPU_SETSIZE) != -1) {
+        printf("FAIL (out-of-range CPU has a node)\n");
+        return 1;
+    }
+
+    printf("OK (%u node(s), cpu %d on node %d)\n", t->numa_nodes, cpu, node);
+    return 0;
+}
+
+static int test_core_of_cpu(void)
+{
+    printf("  Testing CPU to core mapping... ");
+
+    const dynemit_cpu_topology_t *t = dynemit_cpu_topology();
+    static unsigned char seen[CPU_SETSIZE];
+    unsigned cores = 0, mapped = 0;
+    for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+        int core = dynemit_core_of_cpu(cpu);
+        if (core < -1 || core >= CPU_SETSIZE) {
+            printf("FAIL (cpu %d on core %d)\n", cpu, core);
+            return 1;
+        }
+        if (core < 0)
+            continue;
+        mapped++;
+        if (!seen[core]++)
+            cores++;
+    }
+    // Without sysfs topology nothing is mapped; otherwise the distinct
+    // cores are the physical cores
+    if (mapped && cores != t->physical_cores) {
+        printf("FAIL (%u cores, topology says %u)\n", cores, t->physical_cores);
+        return 1;
+    }
+    if (dynemit_core_of_cpu(-1) != -1 || dynemit_core_of_cpu(CPU_SETSIZE) != -1) {
+        printf("FAIL (out-of-range CPU has a core)\n");
+        return 1;
+    }
+
+    printf("OK (%u CPU(s) on %u core(s))\n", mapped, cores);
+    return 0;
+}
+
+int main(void)
+{
+    int failures = 0;
+
+    printf("Testing CPU topology:\n");
+    printf("  Current SIMD level: %s\n\n", simd_level_name(detect_simd_level()));
+
+    // Concurrent first calls before anything else has cached the result
+    failures += test_cached();
+    failures += test_consistency();
+    failures += test_affinity_restored();
+    failures += test_numa();
+    failures += test_core_of_cpu();
+
+    printf("\n");
+    if (failures == 0) {
+        printf("All tests passed!\n");
+        return 0;
+    } else {
+        printf("%d test(s) failed!\n", failures);
+        return 1;
+    }
+}
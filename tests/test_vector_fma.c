@@ -0,0 +1,72 @@
+#include <stdio.h>
+#include <math.h>
+#include <dynemit.h>
+
+// Not a multiple of any SIMD width, so every variant exercises its tail loop
+#define N 37
+
+// Fused and unfused paths round differently, allow a few ULPs of slack
+static int
+nearly_equal(float got, float expect)
+{
+    return fabsf(got - expect) <= 1e-6f * fmaxf(1.0f, fabsf(expect));
+}
+
+int main(void)
+{
+    printf("Testing fused multiply-add operations:\n");
+    printf("======================================\n\n");
+
+    float a[N], b[N], c[N], result[N], y[N];
+
+    for (int i = 0; i < N; i++) {
+        a[i] = (float)i * 0.5f;
+        b[i] = (float)(i + 1);
+        c[i] = (float)(N - i) * 0.25f;
+    }
+
+    // Test vector_fma_f32
+    vector_fma_f32(a, b, c, result, N);
+    printf("vector_fma_f32 test:\n");
+    printf("  result[0..3] = [%.2f, %.2f, %.2f, %.2f]\n", result[0], result[1], result[2], result[3]);
+
+    int fma_ok = 1;
+    for (int i = 0; i < N; i++) {
+        if (!nearly_equal(result[i], a[i] * b[i] + c[i])) {
+            printf("  mismatch at %d: got %f, expect %f\n", i, result[i], a[i] * b[i] + c[i]);
+            fma_ok = 0;
+            break;
+        }
+    }
+    printf("  Status: %s\n\n", fma_ok ? "OK" : "FAILED");
+
+    // Test vector_axpy_f32 (in place on y)
+    const float alpha = 1.5f;
+    for (int i = 0; i < N; i++)
+        y[i] = c[i];
+    vector_axpy_f32(alpha, a, y, N);
+    printf("vector_axpy_f32 test (alpha = %.1f):\n", alpha);
+    printf("  y[0..3] = [%.2f, %.2f, %.2f, %.2f]\n", y[0], y[1], y[2], y[3]);
+
+    int axpy_ok = 1;
+    for (int i = 0; i < N; i++) {
+        if (!nearly_equal(y[i], alpha * a[i] + c[i])) {
+            printf("  mismatch at %d: got %f, expect %f\n", i, y[i], alpha * a[i] + c[i]);
+            axpy_ok = 0;
+            break;
+        }
+    }
+    printf("  Status: %s\n\n", axpy_ok ? "OK" : "FAILED");
+
+    // Zero-length calls must not touch memory
+    vector_fma_f32(a, b, c, result, 0);
+    vector_axpy_f32(alpha, a, y, 0);
+
+    if (fma_ok && axpy_ok) {
+        printf("All tests PASSED!\n");
+        return 0;
+    } else {
+        printf("Some tests FAILED!\n");
+        return 1;
+    }
+}
@@ -0,0 +1,235 @@
+/**
+ * @file test_vector_types.c
+ * @brief Tests for the f64, i32 (wrapping) and i16 (saturating) add/sub/mul kernels
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <dynemit.h>
+
+// Covers every tail length of every SIMD width (up to 32 int16 lanes)
+#define MAX_N 100
+#define GUARD 8
+
+static double  fa[MAX_N], fb[MAX_N], fout[MAX_N + GUARD];
+static int32_t ia[MAX_N], ib[MAX_N], iout[MAX_N + GUARD];
+static int16_t sa[MAX_N], sb[MAX_N], sout[MAX_N + GUARD];
+
+static int16_t sat16(int32_t v)
+{
+    return (int16_t)(v > INT16_MAX ? INT16_MAX : v < INT16_MIN ? INT16_MIN : v);
+}
+
+static int test_f64(void)
+{
+    printf("  Testing f64 add/sub/mul... ");
+
+    for (size_t n = 0; n <= MAX_N; n++) {
+        for (int op = 0; op < 3; op++) {
+            for (size_t i = 0; i < MAX_N + GUARD; i++)
+                fout[i] = -1.0;
+            if (op == 0) vector_add_f64(fa, fb, fout, n);
+            if (op == 1) vector_sub_f64(fa, fb, fout, n);
+            if (op == 2) vector_mul_f64(fa, fb, fout, n);
+            for (size_t i = 0; i < n; i++) {
+                double expect = op == 0 ? fa[i] + fb[i] : op == 1 ? fa[i] - fb[i] : fa[i] * fb[i];
+                if (fout[i] != expect) {
+                    printf("FAIL (op %d, n=%zu: out[%zu] = %f, expect %f)\n", op, n, i, fout[i], expect);
+                    return 1;
+                }
+            }
+            for (size_t i = n; i < MAX_N + GUARD; i++) {
+                if (fout[i] != -1.0) {
+                    printf("FAIL (op %d, n=%zu: wrote out[%zu])\n", op, n, i);
+                    return 1;
+                }
+            }
+        }
+    }
+
+    printf("OK\n");
+    return 0;
+}
+
+static int test_i32(void)
+{
+    printf("  Testing i32 add/sub/mul... ");
+
+    for (size_t n = 0; n <= MAX_N; n++) {
+        for (int op = 0; op < 3; op++) {
+            for (size_t i = 0; i < MAX_N + GUARD; i++)
+                iout[i] = -1;
+            if (op == 0) vector_add_i32(ia, ib, iout, n);
+            if (op == 1) vector_sub_i32(ia, ib, iout, n);
+            if (op == 2) vector_mul_i32(ia, ib, iout, n);
+            for (size_t i = 0; i < n; i++) {
+                uint32_t x = (uint32_t)ia[i], y = (uint32_t)ib[i];
+                int32_t expect = (int32_t)(op == 0 ? x + y : op == 1 ? x - y : x * y);
+                if (iout[i] != expect) {
+                    printf("FAIL (op %d, n=%zu: out[%zu] = %d, expect %d)\n", op, n, i, iout[i], expect);
+                    return 1;
+                }
+            }
+            for (size_t i = n; i < MAX_N + GUARD; i++) {
+                if (iout[i] != -1) {
+                    printf("FAIL (op %d, n=%zu: wrote out[%zu])\n", op, n, i);
+                    return 1;
+                }
+            }
+        }
+    }
+
+    printf("OK\n");
+    return 0;
+}
+
+static int test_i32_wraparound(void)
+{
+    printf("  Testing i32 wraparound... ");
+
+    const int32_t a[4] = { INT32_MAX, INT32_MIN, INT32_MAX, 65536 };
+    const int32_t b[4] = { 1, 1, 2, 65536 };
+    int32_t out[4];
+
+    vector_add_i32(a, b, out, 4);
+    if (out[0] != INT32_MIN) {
+        printf("FAIL (INT32_MAX + 1 = %d)\n", out[0]);
+        return 1;
+    }
+    vector_sub_i32(a, b, out, 4);
+    if (out[1] != INT32_MAX) {
+        printf("FAIL (INT32_MIN - 1 = %d)\n", out[1]);
+        return 1;
+    }
+    vector_mul_i32(a, b, out, 4);
+    if (out[2] != -2 || out[3] != 0) {
+        printf("FAIL (INT32_MAX * 2 = %d, 65536^2 = %d)\n", out[2], out[3]);
+        return 1;
+    }
+
+    printf("OK\n");
+    return 0;
+}
+
+static int test_i16(void)
+{
+    printf("  Testing i16 add/sub/mul (saturating)... ");
+
+    for (size_t n = 0; n <= MAX_N; n++) {
+        for (int op = 0; op < 3; op++) {
+            for (size_t i = 0; i < MAX_N + GUARD; i++)
+                sout[i] = -1;
+            if (op == 0) vector_add_i16(sa, sb, sout, n);
+            if (op == 1) vector_sub_i16(sa, sb, sout, n);
+            if (op == 2) vector_mul_i16(sa, sb, sout, n);
+            for (size_t i = 0; i < n; i++) {
+                int32_t x = sa[i], y = sb[i];
+                int16_t expect = sat16(op == 0 ? x + y : op == 1 ? x - y : x * y);
+                if (sout[i] != expect) {
+                    printf("FAIL (op %d, n=%zu: out[%zu] = %d, expect %d)\n", op, n, i, sout[i], expect);
+                    return 1;
+                }
+            }
+            for (size_t i = n; i < MAX_N + GUARD; i++) {
+                if (sout[i] != -1) {
+                    printf("FAIL (op %d, n=%zu: wrote out[%zu])\n", op, n, i);
+                    return 1;
+                }
+            }
+        }
+    }
+
+    printf("OK\n");
+    return 0;
+}
+
+static int test_i16_saturation(void)
+{
+    printf("  Testing i16 saturation limits... ");
+
+    // Long enough to go through the vector body at every level
+    enum { n = 64 };
+    int16_t a[n], b[n], out[n];
+    for (int i = 0; i < n; i++) {
+        a[i] = (i & 1) ? INT16_MIN : INT16_MAX;
+        b[i] = (i & 1) ? INT16_MIN : INT16_MAX;
+    }
+
+    vector_add_i16(a, b, out, n);
+    for (int i = 0; i < n; i++) {
+        if (out[i] != ((i & 1) ? INT16_MIN : INT16_MAX)) {
+            printf("FAIL (add: out[%d] = %d)\n", i, out[i]);
+            return 1;
+        }
+    }
+
+    // MAX * MAX and MIN * MIN both saturate high; MIN * -1 as well
+    vector_mul_i16(a, b, out, n);
+    for (int i = 0; i < n; i++) {
+        if (out[i] != INT16_MAX) {
+            printf("FAIL (mul: out[%d] = %d)\n", i, out[i]);
+            return 1;
+        }
+    }
+
+    for (int i = 0; i < n; i++) {
+        a[i] = INT16_MIN;
+        b[i] = (i & 1) ? 1 : -1;
+    }
+    vector_sub_i16(a, b, out, n);
+    for (int i = 0; i < n; i++) {
+        int16_t expect = (i & 1) ? INT16_MIN : INT16_MIN + 1;
+        if (out[i] != expect) {
+            printf("FAIL (sub: out[%d] = %d, expect %d)\n", i, out[i], expect);
+            return 1;
+        }
+    }
+    vector_mul_i16(a, b, out, n);
+    for (int i = 0; i < n; i++) {
+        int16_t expect = (i & 1) ? INT16_MIN : INT16_MAX;
+        if (out[i] != expect) {
+            printf("FAIL (mul: out[%d] = %d, expect %d)\n", i, out[i], expect);
+            return 1;
+        }
+    }
+
+    printf("OK\n");
+    return 0;
+}
+
+int main(void)
+{
+    int failures = 0;
+
+    printf("Testing f64/i32/i16 element types:\n");
+    printf("  Current SIMD level: %s\n\n", simd_level_name(detect_simd_level()));
+
+    // Deterministic pseudo-random inputs covering the full integer ranges,
+    // so the i32 products wrap and the i16 results saturate regularly
+    uint32_t seed = 12345;
+    for (int i = 0; i < MAX_N; i++) {
+        seed = seed * 1103515245u + 12345u;
+        ia[i] = (int32_t)seed;
+        sa[i] = (int16_t)(seed >> 16);
+        fa[i] = (double)(int32_t)seed * 1e-3;
+        seed = seed * 1103515245u + 12345u;
+        ib[i] = (int32_t)seed;
+        sb[i] = (i % 3) ? (int16_t)(seed >> 16) : (int16_t)((int32_t)(seed >> 24) - 128);
+        fb[i] = (double)(int32_t)seed * 1e-5 + 0.5;
+    }
+
+    failures += test_f64();
+    failures += test_i32();
+    failures += test_i32_wraparound();
+    failures += test_i16();
+    failures += test_i16_saturation();
+
+    printf("\n");
+    if (failures == 0) {
+        printf("All tests passed!\n");
+        return 0;
+    } else {
+        printf("%d test(s) failed!\n", failures);
+        return 1;
+    }
+}
@@ -0,0 +1,232 @@
+/**
+ * @file test_vmath.c
+ * @brief Accuracy tests for the transcendental kernels of <dynemit/vmath.h>
+ *
+ * Every level kernel of both tiers is run over a sample of all finite
+ * floats (every 65537th bit pattern, plus a dense sweep of the ranges where
+ * the results are not saturated) and compared against the double-precision
+ * libm function, with the error measured in ULPs of the correctly rounded
+ * float result. The bounds are the ones documented in vmath.h. Special
+ * inputs (NaNs, infinities, zeros, subnormals, the overflow and underflow
+ * edges) have exact expectations.
+ */
+
+#include <float.h>
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <dynemit.h>
+
+#define SWEEP 65536
+#define MAX_N 1031
+
+typedef void (*vmath_fn)(const float *, float *, size_t);
+
+typedef struct {
+    const char *name;
+    double (*ref)(double);
+    double lo, hi;          // range of the dense sweep
+    double max_ulp[2];      // precise, fast
+} func_t;
+
+static double sigmoid(double x) { return 1.0 / (1.0 + exp(-x)); }
+
+static const func_t funcs[] = {
+    { "exp",     exp,     -104.0, 89.0, { 1.5, 2.5 } },
+    { "log",     log,     0.0,    1e6,  { 1.0, 1.5 } },
+    { "tanh",    tanh,    -10.0,  10.0, { 2.0, 2.5 } },
+    { "sigmoid", sigmoid, -104.0, 20.0, { 3.0, 4.0 } },
+    { "erf",     erf,     -4.0,   4.0,  { 3.0, 3.0 } },
+};
+static const int num_funcs = sizeof(funcs) / sizeof(funcs[0]);
+
+static float in[SWEEP], out[SWEEP + 1];
+
+// Error of got against the exact ref, in ULPs of the float nearest ref
+static double
+ulp_error(float got, double ref)
+{
+    float rf = (float)ref;
+    if (isnan(ref))
+        return isnan(got) ? 0.0 : INFINITY;
+    if (isinf(rf))
+        return got == rf ? 0.0 : INFINITY;
+    if (isnan(got) || isinf(got))
+        return INFINITY;
+    int e;
+    frexp(rf == 0.0f ? 0x1p-149 : rf, &e);
+    double ulp = ldexp(1.0, e - 24 < -149 ? -149 : e - 24);
+    return fabs((double)got - ref) / ulp;
+}
+
+static int
+check_block(vmath_fn fn, const func_t *f, int fast, size_t n, double *worst)
+{
+    fn(in, out, n);
+    for (size_t i = 0; i < n; i++) {
+        double err = ulp_error(out[i], f->ref(in[i]));
+        if (err > f->max_ulp[fast]) {
+            printf("FAIL (%s(%a) = %a, %.2f ulp, bound %.1f)\n", f->name, in[i], out[i], err, f->max_ulp[fast]);
+            return 1;
+        }
+        if (err > *worst)
+            *worst = err;
+    }
+    return 0;
+}
+
+static int
+check_accuracy(vmath_fn fn, const func_t *f, int fast, double *worst)
+{
+    // Every 65537th bit pattern, the sign bit included
+    uint64_t bits = 0;
+    while (bits < ((uint64_t)1 << 32)) {
+        size_t n = 0;
+        for (; n < SWEEP && bits < ((uint64_t)1 << 32); n++, bits += 65537) {
+            uint32_t b = (uint32_t)bits;
+            memcpy(&in[n], &b, sizeof(b));
+        }
+        if (check_block(fn, f, fast, n, worst))
+            return 1;
+    }
+
+    // Densely over the interesting range
+    for (size_t i = 0; i < SWEEP; i++)
+        in[i] = (float)(f->lo + (f->hi - f->lo) * (double)i / (SWEEP - 1));
+    return check_block(fn, f, fast, SWEEP, worst);
+}
+
+static int
+check_specials(vmath_fn fn, const func_t *f)
+{
+    static const float specials[] = {
+        0.0f, -0.0f, INFINITY, -INFINITY, 0x1p-149f, -0x1p-149f, 0x1p-127f, 0x1.fffffep-127f, 0x1p-126f,
+        1.0f, -1.0f, 0.625f, -0.625f, 88.72f, 88.73f, -87.33f, -103.9f, -104.0f, -150.0f, 1e30f, -1e30f,
+        FLT_MAX, -FLT_MAX,
+    };
+    const size_t n = sizeof(specials) / sizeof(specials[0]);
+
+    memcpy(in, specials, sizeof(specials));
+    in[n] = NAN;
+    in[n + 1] = -NAN;
+    fn(in, out, n + 2);
+    for (size_t i = 0; i < n + 2; i++) {
+        double ref = f->ref(in[i]);
+        // Results that saturate (0, 1 or infinity) and NaNs must be exact
+        if ((isnan(ref) || isinf((float)ref) || ref == 0.0 || ref == 1.0 || ref == -1.0) ?
+                !(isnan(ref) ? isnan(out[i]) : out[i] == (float)ref) :
+                ulp_error(out[i], ref) > f->max_ulp[1]) {
+            printf("FAIL (%s(%a) = %a, expect %a)\n", f->name, in[i], out[i], (float)ref);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// Every length up to MAX_N matches the full-vector results and stops at n
+static int
+check_lengths(vmath_fn fn)
+{
+    static float ref[MAX_N];
+    for (size_t i = 0; i < MAX_N; i++)
+        in[i] = (float)((int)(i % 97) - 48) * 0.125f;
+    fn(in, ref, MAX_N);
+
+    for (size_t n = 0; n < MAX_N; n += n < 70 ? 1 : 37) {
+        out[n] = -7.0f;
+        fn(in, out, n);
+        if (memcmp(out, ref, n * sizeof(float)) != 0 || out[n] != -7.0f) {
+            printf("FAIL (n=%zu)\n", n);
+            return 1;
+        }
+    }
+
+    // In place
+    memcpy(out, in, MAX_N * sizeof(float));
+    fn(out, out, MAX_N);
+    if (memcmp(out, ref, MAX_N * sizeof(float)) != 0) {
+        printf("FAIL (in place)\n");
+        return 1;
+    }
+    return 0;
+}
+
+static int
+test_function(const func_t *f, int fast)
+{
+    char name[64];
+    snprintf(name, sizeof(name), "vector_%s_f32%s", f->name, fast ? "_fast" : "");
+    printf("  Testing %-24s ", name);
+
+    int kernels = 0;
+    double worst = 0.0;
+    void *prev = nullptr;
+    for (int l = SIMD_SCALAR; l <= (int)detect_simd_level(); l++) {
+        // Levels of another architecture's ladder have no kernel
+        void *fn = dynemit_get_kernel(name, (simd_level_t)l);
+        if (!fn || fn == prev)
+            continue;
+        prev = fn;
+        if (check_accuracy((vmath_fn)fn, f, fast, &worst) || check_specials((vmath_fn)fn, f) ||
+            check_lengths((vmath_fn)fn))
+            return 1;
+        kernels++;
+    }
+    if (!kernels) {
+        printf("FAIL (not registered)\n");
+        return 1;
+    }
+
+    printf("OK (%d kernels, max %.2f ulp)\n", kernels, worst);
+    return 0;
+}
+
+static int
+test_public(void)
+{
+    printf("  Testing the dispatched symbols...       ");
+
+    static const vmath_fn fns[][2] = {
+        { vector_exp_f32, vector_exp_f32_fast },         { vector_log_f32, vector_log_f32_fast },
+        { vector_tanh_f32, vector_tanh_f32_fast },       { vector_sigmoid_f32, vector_sigmoid_f32_fast },
+        { vector_erf_f32, vector_erf_f32_fast },
+    };
+    for (int i = 0; i < num_funcs; i++) {
+        for (int fast = 0; fast < 2; fast++) {
+            double worst = 0.0;
+            if (check_specials(fns[i][fast], &funcs[i]) || check_lengths(fns[i][fast]))
+                return 1;
+            for (size_t j = 0; j < 4096; j++)
+                in[j] = (float)(funcs[i].lo + (funcs[i].hi - funcs[i].lo) * (double)j / 4095);
+            if (check_block(fns[i][fast], &funcs[i], fast, 4096, &worst))
+                return 1;
+        }
+    }
+
+    printf("OK\n");
+    return 0;
+}
+
+int main(void)
+{
+    int failures = 0;
+
+    printf("Testing vmath kernels:\n");
+    printf("  CPU SIMD level: %s\n\n", simd_level_name(detect_simd_level()));
+
+    for (int i = 0; i < num_funcs; i++) {
+        failures += test_function(&funcs[i], 0);
+        failures += test_function(&funcs[i], 1);
+    }
+    failures += test_public();
+
+    printf("\n");
+    if (failures == 0) {
+        printf("All tests passed!\n");
+        return 0;
+    } else {
+        printf("%d test(s) failed!\n", failures);
+        return 1;
+    }
+}